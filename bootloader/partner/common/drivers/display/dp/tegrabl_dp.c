@@ -1,5 +1,5 @@
  /*
-  * Copyright (c) 2017-2018, NVIDIA CORPORATION.  All rights reserved.
+  * Copyright (c) 2017-2021, NVIDIA CORPORATION.  All rights reserved.
   *
   * NVIDIA Corporation and its licensors retain all intellectual property
   * and proprietary rights in and to this software, related documentation
@@ -21,6 +21,7 @@
 #include <tegrabl_sor.h>
 #include <tegrabl_dpaux.h>
 #include <tegrabl_drf.h>
+#include <tegrabl_display_sink.h>
 #include <ardpaux.h>
 #include <arsor1.h>
 
@@ -707,6 +708,58 @@ void tegrabl_dp_update_link_config(struct tegrabl_dp *dp)
 	dp_tu_config(dp, cfg);
 }
 
+/* Start from the link that trained with this sink on an earlier boot */
+static void dp_apply_cached_link(struct tegrabl_dp *dp)
+{
+	struct tegrabl_display_sink_link link;
+	struct tegrabl_dp_link_config cfg = dp->link_cfg;
+	struct tegrabl_dp_lt_data *lt_data = &dp->lt_data;
+
+	if (!tegrabl_display_sink_get_link(TEGRABL_MODULE_DPAUX, dp->hdpaux->instance, &link)) {
+		return;
+	}
+
+	if ((link.lane_count == 0U) || (link.lane_count > cfg.max_lane_count) ||
+		(link.link_bw > cfg.max_link_bw)) {
+		return;
+	}
+
+	cfg.lane_count = link.lane_count;
+	cfg.link_bw = link.link_bw;
+	if (!tegrabl_dp_calc_config(dp, dp->mode, &cfg)) {
+		return;
+	}
+	dp->link_cfg = cfg;
+
+	memcpy(lt_data->fast_drive_current, link.drive_current, sizeof(lt_data->fast_drive_current));
+	memcpy(lt_data->fast_pre_emphasis, link.pre_emphasis, sizeof(lt_data->fast_pre_emphasis));
+	memcpy(lt_data->fast_post_cursor2, link.post_cursor2, sizeof(lt_data->fast_post_cursor2));
+	lt_data->fast_lt_pending = true;
+
+	pr_debug("dp: cached link, lanes: %u, link_bw: 0x%x\n", link.lane_count, link.link_bw);
+}
+
+/* Remember the trained link for the next boot, drop it if training failed */
+static void dp_store_link(struct tegrabl_dp *dp, bool trained)
+{
+	struct tegrabl_display_sink_link link;
+	struct tegrabl_dp_lt_data *lt_data = &dp->lt_data;
+
+	if (!trained) {
+		tegrabl_display_sink_set_link(TEGRABL_MODULE_DPAUX, dp->hdpaux->instance, NULL);
+		return;
+	}
+
+	memset(&link, 0, sizeof(link));
+	link.lane_count = lt_data->n_lanes;
+	link.link_bw = lt_data->link_bw;
+	memcpy(link.drive_current, lt_data->drive_current, sizeof(link.drive_current));
+	memcpy(link.pre_emphasis, lt_data->pre_emphasis, sizeof(link.pre_emphasis));
+	memcpy(link.post_cursor2, lt_data->post_cursor2, sizeof(link.post_cursor2));
+
+	tegrabl_display_sink_set_link(TEGRABL_MODULE_DPAUX, dp->hdpaux->instance, &link);
+}
+
 /* Enable DP
  * Enable Sor Macro Clock
  * Perform Link Training
@@ -732,6 +785,7 @@ static tegrabl_error_t tegrabl_dp_enable(struct tegrabl_nvdisp *nvdisp)
 	}
 
 	dp_dpcd_init(dp);
+	dp_apply_cached_link(dp);
 
 	/*dp_prepare_pad*/
 	CHECK_RET(tegrabl_dp_clock_config(sor->nvdisp, sor->instance, TEGRA_SOR_SAFE_CLK));
@@ -778,6 +832,7 @@ static tegrabl_error_t tegrabl_dp_enable(struct tegrabl_nvdisp *nvdisp)
 
 	/* Host is ready. Start link training. */
 	ret = tegrabl_dp_lt(&dp->lt_data);
+	dp_store_link(dp, ret == TEGRABL_NO_ERROR);
 
 	if (ret != TEGRABL_NO_ERROR) {
 		pr_error("dp: link training failed\n");
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2019, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2017-2021, NVIDIA CORPORATION.  All rights reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property
  * and proprietary rights in and to this software, related documentation
@@ -523,7 +523,7 @@ static tegrabl_error_t lt_reset_state(struct tegrabl_dp_lt_data *lt_data)
 
 	lt_data_reset(lt_data);
 
-	tgt_state = STATE_CLOCK_RECOVERY;
+	tgt_state = lt_data->fast_lt_pending ? STATE_FAST_LT : STATE_CLOCK_RECOVERY;
 	timeout = 0;
 
 	/*
@@ -536,10 +536,47 @@ done:
 	return set_lt_state(lt_data, tgt_state, timeout);
 }
 
+/*
+ * Replay the link settings that passed with this sink on an earlier boot:
+ * one pass of each training pattern with the cached voltage swing,
+ * pre-emphasis and post-cursor2, then check the lane status. Any failure
+ * restores the max link config and falls back to full link training.
+ */
 static tegrabl_error_t fast_lt_state(struct tegrabl_dp_lt_data *lt_data)
 {
-	/*dummy func*/
-	return TEGRABL_ERROR(TEGRABL_ERR_NOT_SUPPORTED, 0);
+	struct tegrabl_dp *dp = lt_data->dp;
+	tegrabl_error_t ret = TEGRABL_NO_ERROR;
+
+	/* one shot */
+	lt_data->fast_lt_pending = false;
+
+	memcpy(lt_data->drive_current, lt_data->fast_drive_current,
+		   sizeof(lt_data->drive_current));
+	memcpy(lt_data->pre_emphasis, lt_data->fast_pre_emphasis,
+		   sizeof(lt_data->pre_emphasis));
+	memcpy(lt_data->post_cursor2, lt_data->fast_post_cursor2,
+		   sizeof(lt_data->post_cursor2));
+
+	CHECK_RET(set_lt_tpg(lt_data, TRAINING_PATTERN_1));
+	set_lt_config(lt_data);
+	wait_aux_training(lt_data, true);
+
+	CHECK_RET(set_lt_tpg(lt_data, dp->link_cfg.tps));
+	wait_aux_training(lt_data, false);
+
+	if (get_lt_status(lt_data)) {
+		lt_passed(lt_data);
+		pr_info("dp lt: fast link training done\n");
+		return set_lt_state(lt_data, STATE_DONE_PASS, -1);
+	}
+
+	pr_info("dp lt: fast link training failed, full training\n");
+	tegrabl_sor_detach(dp->sor);
+	CHECK_RET(set_lt_tpg(lt_data, TRAINING_PATTERN_DISABLE));
+	dp->link_cfg = dp->max_link_cfg;
+	CHECK_RET(lt_data_reset(lt_data));
+
+	return set_lt_state(lt_data, STATE_RESET, 0);
 }
 
 static tegrabl_error_t lt_reduce_bit_rate_state(
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2017-2021, NVIDIA CORPORATION.  All rights reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property
  * and proprietary rights in and to this software, related documentation
@@ -82,6 +82,12 @@ struct tegrabl_dp_lt_data {
 
 	uint32_t cr_retry;
 	uint32_t ce_retry;
+
+	/* settings that trained with this sink before, tried once first */
+	bool fast_lt_pending;
+	uint32_t fast_drive_current[4];
+	uint32_t fast_pre_emphasis[4];
+	uint32_t fast_post_cursor2[4];
 };
 
 /* CTS approved list. Do not alter. */
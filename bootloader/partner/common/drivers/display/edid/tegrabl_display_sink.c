@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA Corporation and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA Corporation is strictly prohibited.
+ */
+
+#define MODULE TEGRABL_ERR_DISPLAY
+
+#include "build_config.h"
+#include <string.h>
+#include <stddef.h>
+#include <tegrabl_debug.h>
+#include <tegrabl_error.h>
+#include <tegrabl_utils.h>
+#include <tegrabl_cache_record.h>
+#include <tegrabl_display_sink.h>
+
+#define DISPLAY_SINK_PARTITION "DISP-SINK"
+#define DISPLAY_SINK_VERSION 2U
+#define DISPLAY_SINK_MAX_ENTRIES 2U
+#define EDID_BLOCK_SIZE 128
+
+/**
+* @brief Sink seen on an EDID bus
+*
+* @param module bus type
+* @param instance bus instance
+* @param edid_id first bytes of the EDID, compared on warm boots
+* @param edid_crc crc32 of the whole base EDID block
+* @param is_hdmi HDMI or DVI sink
+* @param link_valid link holds settings that passed training
+* @param mode mode chosen for the sink
+* @param link DP link settings
+*/
+struct display_sink_entry {
+	uint32_t module;
+	uint32_t instance;
+	uint8_t edid_id[DISPLAY_SINK_EDID_ID_SIZE];
+	uint8_t is_hdmi;
+	uint8_t link_valid;
+	uint32_t edid_crc;
+	struct nvdisp_mode mode;
+	struct tegrabl_display_sink_link link;
+};
+
+/**
+* @brief Record kept in the DISPLAY_SINK_PARTITION
+*
+* @param num_entries number of valid entries
+*/
+struct display_sink_record {
+	uint32_t num_entries;
+	uint32_t reserved;
+	struct display_sink_entry entries[DISPLAY_SINK_MAX_ENTRIES];
+};
+
+static struct display_sink_record sink_record;
+static bool sink_record_loaded;
+/* There is a usable DISPLAY_SINK_PARTITION */
+static bool sink_record_enabled;
+/* Sink identity confirmed on this boot, gates reuse of the link */
+static bool sink_matched[DISPLAY_SINK_MAX_ENTRIES];
+
+static struct display_sink_record *display_sink_get(void)
+{
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+
+	if (sink_record_loaded) {
+		goto done;
+	}
+	sink_record_loaded = true;
+
+	err = tegrabl_cache_record_load(DISPLAY_SINK_PARTITION, DISPLAY_SINK_VERSION, &sink_record,
+									sizeof(sink_record));
+	if ((err != TEGRABL_NO_ERROR) && (TEGRABL_ERROR_REASON(err) != TEGRABL_ERR_INVALID)) {
+		pr_debug("%s: no usable %s partition, sink caching disabled\n", __func__,
+				 DISPLAY_SINK_PARTITION);
+		goto done;
+	}
+	if ((err != TEGRABL_NO_ERROR) || (sink_record.num_entries > DISPLAY_SINK_MAX_ENTRIES)) {
+		memset(&sink_record, 0, sizeof(sink_record));
+	}
+	sink_record_enabled = true;
+
+done:
+	return sink_record_enabled ? &sink_record : NULL;
+}
+
+static struct display_sink_entry *display_sink_find(struct display_sink_record *record,
+													uint32_t module, uint32_t instance)
+{
+	uint32_t i;
+
+	for (i = 0; i < record->num_entries; i++) {
+		if ((record->entries[i].module == module) &&
+			(record->entries[i].instance == instance)) {
+			return &record->entries[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void display_sink_store(struct display_sink_record *record)
+{
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+
+	err = tegrabl_cache_record_store(DISPLAY_SINK_PARTITION, DISPLAY_SINK_VERSION, record, sizeof(*record));
+	if (err != TEGRABL_NO_ERROR) {
+		/* Not fatal, the next boot reads the EDID and trains the link again */
+		pr_warn("%s: failed to store sink record (err 0x%08x)\n", __func__, err);
+	}
+}
+
+bool tegrabl_display_sink_is_cached(uint32_t module, uint32_t instance)
+{
+	struct display_sink_record *record = display_sink_get();
+
+	return (record != NULL) && (display_sink_find(record, module, instance) != NULL);
+}
+
+bool tegrabl_display_sink_match(uint32_t module, uint32_t instance,
+								const uint8_t *edid_id,
+								struct nvdisp_mode *mode, bool *is_hdmi)
+{
+	struct display_sink_record *record = display_sink_get();
+	struct display_sink_entry *entry = NULL;
+
+	if (record == NULL) {
+		return false;
+	}
+
+	entry = display_sink_find(record, module, instance);
+	if ((entry == NULL) || (memcmp(entry->edid_id, edid_id, sizeof(entry->edid_id)) != 0)) {
+		return false;
+	}
+
+	memcpy(mode, &entry->mode, sizeof(*mode));
+	*is_hdmi = (entry->is_hdmi != 0U);
+	sink_matched[entry - record->entries] = true;
+
+	return true;
+}
+
+void tegrabl_display_sink_update(uint32_t module, uint32_t instance,
+								 const uint8_t *edid,
+								 const struct nvdisp_mode *mode, bool is_hdmi)
+{
+	struct display_sink_record *record = display_sink_get();
+	struct display_sink_entry *entry = NULL;
+	struct display_sink_entry new_entry;
+
+	if (record == NULL) {
+		return;
+	}
+
+	memset(&new_entry, 0, sizeof(new_entry));
+	new_entry.module = module;
+	new_entry.instance = instance;
+	memcpy(new_entry.edid_id, edid, sizeof(new_entry.edid_id));
+	new_entry.edid_crc = tegrabl_utils_crc32(0, (void *)edid, EDID_BLOCK_SIZE);
+	new_entry.is_hdmi = is_hdmi ? 1U : 0U;
+	/* Copy vic on its own so the padding after avi_m stays zero */
+	memcpy(&new_entry.mode, mode, offsetof(struct nvdisp_mode, avi_m) + sizeof(mode->avi_m));
+	new_entry.mode.vic = mode->vic;
+
+	entry = display_sink_find(record, module, instance);
+	if (entry == NULL) {
+		if (record->num_entries >= DISPLAY_SINK_MAX_ENTRIES) {
+			return;
+		}
+		entry = &record->entries[record->num_entries++];
+	} else if (entry->edid_crc == new_entry.edid_crc) {
+		/* Same sink, keep its trained link */
+		new_entry.link_valid = entry->link_valid;
+		new_entry.link = entry->link;
+	}
+
+	sink_matched[entry - record->entries] = true;
+
+	if (memcmp(entry, &new_entry, sizeof(new_entry)) == 0) {
+		return;
+	}
+	memcpy(entry, &new_entry, sizeof(new_entry));
+
+	display_sink_store(record);
+}
+
+bool tegrabl_display_sink_get_link(uint32_t module, uint32_t instance,
+								   struct tegrabl_display_sink_link *link)
+{
+	struct display_sink_record *record = display_sink_get();
+	struct display_sink_entry *entry = NULL;
+
+	if (record == NULL) {
+		return false;
+	}
+
+	entry = display_sink_find(record, module, instance);
+	if ((entry == NULL) || !sink_matched[entry - record->entries] || (entry->link_valid == 0U)) {
+		return false;
+	}
+
+	memcpy(link, &entry->link, sizeof(*link));
+
+	return true;
+}
+
+void tegrabl_display_sink_set_link(uint32_t module, uint32_t instance,
+								   const struct tegrabl_display_sink_link *link)
+{
+	struct display_sink_record *record = display_sink_get();
+	struct display_sink_entry *entry = NULL;
+
+	if (record == NULL) {
+		return;
+	}
+
+	/* Only links of a sink identified on this boot are worth keeping */
+	entry = display_sink_find(record, module, instance);
+	if ((entry == NULL) || !sink_matched[entry - record->entries]) {
+		return;
+	}
+
+	if (link == NULL) {
+		if (entry->link_valid == 0U) {
+			return;
+		}
+		entry->link_valid = 0U;
+		memset(&entry->link, 0, sizeof(entry->link));
+	} else {
+		if ((entry->link_valid != 0U) && (memcmp(&entry->link, link, sizeof(*link)) == 0)) {
+			return;
+		}
+		entry->link_valid = 1U;
+		memcpy(&entry->link, link, sizeof(*link));
+	}
+
+	display_sink_store(record);
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA Corporation and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA Corporation is strictly prohibited.
+ */
+
+#ifndef __TEGRABL_DISPLAY_SINK_H__
+#define __TEGRABL_DISPLAY_SINK_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <tegrabl_nvdisp_local.h>
+
+/* EDID header, manufacturer, product and serial number, week and year */
+#define DISPLAY_SINK_EDID_ID_SIZE 18
+
+/**
+* @brief DP link that passed training with a sink
+*/
+struct tegrabl_display_sink_link {
+	uint8_t lane_count;
+	uint8_t link_bw;
+	uint8_t reserved[2];
+	uint32_t drive_current[4];
+	uint32_t pre_emphasis[4];
+	uint32_t post_cursor2[4];
+};
+
+/**
+ *  @brief Check if a sink was recorded on an earlier boot for this EDID bus
+ *
+ *  @param module TEGRABL_MODULE_I2C or TEGRABL_MODULE_DPAUX
+ *  @param instance instance of the EDID bus
+ *
+ *  @return true if there is a record
+ */
+bool tegrabl_display_sink_is_cached(uint32_t module, uint32_t instance);
+
+/**
+ *  @brief Compare the identity of the connected sink against the record and
+ *  return the mode chosen for it on an earlier boot
+ *
+ *  @param module TEGRABL_MODULE_I2C or TEGRABL_MODULE_DPAUX
+ *  @param instance instance of the EDID bus
+ *  @param edid_id first DISPLAY_SINK_EDID_ID_SIZE bytes of the EDID
+ *  @param mode returns the cached mode
+ *  @param is_hdmi returns whether the sink is HDMI or DVI
+ *
+ *  @return true if the sink is unchanged
+ */
+bool tegrabl_display_sink_match(uint32_t module, uint32_t instance,
+								const uint8_t *edid_id,
+								struct nvdisp_mode *mode, bool *is_hdmi);
+
+/**
+ *  @brief Record the sink and the mode chosen from its EDID. The stored
+ *  link is dropped if the EDID changed.
+ *
+ *  @param module TEGRABL_MODULE_I2C or TEGRABL_MODULE_DPAUX
+ *  @param instance instance of the EDID bus
+ *  @param edid base EDID block
+ *  @param mode mode chosen for the sink
+ *  @param is_hdmi whether the sink is HDMI or DVI
+ */
+void tegrabl_display_sink_update(uint32_t module, uint32_t instance,
+								 const uint8_t *edid,
+								 const struct nvdisp_mode *mode, bool is_hdmi);
+
+/**
+ *  @brief Get the link trained with the sink on an earlier boot. Only
+ *  returned once the sink identity has been confirmed on this boot.
+ *
+ *  @param module TEGRABL_MODULE_DPAUX
+ *  @param instance dpaux instance
+ *  @param link returns the link settings
+ *
+ *  @return true if a link is available
+ */
+bool tegrabl_display_sink_get_link(uint32_t module, uint32_t instance,
+								   struct tegrabl_display_sink_link *link);
+
+/**
+ *  @brief Record the link that passed training, or drop it
+ *
+ *  @param module TEGRABL_MODULE_DPAUX
+ *  @param instance dpaux instance
+ *  @param link link settings, NULL to drop the stored link
+ */
+void tegrabl_display_sink_set_link(uint32_t module, uint32_t instance,
+								   const struct tegrabl_display_sink_link *link);
+
+#endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2019, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2016-2021, NVIDIA CORPORATION.  All rights reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property
  * and proprietary rights in and to this software, related documentation
@@ -20,6 +20,7 @@
 #include <tegrabl_modes.h>
 #include <string.h>
 #include <tegrabl_dpaux.h>
+#include <tegrabl_display_sink.h>
 
 #define MAX_FREQ 148500000
 #define EDID_BLOCK_SIZE 128
@@ -169,6 +170,37 @@ fail:
 	return err;
 }
 
+/* Single read of the EDID identity bytes, no checksum retries */
+static tegrabl_error_t read_edid_id(uint8_t *edid_id, uint32_t module,
+									uint32_t instance)
+{
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+	struct tegrabl_i2c_dev *hi2c = NULL;
+#if defined (CONFIG_ENABLE_DP)
+	struct tegrabl_dpaux *hdpaux;
+
+	if (module == TEGRABL_MODULE_DPAUX) {
+		err = tegrabl_dpaux_init_aux(instance, &hdpaux);
+		if (err != TEGRABL_NO_ERROR) {
+			goto fail;
+		}
+		err = dpaux_i2c_dev_read(hdpaux, edid_id, 0x0, DISPLAY_SINK_EDID_ID_SIZE);
+	}
+#endif
+	if (module == TEGRABL_MODULE_I2C) {
+		hi2c = tegrabl_i2c_dev_open(instance, EDID_SLAVE, 1, 1);
+		if (!hi2c) {
+			err = TEGRABL_ERROR(TEGRABL_ERR_INVALID, 7);
+			goto fail;
+		}
+		err = tegrabl_i2c_dev_read(hi2c, edid_id, 0x0, DISPLAY_SINK_EDID_ID_SIZE);
+		tegrabl_i2c_dev_close(hi2c);
+	}
+
+fail:
+	return err;
+}
+
 static uint8_t get_bit(int8_t in, uint8_t bit)
 {
 	return (in & (1 << bit)) >> bit;
@@ -768,8 +800,18 @@ tegrabl_error_t tegrabl_edid_get_mode(struct nvdisp_mode *modes,
 {
 	uint8_t edid[EDID_BLOCK_SIZE] = {0};
 	struct hdmi_mode *mode = NULL;
+	bool edid_valid = false;
 	tegrabl_error_t status = TEGRABL_NO_ERROR;
 
+	/* Same sink as on the last boot: skip the full read and parse */
+	if (tegrabl_display_sink_is_cached(module, instance) &&
+		(read_edid_id(edid, module, instance) == TEGRABL_NO_ERROR) &&
+		tegrabl_display_sink_match(module, instance, edid, modes, &is_panel_hdmi)) {
+		pr_info("edid: sink unchanged, using cached mode %ux%u\n",
+				modes->h_active, modes->v_active);
+		goto fail;
+	}
+
 	mode = tegrabl_malloc(sizeof(struct hdmi_mode));
 	if (mode == NULL) {
 		pr_error("memory allocation failed!\n");
@@ -784,6 +826,7 @@ tegrabl_error_t tegrabl_edid_get_mode(struct nvdisp_mode *modes,
 			status = TEGRABL_ERROR(TEGRABL_ERR_INVALID, 6);
 			goto fail;
 		}
+		edid_valid = true;
 	} else {
 		pr_debug("%s, read edid failed, using default mode\n", __func__);
 		memcpy(mode, &s_1920_1080_16, sizeof(struct hdmi_mode));
@@ -791,6 +834,10 @@ tegrabl_error_t tegrabl_edid_get_mode(struct nvdisp_mode *modes,
 
 	mode_from_hdmi_mode(modes, mode);
 
+	if (edid_valid) {
+		tegrabl_display_sink_update(module, instance, edid, modes, is_panel_hdmi);
+	}
+
 fail:
 	if (mode != NULL) {
 		tegrabl_free(mode);
@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2016-2018, NVIDIA Corporation.  All rights reserved.
+# Copyright (c) 2016-2021, NVIDIA Corporation.  All rights reserved.
 #
 # NVIDIA Corporation and its licensors retain all intellectual property
 # and proprietary rights in and to this software, related documentation
@@ -13,7 +13,8 @@ LOCAL_DIR := $(GET_LOCAL_DIR)
 MODULE := $(LOCAL_DIR)
 
 MODULE_DEPS += \
-	$(LOCAL_DIR)/../../lib/graphics
+	$(LOCAL_DIR)/../../lib/graphics \
+	$(LOCAL_DIR)/../../lib/background
 
 GLOBAL_INCLUDES += \
 	$(LOCAL_DIR) \
@@ -45,6 +46,7 @@ MODULE_SRCS += \
 	$(LOCAL_DIR)/edid/tegrabl_edid.c \
 	$(LOCAL_DIR)/edid/tegrabl_modes.c \
 	$(LOCAL_DIR)/edid/tegrabl_mode_selection.c \
+	$(LOCAL_DIR)/edid/tegrabl_display_sink.c \
 	$(LOCAL_DIR)/platform_data/tegrabl_display_dtb.c \
 	$(LOCAL_DIR)/platform_data/tegrabl_display_dtb_hdmi.c \
 	$(LOCAL_DIR)/platform_data/tegrabl_display_dtb_dp.c \
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2018, NVIDIA Corporation.  All rights reserved.
+ * Copyright (c) 2016-2021, NVIDIA Corporation.  All rights reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property
  * and proprietary rights in and to this software, related documentation
@@ -10,6 +10,7 @@
 
 #define MODULE TEGRABL_ERR_DISPLAY
 
+#include "build_config.h"
 #include <tegrabl_debug.h>
 #include <tegrabl_stdarg.h>
 #include <tegrabl_error.h>
@@ -23,6 +24,13 @@
 #include <tegrabl_display_dtb.h>
 #include <tegrabl_timer.h>
 #include <tegrabl_display_soc.h>
+#include <tegrabl_compiler.h>
+#if defined(CONFIG_ENABLE_DISPLAY_THREAD)
+#if !defined(CONFIG_ENABLE_BACKGROUND_TASKS)
+#error "CONFIG_ENABLE_DISPLAY_THREAD needs CONFIG_ENABLE_BACKGROUND_TASKS"
+#endif
+#include <tegrabl_background.h>
+#endif
 
 #define TEXT_SIZE   1024
 
@@ -31,13 +39,18 @@ struct tegrabl_display {
 	uint32_t n_du;
 };
 static struct tegrabl_display *hdisplay;
+#if defined(CONFIG_ENABLE_DISPLAY_THREAD)
+static struct tegrabl_background_task display_init_task;
+#endif
 
-tegrabl_error_t tegrabl_display_init(void)
+static tegrabl_error_t display_init(void *arg)
 {
 	tegrabl_error_t err = TEGRABL_NO_ERROR;
 	uint32_t n_du = 0;
 	struct tegrabl_display_list *du_list = NULL;
 
+	TEGRABL_UNUSED(arg);
+
 	if (hdisplay) {
 		if (hdisplay->n_du > 0) {
 			pr_debug("Display already initialized\n");
@@ -74,6 +87,10 @@ tegrabl_error_t tegrabl_display_init(void)
 		}
 
 		du_list = du_list->next;
+#if defined(CONFIG_ENABLE_DISPLAY_THREAD)
+		/* Nothing in flight between display units */
+		tegrabl_background_yield();
+#endif
 	};
 
 	/* TODO: Get orientation from accelerometer and then set */
@@ -89,6 +106,40 @@ fail:
 	return err;
 }
 
+tegrabl_error_t tegrabl_display_wait_ready(void)
+{
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+
+#if defined(CONFIG_ENABLE_DISPLAY_THREAD)
+	if (tegrabl_background_pending(&display_init_task)) {
+		err = tegrabl_background_wait(&display_init_task);
+		if (err != TEGRABL_NO_ERROR) {
+			pr_warn("display init failed\n");
+		}
+	}
+#endif
+
+	return err;
+}
+
+tegrabl_error_t tegrabl_display_init(void)
+{
+	tegrabl_display_wait_ready();
+
+	return display_init(NULL);
+}
+
+tegrabl_error_t tegrabl_display_init_async(void)
+{
+#if defined(CONFIG_ENABLE_DISPLAY_THREAD)
+	if (hdisplay == NULL) {
+		return tegrabl_background_start(&display_init_task, "display-init", display_init, NULL);
+	}
+#endif
+
+	return tegrabl_display_init();
+}
+
 tegrabl_error_t tegrabl_display_printf(color_t color,
 									   const char *format, ...)
 {
@@ -97,6 +148,8 @@ tegrabl_error_t tegrabl_display_printf(color_t color,
 	tegrabl_error_t err = TEGRABL_NO_ERROR;
 	uint32_t du_idx = 0;
 
+	tegrabl_display_wait_ready();
+
 	if (!hdisplay) {
 		pr_error("%s: display is not initialized\n", __func__);
 		err = TEGRABL_ERROR(TEGRABL_ERR_NOT_INITIALIZED, 0);
@@ -127,6 +180,8 @@ tegrabl_error_t tegrabl_display_show_image(struct tegrabl_image_info *image)
 	struct tegrabl_bmp_image bmp_img = {0};
 	uint32_t du_idx = 0;
 
+	tegrabl_display_wait_ready();
+
 	if (!hdisplay) {
 		pr_error("%s: display is not initialized\n", __func__);
 		err = TEGRABL_ERROR(TEGRABL_ERR_NOT_INITIALIZED, 1);
@@ -201,6 +256,8 @@ tegrabl_error_t tegrabl_display_clear(void)
 	tegrabl_error_t err = TEGRABL_NO_ERROR;
 	uint32_t du_idx = 0;
 
+	tegrabl_display_wait_ready();
+
 	if (!hdisplay) {
 		pr_error("%s: display is not initialized\n", __func__);
 		err = TEGRABL_ERROR(TEGRABL_ERR_NOT_INITIALIZED, 2);
@@ -228,6 +285,8 @@ tegrabl_error_t tegrabl_display_text_set_cursor(cursor_position_t position)
 	tegrabl_error_t err = TEGRABL_NO_ERROR;
 	uint32_t du_idx = 0;
 
+	tegrabl_display_wait_ready();
+
 	if (!hdisplay) {
 		pr_error("%s: display is not initialized\n", __func__);
 		err = TEGRABL_ERROR(TEGRABL_ERR_NOT_INITIALIZED, 3);
@@ -253,6 +312,8 @@ tegrabl_error_t tegrabl_display_shutdown(void)
 	tegrabl_error_t err = TEGRABL_NO_ERROR;
 	uint32_t du_idx = 0;
 
+	tegrabl_display_wait_ready();
+
 	if (!hdisplay) {
 		pr_error("%s: display is not initialized\n", __func__);
 		err = TEGRABL_ERROR(TEGRABL_ERR_NOT_INITIALIZED, 4);
@@ -279,6 +340,8 @@ tegrabl_error_t tegrabl_display_get_params(
 {
 	tegrabl_error_t err = TEGRABL_NO_ERROR;
 
+	tegrabl_display_wait_ready();
+
 	if (!hdisplay || du_idx >= hdisplay->n_du) {
 		pr_debug("%s: display or du %d is not initialized\n", __func__, du_idx);
 		err = TEGRABL_ERROR(TEGRABL_ERR_NOT_INITIALIZED, 5);
@@ -16,6 +16,7 @@
 #include <tegrabl_malloc.h>
 #include <tegrabl_utils.h>
 #include <tegrabl_error.h>
+#include <tegrabl_cache_record.h>
 #include <string.h>
 
 #define TEGRABL_I2C_DEFAULT_RETRY_COUNT	1
@@ -28,6 +29,60 @@
 #define EEPROM_MAJ_VER		1U
 #define EEPROM_MIN_VER		0U
 
+#define EEPROM_CACHE_PARTITION		"EEPROM-CACHE"
+#define EEPROM_CACHE_VERSION		2U
+#define EEPROM_CACHE_MAX_ENTRIES	8U
+#define EEPROM_CACHE_DATA_SIZE		256U
+/* Must cover the probe regions below */
+#define EEPROM_CACHE_MIN_SIZE		90U
+#define EEPROM_CACHE_PROBE_MAX_LEN	20U
+
+/**
+* @brief EEPROM contents seen on an earlier boot
+*
+* @param instance I2C instance
+* @param slave_addr slave address of the EEPROM
+* @param size number of bytes read
+* @param data EEPROM contents
+*/
+struct eeprom_cache_entry {
+	uint32_t instance;
+	uint32_t slave_addr;
+	uint32_t size;
+	uint32_t reserved;
+	uint8_t data[EEPROM_CACHE_DATA_SIZE];
+};
+
+/**
+* @brief Record kept in the EEPROM_CACHE_PARTITION
+*
+* @param num_entries number of valid entries
+* @param entries cached EEPROMs
+*/
+struct eeprom_cache_record {
+	uint32_t num_entries;
+	uint32_t reserved;
+	struct eeprom_cache_entry entries[EEPROM_CACHE_MAX_ENTRIES];
+};
+
+/*
+ * Bytes compared against the cache before trusting it: the board id header
+ * (version to rework level) and the serial number of struct eeprom_layout.
+ * The CRC8 in the last byte covers everything else.
+ */
+static const struct {
+	uint32_t offset;
+	uint32_t len;
+} eeprom_cache_probe_regions[] = {
+	{ 0, 20 },
+	{ 74, 15 },
+};
+
+static struct eeprom_cache_record eeprom_cache;
+static bool eeprom_cache_loaded;
+/* There is a usable EEPROM_CACHE_PARTITION */
+static bool eeprom_cache_enabled;
+
 static tegrabl_error_t verify_cvm_eeprom_version(
 			const struct tegrabl_eeprom *eeprom)
 {
@@ -62,6 +117,153 @@ static tegrabl_error_t verify_eeprom_data(struct tegrabl_eeprom *eeprom)
 	return TEGRABL_NO_ERROR;
 }
 
+static struct eeprom_cache_record *eeprom_cache_get(void)
+{
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+
+	if (eeprom_cache_loaded) {
+		goto done;
+	}
+
+	err = tegrabl_cache_record_load(EEPROM_CACHE_PARTITION, EEPROM_CACHE_VERSION, &eeprom_cache,
+									sizeof(eeprom_cache));
+	if ((TEGRABL_ERROR_REASON(err) == TEGRABL_ERR_NOT_INITIALIZED) ||
+		(TEGRABL_ERROR_REASON(err) == TEGRABL_ERR_NOT_FOUND)) {
+		/* Storage may not be up yet, try again on the next read */
+		goto done;
+	}
+	eeprom_cache_loaded = true;
+
+	if ((err != TEGRABL_NO_ERROR) && (TEGRABL_ERROR_REASON(err) != TEGRABL_ERR_INVALID)) {
+		pr_debug("%s: no usable %s partition, EEPROM caching disabled\n", __func__,
+				 EEPROM_CACHE_PARTITION);
+		goto done;
+	}
+	if ((err != TEGRABL_NO_ERROR) || (eeprom_cache.num_entries > EEPROM_CACHE_MAX_ENTRIES)) {
+		memset(&eeprom_cache, 0, sizeof(eeprom_cache));
+	}
+	eeprom_cache_enabled = true;
+
+done:
+	return eeprom_cache_enabled ? &eeprom_cache : NULL;
+}
+
+static struct eeprom_cache_entry *eeprom_cache_find(struct eeprom_cache_record *record,
+													const struct tegrabl_eeprom *eeprom)
+{
+	uint32_t i;
+
+	for (i = 0; i < record->num_entries; i++) {
+		if ((record->entries[i].instance == eeprom->instance) &&
+			(record->entries[i].slave_addr == eeprom->slave_addr) &&
+			(record->entries[i].size == eeprom->size)) {
+			return &record->entries[i];
+		}
+	}
+
+	return NULL;
+}
+
+static bool eeprom_cache_is_cacheable(const struct tegrabl_eeprom *eeprom)
+{
+	/* Without a valid CRC8 the probe cannot tell if the rest changed */
+	return (eeprom->size >= EEPROM_CACHE_MIN_SIZE) && (eeprom->size <= EEPROM_CACHE_DATA_SIZE) &&
+		(tegrabl_utils_crc8(eeprom->data, eeprom->size - 1) == eeprom->data[eeprom->size - 1]);
+}
+
+static bool eeprom_cache_probe(struct tegrabl_i2c_dev *hi2c_dev, const struct tegrabl_eeprom *eeprom,
+							   const struct eeprom_cache_entry *entry)
+{
+	uint8_t buf[EEPROM_CACHE_PROBE_MAX_LEN];
+	uint32_t offset;
+	uint32_t len;
+	uint32_t i;
+
+	for (i = 0; i <= ARRAY_SIZE(eeprom_cache_probe_regions); i++) {
+		if (i < ARRAY_SIZE(eeprom_cache_probe_regions)) {
+			offset = eeprom_cache_probe_regions[i].offset;
+			len = eeprom_cache_probe_regions[i].len;
+		} else {
+			offset = eeprom->size - 1;
+			len = 1;
+		}
+
+		/* Not packed into one tegrabl_i2c_transaction(), it bypasses BPMP owned buses */
+		if (tegrabl_i2c_dev_read(hi2c_dev, buf, offset, len) != TEGRABL_NO_ERROR) {
+			return false;
+		}
+		if (memcmp(buf, &entry->data[offset], len) != 0) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static bool eeprom_cache_lookup(struct tegrabl_i2c_dev *hi2c_dev, struct tegrabl_eeprom *eeprom)
+{
+	struct eeprom_cache_record *record = eeprom_cache_get();
+	struct eeprom_cache_entry *entry = NULL;
+
+	if (record == NULL) {
+		return false;
+	}
+
+	entry = eeprom_cache_find(record, eeprom);
+	if ((entry == NULL) || !eeprom_cache_probe(hi2c_dev, eeprom, entry)) {
+		return false;
+	}
+
+	memcpy(eeprom->data, entry->data, eeprom->size);
+	pr_debug("eeprom: i2c %u:0x%02x unchanged, using cached contents\n", eeprom->instance,
+			 eeprom->slave_addr);
+
+	return true;
+}
+
+static void eeprom_cache_store(struct eeprom_cache_record *record)
+{
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+
+	err = tegrabl_cache_record_store(EEPROM_CACHE_PARTITION, EEPROM_CACHE_VERSION, record, sizeof(*record));
+	if (err != TEGRABL_NO_ERROR) {
+		/* Not fatal, the next boot reads the whole EEPROM again */
+		pr_warn("%s: failed to store EEPROM cache (err 0x%08x)\n", __func__, err);
+	}
+}
+
+static void eeprom_cache_update(const struct tegrabl_eeprom *eeprom)
+{
+	struct eeprom_cache_record *record = NULL;
+	struct eeprom_cache_entry *entry = NULL;
+
+	if (!eeprom_cache_is_cacheable(eeprom)) {
+		return;
+	}
+
+	record = eeprom_cache_get();
+	if (record == NULL) {
+		return;
+	}
+
+	entry = eeprom_cache_find(record, eeprom);
+	if (entry == NULL) {
+		if (record->num_entries >= EEPROM_CACHE_MAX_ENTRIES) {
+			return;
+		}
+		entry = &record->entries[record->num_entries++];
+		memset(entry, 0, sizeof(*entry));
+		entry->instance = eeprom->instance;
+		entry->slave_addr = eeprom->slave_addr;
+		entry->size = eeprom->size;
+	} else if (memcmp(entry->data, eeprom->data, eeprom->size) == 0) {
+		return;
+	}
+
+	memcpy(entry->data, eeprom->data, eeprom->size);
+	eeprom_cache_store(record);
+}
+
 tegrabl_error_t tegrabl_eeprom_read(struct tegrabl_eeprom *eeprom)
 {
 	tegrabl_error_t error = TEGRABL_NO_ERROR;
@@ -92,6 +294,11 @@ tegrabl_error_t tegrabl_eeprom_read(struct tegrabl_eeprom *eeprom)
 		break;
 	}
 
+	/* An unchanged EEPROM only costs the probe reads */
+	if (eeprom_cache_lookup(hi2c_dev, eeprom)) {
+		retry_count = 0;
+	}
+
 	while (retry_count != 0) {
 		error = tegrabl_i2c_dev_read(hi2c_dev, eeprom->data, 0, eeprom->size);
 		if (error == TEGRABL_NO_ERROR) {
@@ -127,6 +334,8 @@ tegrabl_error_t tegrabl_eeprom_read(struct tegrabl_eeprom *eeprom)
 		goto fail;
 	}
 
+	eeprom_cache_update(eeprom);
+
 	return TEGRABL_NO_ERROR;
 
 fail:
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2020, NVIDIA Corporation.  All rights reserved.
+ * Copyright (c) 2018-2021, NVIDIA Corporation.  All rights reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property
  * and proprietary rights in and to this software, related documentation
@@ -346,7 +346,7 @@ extern err_t low_level_input(void);
 /************************************************************************************************************/
 
 #define DESCRIPTORS_TX			4
-#define DESCRIPTORS_RX			4
+#define DESCRIPTORS_RX			16
 #define DESCRIPTORS_NUM			(DESCRIPTORS_TX + DESCRIPTORS_RX)
 #define DESCRIPTOR_SIZE			sizeof(struct eqos_desc)
 #define DESCRIPTORS_NUM			(DESCRIPTORS_TX + DESCRIPTORS_RX)
@@ -393,6 +393,7 @@ struct eqos_desc {
 struct eqos_dev {
 	struct eqos_desc *tx_descs;
 	struct eqos_desc *rx_descs;
+	dma_addr_t rx_descs_dma;
 	uint32_t tx_desc_id;
 	uint32_t rx_desc_id;
 	void *tx_dma_buf[DESCRIPTORS_TX];
@@ -1178,26 +1179,44 @@ static void tegrabl_eqos_prepare_tx_desc(size_t len)
 
 }
 
-static void tegrabl_eqos_prepare_rx_desc(void)
+/* Hand an Rx descriptor (back) to the DMA */
+static void tegrabl_eqos_arm_rx_desc(uint32_t id)
 {
 	struct eqos_desc *rx_desc = NULL;
-	dma_addr_t p_rx_desc;
 
-	/* Setup descriptor */
-	rx_desc = &(eqos.rx_descs[eqos.rx_desc_id]);
-	rx_desc->des0 = (uintptr_t)eqos.rx_dma_buf[eqos.rx_desc_id];
+	(void)tegrabl_dma_map_buffer(TEGRABL_MODULE_EQOS, 0, eqos.rx_dma_buf[id], MAX_PACKET_SIZE,
+								 TEGRABL_DMA_FROM_DEVICE);
+
+	rx_desc = &(eqos.rx_descs[id]);
+	rx_desc->des0 = (uintptr_t)eqos.rx_dma_buf[id];
 	rx_desc->des1 = 0;
 	rx_desc->des2 = 0;
 	rx_desc->des3 = RDES3_OWN_DMA | RDES3_IOC | RDES3_BUF1V;
 
-	p_rx_desc = tegrabl_dma_map_buffer(TEGRABL_MODULE_EQOS, 0, (void *)rx_desc, DESCRIPTOR_SIZE,
-									   TEGRABL_DMA_TO_DEVICE);
-	TEGRABL_UNUSED(p_rx_desc);
+	(void)tegrabl_dma_map_buffer(TEGRABL_MODULE_EQOS, 0, (void *)rx_desc, DESCRIPTOR_SIZE,
+								 TEGRABL_DMA_TO_DEVICE);
+}
 
-	/* Setup descriptor registers */
+/*
+ * Arm the whole Rx ring, so frames arriving back to back land in the next
+ * descriptors while software is still handling the first one.
+ */
+static void tegrabl_eqos_prepare_rx_ring(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < DESCRIPTORS_RX; i++) {
+		tegrabl_eqos_arm_rx_desc(i);
+	}
+
+	eqos.rx_descs_dma = tegrabl_dma_map_buffer(TEGRABL_MODULE_EQOS, 0, (void *)eqos.rx_descs,
+											   RX_DESCRIPTORS_SIZE, TEGRABL_DMA_TO_DEVICE);
+
+	/* Setup descriptor registers, the tail points past the last armed descriptor */
 	NV_WRITE32(DMA_CH0_RXDESC_LIST_HIGH_ADDR, 0x0);
-	NV_WRITE32(DMA_CH0_RXDESC_LIST_ADDR, (uintptr_t)p_rx_desc);
-	NV_WRITE32(DMA_CH0_RXDESC_TAIL_POINTER, (uintptr_t)((struct eqos_desc *)p_rx_desc + 1));
+	NV_WRITE32(DMA_CH0_RXDESC_LIST_ADDR, (uintptr_t)eqos.rx_descs_dma);
+	NV_WRITE32(DMA_CH0_RXDESC_TAIL_POINTER,
+			   (uintptr_t)((struct eqos_desc *)(uintptr_t)eqos.rx_descs_dma + DESCRIPTORS_RX));
 }
 
 tegrabl_error_t tegrabl_eqos_init(void)
@@ -1298,7 +1317,7 @@ tegrabl_error_t tegrabl_eqos_init(void)
 	NV_WRITE32(DMA_CH0_TXDESC_RING_LENGTH, DESCRIPTORS_TX-1);
 	NV_WRITE32(DMA_CH0_RXDESC_RING_LENGTH, DESCRIPTORS_RX-1);
 
-	tegrabl_eqos_prepare_rx_desc();
+	tegrabl_eqos_prepare_rx_ring();
 
 	/* Start Rx of DMA */
 	SET_REG_BIT(DMA_CH0_RX_CONTROL, SR);
@@ -1354,7 +1373,7 @@ void tegrabl_eqos_send(void *packet, size_t len)
 	return;
 }
 
-void tegrabl_eqos_receive(void *packet, size_t *len)
+void tegrabl_eqos_receive(void *packet, size_t size, size_t *len)
 {
 	struct eqos_desc *rx_desc = NULL;
 	static uint32_t total_rx_pkt_cnt = 0;
@@ -1366,31 +1385,48 @@ void tegrabl_eqos_receive(void *packet, size_t *len)
 	tegrabl_dma_unmap_buffer(TEGRABL_MODULE_EQOS, 0, (void *)rx_desc, DESCRIPTOR_SIZE, TEGRABL_DMA_FROM_DEVICE);
 	*len = (rx_desc->des3 & (0x7FFF));
 
-	/* Transfer packet to network layer */
-	tegrabl_dma_unmap_buffer(TEGRABL_MODULE_EQOS, 0, (void *)eqos.rx_dma_buf[eqos.rx_desc_id], *len,
-							 TEGRABL_DMA_FROM_DEVICE);
-	memcpy(packet, eqos.rx_dma_buf[eqos.rx_desc_id], *len);
+	/* Frames that do not fit are not copied, the caller drops them by *len */
+	if (*len <= size) {
+		/* Transfer packet to network layer */
+		tegrabl_dma_unmap_buffer(TEGRABL_MODULE_EQOS, 0, (void *)eqos.rx_dma_buf[eqos.rx_desc_id], *len,
+								 TEGRABL_DMA_FROM_DEVICE);
+		memcpy(packet, eqos.rx_dma_buf[eqos.rx_desc_id], *len);
 
-	/* Unicast */
-	if ((*(uint8_t *)eqos.rx_dma_buf[eqos.rx_desc_id] & 1U) == 0U) {
-		pr_trace("Rx packet: %u, len = %d, desc cnt: %u\n", total_rx_pkt_cnt++, (int32_t)*len, eqos.rx_desc_id);
-		print_buffer(eqos.rx_dma_buf[eqos.rx_desc_id], *len, "Rx buffer");
+		/* Unicast */
+		if ((*(uint8_t *)eqos.rx_dma_buf[eqos.rx_desc_id] & 1U) == 0U) {
+			pr_trace("Rx packet: %u, len = %d, desc cnt: %u\n", total_rx_pkt_cnt++, (int32_t)*len,
+					 eqos.rx_desc_id);
+			print_buffer(eqos.rx_dma_buf[eqos.rx_desc_id], *len, "Rx buffer");
+		}
 	}
 
-	/* Disable Rx of DMA (till next set of descriptor is ready) */
-	CLR_REG_BIT(DMA_CH0_RX_CONTROL, SR);
+	/* Refill the descriptor and move the tail past it, the DMA keeps running */
+	tegrabl_eqos_arm_rx_desc(eqos.rx_desc_id);
 
 	eqos.rx_desc_id++;
 	eqos.rx_desc_id %= DESCRIPTORS_RX;
 
-	tegrabl_eqos_prepare_rx_desc();
-
-	/* Enable Rx of DMA */
-	SET_REG_BIT(DMA_CH0_RX_CONTROL, SR);
+	NV_WRITE32(DMA_CH0_RXDESC_TAIL_POINTER,
+			   (uintptr_t)((struct eqos_desc *)(uintptr_t)eqos.rx_descs_dma + eqos.rx_desc_id));
 
 	return;
 }
 
+bool tegrabl_eqos_is_rx_pending(void)
+{
+	struct eqos_desc *rx_desc = NULL;
+
+	if (eqos.rx_descs == NULL) {
+		return false;
+	}
+
+	/* Descriptors are handed back to software in ring order as frames land */
+	rx_desc = &(eqos.rx_descs[eqos.rx_desc_id]);
+	tegrabl_dma_unmap_buffer(TEGRABL_MODULE_EQOS, 0, (void *)rx_desc, DESCRIPTOR_SIZE, TEGRABL_DMA_FROM_DEVICE);
+
+	return (rx_desc->des3 & RDES3_OWN_DMA) == 0U;
+}
+
 bool tegrabl_eqos_is_dma_rx_intr_occured(void)
 {
 	uint32_t val;
@@ -0,0 +1,400 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ */
+
+#define MODULE TEGRABL_ERR_GPCDMA
+
+#include "build_config.h"
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <tegrabl_debug.h>
+#include <tegrabl_error.h>
+#include <tegrabl_utils.h>
+#include <tegrabl_timer.h>
+#include <tegrabl_gpcdma.h>
+#include <tegrabl_dma_copy.h>
+#include <tegrabl_gpcdma_err_aux.h>
+#include <tegrabl_background.h>
+
+/* Channel 0 is for secure OS only, channels 1 and 2 belong to QSPI */
+#define DMA_COPY_FIRST_CHANNEL		3U
+#define DMA_COPY_NUM_CHANNELS		4U
+#define DMA_COPY_MAX_SEGMENTS		32U
+#define DMA_COPY_MAX_FENCES			16U
+/* Smaller copies are not worth the cache maintenance */
+#define DMA_COPY_MIN_SIZE			SZ_64K
+/* DMA writes whole cache lines only, the CPU copies the partial ones */
+#define DMA_COPY_ALIGN				64UL
+/* Small enough that a later copy starts on the channels as they free up */
+#define DMA_COPY_MAX_SEGMENT_SIZE	(16UL * SZ_1M)
+/* A segment takes a few ms, a channel busy for longer than this is hung */
+#define DMA_COPY_TIMEOUT_US			(1000UL * 1000UL)
+/* An aborted channel stops once its current burst drains */
+#define DMA_COPY_ABORT_TIMEOUT_US	1000UL
+
+struct dma_copy_segment {
+	uintptr_t dst;
+	uintptr_t src;
+	uint32_t size;
+	tegrabl_dma_fence_t fence;
+};
+
+struct dma_copy_channel {
+	bool busy;
+	/* Did not stop when aborted, never used again */
+	bool hung;
+	time_t start_us;
+	tegrabl_dma_fence_t fence;
+	struct tegrabl_dma_xfer_params params;
+};
+
+static tegrabl_gpcdma_handle_t dma_copy_handle;
+static bool dma_copy_handle_requested;
+static struct dma_copy_channel dma_copy_channels[DMA_COPY_NUM_CHANNELS];
+static struct dma_copy_segment dma_copy_queue[DMA_COPY_MAX_SEGMENTS];
+static uint32_t dma_copy_queue_head;
+static uint32_t dma_copy_queue_count;
+/* Segments still outstanding per fence */
+static uint32_t dma_copy_pending[DMA_COPY_MAX_FENCES];
+/* Set if a segment of the fence ran on a channel that could not be stopped */
+static bool dma_copy_failed[DMA_COPY_MAX_FENCES];
+static uint32_t dma_copy_hung_channels;
+/* Last fence handed out, and the fence up to which all copies are done */
+static tegrabl_dma_fence_t dma_copy_last_fence;
+static tegrabl_dma_fence_t dma_copy_done_fence;
+
+static tegrabl_gpcdma_handle_t dma_copy_get_handle(void)
+{
+#if defined(CONFIG_ENABLE_DMA_COPY)
+	if (!dma_copy_handle_requested) {
+		dma_copy_handle_requested = true;
+		dma_copy_handle = tegrabl_dma_request(DMA_GPC);
+		if (dma_copy_handle == NULL) {
+			pr_warn("%s: GPCDMA unavailable, copying with the CPU\n", __func__);
+		}
+	}
+#endif
+
+	return dma_copy_handle;
+}
+
+static void dma_copy_advance(void)
+{
+	while ((dma_copy_done_fence != dma_copy_last_fence) &&
+		   (dma_copy_pending[(dma_copy_done_fence + 1U) % DMA_COPY_MAX_FENCES] == 0U)) {
+		dma_copy_done_fence++;
+	}
+}
+
+static void dma_copy_retire(tegrabl_dma_fence_t fence)
+{
+	dma_copy_pending[fence % DMA_COPY_MAX_FENCES]--;
+}
+
+static void dma_copy_start(uint32_t ch)
+{
+	struct dma_copy_channel *channel = &dma_copy_channels[ch];
+	struct dma_copy_segment *seg = &dma_copy_queue[dma_copy_queue_head];
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+
+	dma_copy_queue_head = (dma_copy_queue_head + 1U) % DMA_COPY_MAX_SEGMENTS;
+	dma_copy_queue_count--;
+
+	memset(&channel->params, 0, sizeof(channel->params));
+	channel->params.src = seg->src;
+	channel->params.dst = seg->dst;
+	channel->params.size = seg->size;
+	channel->params.is_async_xfer = true;
+	channel->params.dir = DMA_MEM_TO_MEM;
+	channel->fence = seg->fence;
+
+	err = tegrabl_dma_transfer(dma_copy_handle, (uint8_t)(DMA_COPY_FIRST_CHANNEL + ch), &channel->params);
+	if (err != TEGRABL_NO_ERROR) {
+		pr_warn("%s: channel %u failed (err 0x%08x), copying with the CPU\n", __func__,
+				DMA_COPY_FIRST_CHANNEL + ch, err);
+		memcpy((void *)seg->dst, (const void *)seg->src, seg->size);
+		dma_copy_retire(seg->fence);
+		return;
+	}
+
+	channel->start_us = tegrabl_get_timestamp_us();
+	channel->busy = true;
+}
+
+static tegrabl_error_t dma_copy_abort(uint32_t ch)
+{
+	struct dma_copy_channel *channel = &dma_copy_channels[ch];
+	uint8_t c_num = (uint8_t)(DMA_COPY_FIRST_CHANNEL + ch);
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+	time_t start_us;
+
+	pr_warn("%s: channel %u timed out, copying with the CPU\n", __func__, c_num);
+
+	tegrabl_dma_transfer_abort(dma_copy_handle, c_num);
+	start_us = tegrabl_get_timestamp_us();
+	while (tegrabl_dma_transfer_status(dma_copy_handle, c_num, &channel->params) != TEGRABL_NO_ERROR) {
+		if ((tegrabl_get_timestamp_us() - start_us) >= DMA_COPY_ABORT_TIMEOUT_US) {
+			err = TEGRABL_ERROR(TEGRABL_ERR_TIMEOUT, AUX_INFO_DMA_COPY_ABORT);
+			pr_error("%s: channel %u did not stop, not using it again\n", __func__, c_num);
+			return err;
+		}
+	}
+	memcpy((void *)channel->params.dst, (const void *)channel->params.src, channel->params.size);
+
+	return err;
+}
+
+static void dma_copy_poll(void)
+{
+	struct dma_copy_channel *channel;
+	struct dma_copy_segment *seg;
+	uint32_t ch;
+
+	for (ch = 0; ch < DMA_COPY_NUM_CHANNELS; ch++) {
+		channel = &dma_copy_channels[ch];
+		if (channel->busy) {
+			if (tegrabl_dma_transfer_status(dma_copy_handle, (uint8_t)(DMA_COPY_FIRST_CHANNEL + ch),
+											&channel->params) != TEGRABL_NO_ERROR) {
+				if ((tegrabl_get_timestamp_us() - channel->start_us) < DMA_COPY_TIMEOUT_US) {
+					continue;
+				}
+				if (dma_copy_abort(ch) != TEGRABL_NO_ERROR) {
+					channel->hung = true;
+					dma_copy_hung_channels++;
+					dma_copy_failed[channel->fence % DMA_COPY_MAX_FENCES] = true;
+				}
+			}
+			channel->busy = false;
+			dma_copy_retire(channel->fence);
+		}
+		if ((dma_copy_queue_count != 0U) && !channel->hung) {
+			dma_copy_start(ch);
+		}
+	}
+
+	/* No channel left to run the queue, let the CPU do it */
+	while ((dma_copy_hung_channels == DMA_COPY_NUM_CHANNELS) && (dma_copy_queue_count != 0U)) {
+		seg = &dma_copy_queue[dma_copy_queue_head];
+		memcpy((void *)seg->dst, (const void *)seg->src, seg->size);
+		dma_copy_queue_head = (dma_copy_queue_head + 1U) % DMA_COPY_MAX_SEGMENTS;
+		dma_copy_queue_count--;
+		dma_copy_retire(seg->fence);
+	}
+
+	dma_copy_advance();
+}
+
+static bool dma_copy_range_overlaps(uintptr_t a, size_t a_size, uintptr_t b, size_t b_size)
+{
+	return (a_size != 0UL) && (b_size != 0UL) && (a < (b + b_size)) && (b < (a + a_size));
+}
+
+/* The copy may not write what another copy reads or writes, nor read what it writes */
+static bool dma_copy_conflicts(const struct tegrabl_dma_copy_sg *sg, uintptr_t dst, uintptr_t src,
+							   size_t size)
+{
+	uintptr_t d = (uintptr_t)sg->dst;
+	uintptr_t s = (uintptr_t)sg->src;
+
+	return dma_copy_range_overlaps(d, sg->size, dst, size) ||
+		   dma_copy_range_overlaps(d, sg->size, src, size) ||
+		   dma_copy_range_overlaps(s, sg->size, dst, size);
+}
+
+static bool dma_copy_in_flight(const struct tegrabl_dma_copy_sg *sg)
+{
+	struct dma_copy_segment *seg;
+	struct dma_copy_channel *channel;
+	uint32_t i;
+
+	for (i = 0; i < dma_copy_queue_count; i++) {
+		seg = &dma_copy_queue[(dma_copy_queue_head + i) % DMA_COPY_MAX_SEGMENTS];
+		if (dma_copy_conflicts(sg, seg->dst, seg->src, seg->size)) {
+			return true;
+		}
+	}
+
+	for (i = 0; i < DMA_COPY_NUM_CHANNELS; i++) {
+		channel = &dma_copy_channels[i];
+		if (channel->busy &&
+			dma_copy_conflicts(sg, channel->params.dst, channel->params.src, channel->params.size)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void dma_copy_queue_segment(uintptr_t dst, uintptr_t src, uint32_t size,
+								   tegrabl_dma_fence_t fence)
+{
+	struct dma_copy_segment *seg;
+
+	while (dma_copy_queue_count == DMA_COPY_MAX_SEGMENTS) {
+		dma_copy_poll();
+	}
+
+	seg = &dma_copy_queue[(dma_copy_queue_head + dma_copy_queue_count) % DMA_COPY_MAX_SEGMENTS];
+	seg->dst = dst;
+	seg->src = src;
+	seg->size = size;
+	seg->fence = fence;
+	dma_copy_queue_count++;
+	dma_copy_pending[fence % DMA_COPY_MAX_FENCES]++;
+
+	dma_copy_poll();
+}
+
+static void dma_copy_add(void *dst, const void *src, size_t size, tegrabl_dma_fence_t fence)
+{
+	uintptr_t d = (uintptr_t)dst;
+	uintptr_t s = (uintptr_t)src;
+	size_t head;
+	size_t tail;
+	size_t mid;
+	size_t piece;
+	size_t len;
+
+	if ((dma_copy_handle == NULL) || (size < DMA_COPY_MIN_SIZE) ||
+		((d < (s + size)) && (s < (d + size))) || (((d - s) & 0x3UL) != 0UL)) {
+		memmove(dst, src, size);
+		return;
+	}
+
+	head = (DMA_COPY_ALIGN - (d & (DMA_COPY_ALIGN - 1UL))) & (DMA_COPY_ALIGN - 1UL);
+	tail = (d + size) & (DMA_COPY_ALIGN - 1UL);
+	mid = size - head - tail;
+
+	/* These lines are not touched by the DMA, so the CPU can fill them now */
+	memcpy(dst, src, head);
+	memcpy((void *)(d + size - tail), (const void *)(s + size - tail), tail);
+
+	/* Spread the copy over all channels */
+	piece = ROUND_UP(DIV_CEIL(mid, DMA_COPY_NUM_CHANNELS), DMA_COPY_ALIGN);
+	piece = MIN(piece, DMA_COPY_MAX_SEGMENT_SIZE);
+
+	d += head;
+	s += head;
+	while (mid != 0UL) {
+		len = MIN(piece, mid);
+		dma_copy_queue_segment(d, s, (uint32_t)len, fence);
+		d += len;
+		s += len;
+		mid -= len;
+	}
+}
+
+tegrabl_error_t tegrabl_dma_copy_submit(void *dst, const void *src, size_t size,
+										tegrabl_dma_fence_t *fence)
+{
+	struct tegrabl_dma_copy_sg sg;
+
+	sg.dst = dst;
+	sg.src = src;
+	sg.size = size;
+
+	return tegrabl_dma_copy_submit_sg(&sg, 1, fence);
+}
+
+tegrabl_error_t tegrabl_dma_copy_submit_sg(const struct tegrabl_dma_copy_sg *sg, uint32_t count,
+										   tegrabl_dma_fence_t *fence)
+{
+	tegrabl_dma_fence_t new_fence;
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+	uint32_t i;
+	uint32_t j;
+
+	if ((sg == NULL) && (count != 0U)) {
+		err = TEGRABL_ERROR(TEGRABL_ERR_BAD_PARAMETER, AUX_INFO_DMA_COPY_SUBMIT);
+		TEGRABL_SET_ERROR_STRING(err, "sg: %p", sg);
+		return err;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (((sg[i].dst == NULL) || (sg[i].src == NULL)) && (sg[i].size != 0UL)) {
+			err = TEGRABL_ERROR(TEGRABL_ERR_BAD_PARAMETER, AUX_INFO_DMA_COPY_SUBMIT);
+			TEGRABL_SET_ERROR_STRING(err, "dst: %p, src: %p", sg[i].dst, sg[i].src);
+			return err;
+		}
+	}
+
+	dma_copy_get_handle();
+	if (dma_copy_handle != NULL) {
+		dma_copy_poll();
+	}
+
+	/* Copies are reordered across channels, so none may depend on another in flight */
+	for (i = 0; i < count; i++) {
+		if (dma_copy_in_flight(&sg[i])) {
+			err = TEGRABL_ERROR(TEGRABL_ERR_BUSY, AUX_INFO_DMA_COPY_OVERLAP);
+			TEGRABL_SET_ERROR_STRING(err, "dst: %p, src: %p", sg[i].dst, sg[i].src);
+			return err;
+		}
+		for (j = 0; j < i; j++) {
+			if (dma_copy_conflicts(&sg[j], (uintptr_t)sg[i].dst, (uintptr_t)sg[i].src, sg[i].size)) {
+				err = TEGRABL_ERROR(TEGRABL_ERR_BAD_PARAMETER, AUX_INFO_DMA_COPY_OVERLAP);
+				TEGRABL_SET_ERROR_STRING(err, "dst: %p, src: %p", sg[i].dst, sg[i].src);
+				return err;
+			}
+		}
+	}
+
+	/* The pending count of the oldest fence slot must be free */
+	while ((dma_copy_last_fence - dma_copy_done_fence) >= (DMA_COPY_MAX_FENCES - 1U)) {
+		dma_copy_poll();
+	}
+
+	/* Not published until all segments are queued, so it cannot retire early */
+	new_fence = dma_copy_last_fence + 1U;
+	dma_copy_failed[new_fence % DMA_COPY_MAX_FENCES] = false;
+	for (i = 0; i < count; i++) {
+		dma_copy_add(sg[i].dst, sg[i].src, sg[i].size, new_fence);
+	}
+	dma_copy_last_fence = new_fence;
+	dma_copy_advance();
+
+	if (fence != NULL) {
+		*fence = new_fence;
+	}
+
+	return err;
+}
+
+bool tegrabl_dma_copy_is_done(tegrabl_dma_fence_t fence)
+{
+	if (dma_copy_handle != NULL) {
+		dma_copy_poll();
+	}
+
+	return fence <= dma_copy_done_fence;
+}
+
+tegrabl_error_t tegrabl_dma_copy_wait(tegrabl_dma_fence_t fence)
+{
+	tegrabl_error_t err;
+
+	if (fence > dma_copy_last_fence) {
+		err = TEGRABL_ERROR(TEGRABL_ERR_INVALID, AUX_INFO_DMA_COPY_WAIT);
+		TEGRABL_SET_ERROR_STRING(err, "fence %u", fence);
+		return err;
+	}
+
+	while (!tegrabl_dma_copy_is_done(fence)) {
+		tegrabl_background_yield();
+	}
+
+	if (dma_copy_failed[fence % DMA_COPY_MAX_FENCES]) {
+		err = TEGRABL_ERROR(TEGRABL_ERR_TIMEOUT, AUX_INFO_DMA_COPY_WAIT);
+		TEGRABL_SET_ERROR_STRING(err, "fence %u", fence);
+		return err;
+	}
+
+	return TEGRABL_NO_ERROR;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2018, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2015-2021, NVIDIA CORPORATION.  All rights reserved.
  *
  * NVIDIA CORPORATION and its licensors retain all intellectual property
  * and proprietary rights in and to this software, related documentation
@@ -397,7 +397,7 @@ tegrabl_error_t tegrabl_dma_transfer_status(tegrabl_gpcdma_handle_t handle,
 										   (DMA_CHANNEL_OFFSET * (c_num + 1UL));
 	if ((NV_READ32(cb + DMA_CH_STAT) & DMA_CH_STAT_BUSY) != 0UL) {
 		err = TEGRABL_ERROR(TEGRABL_ERR_BUSY, AUX_INFO_DMA_TRANSFER_STATUS);
-		pr_debug("DMA channel %u is busy\n", c_num);
+		pr_trace("DMA channel %u is busy\n", c_num);
 		return err;
 	} else {
 		tegrabl_unmap_buffers(params, dma_module_id);
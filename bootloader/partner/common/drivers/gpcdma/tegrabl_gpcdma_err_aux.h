@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2018-2021, NVIDIA CORPORATION.  All rights reserved.
  *
  * NVIDIA CORPORATION and its licensors retain all intellectual property
  * and proprietary rights in and to this software, related documentation
@@ -18,6 +18,10 @@
 #define AUX_INFO_DMA_TRANSFER_STATUS	0x3U
 #define AUX_INFO_INIT_SCRUB_DMA_1		0x4U
 #define AUX_INFO_INIT_SCRUB_DMA_2		0x5U
+#define AUX_INFO_DMA_COPY_SUBMIT		0x6U
+#define AUX_INFO_DMA_COPY_WAIT			0x7U
+#define AUX_INFO_DMA_COPY_OVERLAP		0x8U
+#define AUX_INFO_DMA_COPY_ABORT			0x9U
 
 #endif
 
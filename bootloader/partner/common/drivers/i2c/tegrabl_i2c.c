@@ -735,8 +735,8 @@ tegrabl_error_t tegrabl_i2c_transaction(struct tegrabl_i2c *hi2c,
 #endif
 
 
+	ptrans = trans;
 	for (i = 0; i < num_trans; i++) {
-		ptrans = trans;
 		if (ptrans->is_write == true) {
 			error = tegrabl_i2c_write(hi2c, ptrans->slave_addr,
 					 ptrans->is_repeat_start, ptrans->buf, ptrans->len);
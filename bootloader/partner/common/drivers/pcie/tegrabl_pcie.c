@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2020, NVIDIA CORPORATION.  All Rights Reserved.
+ * Copyright (c) 2019-2021, NVIDIA CORPORATION.  All Rights Reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property and
  * proprietary rights in and to this software and related documentation.  Any
@@ -17,6 +17,7 @@
 #define MODULE TEGRABL_ERR_PCIE
 
 #include <inttypes.h>
+#include <string.h>
 #include <tegrabl_pcie.h>
 #include <tegrabl_debug.h>
 #include <tegrabl_io.h>
@@ -24,6 +25,7 @@
 #include <tegrabl_timer.h>
 #include <tegrabl_utils.h>
 #include <tegrabl_malloc.h>
+#include <tegrabl_background.h>
 #include "tegrabl_pcie_soc_common.h"
 
 /**
@@ -246,6 +248,9 @@ static void pcie_bus_walk(struct tegrabl_pcie_bus *bus, void *pdata)
 	int ports = 0;
 	uint16_t g_vendor, g_device;
 
+	/* Drop devices found behind a previously enumerated controller */
+	memset(enumeration_data, 0, sizeof(enumeration_data));
+
 	for (busnr = 0UL; busnr <= 1UL; busnr++) {
 		/* TODO Need to extend it for multi device & function if required */
 		for (devfn = 0; devfn < 1; devfn++) {
@@ -297,11 +302,109 @@ static void pcie_bus_walk(struct tegrabl_pcie_bus *bus, void *pdata)
 	return;
 }
 
+/**
+ * @brief Powers up the Host PCIE controller and starts link training
+ *
+ * @param[in] ctrl_num Controller number which needs to be started
+ * @param[in] flags Specifies configuration information like link speed Etc.
+ *                  Bits[2:0] : Specify the link speed
+ *
+ * @return TEGRABL_NO_ERROR if successful, appropriate error otherwise
+ */
+tegrabl_error_t tegrabl_pcie_start(uint8_t ctrl_num, uint32_t flags)
+{
+	tegrabl_error_t error = TEGRABL_NO_ERROR;
+
+	/* Nothing to do if training is in progress or the link is up */
+	error = tegrabl_pcie_soc_host_poll(ctrl_num, NULL, NULL);
+	if ((error == TEGRABL_NO_ERROR) || (error == TEGRABL_ERR_BUSY)) {
+		return TEGRABL_NO_ERROR;
+	}
+
+	/* enable regulators for this PCIe controller */
+	error = tegrabl_pcie_enable_regulators(ctrl_num);
+	if (error != TEGRABL_NO_ERROR) {
+		pr_error("%s: failed to enable PCIe regulators; err=0x%x\n", __func__, error);
+		return error;
+	}
+
+	error = tegrabl_pcie_soc_host_start(ctrl_num, flags);
+	if (error != TEGRABL_NO_ERROR) {
+		pr_info("Failed to initialize SoC Host PCIe controller\n");
+		return error;
+	}
+
+	return error;
+}
+
+/**
+ * @brief Waits for the first of a list of started controllers to link up
+ *
+ * @param[in,out] ctrl_nums List of controller numbers terminated with -1.
+ *                          Returned controllers and the ones which failed
+ *                          to link up are removed from the list.
+ *
+ * @return Controller number whose link is up, -1 if none is left training
+ */
+int8_t tegrabl_pcie_wait_link_up(int8_t *ctrl_nums)
+{
+	tegrabl_error_t error;
+	bool training;
+	int8_t ctrl_num;
+	uint32_t i;
+	uint32_t j;
+
+	if (ctrl_nums == NULL) {
+		return -1;
+	}
+
+	do {
+		training = false;
+		i = 0;
+		while (ctrl_nums[i] >= 0) {
+			ctrl_num = ctrl_nums[i];
+			error = tegrabl_pcie_soc_host_poll((uint8_t)ctrl_num, NULL, NULL);
+			if (error == TEGRABL_ERR_BUSY) {
+				training = true;
+				i++;
+				continue;
+			}
+
+			for (j = i; ctrl_nums[j] >= 0; j++) {
+				ctrl_nums[j] = ctrl_nums[j + 1U];
+			}
+			if (error == TEGRABL_NO_ERROR) {
+				return ctrl_num;
+			}
+		}
+		if (training) {
+			tegrabl_background_yield();
+		}
+	} while (training);
+
+	return -1;
+}
+
+/**
+ * @brief Puts a controller started with tegrabl_pcie_start() back in reset
+ *
+ * @param[in] ctrl_num Controller number
+ */
+void tegrabl_pcie_stop(uint8_t ctrl_num)
+{
+	tegrabl_error_t error = tegrabl_pcie_soc_host_poll(ctrl_num, NULL, NULL);
+
+	/* Controllers that failed to link up are already in reset */
+	if ((error == TEGRABL_NO_ERROR) || (error == TEGRABL_ERR_BUSY)) {
+		tegrabl_pcie_reset_state(ctrl_num);
+	}
+}
+
 /**
  * @brief Performs initialization of the Host PCIE controller.
  *
  * Below are the steps performed by this API:
- * - Initialize Host controller
+ * - Initialize Host controller, unless tegrabl_pcie_start() already did
  * - Check for PCIe link up
  * - Enumerate connected device that includes
  * - Mapping of endpoint device's resouces into host system memory
@@ -322,16 +425,15 @@ tegrabl_error_t tegrabl_pcie_init(uint8_t ctrl_num, uint32_t flags)
 	struct tegrabl_pcie_bus *bus = NULL;
 	void *pdata = NULL;
 
-	/* enable regulators for this PCIe controller */
-	error = tegrabl_pcie_enable_regulators(ctrl_num);
+	error = tegrabl_pcie_start(ctrl_num, flags);
 	if (error != TEGRABL_NO_ERROR) {
-		pr_error("%s: failed to enable PCIe regulators; err=0x%x\n", __func__, error);
 		return error;
 	}
 
-	error = tegrabl_pcie_soc_host_init(ctrl_num, flags, &bus, &pdata);
+	do {
+		error = tegrabl_pcie_soc_host_poll(ctrl_num, &bus, &pdata);
+	} while (error == TEGRABL_ERR_BUSY);
 	if (error != TEGRABL_NO_ERROR) {
-		pr_info("Failed to initialize SoC Host PCIe controller\n");
 		return error;
 	}
 
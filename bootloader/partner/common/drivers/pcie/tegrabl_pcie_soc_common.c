@@ -97,6 +97,10 @@ static struct tegrabl_tegra_pcie tegra_pcie_info[PCIE_CTRL_MAX];
  * by each PCIe Host controller that exist in a given system
  */
 static struct tegrabl_pcie_bus tegra_pcie_bus[PCIE_CTRL_MAX];
+/**
+ * @brief Link state of each PCIe Host controller, one of PCIE_LINK_*
+ */
+static uint8_t tegra_pcie_link_state[PCIE_CTRL_MAX];
 
 /** Macro to fit bus number in Bus:Device:Function format */
 #define PCIE_ATU_BUS(x)		(((x) & 0xffUL) << 24U)
@@ -208,24 +212,57 @@ static void tegrabl_pcie_soc_conf_write(struct tegrabl_pcie_dev *pdev, int offse
 }
 
 /**
- * @brief Performs initialization of the Host PCIE controller.
+ * @brief Fills the host and bus structures of a controller whose link is up
+ *
+ * @param[in] ctrl_num Controller number
+ */
+static void pcie_soc_host_setup(uint8_t ctrl_num)
+{
+	uint32_t *dbi_reg_offset = tegrabl_pcie_get_dbi_reg();
+	uint32_t *iatu_dma_offset = tegrabl_pcie_get_iatu_reg();
+	uint32_t *pcie_io_base = tegrabl_pcie_get_io_base();
+	uint32_t *pcie_mem_base = tegrabl_pcie_get_mem_base();
+
+	/**
+	 * Store config base address in host structure to get it back
+	 * from PCIe subsystem during read/write config.
+	 * cfg0_base: Root port config base address which is same as DBI base
+	 * cfg0_size: Root port config size is 4 KB, however setting as side of 128 KB
+	 * cfg1_base: Endpoint config base address which is DBI base + 128 KB
+	 * cfg1_size: Endpoint config size is 4 KB per BDF, setting as side of 128 KB
+	 */
+	tegra_pcie_info[ctrl_num].ctrl_num = ctrl_num;
+	tegra_pcie_info[ctrl_num].cfg0_base = dbi_reg_offset[ctrl_num];
+	pr_info("tegra_pcie_info[%d].cfg0_base = 0x%08X\n", ctrl_num, tegra_pcie_info[ctrl_num].cfg0_base);
+	tegra_pcie_info[ctrl_num].cfg0_size = SZ_128K;
+	tegra_pcie_info[ctrl_num].cfg1_base = dbi_reg_offset[ctrl_num] + tegra_pcie_info[ctrl_num].cfg0_size;
+	pr_info("tegra_pcie_info[%d].cfg1_base = 0x%08X\n", ctrl_num, tegra_pcie_info[ctrl_num].cfg1_base);
+	tegra_pcie_info[ctrl_num].cfg1_size = SZ_128K;
+	tegra_pcie_info[ctrl_num].atu_dma_base = iatu_dma_offset[ctrl_num];
+	pr_info("tegra_pcie_info[%d].atu_dma_base = 0x%08X\n", ctrl_num, tegra_pcie_info[ctrl_num].atu_dma_base);
+
+	/** Populate PCIe bus structure */
+	tegra_pcie_bus[ctrl_num].read = tegrabl_pcie_soc_conf_read;
+	tegra_pcie_bus[ctrl_num].write = tegrabl_pcie_soc_conf_write;
+	tegra_pcie_bus[ctrl_num].io = pcie_io_base[ctrl_num];
+	tegra_pcie_bus[ctrl_num].io_size = PCIE_IO_SIZE;
+	tegra_pcie_bus[ctrl_num].mem = pcie_mem_base[ctrl_num];
+	pr_info("tegra_pcie_bus[%d].mem = 0x%08X\n", ctrl_num, tegra_pcie_bus[ctrl_num].mem);
+	tegra_pcie_bus[ctrl_num].mem_size = PCIE_MEM_SIZE;
+}
+
+/**
+ * @brief Initializes the Host PCIe controller and starts link training
  *
  * @param[in] ctrl_num Controller number which needs to be initialized
  * @param[in] flags Specifies configuration information like link speed Etc.
- * @param[out] bus Pointer to pointer of a PCIe bus structure
- * @param[out] pdata Pointer to PCIe private data structure
  *
  * @return TEGRABL_NO_ERROR if successful, appropriate error otherwise
  */
-tegrabl_error_t tegrabl_pcie_soc_host_init(uint8_t ctrl_num, uint32_t flags, struct tegrabl_pcie_bus **bus,
-										   void **pdata)
+tegrabl_error_t tegrabl_pcie_soc_host_start(uint8_t ctrl_num, uint32_t flags)
 {
 	tegrabl_error_t error = TEGRABL_NO_ERROR;
 	uint8_t link_speed;
-	uint32_t *dbi_reg_offset;
-	uint32_t *iatu_dma_offset;
-	uint32_t *pcie_io_base;
-	uint32_t *pcie_mem_base;
 
 	if (ctrl_num >= max_ctrl_supported) {
 		pr_error("Controller number is invalid\n");
@@ -239,60 +276,77 @@ tegrabl_error_t tegrabl_pcie_soc_host_init(uint8_t ctrl_num, uint32_t flags, str
 		return TEGRABL_ERR_NOT_SUPPORTED;
 	}
 
+	if ((tegrabl_pcie_get_dbi_reg() == NULL) || (tegrabl_pcie_get_iatu_reg() == NULL) ||
+		(tegrabl_pcie_get_io_base() == NULL) || (tegrabl_pcie_get_mem_base() == NULL)) {
+		return TEGRABL_ERR_INVALID;
+	}
+
 	error = tegrabl_pcie_soc_preinit(ctrl_num);
 	if (error != TEGRABL_NO_ERROR) {
 		pr_error("Failed tegrabl_pcie_soc_preinit(), error=0x%x\n", error);
 		return error;
 	}
 
-	dbi_reg_offset = tegrabl_pcie_get_dbi_reg();
-	iatu_dma_offset = tegrabl_pcie_get_iatu_reg();
-	pcie_io_base = tegrabl_pcie_get_io_base();
-	pcie_mem_base = tegrabl_pcie_get_mem_base();
-
-	if ((dbi_reg_offset == NULL) || (iatu_dma_offset == NULL) || (pcie_io_base == NULL) ||
-		(pcie_mem_base == NULL)) {
-		return TEGRABL_ERR_INVALID;
-	}
-
-	error = tegrabl_pcie_soc_init(ctrl_num, link_speed);
+	error = tegrabl_pcie_soc_start(ctrl_num, link_speed);
 	if (error != TEGRABL_NO_ERROR) {
-		pr_warn("Failed tegrabl_pcie_soc_init(), error=0x%x\n", error);
+		pr_warn("Failed tegrabl_pcie_soc_start(), error=0x%x\n", error);
 		return error;
 	}
 
-	/**
-	 * Store config base address in host structure to get it back
-	 * from PCIe subsystem during read/write config.
-	 * cfg0_base: Root port config base address which is same as DBI base
-	 * cfg0_size: Root port config size is 4 KB, however setting as side of 128 KB
-	 * cfg1_base: Endpoint config base address which is DBI base + 128 KB
-	 * cfg1_size: Endpoint config size is 4 KB per BDF, setting as side of 128 KB
-	 */
-	tegra_pcie_info[ctrl_num].ctrl_num = ctrl_num;
-	tegra_pcie_info[ctrl_num].cfg0_base = dbi_reg_offset[ctrl_num];
-	pr_info("tegra_pcie_info[%d].cfg0_base = 0x%08X\n", ctrl_num, tegra_pcie_info[ctrl_num].cfg0_base);
-	tegra_pcie_info[ctrl_num].cfg0_size = SZ_128K;
-	tegra_pcie_info[ctrl_num].cfg1_base = dbi_reg_offset[ctrl_num] + tegra_pcie_info[ctrl_num].cfg0_size;
-	pr_info("tegra_pcie_info[%d].cfg1_base = 0x%08X\n", ctrl_num, tegra_pcie_info[ctrl_num].cfg1_base);
-	tegra_pcie_info[ctrl_num].cfg1_size = SZ_128K;
-	tegra_pcie_info[ctrl_num].atu_dma_base = iatu_dma_offset[ctrl_num];
-	pr_info("tegra_pcie_info[%d].atu_dma_base = 0x%08X\n", ctrl_num, tegra_pcie_info[ctrl_num].atu_dma_base);
+	tegra_pcie_link_state[ctrl_num] = PCIE_LINK_TRAINING;
 
-	/** Populate PCIe bus structure */
-	tegra_pcie_bus[ctrl_num].read = tegrabl_pcie_soc_conf_read;
-	tegra_pcie_bus[ctrl_num].write = tegrabl_pcie_soc_conf_write;
-	tegra_pcie_bus[ctrl_num].io = pcie_io_base[ctrl_num];
-	tegra_pcie_bus[ctrl_num].io_size = PCIE_IO_SIZE;
-	tegra_pcie_bus[ctrl_num].mem = pcie_mem_base[ctrl_num];
-	pr_info("tegra_pcie_bus[%d].mem = 0x%08X\n", ctrl_num, tegra_pcie_bus[ctrl_num].mem);
-	tegra_pcie_bus[ctrl_num].mem_size = PCIE_MEM_SIZE;
+	return error;
+}
 
-	*bus = &tegra_pcie_bus[ctrl_num];
-	*pdata = (void *)&tegra_pcie_info[ctrl_num];
+/**
+ * @brief Advances link training of a controller and reports its state
+ *
+ * @param[in] ctrl_num Controller number
+ * @param[out] bus Pointer to pointer of a PCIe bus structure, can be NULL
+ * @param[out] pdata Pointer to PCIe private data structure, can be NULL
+ *
+ * @return TEGRABL_NO_ERROR if the link is up, TEGRABL_ERR_BUSY while it is
+ * training, appropriate error otherwise
+ */
+tegrabl_error_t tegrabl_pcie_soc_host_poll(uint8_t ctrl_num, struct tegrabl_pcie_bus **bus, void **pdata)
+{
+	tegrabl_error_t error;
 
-	if (*bus == NULL || *pdata == NULL) {
+	if (ctrl_num >= max_ctrl_supported) {
+		return TEGRABL_ERR_NOT_SUPPORTED;
+	}
+
+	if (tegra_pcie_link_state[ctrl_num] == PCIE_LINK_TRAINING) {
+		error = tegrabl_pcie_soc_poll(ctrl_num);
+		if (error == TEGRABL_NO_ERROR) {
+			pcie_soc_host_setup(ctrl_num);
+			tegra_pcie_link_state[ctrl_num] = PCIE_LINK_UP;
+		} else if (error != TEGRABL_ERR_BUSY) {
+			tegra_pcie_link_state[ctrl_num] = PCIE_LINK_FAILED;
+		} else {
+			/* Keep training */
+		}
+	}
+
+	switch (tegra_pcie_link_state[ctrl_num]) {
+	case PCIE_LINK_UP:
+		if (bus != NULL) {
+			*bus = &tegra_pcie_bus[ctrl_num];
+		}
+		if (pdata != NULL) {
+			*pdata = (void *)&tegra_pcie_info[ctrl_num];
+		}
+		error = TEGRABL_NO_ERROR;
+		break;
+	case PCIE_LINK_TRAINING:
+		error = TEGRABL_ERR_BUSY;
+		break;
+	case PCIE_LINK_FAILED:
 		error = TEGRABL_ERR_INIT_FAILED;
+		break;
+	default:
+		error = TEGRABL_ERR_NOT_INITIALIZED;
+		break;
 	}
 
 	return error;
@@ -309,6 +363,7 @@ tegrabl_error_t tegrabl_pcie_reset_state(uint8_t ctrl_num)
 	tegrabl_set_ctrl_state(ctrl_num, false);
 	tegrabl_pcie_soc_powergate(ctrl_num);
 	tegrabl_pcie_disable_regulators(ctrl_num);
+	tegra_pcie_link_state[ctrl_num] = PCIE_LINK_IDLE;
 
 	return TEGRABL_NO_ERROR;
 }
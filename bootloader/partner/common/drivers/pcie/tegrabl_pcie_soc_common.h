@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2020, NVIDIA CORPORATION.  All Rights Reserved.
+ * Copyright (c) 2019-2021, NVIDIA CORPORATION.  All Rights Reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property and
  * proprietary rights in and to this software and related documentation.  Any
@@ -21,18 +21,36 @@
 #include <tegrabl_pcie.h>
 #include <tegrabl_pcie_soc_local.h>
 
+/** Link states of a Host PCIe controller */
+#define PCIE_LINK_IDLE		0U
+#define PCIE_LINK_TRAINING	1U
+#define PCIE_LINK_UP		2U
+#define PCIE_LINK_FAILED	3U
+
 /**
- * @brief Performs initialization of the Host PCIe controller.
+ * @brief Initializes the Host PCIe controller and starts link training
+ * without waiting for the link to come up.
  *
  * @param[in] ctrl_num Controller number which needs to be initialized
  * @param[in] flags Specifies configuration information like link speed Etc.
- * @param[out] bus Pointer to pointer of a PCIe bus structure
- * @param[out] pdata Pointer to PCIe private data structure
  *
  * @return TEGRABL_NO_ERROR if successful, appropriate error otherwise
  */
-tegrabl_error_t tegrabl_pcie_soc_host_init(uint8_t ctrl_num, uint32_t flags, struct tegrabl_pcie_bus **bus,
-										   void **pdata);
+tegrabl_error_t tegrabl_pcie_soc_host_start(uint8_t ctrl_num, uint32_t flags);
+
+/**
+ * @brief Advances link training of the Host PCIe controller. Never blocks,
+ * callers poll all controllers they started in turn.
+ *
+ * @param[in] ctrl_num Controller number
+ * @param[out] bus Pointer to pointer of a PCIe bus structure, can be NULL
+ * @param[out] pdata Pointer to PCIe private data structure, can be NULL
+ *
+ * @return TEGRABL_NO_ERROR if the link is up and bus, pdata are set,
+ * TEGRABL_ERR_BUSY while the link is training, TEGRABL_ERR_INIT_FAILED if
+ * training timed out and TEGRABL_ERR_NOT_INITIALIZED if it was not started
+ */
+tegrabl_error_t tegrabl_pcie_soc_host_poll(uint8_t ctrl_num, struct tegrabl_pcie_bus **bus, void **pdata);
 
 /**
  * @brief API to disable PCIe host controller link with the endpoint
@@ -93,14 +93,28 @@ tegrabl_error_t tegrabl_power_on_phy(uint8_t ctrl_num);
 tegrabl_error_t tegrabl_pcie_soc_preinit(uint8_t ctrl_num);
 
 /**
- * @brief API to initialize a PCIe controller
+ * @brief API to initialize a PCIe controller and start link training.
+ * Returns without waiting for the link, see tegrabl_pcie_soc_poll().
  *
  * @ctrl_num - PCIe controller number to initialize
  * @link_speed - link speed
  *
  * @return TEGRABL_NO_ERROR if success, error-reason otherwise.
  */
-tegrabl_error_t tegrabl_pcie_soc_init(uint8_t ctrl_num, uint8_t link_speed);
+tegrabl_error_t tegrabl_pcie_soc_start(uint8_t ctrl_num, uint8_t link_speed);
+
+/**
+ * @brief API to advance link training of a PCIe controller started with
+ * tegrabl_pcie_soc_start(). Never blocks, so several controllers can train
+ * at the same time. The controller is put back in reset if the link fails.
+ *
+ * @ctrl_num - PCIe controller number to poll
+ *
+ * @return TEGRABL_NO_ERROR once the link is up, TEGRABL_ERR_BUSY while it
+ * is training, TEGRABL_ERR_INIT_FAILED if it timed out and
+ * TEGRABL_ERR_NOT_INITIALIZED if training was not started.
+ */
+tegrabl_error_t tegrabl_pcie_soc_poll(uint8_t ctrl_num);
 
 /**
  * @brief API to turn off PCIe PME
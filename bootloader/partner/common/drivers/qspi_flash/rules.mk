@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2017-2018, NVIDIA CORPORATION.  All rights reserved.
+# Copyright (c) 2017-2021, NVIDIA CORPORATION.  All rights reserved.
 #
 # NVIDIA CORPORATION and its licensors retain all intellectual property
 # and proprietary rights in and to this software, related documentation
@@ -20,6 +20,7 @@ GLOBAL_INCLUDES += \
 
 MODULE_SRCS += \
 	$(LOCAL_DIR)/tegrabl_qspi_flash.c \
+	$(LOCAL_DIR)/tegrabl_qspi_flash_erase_plan.c \
 	$(LOCAL_DIR)/micron/tegrabl_qspi_flash_micron.c \
 	$(LOCAL_DIR)/spansion/tegrabl_qspi_flash_spansion.c \
 	$(LOCAL_DIR)/macronix/tegrabl_qspi_flash_macronix.c
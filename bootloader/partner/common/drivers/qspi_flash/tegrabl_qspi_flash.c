@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2020, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2015-2021, NVIDIA CORPORATION.  All rights reserved.
  *
  * NVIDIA CORPORATION and its licensors retain all intellectual property
  * and proprietary rights in and to this software, related documentation
@@ -22,6 +22,7 @@
 #include <tegrabl_qspi.h>
 #include <tegrabl_qspi_flash.h>
 #include <tegrabl_qspi_flash_private.h>
+#include <tegrabl_qspi_flash_erase_plan.h>
 #include <tegrabl_qspi_flash_spansion.h>
 #include <tegrabl_qspi_flash_macronix.h>
 #include <tegrabl_qspi_flash_micron.h>
@@ -37,9 +38,9 @@ static struct device_info device_info_list[] = {
 	{"Spansion 64MB", 0x01, 0x02, 0x20, 0x12/* 256KB */, 0x0c/* 4KB */, 8,
 				FLAG_DDR | FLAG_QPI | FLAG_BULK | FLAG_PAGE512},
 	{"Micron 16MB", 0x20, 0xBB, 0x18, 0x10/* 64KB */, 0x0c/* 4KB */, 0,
-				FLAG_QPI | FLAG_BULK},
+				FLAG_QPI | FLAG_BULK | FLAG_UNIFORM},
 	{"Macronix 64MB", 0xC2, 0x95, 0x3A, 0x10/* 64KB */, 0x0c/* 4KB */, 0,
-				FLAG_DDR | FLAG_QPI | FLAG_BULK}
+				FLAG_DDR | FLAG_QPI | FLAG_BULK | FLAG_UNIFORM}
 };
 
 static struct tegrabl_qspi_flash_driver_info *qspi_flash_driver_info[QSPI_MAX_INSTANCE];
@@ -70,14 +71,18 @@ static tegrabl_error_t read_device_id_info(
 static tegrabl_error_t qspi_bdev_ioctl(
 		struct tegrabl_bdev *dev, uint32_t ioctl, void *argp)
 {
-	TEGRABL_UNUSED(dev);
-	TEGRABL_UNUSED(argp);
+	struct tegrabl_qspi_flash_driver_info *hqfdi = dev->priv_data;
 
 #if !defined(CONFIG_ENABLE_BLOCKDEV_BASIC)
 	if (ioctl == TEGRABL_IOCTL_DEVICE_CACHE_FLUSH) {
 		return TEGRABL_NO_ERROR;
 	}
 #endif
+	/* Largest erase unit, smaller erases save and restore the rest of it */
+	if (ioctl == TEGRABL_IOCTL_ERASE_SIZE) {
+		*(uint32_t *)argp = 1UL << hqfdi->chip_info.sector_size_log2;
+		return TEGRABL_NO_ERROR;
+	}
 	pr_debug("Unknown ioctl %"PRIu32"\n", ioctl);
 	return TEGRABL_ERROR(TEGRABL_ERR_NOT_SUPPORTED, AUX_INFO_IOCTL_NOT_SUPPORTED);
 }
@@ -641,6 +646,11 @@ tegrabl_error_t qspi_write_en(
 			return TEGRABL_ERROR(TEGRABL_ERR_TIMEOUT, AUX_INFO_WEN_TIMEOUT);
 		}
 
+		/* WEL is updated when the command ends, wait only if it was missed */
+		if (tried != 0U) {
+			tegrabl_udelay(QSPI_FLASH_WRITE_ENABLE_WAIT_TIME);
+		}
+
 		if (benable) {
 			command = QSPI_FLASH_CMD_WREN;
 			comp = QSPI_FLASH_WEL_ENABLE;
@@ -666,7 +676,6 @@ tegrabl_error_t qspi_write_en(
 			return err;
 		}
 
-		tegrabl_udelay(QSPI_FLASH_WRITE_ENABLE_WAIT_TIME);
 		err = qspi_read_reg(hqfdi, QSPI_FLASH_CMD_RDSR1, &reg_val);
 		if (err != TEGRABL_NO_ERROR) {
 			pr_error("QSPI-WriteEN: read RDSR1 cmd fail (err:0x%x)\n", err);
@@ -766,16 +775,9 @@ exit:
 	return TEGRABL_NO_ERROR;
 }
 
-#define block_num_to_sector_num(blk)		\
-		DIV_FLOOR_LOG2(((blk) << chip_info->block_size_log2), \
-					   chip_info->sector_size_log2)
-
-#define block_cnt_to_sector_cnt(cnt)		\
-		DIV_CEIL_LOG2(((cnt) << chip_info->block_size_log2), \
-					  chip_info->sector_size_log2)
-
 /**
- * @brief Initiate the paramter sector erase command.
+ * @brief Initiate the paramter sector erase command. On FLAG_UNIFORM parts
+ * it erases 4KB sub-sectors anywhere in the flash.
  *
  * @param start_parameter_sector_num Sector Number to do Erase
  * @param num_of_parameter_sectors  Number of parameter sectors
@@ -798,6 +800,7 @@ tegrabl_qspi_flash_parameter_sector_erase(
 	tegrabl_error_t err = TEGRABL_NO_ERROR;
 	uint8_t address_data[4];
 	uint32_t num_of_sectors_to_erase = num_of_parameter_sectors;
+	uint32_t parameter_sector_count = chip_info->parameter_sector_count;
 	uint32_t address;
 	uint8_t *cmd = hqfdi->cmd;
 
@@ -809,19 +812,25 @@ tegrabl_qspi_flash_parameter_sector_erase(
 		*cmd = QSPI_FLASH_CMD_PARA_SECTOR_ERASE;
 	}
 
-	if (start_parameter_sector_num > chip_info->parameter_sector_count) {
+	/* Uniform parts take the 4KB erase anywhere */
+	if ((device_info_list[chip_info->device_list_index].flag & FLAG_UNIFORM) != 0U) {
+		parameter_sector_count = 1UL << (chip_info->flash_size_log2 -
+										 chip_info->parameter_sector_size_log2);
+	}
+
+	if (start_parameter_sector_num > parameter_sector_count) {
 		pr_error("Qspi param sector erase: Incorrect sector number: %u\n", start_parameter_sector_num);
 		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, AUX_INFO_INVALID_PARAMS2);
 	}
 
 	if ((num_of_parameter_sectors == 0UL) ||
-		(num_of_parameter_sectors > chip_info->parameter_sector_count)) {
+		(num_of_parameter_sectors > parameter_sector_count)) {
 		pr_error("Qspi param sector erase: Incorrect number of sectors: %u\n", num_of_parameter_sectors);
 		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, AUX_INFO_INVALID_PARAMS3);
 	}
 
 	if ((start_parameter_sector_num + num_of_parameter_sectors) >
-			chip_info->parameter_sector_count) {
+			parameter_sector_count) {
 		pr_error("Qspi param sector erase: Exceed total sector count\n");
 		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, AUX_INFO_INVALID_PARAMS4);
 	}
@@ -1093,19 +1102,105 @@ tegrabl_qspi_flash_bulk_erase(struct tegrabl_qspi_flash_driver_info *hqfdi)
 	return err;
 }
 
+static bool qspi_is_erased(const uint8_t *buf, uint32_t size)
+{
+	uint32_t i;
+
+	for (i = 0; i < size; i++) {
+		if (buf[i] != 0xFFU) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * @brief Erase [start, end) within one erase unit, keeping the rest of the
+ * unit. The unit is read first; nothing is erased if the range already reads
+ * back erased, and only non-blank data outside the range is written back.
+ *
+ * @param dev block device
+ * @param buf buffer of a sector, NULL if none could be allocated
+ * @param unit start of the unit in bytes
+ * @param unit_size size of the unit, a sector or a 4KB sub-sector
+ * @param start start of the range to erase, block aligned
+ * @param end end of the range to erase, block aligned
+ *
+ * @return TEGRABL_NO_ERROR if successful else appropriate error
+ */
+static tegrabl_error_t qspi_erase_unit(tegrabl_bdev_t *dev, uint8_t *buf,
+	uint32_t unit, uint32_t unit_size, uint32_t start, uint32_t end)
+{
+	struct tegrabl_qspi_flash_driver_info *hqfdi = dev->priv_data;
+	struct tegrabl_qspi_flash_chip_info *chip_info = &hqfdi->chip_info;
+	uint32_t log2 = chip_info->block_size_log2;
+	uint32_t unit_end = unit + unit_size;
+	tegrabl_error_t error = TEGRABL_NO_ERROR;
+
+	if (buf != NULL) {
+		error = qspi_bdev_read_block(dev, buf, unit >> log2, unit_size >> log2);
+		if (error != TEGRABL_NO_ERROR) {
+			return error;
+		}
+		if (qspi_is_erased(buf + (start - unit), end - start)) {
+			pr_trace("QSPI: 0x%x - 0x%x already erased\n", start, end);
+			return TEGRABL_NO_ERROR;
+		}
+	} else if ((start != unit) || (end != unit_end)) {
+		return TEGRABL_ERROR(TEGRABL_ERR_NO_MEMORY, AUX_INFO_NO_MEMORY_1);
+	} else {
+		/* No room to blank check, erase it anyway */
+	}
+
+	if (unit_size == (1UL << chip_info->parameter_sector_size_log2)) {
+		error = tegrabl_qspi_flash_parameter_sector_erase(hqfdi,
+				unit >> chip_info->parameter_sector_size_log2, 1, 0);
+	} else {
+		/* Parameter sectors overlay sector 0 and are erased separately */
+		if ((unit == 0UL) && (chip_info->parameter_sector_count != 0UL)) {
+			error = tegrabl_qspi_flash_parameter_sector_erase(hqfdi, 0,
+					chip_info->parameter_sector_count, 0);
+			if (error != TEGRABL_NO_ERROR) {
+				return error;
+			}
+		}
+		error = tegrabl_qspi_flash_sector_erase(hqfdi,
+				unit >> chip_info->sector_size_log2, 1);
+	}
+	if (error != TEGRABL_NO_ERROR) {
+		return error;
+	}
+
+	if ((start != unit) && !qspi_is_erased(buf, start - unit)) {
+		error = qspi_bdev_write_block(dev, buf, unit >> log2, (start - unit) >> log2);
+		if (error != TEGRABL_NO_ERROR) {
+			return error;
+		}
+	}
+	if ((end != unit_end) && !qspi_is_erased(buf + (end - unit), unit_end - end)) {
+		error = qspi_bdev_write_block(dev, buf + (end - unit), end >> log2,
+				(unit_end - end) >> log2);
+	}
+
+	return error;
+}
+
 static tegrabl_error_t qspi_bdev_erase(tegrabl_bdev_t *dev, bnum_t block,
 	bnum_t count, bool is_secure)
 {
 	tegrabl_error_t error = TEGRABL_NO_ERROR;
 	struct tegrabl_qspi_flash_driver_info *hqfdi;
 	struct tegrabl_qspi_flash_chip_info *chip_info;
-	uint32_t sector_num = 0;
-	uint32_t sector_cnt = 0;
-	uint8_t *head_backup = NULL;
-	uint8_t *tail_backup = NULL;
-	bnum_t head_start, head_count;
-	bnum_t tail_start, tail_count;
+	uint8_t *buf = NULL;
 	uint8_t device_info_flag;
+	uint32_t sector_size;
+	uint32_t small_size;
+	uint32_t param_end;
+	uint32_t offset;
+	uint32_t end;
+	struct qspi_erase_plan plan;
+	struct qspi_erase_unit unit;
 
 	TEGRABL_UNUSED(is_secure);
 
@@ -1125,99 +1220,66 @@ static tegrabl_error_t qspi_bdev_erase(tegrabl_bdev_t *dev, bnum_t block,
 		return error;
 	}
 
-	head_count = tail_count = 0;
-	head_start = tail_start = 0;
-	sector_num = block_num_to_sector_num(block);
-	sector_cnt = block_cnt_to_sector_cnt(count);
-
-	pr_trace("QSPI: erasing sectors from %u - %u\n", sector_num, (sector_cnt - 1) + sector_num);
-
-	if (count != chip_info->block_count) {
-		/* Need to preserve the partitions that are overlapping */
-		/* on the sector which needs to be erased.              */
-		/* head : former overlapping partition                  */
-		/* tail : latter overlapping partition                  */
-#define PAGES_IN_SECTOR_LOG2 \
-	(chip_info->sector_size_log2 - chip_info->block_size_log2)
-		head_start = sector_num << PAGES_IN_SECTOR_LOG2;
-		head_count = block & ((1UL << PAGES_IN_SECTOR_LOG2) - 1UL);
-		tail_start = block + count;
-		sector_cnt = tail_start + ((1UL << PAGES_IN_SECTOR_LOG2) - 1UL);
-		sector_cnt = block_num_to_sector_num(sector_cnt);
-		tail_count = (sector_cnt << PAGES_IN_SECTOR_LOG2) - tail_start;
-		sector_cnt -= sector_num;
-#undef PAGES_IN_SECTOR_LOG2
-
-		pr_info("QSPI: erasing sectors from %u - %u\n",
-				sector_num, sector_cnt - 1U + sector_num);
-
-		if (head_count != 0UL) {
-			pr_info("QSPI: recoverying head blocks from %u - %u\n",
-					head_start, head_start + head_count);
-			head_backup = tegrabl_calloc(1,
-					head_count << chip_info->block_size_log2);
-			if (head_backup == NULL) {
-				error = TEGRABL_ERROR(
-					TEGRABL_ERR_NO_MEMORY, AUX_INFO_NO_MEMORY_1);
-				goto fail;
-			}
-			error = qspi_bdev_read_block(dev,
-					(void *)head_backup, head_start, head_count);
-			if (error != TEGRABL_NO_ERROR) {
-				goto fail;
-			}
-		}
-		if (tail_count != 0UL) {
-			pr_info("QSPI: recoverying tail blocks from %u - %u\n",
-					tail_start, tail_start + tail_count);
-			tail_backup = tegrabl_calloc(1,
-					tail_count << chip_info->block_size_log2);
-			if (tail_backup == NULL) {
-				error = TEGRABL_ERROR(
-					TEGRABL_ERR_NO_MEMORY, AUX_INFO_NO_MEMORY_2);
-				goto fail;
-			}
-			error = qspi_bdev_read_block(dev,
-					(void *)tail_backup, tail_start, tail_count);
-			if (error != TEGRABL_NO_ERROR) {
-				goto fail;
-			}
-		}
+	sector_size = 1UL << chip_info->sector_size_log2;
+	small_size = 1UL << chip_info->parameter_sector_size_log2;
+	param_end = chip_info->parameter_sector_count << chip_info->parameter_sector_size_log2;
+	offset = block << chip_info->block_size_log2;
+	end = (block + count) << chip_info->block_size_log2;
+
+	pr_trace("QSPI: erasing 0x%x - 0x%x\n", offset, end);
+
+	/* Used to blank check each unit and to keep data around the range */
+	buf = tegrabl_malloc(sector_size);
+	if (buf == NULL) {
+		pr_warn("QSPI: no memory for blank check\n");
 	}
 
-	/* handling sector-0 erase differently */
-	if (sector_num == 0UL) {
-		tegrabl_qspi_flash_parameter_sector_erase(hqfdi, 0, 8, 0);
+	qspi_erase_plan_init(&plan, offset, end, sector_size, small_size, param_end,
+						 (device_info_flag & FLAG_UNIFORM) != 0U);
+	while ((error == TEGRABL_NO_ERROR) && qspi_erase_plan_next(&plan, &unit)) {
+		error = qspi_erase_unit(dev, buf, unit.unit, unit.unit_size, unit.start, unit.end);
 	}
-	error = tegrabl_qspi_flash_sector_erase(hqfdi, sector_num,
-											sector_cnt);
-	if (error != TEGRABL_NO_ERROR) {
-		goto fail;
+
+	if (buf != NULL) {
+		tegrabl_free(buf);
 	}
-	if (head_count != 0UL) {
-		error = qspi_bdev_write_block(dev,
-			(void *)head_backup, head_start, head_count);
-		if (error != TEGRABL_NO_ERROR) {
-			goto fail;
+
+	return error;
+}
+
+/**
+ * @brief Wait for a page program to finish
+ *
+ * @param hqfdi driver info of the flash
+ *
+ * @return TEGRABL_NO_ERROR once the flash is ready, error on timeout
+ */
+static tegrabl_error_t qspi_program_wait(struct tegrabl_qspi_flash_driver_info *hqfdi)
+{
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+	uint32_t tried;
+	uint8_t reg_val;
+
+	for (tried = 0; tried < QSPI_FLASH_PROGRAM_POLL_COUNT; tried++) {
+		err = qspi_read_reg(hqfdi, QSPI_FLASH_CMD_RDSR1, &reg_val);
+		if (err != TEGRABL_NO_ERROR) {
+			pr_error("Read RDSR1 cmd fail (err:0x%x)\n", err);
+			return err;
 		}
-	}
-	if (tail_count != 0UL) {
-		error = qspi_bdev_write_block(dev,
-			(void *)tail_backup, tail_start, tail_count);
-	}
-fail:
-	if (head_backup != NULL) {
-		tegrabl_free(head_backup);
-	}
-	if (tail_backup != NULL) {
-		tegrabl_free(tail_backup);
+		if ((reg_val & (uint8_t) QSPI_FLASH_WIP_FIELD) == (uint8_t) QSPI_FLASH_WIP_DISABLE) {
+			return TEGRABL_NO_ERROR;
+		}
+		tegrabl_udelay(QSPI_FLASH_PROGRAM_POLL_TIME);
 	}
 
-	return error;
+	pr_error("QSPI Flash: page program timeout\n");
+	return TEGRABL_ERROR(TEGRABL_ERR_TIMEOUT, AUX_INFO_WIP_TIMEOUT);
 }
 
 /**
  * @brief Initiate the writing of multiple pages of data from buffer.
+ * The next page is prepared while the previous one programs, and pages that
+ * are all 0xFF are skipped since programming cannot set bits.
  *
  * @param start_page_num Start page number for which data has to be written
  * @param num_of_pages Number of pages to be written
@@ -1235,13 +1297,16 @@ tegrabl_qspi_flash_write(
 	struct tegrabl_qspi_flash_chip_info *chip_info = &hqfdi->chip_info;
 	struct tegrabl_qspi_transfer *transfers;
 	tegrabl_error_t err = TEGRABL_NO_ERROR;
+	tegrabl_error_t wait_err = TEGRABL_NO_ERROR;
+	tegrabl_error_t qpi_err = TEGRABL_NO_ERROR;
 	uint8_t cmd_address_info[5];
 	uint32_t bytes_to_write;
+	uint32_t write_len;
 	uint32_t address;
 	uint8_t *p_source = (uint8_t *)p_source_buffer;
+	bool is_programming = false;
 
 	transfers = hqfdi->transfers;
-	memset(transfers, 0, 2U*(sizeof(struct tegrabl_qspi_transfer)));
 
 	/* Use combined command address buffer */
 	if (chip_info->address_length == 4UL) {
@@ -1253,6 +1318,11 @@ tegrabl_qspi_flash_write(
 		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, AUX_INFO_INVALID_PARAMS7);
 	}
 
+	/* Make sure the Dest is 4-byte aligned */
+	if (((uintptr_t)p_source & 0x3U) != 0U) {
+		return TEGRABL_ERROR(TEGRABL_ERR_BAD_ADDRESS, AUX_INFO_NOT_ALIGNED);
+	}
+
 	/* Setup QPI mode based on device info list */
 	/* Switch to X1 if QPI setup fails */
 	err = qspi_qpi_flag_set(hqfdi, true);
@@ -1269,91 +1339,97 @@ tegrabl_qspi_flash_write(
 			 start_page_num, num_of_pages, p_source_buffer);
 
 	while (bytes_to_write != 0UL) {
-		pr_trace("Sector write addr 0x%x\n", address);
-		/* Enable Write */
-		err = qspi_write_en(hqfdi, true);
-		if (err != TEGRABL_NO_ERROR) {
-			return err;
-		}
+		write_len = MIN(bytes_to_write, chip_info->page_write_size);
+
+		/* Everything up to the WIP wait overlaps the previous program */
+		if (!qspi_is_erased(p_source, write_len)) {
+			pr_trace("Sector write addr 0x%x\n", address);
+
+			/* address are sent to device with MSB first */
+			/* Command and address are combined to save transaction time */
+			if (chip_info->address_length == 4UL) {
+				cmd_address_info[1] = (uint8_t)(uint32_t)((address >> 24) & 0xFFU);
+				cmd_address_info[2] = (uint8_t)(uint32_t)((address >> 16) & 0xFFU);
+				cmd_address_info[3] = (uint8_t)(uint32_t)((address >> 8) & 0xFFU);
+				cmd_address_info[4] = (uint8_t)(uint32_t)((address) & 0xFFU);
+			} else {
+				cmd_address_info[1] = (uint8_t)(uint32_t)((address >> 16) & 0xFFU);
+				cmd_address_info[2] = (uint8_t)(uint32_t)((address >> 8) & 0xFFU);
+				cmd_address_info[3] = (uint8_t)(uint32_t)((address) & 0xFFU);
+			}
 
-		/* address are sent to device with MSB first */
-		/* Command and address are combined to save transaction time */
-		if (chip_info->address_length == 4UL) {
-			cmd_address_info[1] = (uint8_t)(uint32_t)((address >> 24) & 0xFFU);
-			cmd_address_info[2] = (uint8_t)(uint32_t)((address >> 16) & 0xFFU);
-			cmd_address_info[3] = (uint8_t)(uint32_t)((address >> 8) & 0xFFU);
-			cmd_address_info[4] = (uint8_t)(uint32_t)((address) & 0xFFU);
-		} else {
-			cmd_address_info[1] = (uint8_t)(uint32_t)((address >> 16) & 0xFFU);
-			cmd_address_info[2] = (uint8_t)(uint32_t)((address >> 8) & 0xFFU);
-			cmd_address_info[3] = (uint8_t)(uint32_t)((address) & 0xFFU);
-		}
+			if (is_programming) {
+				err = qspi_program_wait(hqfdi);
+				if (err != TEGRABL_NO_ERROR) {
+					break;
+				}
+				is_programming = false;
+			}
 
-		/* Make sure the Dest is 4-byte aligned */
-		if (((uintptr_t)p_source & 0x3U) != 0U) {
-			return TEGRABL_ERROR(TEGRABL_ERR_BAD_ADDRESS, AUX_INFO_NOT_ALIGNED);
-		}
+			/* Enable Write */
+			err = qspi_write_en(hqfdi, true);
+			if (err != TEGRABL_NO_ERROR) {
+				break;
+			}
 
-		/* Set command and address Parameters in First Transfer */
-		/* address width depends on whether QPI mode is enabled */
-		/* Set Read length is 0 for address */
+			/* Register accesses above reuse the transfers, fill them last */
+			memset(transfers, 0, 2U*(sizeof(struct tegrabl_qspi_transfer)));
 
-		transfers[0].tx_buf = cmd_address_info;
-		transfers[0].rx_buf = NULL;
-		transfers[0].write_len = chip_info->address_length + 1UL;
-		transfers[0].read_len = 0;
-		transfers[0].mode = QSPI_FLASH_CMD_MODE_VAL;
-		transfers[0].bus_width = chip_info->qpi_bus_width;
-		transfers[0].dummy_cycles = ZERO_CYCLES;
-		transfers[0].op_mode = SDR_MODE;
+			/* Set command and address Parameters in First Transfer */
+			/* address width depends on whether QPI mode is enabled */
+			/* Set Read length is 0 for address */
 
-		/* Set WriteData Parameters in Second Transfer */
+			transfers[0].tx_buf = cmd_address_info;
+			transfers[0].rx_buf = NULL;
+			transfers[0].write_len = chip_info->address_length + 1UL;
+			transfers[0].read_len = 0;
+			transfers[0].mode = QSPI_FLASH_CMD_MODE_VAL;
+			transfers[0].bus_width = chip_info->qpi_bus_width;
+			transfers[0].dummy_cycles = ZERO_CYCLES;
+			transfers[0].op_mode = SDR_MODE;
 
-		transfers[1].tx_buf = p_source;
-		transfers[1].rx_buf = NULL;
-		transfers[1].write_len =
-			MIN(bytes_to_write, chip_info->page_write_size);
-		transfers[1].read_len = 0;
-		transfers[1].mode = QSPI_FLASH_ADDR_DATA_MODE_VAL;
-		transfers[1].bus_width = chip_info->qpi_bus_width;
-		transfers[1].dummy_cycles = ZERO_CYCLES;
-		transfers[1].op_mode = SDR_MODE;
+			/* Set WriteData Parameters in Second Transfer */
 
-		err = tegrabl_qspi_transaction(hqfdi->hqspi, &transfers[0], 2,
-									   QSPI_XFER_TIMEOUT);
+			transfers[1].tx_buf = p_source;
+			transfers[1].rx_buf = NULL;
+			transfers[1].write_len = write_len;
+			transfers[1].read_len = 0;
+			transfers[1].mode = QSPI_FLASH_ADDR_DATA_MODE_VAL;
+			transfers[1].bus_width = chip_info->qpi_bus_width;
+			transfers[1].dummy_cycles = ZERO_CYCLES;
+			transfers[1].op_mode = SDR_MODE;
 
-		if (err != TEGRABL_NO_ERROR) {
-			pr_error("QSPI Flash Write failed: x%x\n", err);
-			pr_trace("address = 0x%x\n", address);
-			/* Disable Write En bit */
-			err = qspi_write_en(hqfdi, false);
+			err = tegrabl_qspi_transaction(hqfdi->hqspi, &transfers[0], 2,
+										   QSPI_XFER_TIMEOUT);
 			if (err != TEGRABL_NO_ERROR) {
-				return err;
+				pr_error("QSPI Flash Write failed: x%x\n", err);
+				pr_trace("address = 0x%x\n", address);
+				/* Disable Write En bit */
+				(void)qspi_write_en(hqfdi, false);
+				break;
 			}
-
-			break;
+			is_programming = true;
 		}
 
-		if (bytes_to_write > chip_info->page_write_size) {
-			bytes_to_write -= chip_info->page_write_size;
-			address += chip_info->page_write_size;
-			p_source += chip_info->page_write_size;
-		} else {
-			bytes_to_write = 0;
-		}
+		bytes_to_write -= write_len;
+		address += write_len;
+		p_source += write_len;
+	}
 
-		qspi_writein_progress(hqfdi, QSPI_FLASH_WIP_WAIT_FOR_READY,
-					QSPI_FLASH_WIP_WAIT_IN_US);
+	/* Let the last page finish even after an error */
+	if (is_programming) {
+		wait_err = qspi_program_wait(hqfdi);
+		err = (err != TEGRABL_NO_ERROR) ? err : wait_err;
 	}
 
 	/* Switch to X1 mode */
-	err = qspi_qpi_flag_set(hqfdi, false);
-	if (err != TEGRABL_NO_ERROR) {
-		pr_error("QPI disable failed err(:0x%x)\n", err);
-		return err;
+	qpi_err = qspi_qpi_flag_set(hqfdi, false);
+	if (qpi_err != TEGRABL_NO_ERROR) {
+		pr_error("QPI disable failed err(:0x%x)\n", qpi_err);
+		return qpi_err;
 	}
 
-	return TEGRABL_NO_ERROR;
+	return err;
 }
 
 static tegrabl_error_t qspi_bdev_write_block(tegrabl_bdev_t *dev,
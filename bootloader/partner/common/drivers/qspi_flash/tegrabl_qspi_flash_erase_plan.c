@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ */
+
+#include "build_config.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <tegrabl_utils.h>
+#include <tegrabl_qspi_flash_erase_plan.h>
+
+void qspi_erase_plan_init(struct qspi_erase_plan *plan, uint32_t offset, uint32_t end,
+						  uint32_t sector_size, uint32_t small_size, uint32_t param_end,
+						  bool uniform)
+{
+	plan->offset = offset;
+	plan->end = end;
+	plan->sector_size = sector_size;
+	plan->small_size = small_size;
+	plan->param_end = param_end;
+	plan->uniform = uniform;
+	plan->small = 0;
+	plan->small_end = 0;
+	plan->piece_end = 0;
+}
+
+bool qspi_erase_plan_next(struct qspi_erase_plan *plan, struct qspi_erase_unit *unit)
+{
+	uint32_t sector;
+	uint32_t small;
+	uint32_t small_end;
+	uint32_t piece_end;
+
+	if (plan->small >= plan->small_end) {
+		if (plan->offset >= plan->end) {
+			return false;
+		}
+
+		sector = plan->offset & ~(plan->sector_size - 1UL);
+		piece_end = MIN(plan->end, sector + plan->sector_size);
+
+		unit->unit = sector;
+		unit->unit_size = plan->sector_size;
+		unit->start = plan->offset;
+		unit->end = piece_end;
+
+		if ((plan->offset == sector) && (piece_end == (sector + plan->sector_size))) {
+			plan->offset = piece_end;
+			return true;
+		}
+
+		/* Partial sector, 4KB erases can avoid saving the rest of it */
+		small = plan->offset & ~(plan->small_size - 1UL);
+		small_end = ROUND_UP_POW2(piece_end, plan->small_size);
+		if (!(plan->uniform || (small_end <= plan->param_end)) ||
+			((((small_end - small) / plan->small_size) * QSPI_SMALL_ERASE_RATIO) >
+			 (plan->sector_size / plan->small_size))) {
+			plan->offset = piece_end;
+			return true;
+		}
+
+		plan->small = small;
+		plan->small_end = small_end;
+		plan->piece_end = piece_end;
+	}
+
+	unit->unit = plan->small;
+	unit->unit_size = plan->small_size;
+	unit->start = MAX(plan->offset, plan->small);
+	unit->end = MIN(plan->piece_end, plan->small + plan->small_size);
+
+	plan->small += plan->small_size;
+	if (plan->small >= plan->small_end) {
+		plan->offset = plan->piece_end;
+	}
+
+	return true;
+}
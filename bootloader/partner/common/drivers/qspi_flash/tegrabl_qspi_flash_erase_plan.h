@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ */
+
+#ifndef INCLUDED_TEGRABL_QSPI_FLASH_ERASE_PLAN_H
+#define INCLUDED_TEGRABL_QSPI_FLASH_ERASE_PLAN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/* A partial sector is erased in 4KB steps if it takes at most a quarter of
+ * the 4KB erases that would cover the whole sector; a 4KB erase takes about
+ * a third of the time of a 64KB one and needs nothing saved and restored. */
+#define QSPI_SMALL_ERASE_RATIO 4U
+
+/**
+ * @brief One erase of a plan. Data of the unit outside [start, end) must be
+ * kept.
+ *
+ * @param unit start of the unit in bytes
+ * @param unit_size size of the unit, a sector or a 4KB sub-sector
+ * @param start start of the range to erase within the unit
+ * @param end end of the range to erase within the unit
+ */
+struct qspi_erase_unit {
+	uint32_t unit;
+	uint32_t unit_size;
+	uint32_t start;
+	uint32_t end;
+};
+
+/**
+ * @brief Splits a byte range into sector and 4KB sub-sector erases
+ *
+ * @param offset next byte to plan
+ * @param end end of the range
+ * @param sector_size size of a sector
+ * @param small_size size of a sub-sector
+ * @param param_end end of the 4KB parameter sectors, 0 if there are none
+ * @param uniform 4KB erases are supported in every sector
+ * @param small next sub-sector of the partial sector being split
+ * @param small_end end of the sub-sectors of that partial sector
+ * @param piece_end end of the range within that partial sector
+ */
+struct qspi_erase_plan {
+	uint32_t offset;
+	uint32_t end;
+	uint32_t sector_size;
+	uint32_t small_size;
+	uint32_t param_end;
+	bool uniform;
+	uint32_t small;
+	uint32_t small_end;
+	uint32_t piece_end;
+};
+
+/**
+ * @brief Start planning the erase of [offset, end)
+ *
+ * @param plan plan to initialize
+ * @param offset start of the range, block aligned
+ * @param end end of the range, block aligned
+ * @param sector_size size of a sector, a power of 2
+ * @param small_size size of a sub-sector, a power of 2
+ * @param param_end end of the parameter sectors, 0 if there are none
+ * @param uniform 4KB erases are supported in every sector
+ */
+void qspi_erase_plan_init(struct qspi_erase_plan *plan, uint32_t offset, uint32_t end,
+						  uint32_t sector_size, uint32_t small_size, uint32_t param_end,
+						  bool uniform);
+
+/**
+ * @brief Get the next erase of a plan. Full sectors are erased whole. A
+ * partial sector is split into sub-sectors where they are supported and
+ * cheaper, else the sector is erased and the rest of it restored.
+ *
+ * @param plan plan to advance
+ * @param unit returns the next erase
+ *
+ * @return false once the whole range is planned
+ */
+bool qspi_erase_plan_next(struct qspi_erase_plan *plan, struct qspi_erase_unit *unit);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* INCLUDED_TEGRABL_QSPI_FLASH_ERASE_PLAN_H */
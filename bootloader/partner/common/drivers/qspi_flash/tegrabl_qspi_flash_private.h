@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2020, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2015-2021, NVIDIA CORPORATION.  All rights reserved.
  *
  * NVIDIA CORPORATION and its licensors retain all intellectual property
  * and proprietary rights in and to this software, related documentation
@@ -100,6 +100,9 @@ extern "C"
 #define QSPI_FLASH_WIP_WAIT_IN_MS				true
 #define QSPI_FLASH_WE_RETRY_COUNT				2000U
 #define QSPI_FLASH_WIP_RETRY_COUNT				2000U
+/* Page programs take 0.1 - 3 ms, polled at a finer step than erases */
+#define QSPI_FLASH_PROGRAM_POLL_TIME			10U
+#define QSPI_FLASH_PROGRAM_POLL_COUNT			1000U
 #define QSPI_FLASH_SINGLE_WRITE_SIZE			256U
 #define QSPI_FLASH_QUAD_ENABLE					0x02U
 #define QSPI_FLASH_QUAD_DISABLE					0x0U
@@ -135,7 +138,7 @@ extern "C"
 #define FLAG_BULK					0x08U
 #define FLAG_BLANK_CHK					0x10U
 #define FLAG_DDR					0x20U
-#define FLAG_UNIFORM					0x40U
+#define FLAG_UNIFORM					0x40U /* 4KB erase works anywhere */
 #define FLAG_PAGE512_FIXED				0x80U
 
 /* QSPI Transfer timeout 5sec */
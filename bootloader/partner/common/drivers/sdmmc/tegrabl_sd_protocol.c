@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2020, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2016-2021, NVIDIA CORPORATION.  All rights reserved.
  *
  * NVIDIA CORPORATION and its licensors errain all intellectual property
  * and proprietary rights in and to this software, related documentation
@@ -19,6 +19,7 @@
 #include <tegrabl_sd_protocol.h>
 #include <tegrabl_sdmmc_protocol.h>
 #include <tegrabl_sdmmc_host.h>
+#include <tegrabl_background.h>
 
 
 /** @brief Initializes the card by following SDMMC protocol.
@@ -77,6 +78,9 @@ tegrabl_error_t sd_identify_card(struct tegrabl_sdmmc *hsdmmc)
 			goto fail;
 		}
 
+		if (!(ocr_reg & (uint32_t)(SD_CARD_POWERUP_STATUS_MASK))) {
+			tegrabl_background_yield();
+		}
 	} while (!(ocr_reg & (uint32_t)(SD_CARD_POWERUP_STATUS_MASK)));
 
 	if (ocr_reg & SD_CARD_CAPACITY_MASK) {
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2020, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2015-2021, NVIDIA CORPORATION.  All rights reserved.
  *
  * NVIDIA CORPORATION and its licensors retain all intellectual property
  * and proprietary rights in and to this software, related documentation
@@ -25,6 +25,7 @@
 #include <tegrabl_addressmap.h>
 #include <tegrabl_timer.h>
 #include <tegrabl_malloc.h>
+#include <tegrabl_background.h>
 #include <inttypes.h>
 
 #if defined(CONFIG_ENABLE_SDCARD)
@@ -276,6 +277,8 @@ static tegrabl_error_t sdmmc_get_operating_conditions(struct tegrabl_sdmmc *hsdm
 		}
 
 		elapsed_time = tegrabl_get_timestamp_us() - start_time;
+		/* Taken before yielding, so the card is polled once more after a long task */
+		tegrabl_background_yield();
 	}
 
 	if (elapsed_time >= timeout) {
@@ -1289,7 +1292,7 @@ tegrabl_error_t sdmmc_block_io(bnum_t block, bnum_t count, uint8_t *buf,
 
 		/* Wait for idle condition. */
 		while (sdmmc_query_status(hsdmmc) == DEVICE_STATUS_IO_PROGRESS) {
-			;
+			tegrabl_background_yield();
 		}
 		tegrabl_dma_unmap_buffer(TEGRABL_MODULE_SDMMC,
 							(uint8_t)(hsdmmc->controller_id), buf,
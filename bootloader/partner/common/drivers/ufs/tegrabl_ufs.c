@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2020, NVIDIA Corporation.  All rights reserved.
+ * Copyright (c) 2016-2021, NVIDIA Corporation.  All rights reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property
  * and proprietary rights in and to this software and related documentation
@@ -34,6 +34,9 @@
 #include <arfuse.h>
 #include <arpmc_impl.h>
 #include <tegrabl_io.h>
+#if defined(CONFIG_ENABLE_UFS_PWR_MODE_CACHE)
+#include <tegrabl_cache_record.h>
+#endif
 
 /* Global structure pointers */
 
@@ -43,13 +46,59 @@ static struct cmd_descriptor *pcmd_descriptor;
 static struct tegrabl_ufs_context *pufs_context;
 
 struct transer_comp_info {
+	bool is_queued;
 	uint32_t trd_index;
+	uint32_t cmd_desc_index;
 	uint32_t prdt_length;
 	uint32_t direction;
 	struct cmd_descriptor *plcmd_descriptor;
 };
 
-static struct transer_comp_info tcinfo;
+/*
+ * Reads and writes in flight, one per LUN so that transfers on the boot and
+ * user LUNs can overlap. Well known LUNs such as RPMB share the last one.
+ */
+#define UFS_RW_QUEUES (TOTAL_UFS_LUNS + 1U)
+/* Task tags of reads and writes, kept clear of the tags of other requests */
+#define UFS_RW_TASK_TAG_BASE 0x20U
+static struct transer_comp_info tcinfo[UFS_RW_QUEUES];
+
+static inline struct transer_comp_info *tegrabl_ufs_rw_queue(uint8_t lun)
+{
+	return &tcinfo[(lun < TOTAL_UFS_LUNS) ? lun : TOTAL_UFS_LUNS];
+}
+
+/*
+ * Slots of queued requests stay reserved until they are checked for
+ * completion. Two TRDs share a cache line, so the neighbour of a queued TRD
+ * is not handed out either: writing it back would overwrite the status the
+ * controller updates.
+ */
+static bool tegrabl_ufs_trd_is_queued(uint32_t trd_index)
+{
+	uint32_t i;
+
+	for (i = 0; i < UFS_RW_QUEUES; i++) {
+		if (tcinfo[i].is_queued && ((tcinfo[i].trd_index >> 1) == (trd_index >> 1))) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static bool tegrabl_ufs_cmd_desc_is_queued(uint32_t cmd_desc_index)
+{
+	uint32_t i;
+
+	for (i = 0; i < UFS_RW_QUEUES; i++) {
+		if (tcinfo[i].is_queued && (tcinfo[i].cmd_desc_index == cmd_desc_index)) {
+			return true;
+		}
+	}
+
+	return false;
+}
 
 /* Global structures */
 static struct tegrabl_ufs_params pufs_params;
@@ -136,6 +185,9 @@ tegrabl_ufs_get_cmd_descriptor(uint32_t *cmd_desc_index)
 	if (pufs_context->cmd_desc_in_use < MAX_CMD_DESC_NUM) {
 		next_cmd_index =
 			NEXT_CD_IDX(pufs_context->last_cmd_desc_index);
+		while (tegrabl_ufs_cmd_desc_is_queued(next_cmd_index)) {
+			next_cmd_index = NEXT_CD_IDX(next_cmd_index);
+		}
 		pufs_context->last_cmd_desc_index = next_cmd_index;
 		*cmd_desc_index = next_cmd_index;
 		pufs_context->cmd_desc_in_use++;
@@ -634,22 +686,21 @@ static tegrabl_error_t tegrabl_ufs_unipro_post_linkup(void)
 	return error;
 }
 
-static  tegrabl_error_t tegrabl_ufs_enable_hs_mode(const struct tegrabl_ufs_params *params)
+/* Link settings needed after every link startup before moving to HS mode */
+static tegrabl_error_t tegrabl_ufs_hs_link_setup(void)
 {
 	tegrabl_error_t error;
 	uint32_t reg_data = 0;
-	uint32_t data = 0;
-	uint32_t gear = 0;
 
 	error = tegrabl_ufs_unipro_post_linkup();
 	if (error != TEGRABL_NO_ERROR) {
-		goto uphy_power_down;
+		return error;
 	}
 
 	error =  tegrabl_ufs_set_dme_command(DME_GET, 0,
 			vs_debugsaveconfigtime, &reg_data);
 	if (error != TEGRABL_NO_ERROR) {
-		goto uphy_power_down;
+		return error;
 	}
 
 	reg_data &= ~(set_tref(~0UL));
@@ -659,8 +710,18 @@ static  tegrabl_error_t tegrabl_ufs_enable_hs_mode(const struct tegrabl_ufs_para
 
 	pr_debug("pvs_debugsaveconfigtime value is 0x%X\n", reg_data);
 
-	error =  tegrabl_ufs_set_dme_command(DME_SET, 0,
+	return tegrabl_ufs_set_dme_command(DME_SET, 0,
 			vs_debugsaveconfigtime, &reg_data);
+}
+
+static  tegrabl_error_t tegrabl_ufs_enable_hs_mode(const struct tegrabl_ufs_params *params)
+{
+	tegrabl_error_t error;
+	uint32_t reg_data = 0;
+	uint32_t data = 0;
+	uint32_t gear = 0;
+
+	error = tegrabl_ufs_hs_link_setup();
 	if (error != TEGRABL_NO_ERROR) {
 		goto uphy_power_down;
 	}
@@ -768,6 +829,148 @@ uphy_power_down:
 }
 #endif
 
+#if defined(CONFIG_ENABLE_UFS_HS_MODE) && defined(CONFIG_ENABLE_UFS_PWR_MODE_CACHE)
+/* Partition caching the HS power mode negotiated on an earlier boot */
+#define UFS_PWR_MODE_PARTITION	"UFS-PWRMODE"
+#define UFS_PWR_MODE_VERSION	1U
+
+/* HS power mode recorded by an earlier boot, or negotiated by this one */
+static struct tegrabl_ufs_pwr_mode_record ufs_pwr_mode;
+/* Params of a HS mode switch deferred until the record can be read */
+static struct tegrabl_ufs_params ufs_hs_mode_params;
+static bool ufs_hs_mode_pending;
+
+/*
+ * The record is only used for the device and platform limits it was
+ * negotiated with, reading the device descriptor costs less than the
+ * capability queries and the extra power mode change it saves.
+ */
+static bool tegrabl_ufs_pwr_mode_record_matches(const struct tegrabl_ufs_params *params)
+{
+	struct tegrabl_ufs_pwr_mode_record *record = &ufs_pwr_mode;
+	uint8_t hs_series;
+	uint16_t manufacture_id = MANUFACTURE_UNKNOWN;
+
+	if (record->magic != TEGRABL_UFS_PWR_MODE_MAGIC) {
+		return false;
+	}
+
+	hs_series = (params->enable_hs_rate_b == true) ? UFS_HS_RATE_B : UFS_HS_RATE_A;
+	if ((params->enable_hs_modes != true) ||
+		(record->max_hs_mode != params->max_hs_mode) ||
+		(record->max_active_lanes != params->max_active_lanes) ||
+		(record->hs_series != hs_series)) {
+		pr_info("UFS platform params changed, negotiating power mode\n");
+		return false;
+	}
+
+	if ((record->tx_gear == 0U) || (record->tx_gear > params->max_hs_mode) ||
+		(record->rx_gear == 0U) || (record->rx_gear > params->max_hs_mode) ||
+		(record->tx_lanes == 0U) || (record->tx_lanes > params->max_active_lanes) ||
+		(record->rx_lanes == 0U) || (record->rx_lanes > UFS_TWO_LANES_ACTIVE)) {
+		pr_warn("Invalid UFS power mode record\n");
+		return false;
+	}
+
+	if (tegrabl_ufs_get_manufacture_id(&manufacture_id) != TEGRABL_NO_ERROR) {
+		return false;
+	}
+	if (manufacture_id != record->manufacture_id) {
+		pr_info("UFS device changed, negotiating power mode\n");
+		return false;
+	}
+
+	return true;
+}
+
+/* Program the recorded power mode with a single PA_PWRMODE change */
+static tegrabl_error_t tegrabl_ufs_restore_pwr_mode(void)
+{
+	struct tegrabl_ufs_pwr_mode_record *record = &ufs_pwr_mode;
+	tegrabl_error_t error;
+	uint32_t data;
+	uint32_t i;
+	const struct {
+		uint16_t attr;
+		uint32_t value;
+	} attrs[] = {
+		{ pa_active_tx_data_lanes, record->tx_lanes },
+		{ pa_active_rx_data_lanes, record->rx_lanes },
+		{ pa_rx_gear, record->rx_gear },
+		{ pa_tx_gear, record->tx_gear },
+		{ pa_rx_termination, record->termination },
+		{ pa_tx_termination, record->termination },
+		{ pa_hs_series, record->hs_series },
+	};
+
+	error = tegrabl_ufs_hs_link_setup();
+	if (error != TEGRABL_NO_ERROR) {
+		return error;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(attrs); i++) {
+		data = attrs[i].value;
+		error = tegrabl_ufs_set_dme_command(DME_SET, 0, attrs[i].attr, &data);
+		if (error != TEGRABL_NO_ERROR) {
+			return error;
+		}
+	}
+
+	data = ((PWRMODE_FAST_MODE << 4) | PWRMODE_FAST_MODE);
+	error = tegrabl_ufs_set_dme_command(DME_SET, 0, pa_pwr_mode, &data);
+	if (error != TEGRABL_NO_ERROR) {
+		return error;
+	}
+
+	pr_info("Restored HS mode %d Gear %d\n", record->hs_series, record->rx_gear);
+	return TEGRABL_NO_ERROR;
+}
+
+/* Record the power mode the full negotiation reached, if it is an HS one */
+static void tegrabl_ufs_save_pwr_mode(const struct tegrabl_ufs_params *params)
+{
+	struct tegrabl_ufs_pwr_mode_record record;
+	const uint16_t attrs[] = {
+		pa_pwr_mode,
+		pa_tx_gear,
+		pa_rx_gear,
+		pa_active_tx_data_lanes,
+		pa_active_rx_data_lanes,
+		pa_hs_series,
+		pa_tx_termination,
+	};
+	uint32_t data[ARRAY_SIZE(attrs)];
+	uint32_t i;
+
+	memset(&ufs_pwr_mode, 0, sizeof(ufs_pwr_mode));
+
+	for (i = 0; i < ARRAY_SIZE(attrs); i++) {
+		data[i] = 0;
+		if (tegrabl_ufs_set_dme_command(DME_GET, 0, attrs[i], &data[i]) != TEGRABL_NO_ERROR) {
+			return;
+		}
+	}
+	if (data[0] != ((PWRMODE_FAST_MODE << 4) | PWRMODE_FAST_MODE)) {
+		return;
+	}
+
+	memset(&record, 0, sizeof(record));
+	if (tegrabl_ufs_get_manufacture_id(&record.manufacture_id) != TEGRABL_NO_ERROR) {
+		return;
+	}
+	record.max_hs_mode = params->max_hs_mode;
+	record.max_active_lanes = params->max_active_lanes;
+	record.tx_gear = (uint8_t)data[1];
+	record.rx_gear = (uint8_t)data[2];
+	record.tx_lanes = (uint8_t)data[3];
+	record.rx_lanes = (uint8_t)data[4];
+	record.hs_series = (uint8_t)data[5];
+	record.termination = (uint8_t)data[6];
+	record.magic = TEGRABL_UFS_PWR_MODE_MAGIC;
+	ufs_pwr_mode = record;
+}
+#endif
+
 static void tegrabl_ufs_device_clk_enable(void)
 {
 	uint32_t reg_data;
@@ -916,6 +1119,13 @@ static tegrabl_error_t tegrabl_ufs_switch_gear(const struct tegrabl_ufs_params *
 	switch (req_mode_switch) {
 #if defined(CONFIG_ENABLE_UFS_HS_MODE)
 	case SWITCH_TO_HS_MODE:
+#if defined(CONFIG_ENABLE_UFS_PWR_MODE_CACHE)
+		/* Stay in PWM until the partition with the record can be read */
+		ufs_hs_mode_params = *params;
+		ufs_hs_mode_pending = true;
+		pr_info("UFS HS mode switch deferred\n");
+		break;
+#endif
 		error = tegrabl_ufs_enable_hs_mode(params);
 		if (error != TEGRABL_NO_ERROR) {
 			pr_error("HS mode switch failed %d\n", error);
@@ -940,6 +1150,63 @@ static tegrabl_error_t tegrabl_ufs_switch_gear(const struct tegrabl_ufs_params *
 	return error;
 }
 
+#if defined(CONFIG_ENABLE_UFS_HS_MODE) && defined(CONFIG_ENABLE_UFS_PWR_MODE_CACHE)
+tegrabl_error_t tegrabl_ufs_complete_hs_mode(void)
+{
+	tegrabl_error_t error = TEGRABL_NO_ERROR;
+	tegrabl_error_t err;
+
+	if (!ufs_hs_mode_pending) {
+		goto done;
+	}
+	ufs_hs_mode_pending = false;
+
+	err = tegrabl_cache_record_load(UFS_PWR_MODE_PARTITION, UFS_PWR_MODE_VERSION, &ufs_pwr_mode,
+									sizeof(ufs_pwr_mode));
+	if (err != TEGRABL_NO_ERROR) {
+		pr_debug("No UFS power mode record, err %x\n", err);
+		memset(&ufs_pwr_mode, 0, sizeof(ufs_pwr_mode));
+	}
+
+	if (tegrabl_ufs_pwr_mode_record_matches(&ufs_hs_mode_params)) {
+		error = tegrabl_ufs_restore_pwr_mode();
+		if (error == TEGRABL_NO_ERROR) {
+			goto done;
+		}
+
+		/* Link state is unknown, start it up again and negotiate */
+		pr_warn("Restoring UFS power mode failed, negotiating it\n");
+		error = tegrabl_ufs_hw_init(pufs_context->init_done);
+		tegrabl_clear_err_regs();
+		if (error != TEGRABL_NO_ERROR) {
+			goto done;
+		}
+		error = tegrabl_ufs_change_num_lanes(&ufs_hs_mode_params);
+		if (error != TEGRABL_NO_ERROR) {
+			goto done;
+		}
+	}
+
+	error = tegrabl_ufs_enable_hs_mode(&ufs_hs_mode_params);
+	if (error != TEGRABL_NO_ERROR) {
+		pr_error("HS mode switch failed %d\n", error);
+		goto done;
+	}
+
+	tegrabl_ufs_save_pwr_mode(&ufs_hs_mode_params);
+	if (ufs_pwr_mode.magic == TEGRABL_UFS_PWR_MODE_MAGIC) {
+		err = tegrabl_cache_record_store(UFS_PWR_MODE_PARTITION, UFS_PWR_MODE_VERSION, &ufs_pwr_mode,
+										 sizeof(ufs_pwr_mode));
+		if (err != TEGRABL_NO_ERROR) {
+			pr_warn("Failed to cache UFS power mode, err %x\n", err);
+		}
+	}
+
+done:
+	return error;
+}
+#endif
+
 static tegrabl_error_t tegrabl_ufs_disable_hce(void)
 {
 	tegrabl_error_t error = 0;
@@ -1365,6 +1632,9 @@ tegrabl_error_t tegrabl_ufs_get_tx_rx_descriptor(uint32_t *ptrd_index)
 
 	if (pufs_context->tx_req_des_in_use < MAX_TRD_NUM) {
 		trd_index = NEXT_TRD_IDX(pufs_context->last_trd_index);
+		while (tegrabl_ufs_trd_is_queued(trd_index)) {
+			trd_index = NEXT_TRD_IDX(trd_index);
+		}
 		reg_data = UFS_READ32(UTRLDBR);
 		if ((reg_data & (1UL << trd_index)) != 0U) {
 			pr_error("reg data is %0x\n", reg_data);
@@ -2389,13 +2659,30 @@ tegrabl_error_t
 tegrabl_ufs_rw_common(const uint32_t block, const uint32_t page,
 		const uint32_t length, uint32_t *pbuffer,
 		uint32_t opcode, uint8_t lun)
+{
+	struct tegrabl_ufs_sg sg;
+
+	TEGRABL_UNUSED(page);
+
+	sg.buf = pbuffer;
+	sg.count = length;
+
+	return tegrabl_ufs_rw_common_sg(block, &sg, 1U, opcode, lun);
+}
+
+tegrabl_error_t
+tegrabl_ufs_rw_common_sg(const uint32_t block, const struct tegrabl_ufs_sg *sg,
+		uint32_t num_sg, uint32_t opcode, uint8_t lun)
 {
 	uint32_t trd_index = 0;
 	uint32_t cmd_desc_index = 0;
 	struct cmd_descriptor *plcmd_descriptor;
 	struct command_upiu *pcommand_upiu;
-	uint32_t pending_length = length;
-	uint32_t prdt_length;
+	struct transer_comp_info *queue = tegrabl_ufs_rw_queue(lun);
+	uint32_t length = 0;
+	uint32_t pending_length;
+	uint32_t prdt_length = 0;
+	uint32_t i;
 	tegrabl_error_t error = TEGRABL_NO_ERROR;
 	uint8_t lun_ready = 0;
 
@@ -2405,14 +2692,23 @@ tegrabl_ufs_rw_common(const uint32_t block, const uint32_t page,
 	uint8_t ufs_security_protocol = (lun == UFS_UPIU_RPMB_WLUN) ?
 		SCSI_SECURITY_PROTOCOL_UFS : 0U;
 
-	TEGRABL_UNUSED(page);
+	/* Every buffer takes whole PRDT entries of up to MAX_BLOCKS each */
+	for (i = 0; i < num_sg; i++) {
+		length += sg[i].count;
+		prdt_length += DIV_CEIL(sg[i].count, MAX_BLOCKS);
+	}
 
-	pr_trace("UFS R/W block %d len %d\n", block, length);
+	pr_trace("UFS R/W block %d len %d, %d buffers\n", block, length, num_sg);
 
-	if (length > MAX_PRDT_LENGTH*MAX_BLOCKS) {
-		pr_error("# of blocks %u > %u\n", length,
-			 (unsigned int)MAX_PRDT_LENGTH*MAX_BLOCKS);
-		return error;
+	if (prdt_length > MAX_PRDT_LENGTH) {
+		pr_error("# of PRDT entries %u > %u\n", prdt_length,
+			 (unsigned int)MAX_PRDT_LENGTH);
+		return TEGRABL_ERROR(TEGRABL_ERR_OVERFLOW, 2U);
+	}
+
+	if (queue->is_queued) {
+		pr_error("LUN %d has a transfer in flight\n", lun);
+		return TEGRABL_ERROR(TEGRABL_ERR_BUSY, 2U);
 	}
 
 	error = tegrabl_ufs_check_lun_ready(lun, &lun_ready);
@@ -2444,7 +2740,7 @@ tegrabl_ufs_rw_common(const uint32_t block, const uint32_t page,
 				UFS_UPIU_FLAGS_W_SHIFT : UFS_UPIU_FLAGS_R_SHIFT);
 	pcommand_upiu->basic_header.lun = lun;
 	pcommand_upiu->basic_header.cmd_set_type = UPIU_COMMAND_SET_SCSI;
-	pcommand_upiu->basic_header.task_tag = ((direction == 1UL) ? 0x14U : 0x15U);
+	pcommand_upiu->basic_header.task_tag = (uint8_t)(UFS_RW_TASK_TAG_BASE + trd_index);
 	pcommand_upiu->expected_data_tx_len_bige =
 		BYTE_SWAP32(length * (1UL << pufs_context->page_size_log2));
 
@@ -2488,37 +2784,40 @@ tegrabl_ufs_rw_common(const uint32_t block, const uint32_t page,
 	}
 #endif
 
-	for (prdt_length = 0;
-		(pending_length > 0U) && (prdt_length < MAX_PRDT_LENGTH);
-		prdt_length++) {
-		uint32_t *lbuffer;
-		uint32_t num_blocks;
-		dma_addr_t address = 0;
+	prdt_length = 0;
+	for (i = 0; i < num_sg; i++) {
+		uint32_t *lbuffer = sg[i].buf;
 
-		if ((pending_length / MAX_BLOCKS) != 0U) {
-			num_blocks = MAX_BLOCKS;
-		} else {
-			num_blocks = pending_length;
-		}
+		for (pending_length = sg[i].count; pending_length > 0U; prdt_length++) {
+			uint32_t num_blocks;
+			dma_addr_t address = 0;
 
-		pending_length -= num_blocks;
+			if ((pending_length / MAX_BLOCKS) != 0U) {
+				num_blocks = MAX_BLOCKS;
+			} else {
+				num_blocks = pending_length;
+			}
 
-		lbuffer = pbuffer + ((prdt_length * (MAX_BLOCKS * BLOCK_SIZE) / 4U));
-		pr_trace("ufs prdt %d: buf %p, len %ld\n",
-			prdt_length, lbuffer,
-			num_blocks * (1UL << pufs_context->page_size_log2));
+			pending_length -= num_blocks;
 
-		address = tegrabl_dma_map_buffer(TEGRABL_MODULE_UFS, 0,
-					lbuffer, (num_blocks * 4096U),
-					((direction == 1UL) ? TEGRABL_DMA_TO_DEVICE :
-					 TEGRABL_DMA_FROM_DEVICE));
+			pr_trace("ufs prdt %d: buf %p, len %ld\n",
+				prdt_length, lbuffer,
+				num_blocks * (1UL << pufs_context->page_size_log2));
 
-		plcmd_descriptor->vprdt[prdt_length].dw0 =
-			((uintptr_t)(address & 0xffffffffCUL)) & ~(0x3UL);
-		plcmd_descriptor->vprdt[prdt_length].dw1 =
-			((uintptr_t)(address >> 32) & 0xffffffffUL);
-		plcmd_descriptor->vprdt[prdt_length].dw3 =
-			(num_blocks * (1UL << pufs_context->page_size_log2)) - 1U;
+			address = tegrabl_dma_map_buffer(TEGRABL_MODULE_UFS, 0,
+						lbuffer, (num_blocks * 4096U),
+						((direction == 1UL) ? TEGRABL_DMA_TO_DEVICE :
+						 TEGRABL_DMA_FROM_DEVICE));
+
+			plcmd_descriptor->vprdt[prdt_length].dw0 =
+				((uintptr_t)(address & 0xffffffffCUL)) & ~(0x3UL);
+			plcmd_descriptor->vprdt[prdt_length].dw1 =
+				((uintptr_t)(address >> 32) & 0xffffffffUL);
+			plcmd_descriptor->vprdt[prdt_length].dw3 =
+				(num_blocks * (1UL << pufs_context->page_size_log2)) - 1U;
+
+			lbuffer += (num_blocks * BLOCK_SIZE) / 4U;
+		}
 	}
 
 	pr_trace("R/W cmd: prdt cnt %d\n", prdt_length);
@@ -2536,28 +2835,48 @@ tegrabl_ufs_rw_common(const uint32_t block, const uint32_t page,
 		return error;
 	}
 
-	tcinfo.trd_index = trd_index;
-	tcinfo.prdt_length = prdt_length;
-	tcinfo.plcmd_descriptor = &pcmd_descriptor[cmd_desc_index];
-	tcinfo.direction = direction;
+	queue->trd_index = trd_index;
+	queue->cmd_desc_index = cmd_desc_index;
+	queue->prdt_length = prdt_length;
+	queue->plcmd_descriptor = &pcmd_descriptor[cmd_desc_index];
+	queue->direction = direction;
+	queue->is_queued = true;
 
 	return error;
 }
 
 tegrabl_error_t
-tegrabl_ufs_rw_check_complete(const uint32_t length, uint32_t *pbuffer)
+tegrabl_ufs_rw_check_complete(uint8_t lun, const uint32_t length, uint32_t *pbuffer)
+{
+	struct tegrabl_ufs_sg sg;
+
+	sg.buf = pbuffer;
+	sg.count = length;
+
+	return tegrabl_ufs_rw_check_complete_sg(lun, &sg, 1U);
+}
+
+tegrabl_error_t
+tegrabl_ufs_rw_check_complete_sg(uint8_t lun, const struct tegrabl_ufs_sg *sg, uint32_t num_sg)
 {
 	struct response_upiu *presponse_upiu;
+	struct transer_comp_info *queue = tegrabl_ufs_rw_queue(lun);
 	uint32_t trd_index;
 	uint32_t prdt_length;
 	uint32_t direction;
+	uint32_t i;
 	struct cmd_descriptor *plcmd_descriptor;
 	tegrabl_error_t error = TEGRABL_NO_ERROR;
 
-	trd_index = tcinfo.trd_index;
-	prdt_length = tcinfo.prdt_length;
-	plcmd_descriptor = tcinfo.plcmd_descriptor;
-	direction = tcinfo.direction;
+	if (!queue->is_queued) {
+		return TEGRABL_ERROR(TEGRABL_ERR_NOT_STARTED, 0U);
+	}
+
+	trd_index = queue->trd_index;
+	prdt_length = queue->prdt_length;
+	plcmd_descriptor = queue->plcmd_descriptor;
+	direction = queue->direction;
+	queue->is_queued = false;
 
 	error = tegrabl_ufs_wait_trd_request_complete(trd_index, prdt_length * SCSI_REQ_READ_TIMEOUT);
 	if (error != TEGRABL_NO_ERROR) {
@@ -2588,9 +2907,11 @@ tegrabl_ufs_rw_check_complete(const uint32_t length, uint32_t *pbuffer)
 
 	tegrabl_ufs_free_trd_cmd_desc();
 
-	tegrabl_dma_unmap_buffer(TEGRABL_MODULE_UFS, 0,
-			pbuffer, (length * 4096UL),
-			((direction == 1UL) ? TEGRABL_DMA_TO_DEVICE : TEGRABL_DMA_FROM_DEVICE));
+	for (i = 0; i < num_sg; i++) {
+		tegrabl_dma_unmap_buffer(TEGRABL_MODULE_UFS, 0,
+				sg[i].buf, (sg[i].count * 4096UL),
+				((direction == 1UL) ? TEGRABL_DMA_TO_DEVICE : TEGRABL_DMA_FROM_DEVICE));
+	}
 
 	pr_trace("R/W successfull\n");
 
@@ -2625,7 +2946,7 @@ tegrabl_ufs_read(uint8_t lun_id, const uint32_t block, const uint32_t page,
 	if (error != TEGRABL_NO_ERROR) {
 		goto out;
 	}
-	error = tegrabl_ufs_rw_check_complete(length, pbuffer);
+	error = tegrabl_ufs_rw_check_complete(lun_id, length, pbuffer);
 out:
 	if (error != TEGRABL_NO_ERROR) {
 		pr_error("UFS Read transfer failed error = %u\n", error);
@@ -2649,7 +2970,7 @@ tegrabl_ufs_write(uint8_t lun_id, const uint32_t block, const uint32_t page,
 			goto out;
 		}
 
-		error = tegrabl_ufs_rw_check_complete(length, pbuffer);
+		error = tegrabl_ufs_rw_check_complete(lun_id, length, pbuffer);
 		if (error != TEGRABL_NO_ERROR) {
 			retry = retry - 1U;
 			error = tegrabl_ufs_hw_init(1);
@@ -2667,6 +2988,40 @@ out:
 	return error;
 }
 
+tegrabl_error_t
+tegrabl_ufs_rw_sg(uint8_t lun_id, const uint32_t block, const struct tegrabl_ufs_sg *sg,
+			uint32_t num_sg, bool is_write)
+{
+	tegrabl_error_t error = TEGRABL_NO_ERROR;
+	uint32_t retry = is_write ? 2U : 1U;
+
+	while (retry != 0U) {
+		error = tegrabl_ufs_rw_common_sg(block, sg, num_sg,
+					is_write ? SCSI_WRITE10_OPCODE : SCSI_READ10_OPCODE, lun_id);
+		if (error != TEGRABL_NO_ERROR) {
+			goto out;
+		}
+
+		error = tegrabl_ufs_rw_check_complete_sg(lun_id, sg, num_sg);
+		if (error == TEGRABL_NO_ERROR) {
+			break;
+		}
+		retry = retry - 1U;
+		if (is_write) {
+			error = tegrabl_ufs_hw_init(1);
+			if (error != TEGRABL_NO_ERROR) {
+				goto out;
+			}
+		}
+	}
+out:
+	if (error != TEGRABL_NO_ERROR) {
+		pr_error("UFS %s of %u buffers failed, error = %u\n",
+				is_write ? "write" : "read", num_sg, error);
+	}
+	return error;
+}
+
 static void tegrabl_ufs_update_platform_params(struct tegrabl_ufs_platform_params *plat_params,
 	struct tegrabl_ufs_params *params)
 {
@@ -3130,7 +3485,7 @@ tegrabl_ufs_security_command(const uint8_t opcode, const uint32_t block,
 	if (error != TEGRABL_NO_ERROR) {
 		goto out;
 	}
-	error = tegrabl_ufs_rw_check_complete(length, pbuffer);
+	error = tegrabl_ufs_rw_check_complete(UFS_UPIU_RPMB_WLUN, length, pbuffer);
 out:
 	if (error != TEGRABL_NO_ERROR) {
 		pr_error("UFS Secure command failed, error = %u\n", error);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2018, NVIDIA Corporation.  All rights reserved.
+ * Copyright (c) 2015-2021, NVIDIA Corporation.  All rights reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property
  * and proprietary rights in and to this software and related documentation
@@ -153,8 +153,8 @@ static tegrabl_error_t tegrabl_ufs_blockdev_xfer(
 		if (error != TEGRABL_NO_ERROR) {
 			goto fail;
 		}
-		context->xfer_info.dma_in_progress = true;
-		context->xfer_info.bulk_count = bulk_count;
+		priv_data->xfer_info.dma_in_progress = true;
+		priv_data->xfer_info.bulk_count = bulk_count;
 	}
 
 fail:
@@ -215,9 +215,10 @@ static tegrabl_error_t tegrabl_ufs_blockdev_xfer_wait(
 	start_time_us = tegrabl_get_timestamp_us();
 
 	while ((count > 0UL) && (elapsed_time_us <= timeout_us)) {
-		if (context->xfer_info.dma_in_progress) {
-			bulk_count = context->xfer_info.bulk_count;
-			error = tegrabl_ufs_rw_check_complete(bulk_count, (uint32_t *)buf);
+		if (priv_data->xfer_info.dma_in_progress) {
+			bulk_count = priv_data->xfer_info.bulk_count;
+			priv_data->xfer_info.dma_in_progress = false;
+			error = tegrabl_ufs_rw_check_complete(priv_data->lun_id, bulk_count, (uint32_t *)buf);
 			if (error != TEGRABL_NO_ERROR) {
 				goto fail;
 			}
@@ -235,6 +236,8 @@ static tegrabl_error_t tegrabl_ufs_blockdev_xfer_wait(
 		if (error != TEGRABL_NO_ERROR) {
 			goto fail;
 		}
+		priv_data->xfer_info.dma_in_progress = true;
+		priv_data->xfer_info.bulk_count = bulk_count;
 
 		elapsed_time_us = tegrabl_get_timestamp_us() - start_time_us;
 	}
@@ -314,6 +317,83 @@ fail:
 	return error;
 }
 
+/**
+ * @brief Reads or writes a list of segments. Segments that follow each other
+ * on the device are sent as one command whose PRDT points at each of their
+ * buffers, so a scattered load costs one command per device run instead of
+ * one per buffer.
+ *
+ * @param dev Block device to transfer with
+ * @param xfer_type TEGRABL_BLOCKDEV_READ or TEGRABL_BLOCKDEV_WRITE
+ * @param segs Segments to transfer
+ * @param num_segs Number of segments
+ *
+ * @return TEGRABL_NO_ERROR if successful else appropriate error.
+ */
+static tegrabl_error_t tegrabl_ufs_bdev_xfer_list(struct tegrabl_bdev *dev,
+		uint8_t xfer_type, struct tegrabl_blockdev_xfer_segment *segs,
+		uint32_t num_segs)
+{
+	tegrabl_error_t error = TEGRABL_NO_ERROR;
+	struct tegrabl_ufs_sg sg[MAX_PRDT_LENGTH];
+	struct ufs_priv_data *priv_data = NULL;
+	bool is_write = (xfer_type == TEGRABL_BLOCKDEV_WRITE);
+	uint32_t num_sg;
+	uint32_t prdt_count;
+	uint32_t count;
+	uint32_t done = 0;
+	uint32_t block;
+	uint32_t next;
+	uint32_t i = 0;
+
+	if ((dev == NULL) || (segs == NULL)) {
+		error = TEGRABL_ERROR(TEGRABL_ERR_INVALID, 0);
+		goto fail;
+	}
+
+#if defined(CONFIG_ENABLE_BLOCKDEV_BASIC)
+	if (is_write) {
+		error = TEGRABL_ERROR(TEGRABL_ERR_NOT_SUPPORTED, 0);
+		goto fail;
+	}
+#endif
+
+	priv_data = (struct ufs_priv_data *)dev->priv_data;
+
+	while (i < num_segs) {
+		block = segs[i].start_block + done;
+		next = block;
+		num_sg = 0;
+		prdt_count = 0;
+
+		/* Gather what continues on the device until the PRDT is full */
+		while ((i < num_segs) && (prdt_count < MAX_PRDT_LENGTH) &&
+				((segs[i].start_block + done) == next)) {
+			count = MIN(segs[i].block_count - done,
+					(MAX_PRDT_LENGTH - prdt_count) * UFS_BLOCK_MAX);
+			sg[num_sg].buf = (uint32_t *)((uint8_t *)segs[i].buf +
+					((size_t)done << dev->block_size_log2));
+			sg[num_sg].count = count;
+			num_sg++;
+			prdt_count += DIV_CEIL(count, UFS_BLOCK_MAX);
+			next += count;
+			done += count;
+			if (done == segs[i].block_count) {
+				done = 0;
+				i++;
+			}
+		}
+
+		error = tegrabl_ufs_rw_sg(priv_data->lun_id, block, sg, num_sg, is_write);
+		if (error != TEGRABL_NO_ERROR) {
+			goto fail;
+		}
+	}
+
+fail:
+	return error;
+}
+
 #if defined(CONFIG_ENABLE_UFS_KPI)
 static time_t last_write_start_time;
 static time_t last_write_end_time;
@@ -502,6 +582,7 @@ static tegrabl_error_t tegrabl_ufs_register_region(
 	ufs_boot_dev->ioctl = tegrabl_ufs_bdev_ioctl;
 	ufs_boot_dev->xfer = tegrabl_ufs_blockdev_xfer;
 	ufs_boot_dev->xfer_wait = tegrabl_ufs_blockdev_xfer_wait;
+	ufs_boot_dev->xfer_list = tegrabl_ufs_bdev_xfer_list;
 	ufs_boot_dev->priv_data = (void *)boot_priv_data;
 
 	error = tegrabl_blockdev_register_device(ufs_boot_dev);
@@ -546,6 +627,7 @@ static tegrabl_error_t tegrabl_ufs_register_region(
 	user_dev->ioctl = tegrabl_ufs_bdev_ioctl;
 	user_dev->xfer = tegrabl_ufs_blockdev_xfer;
 	user_dev->xfer_wait = tegrabl_ufs_blockdev_xfer_wait;
+	user_dev->xfer_list = tegrabl_ufs_bdev_xfer_list;
 	user_dev->priv_data = (void *)user_priv_data;
 
 	error = tegrabl_blockdev_register_device(user_dev);
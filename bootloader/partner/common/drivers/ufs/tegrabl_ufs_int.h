@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2018 NVIDIA Corporation.  All rights reserved.
+ * Copyright (c) 2016-2021 NVIDIA Corporation.  All rights reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property
  * and proprietary rights in and to this software and related documentation
@@ -62,7 +62,6 @@ struct tegrabl_ufs_context {
 	uint32_t page_size_log2;
 	uint32_t active_lanes;
 	uint32_t num_lanes;
-	struct tegrabl_ufs_xfer_info xfer_info;
 	/* End: Device stuff obtained from fuses, bct */
 	/* Start: House keeping */
 	uint32_t init_done;
@@ -84,12 +83,20 @@ struct tegrabl_ufs_context {
 
 #define TOTAL_UFS_LUNS 0x2U
 
+/* One buffer of a scatter gather transfer, count in blocks */
+struct tegrabl_ufs_sg {
+	uint32_t *buf;
+	uint32_t count;
+};
+
 /* Defines the private data being used by ufs */
 struct ufs_priv_data {
 	/* defines the device type */
 	uint8_t lun_id;
 	/* store context pointer */
 	void *context;
+	/* non blocking transfer in flight on this LUN */
+	struct tegrabl_ufs_xfer_info xfer_info;
 };
 
 
@@ -97,9 +104,15 @@ tegrabl_error_t tegrabl_ufs_init(const struct tegrabl_ufs_params *params,
 	struct tegrabl_ufs_context *context);
 tegrabl_error_t tegrabl_ufs_xfer(uint8_t lun_id, const uint32_t block, const uint32_t page,
 		const uint32_t length, uint32_t *pbuffer);
-tegrabl_error_t tegrabl_ufs_rw_check_complete(const uint32_t length, uint32_t *pbuffer);
+tegrabl_error_t tegrabl_ufs_rw_check_complete(uint8_t lun, const uint32_t length, uint32_t *pbuffer);
 tegrabl_error_t tegrabl_ufs_rw_common(const uint32_t block, const uint32_t page,
 			const uint32_t length, uint32_t *pbuffer, uint32_t direction, uint8_t lun);
+tegrabl_error_t tegrabl_ufs_rw_check_complete_sg(uint8_t lun, const struct tegrabl_ufs_sg *sg,
+		uint32_t num_sg);
+tegrabl_error_t tegrabl_ufs_rw_common_sg(const uint32_t block, const struct tegrabl_ufs_sg *sg,
+		uint32_t num_sg, uint32_t opcode, uint8_t lun);
+tegrabl_error_t tegrabl_ufs_rw_sg(uint8_t lun_id, const uint32_t block,
+		const struct tegrabl_ufs_sg *sg, uint32_t num_sg, bool is_write);
 tegrabl_error_t tegrabl_ufs_read(uint8_t lun_id, const uint32_t block, const uint32_t page,
 		const uint32_t length, uint32_t *pbuffer);
 tegrabl_error_t tegrabl_ufs_write(uint8_t lun_id, const uint32_t block, const uint32_t page,
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2020, NVIDIA Corporation.  All rights reserved.
+ * Copyright (c) 2018-2021, NVIDIA Corporation.  All rights reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property
  * and proprietary rights in and to this software and related documentation
@@ -107,6 +107,76 @@ void dump_buf(const void *data, size_t size)
 
 #endif	/* USB_DEBUG */
 
+/**
+ * @brief Sets up the CDB of a READ/WRITE command. READ(16)/WRITE(16) are
+ * used for devices too large for READ CAPACITY(10), as their 10 byte
+ * versions may not be supported there.
+ *
+ * @param context Context information
+ * @param is_write True for WRITE
+ * @param block Start sector
+ * @param count Number of sectors
+ */
+static void tegrabl_usbmsd_setup_rw_cdb(struct tegrabl_usbmsd_context *context,
+					bool is_write, bnum_t block,
+					uint32_t count)
+{
+	uint64_t lba = (uint64_t)block;
+
+	if (context->use_cdb16) {
+		context->cmdlen = 16;
+		memset(context->cmd, 0x0, context->cmdlen);
+		context->cmd[0] = is_write ? WRITE_16 : READ_16;
+		context->cmd[2] = ((uint8_t)(lba >> 56)) & 0xFF;
+		context->cmd[3] = ((uint8_t)(lba >> 48)) & 0xFF;
+		context->cmd[4] = ((uint8_t)(lba >> 40)) & 0xFF;
+		context->cmd[5] = ((uint8_t)(lba >> 32)) & 0xFF;
+		context->cmd[6] = ((uint8_t)(lba >> 24)) & 0xFF;
+		context->cmd[7] = ((uint8_t)(lba >> 16)) & 0xFF;
+		context->cmd[8] = ((uint8_t)(lba >> 8)) & 0xFF;
+		context->cmd[9] = ((uint8_t)(lba)) & 0xFF;
+		context->cmd[10] = ((uint8_t)(count >> 24)) & 0xFF;
+		context->cmd[11] = ((uint8_t)(count >> 16)) & 0xFF;
+		context->cmd[12] = ((uint8_t)(count >> 8)) & 0xFF;
+		context->cmd[13] = ((uint8_t)(count)) & 0xFF;
+	} else {
+		/* 32-bit LBA and 16-bit count */
+		context->cmdlen = 10;
+		memset(context->cmd, 0x0, context->cmdlen);
+		context->cmd[0] = is_write ? WRITE_10 : READ_10;
+		context->cmd[2] = ((uint8_t)(lba >> 24)) & 0xFF;
+		context->cmd[3] = ((uint8_t)(lba >> 16)) & 0xFF;
+		context->cmd[4] = ((uint8_t)(lba >> 8)) & 0xFF;
+		context->cmd[5] = ((uint8_t)(lba)) & 0xFF;
+		context->cmd[7] = ((uint8_t)(count >> 8)) & 0xFF;
+		context->cmd[8] = ((uint8_t)(count)) & 0xFF;
+	}
+}
+
+/**
+ * @brief Gets the number of sectors the next READ/WRITE command moves.
+ * Buffers that are not 64KB aligned are transferred 64KB per command
+ * in place instead of being copied through an aligned buffer.
+ *
+ * @param context Context information
+ * @param buf Buffer of the command
+ * @param count Number of sectors left
+ *
+ * @return number of sectors for the command
+ */
+static uint32_t tegrabl_usbmsd_bulk_count(struct tegrabl_usbmsd_context *context,
+					  const void *buf, bnum_t count)
+{
+	uint32_t max_sectors = context->max_xfer_sectors;
+
+	if (IS_ALIGNED((uintptr_t)buf, SZ_64K) == false) {
+		max_sectors = MIN(max_sectors,
+				  (uint32_t)(SZ_64K >> context->block_size_log2));
+	}
+
+	return MIN(count, max_sectors);
+}
+
 /**
  * @brief Processes ioctl request.
  *
@@ -212,12 +282,15 @@ static tegrabl_error_t tegrabl_usbmsd_bdev_xfer(
 		goto fail;
 	}
 
-	bulk_count = MIN(count, USBMSD_MAX_READ_WRITE_SECTORS);
+	bulk_count = tegrabl_usbmsd_bulk_count(context, xfer->buf, count);
 	if (xfer->xfer_type == TEGRABL_BLOCKDEV_READ)
 		is_write = false;
 	else
 		is_write = true;
 
+	tegrabl_usbmsd_setup_rw_cdb(context, is_write, block, bulk_count);
+	context->xfer_info.is_write = is_write;
+
 	xfer_length = (bulk_count << context->block_size_log2);
 	error = tegrabl_usbmsd_io(context, xfer->buf, xfer_length,
 				  TEGRABL_USBMSD_READ_TIMEOUT);
@@ -270,13 +343,6 @@ static tegrabl_error_t tegrabl_usbmsd_bdev_read_block(struct tegrabl_bdev *dev,
 		goto fail;
 	}
 
-	xfer_length = count * TEGRABL_BLOCKDEV_BLOCK_SIZE(dev);
-	if ((xfer_length > SZ_64K) && (IS_ALIGNED((uintptr_t)buffer, SZ_64K) == false)) {
-		error = TEGRABL_ERROR(TEGRABL_ERR_NOT_ALIGNED, 0);
-		TEGRABL_SET_ERROR_STRING(error, "buffer: %p", "64KB", buffer);
-		goto fail;
-	}
-
 	context = (struct tegrabl_usbmsd_context *)dev->priv_data;
 	if (context == NULL) {
 		error = TEGRABL_ERROR(TEGRABL_ERR_INVALID,
@@ -296,27 +362,14 @@ static tegrabl_error_t tegrabl_usbmsd_bdev_read_block(struct tegrabl_bdev *dev,
 		goto fail;
 	}
 
-	/* Set up SCSI CDB in here for READ_10 */
-	context->cmdlen = 10;
-	memset(context->cmd, 0x0, context->cmdlen);
-	context->cmd[0] = READ_10;
 	context->xfer_info.is_write = 0;	/* data comes from device */
 
 	pr_debug("start block = %d, count = %d\n", block, count);
 	while (count != 0U) {
-		bulk_count = MIN(count, USBMSD_MAX_READ_WRITE_SECTORS);
+		bulk_count = tegrabl_usbmsd_bulk_count(context, buf, count);
 
 		pr_debug("%s: bulk count = %d\n", __func__, bulk_count);
-		/*
-		 * Find a cleaner way of storing block/count in the CDB
-		 * NOTE: Assumes 32-bit LBA and 16-bit count, max!
-		 */
-		context->cmd[2] = ((uint8_t)(block >> 24)) & 0xFF;
-		context->cmd[3] = ((uint8_t)(block >> 16)) & 0xFF;
-		context->cmd[4] = ((uint8_t)(block >> 8)) & 0xFF;
-		context->cmd[5] = ((uint8_t)(block)) & 0xFF;
-		context->cmd[7] = ((uint8_t)(bulk_count >> 8)) & 0xFF;
-		context->cmd[8] = ((uint8_t)(bulk_count)) & 0xFF;
+		tegrabl_usbmsd_setup_rw_cdb(context, false, block, bulk_count);
 
 		xfer_length = (bulk_count << context->block_size_log2);
 		pr_debug("%s: xfer_length = %d\n", __func__, xfer_length);
@@ -399,26 +452,13 @@ static tegrabl_error_t tegrabl_usbmsd_bdev_write_block(struct tegrabl_bdev *dev,
 		goto fail;
 	}
 
-	/* Set up SCSI CDB in here for WRITE_10 */
-	context->cmdlen = 10;
-	memset(context->cmd, 0x0, context->cmdlen);
-	context->cmd[0] = WRITE_10;
 	context->xfer_info.is_write = 1;	/* data comes from host */
 
 	pr_debug("start block = %d, count = %d\n", block, count);
 	while (count > 0UL) {
-		bulk_count = MIN(count, USBMSD_MAX_READ_WRITE_SECTORS);
-
-		/*
-		 * Find a cleaner way of storing block/count in the CDB
-		 * NOTE: Assumes 32-bit LBA and 16-bit count, max!
-		 */
-		context->cmd[2] = ((uint8_t)(block >> 24)) & 0xFF;
-		context->cmd[3] = ((uint8_t)(block >> 16)) & 0xFF;
-		context->cmd[4] = ((uint8_t)(block >> 8)) & 0xFF;
-		context->cmd[5] = ((uint8_t)(block)) & 0xFF;
-		context->cmd[7] = ((uint8_t)(bulk_count >> 8)) & 0xFF;
-		context->cmd[8] = ((uint8_t)(bulk_count)) & 0xFF;
+		bulk_count = tegrabl_usbmsd_bulk_count(context, buf, count);
+
+		tegrabl_usbmsd_setup_rw_cdb(context, true, block, bulk_count);
 
 		xfer_length = (bulk_count << context->block_size_log2);
 		error = tegrabl_usbmsd_io(context, (void *)buf, xfer_length,
@@ -513,6 +553,8 @@ static void tegrabl_usbmsd_set_default_context(
 	pr_debug("Default Context\n");
 	context->instance = instance;
 	context->block_size_log2 = TEGRABL_USBMSD_SECTOR_SIZE_LOG2;
+	context->max_xfer_sectors = USBMSD_MAX_READ_WRITE_SECTORS;
+	context->use_cdb16 = false;
 }
 
 /**
@@ -525,7 +567,7 @@ static tegrabl_error_t tegrabl_usbmsd_register(
 {
 	tegrabl_error_t error = TEGRABL_NO_ERROR;
 	size_t block_size_log2 = context->block_size_log2;
-	bnum_t block_count = context->block_count;
+	bnum_t block_count;
 	struct tegrabl_bdev *user_dev = NULL;
 	uint32_t device_id = 0;
 
@@ -538,6 +580,14 @@ static tegrabl_error_t tegrabl_usbmsd_register(
 		goto fail;
 	}
 
+	/* Blocks past the range of bnum_t cannot be addressed */
+	if (context->block_count > (uint64_t)UINT32_MAX) {
+		pr_warn("usbmsd: only first %u of %" PRIu64 " blocks usable\n",
+			UINT32_MAX, context->block_count);
+		context->block_count = UINT32_MAX;
+	}
+	block_count = (bnum_t)context->block_count;
+
 	device_id = TEGRABL_STORAGE_USB_MS << 16 | context->instance;
 	pr_debug("usbmsd device id %08x", device_id);
 
@@ -773,6 +823,12 @@ tegrabl_error_t tegrabl_usbmsd_bdev_open(uint32_t instance)
 	context->out_ep = context->host_context.curr_dev_priv->enum_dev.ep[USB_DIR_OUT].addr;
 	context->in_ep = context->host_context.curr_dev_priv->enum_dev.ep[USB_DIR_IN].addr;
 
+	/* SuperSpeed devices keep up with larger commands */
+	if (context->host_context.curr_dev_priv->speed >= USBMSD_PORT_SPEED_SS) {
+		context->max_xfer_sectors = USBMSD_SS_MAX_READ_WRITE_SECTORS;
+	}
+	pr_debug("%u sectors per command\n", context->max_xfer_sectors);
+
 	context->tag = 0x1;		/* increment after each CSW xfer */
 
 	pr_debug("Initializing usbmsd controller\n");
@@ -1353,6 +1409,46 @@ fail:
 	return error;
 }
 
+/**
+ * @brief Gets the capacity of devices with more than 2^32 blocks. Such
+ * devices are accessed with READ(16)/WRITE(16) afterwards.
+ *
+ * @param context Context information
+ *
+ * @return TEGRABL_NO_ERROR if successful else appropriate error.
+ */
+static tegrabl_error_t tegrabl_usbmsd_read_capacity_16(
+					struct tegrabl_usbmsd_context *context)
+{
+	tegrabl_error_t error = TEGRABL_NO_ERROR;
+	uint32_t buf[USBMSD_READ_CAP_16_SIZE / sizeof(uint32_t)];
+	uint64_t max_lba;
+
+	context->cmdlen = 16;
+	memset(context->cmd, 0x0, context->cmdlen);
+	context->cmd[0] = SERVICE_ACTION_IN_16;
+	context->cmd[1] = SAI_READ_CAPACITY_16;
+	context->cmd[13] = USBMSD_READ_CAP_16_SIZE;
+	context->xfer_info.is_write = 0;	/* data comes from device */
+
+	error = tegrabl_usbmsd_io(context, &buf, USBMSD_READ_CAP_16_SIZE,
+				  TEGRABL_USBMSD_READ_TIMEOUT);
+	if (error != TEGRABL_NO_ERROR) {
+		pr_error("READ CAPACITY(16) returned error 0x%X ...\n", error);
+		return error;
+	}
+
+	/* Max LBA is 8 bytes, then 4 bytes of block size */
+	max_lba = ((uint64_t)be32tole32(buf[0]) << 32) | be32tole32(buf[1]);
+	pr_debug("Max LBA = 0x%" PRIx64 ", block size = %u\n", max_lba,
+		 be32tole32(buf[2]));
+
+	context->block_count = max_lba + 1ULL;
+	context->use_cdb16 = true;
+
+	return error;
+}
+
 tegrabl_error_t tegrabl_usbmsd_read_capacity(
 					struct tegrabl_usbmsd_context *context)
 {
@@ -1387,12 +1483,17 @@ tegrabl_error_t tegrabl_usbmsd_read_capacity(
 	buf[0] = be32tole32(buf[0]);	/* Max LBA */
 	buf[1] = be32tole32(buf[1]);	/* Block size */
 
-	/* TBD: If FFFFFFFFh is returned, use READ_CAPACITY(16)? */
 	pr_debug("Max LBA (buf[0]) = 0x%X, block size (buf[1]) = %u\n",
-		 (buf[0])+1, buf[1]);
+		 buf[0], buf[1]);
 
-	if (error == TEGRABL_NO_ERROR)
-		context->block_count = (uint64_t)(buf[0] + 1);
+	if (error == TEGRABL_NO_ERROR) {
+		if (buf[0] == 0xFFFFFFFFU) {
+			/* Too large for READ_CAPACITY(10) */
+			error = tegrabl_usbmsd_read_capacity_16(context);
+		} else {
+			context->block_count = (uint64_t)buf[0] + 1ULL;
+		}
+	}
 
 	/* TBD: Use buf[1] from READ_CAP as block size? (s/b 512) */
 
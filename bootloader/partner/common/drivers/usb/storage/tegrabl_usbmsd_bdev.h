@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2018-2021, NVIDIA CORPORATION.  All rights reserved.
  *
  * NVIDIA CORPORATION and its licensors retain all intellectual property
  * and proprietary rights in and to this software, related documentation
@@ -19,6 +19,12 @@
 #define USBMSD_BUFFER_ALIGNMENT		(4096)
 #define TEGRABL_USB_BUF_ALIGN_SIZE	8
 #define USBMSD_MAX_READ_WRITE_SECTORS	128 /* TODO: This is a WAR for usb read/write to work */
+/* Per command limit on SuperSpeed links, 1MB with 512 byte sectors */
+#define USBMSD_SS_MAX_READ_WRITE_SECTORS	2048
+/* Port speed ID of a SuperSpeed link, as reported in PORTSC */
+#define USBMSD_PORT_SPEED_SS	4
+/* Response size of READ CAPACITY(16) */
+#define USBMSD_READ_CAP_16_SIZE	32
 
 #define TEGRABL_USBMSD_WRITE_TIMEOUT		1000000	/* usec */
 #define TEGRABL_USBMSD_READ_TIMEOUT		1000000	/* usec */
@@ -89,6 +95,10 @@ struct tegrabl_usbmsd_context {
 	size_t block_size_log2;
 	/* Number of blocks in device */
 	uint64_t block_count;
+	/* Most blocks moved by one READ/WRITE command */
+	uint32_t max_xfer_sectors;
+	/* Device needs READ(16)/WRITE(16), it has more than 2^32 blocks */
+	bool use_cdb16;
 	/* Device-specific transfer info */
 	struct tegrabl_usbmsd_xfer_info xfer_info;
 	/* host context with descriptor info, etc. from dev enumeration */
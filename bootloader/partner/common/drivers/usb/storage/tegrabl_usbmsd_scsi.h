@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2018-2021, NVIDIA CORPORATION.  All rights reserved.
  *
  * NVIDIA CORPORATION and its licensors retain all intellectual property
  * and proprietary rights in and to this software, related documentation
@@ -25,6 +25,9 @@
 #define READ_10			0x28
 #define WRITE_10		0x2A
 #define VERIFY_10		0x2F
+#define READ_16			0x88
+#define WRITE_16		0x8A
+#define SERVICE_ACTION_IN_16	0x9E
 #define MODE_SELECT_10		0x55
 #define MODE_SENSE_10		0x5A
 #define REPORT_LUNS		0xA0
@@ -32,4 +35,7 @@
 #define WRITE_12		0xAA
 #define VERIFY_12		0xAF
 
+/* SERVICE ACTION IN(16) service actions */
+#define SAI_READ_CAPACITY_16	0x10
+
 #endif	/* TEGRABL_USBMSD_SCSI_H */
@@ -1717,6 +1717,7 @@ fail:
 }
 
 #define MAX_TX_LENGTH   0x10000
+#define TD_SIZE_MAX     31U
 tegrabl_error_t tegrabl_xhci_xfer_data(struct xusb_host_context *ctx,
 				uint8_t ep_id, void *buffer, uint32_t *length)
 {
@@ -1769,13 +1770,22 @@ tegrabl_error_t tegrabl_xhci_xfer_data(struct xusb_host_context *ctx,
 	size = 0;
 	while (count < need_trbs) {
 		trb = (struct normal_trb *)ep_ring->enque_curr_ptr;
+		/*
+		 * Ring slots are reused, so drop the CH/IOC/ISP bits of an earlier TD. The
+		 * first TRB is handed over last, by xhci_ring_doorbell_wait().
+		 */
+		memset(trb, 0, sizeof(struct TRB));
 		if (ep_ring->enque_curr_ptr != ep_ring->enque_start_ptr) {
 			trb->cycle_bit = ep_ring->cycle_state;
+		} else {
+			trb->cycle_bit = ep_ring->cycle_state ^ 1U;
 		}
 		trb->data_buffer_lo = U64_TO_U32_LO(dma);
 		trb->data_buffer_hi = U64_TO_U32_HI(dma);
 		trb->trb_tfr_len = transfer_size;
-		trb->td_size = (total_packets - ((size + transfer_size) / ctx->curr_dev_priv->enum_dev.ep[dir].packet_size));
+		/* TD Size saturates, the field is 5 bits wide */
+		trb->td_size = MIN(total_packets - ((size + transfer_size) /
+						   ctx->curr_dev_priv->enum_dev.ep[dir].packet_size), TD_SIZE_MAX);
 		if (count != (need_trbs - 1)) {
 			trb->CH = 1;
 		} else {
@@ -1793,6 +1803,9 @@ tegrabl_error_t tegrabl_xhci_xfer_data(struct xusb_host_context *ctx,
 			transfer_size = MAX_TX_LENGTH;
 		}
 		count++;
+		/* Clean each TRB on its own, the TD may wrap past the link TRB */
+		tegrabl_dma_map_buffer(TEGRABL_MODULE_XUSB_HOST, 0, (void *)trb, sizeof(struct TRB),
+							   TEGRABL_DMA_TO_DEVICE);
 		set_enq_ptr(ep_ring);
 
 		t = (struct TRB *)trb;
@@ -1800,7 +1813,7 @@ tegrabl_error_t tegrabl_xhci_xfer_data(struct xusb_host_context *ctx,
 				t->field[2], t->field[3]);
 	}
 	ep_ring->dma = tegrabl_dma_map_buffer(TEGRABL_MODULE_XUSB_HOST, 0, (void *)ep_ring->enque_start_ptr,
-					  sizeof(struct TRB) * need_trbs, TEGRABL_DMA_TO_DEVICE);
+					  sizeof(struct TRB), TEGRABL_DMA_TO_DEVICE);
 
 	/* prepare ep context */
 	/* ring ep doorbell and wait*/
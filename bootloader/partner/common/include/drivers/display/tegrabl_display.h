@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, NVIDIA Corporation.  All rights reserved.
+ * Copyright (c) 2016-2021, NVIDIA Corporation.  All rights reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property
  * and proprietary rights in and to this software, related documentation
@@ -24,6 +24,25 @@
  */
 tegrabl_error_t tegrabl_display_init(void);
 
+/**
+ *  @brief Starts initializing the display on a background thread when
+ *  CONFIG_ENABLE_DISPLAY_THREAD is set, else initializes it in place. The
+ *  thread runs one display unit at a time whenever tegrabl_background_yield()
+ *  is called, the other display functions run it to completion.
+ *
+ *  @return TEGRABL_NO_ERROR if success, error code if fails.
+ */
+tegrabl_error_t tegrabl_display_init_async(void);
+
+/**
+ *  @brief Waits for a display initialization started by
+ *  tegrabl_display_init_async()
+ *
+ *  @return TEGRABL_NO_ERROR if the display is initialized or no
+ *  initialization is in progress, error code of the initialization if fails.
+ */
+tegrabl_error_t tegrabl_display_wait_ready(void);
+
 /**
  *  @brief Prints the given text in given color on display
  *
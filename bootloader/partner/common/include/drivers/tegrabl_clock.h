@@ -241,7 +241,8 @@ void tegrabl_car_disable_plle(void);
 tegrabl_error_t tegrabl_usbf_clock_init(void);
 
 /**
- * @brief powergate XUSBA and XUSBC partitions
+ * @brief powergate XUSBA and XUSBC partitions. On BPMP based platforms the
+ * requests are only posted, tegrabl_ccplex_bpmp_flush() collects them.
  *
  * @return TEGRABL_NO_ERROR if success, error-reason otherwise.
  */
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ */
+
+#ifndef INCLUDED_TEGRABL_DMA_COPY_H
+#define INCLUDED_TEGRABL_DMA_COPY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <tegrabl_error.h>
+
+/**
+ * @brief Fence returned by a copy submission. Fences complete in the order
+ * they were handed out, 0 is never returned and is always complete.
+ */
+typedef uint32_t tegrabl_dma_fence_t;
+
+/**
+ * @brief Scatter-gather element of a copy submission
+ *
+ * @param dst destination buffer
+ * @param src source buffer
+ * @param size number of bytes to copy
+ */
+struct tegrabl_dma_copy_sg {
+	void *dst;
+	const void *src;
+	size_t size;
+};
+
+/**
+ * @brief Queue a memory to memory copy. Large copies are split across the
+ * GPCDMA channels reserved for the copy engine, the unaligned head and tail
+ * and copies that are small, overlapping or not word aligned relative to each
+ * other are done by the CPU before returning. Without CONFIG_ENABLE_DMA_COPY
+ * every copy is done by the CPU and the fence is complete on return.
+ *
+ * Neither buffer may be accessed by the CPU until the fence completes. The
+ * segments of all copies in flight run in any order, so a copy overlapping
+ * the buffers of another one still in flight is rejected. A channel that
+ * hangs is aborted and its segment copied by the CPU. If the channel does
+ * not stop it is not used again and the fence fails with TEGRABL_ERR_TIMEOUT.
+ *
+ * @param dst destination buffer
+ * @param src source buffer
+ * @param size number of bytes to copy
+ * @param fence returns the fence of the copy, can be NULL
+ *
+ * @return TEGRABL_NO_ERROR if the copy was queued, TEGRABL_ERR_BUSY if it
+ * overlaps a copy in flight
+ */
+tegrabl_error_t tegrabl_dma_copy_submit(void *dst, const void *src, size_t size,
+										tegrabl_dma_fence_t *fence);
+
+/**
+ * @brief Queue a list of copies under a single fence
+ *
+ * @param sg list of copies
+ * @param count number of elements in sg
+ * @param fence returns the fence of the copies, can be NULL
+ *
+ * @return TEGRABL_NO_ERROR if the copies were queued, TEGRABL_ERR_BUSY if one
+ * overlaps a copy in flight, TEGRABL_ERR_BAD_PARAMETER if they overlap each other
+ */
+tegrabl_error_t tegrabl_dma_copy_submit_sg(const struct tegrabl_dma_copy_sg *sg, uint32_t count,
+										   tegrabl_dma_fence_t *fence);
+
+/**
+ * @brief Check if a fence completed. Also retires finished channels and
+ * starts queued copies, so long running CPU work may call this to keep the
+ * channels busy.
+ *
+ * @param fence fence from a submission
+ *
+ * @return true if all copies up to and including the fence are done
+ */
+bool tegrabl_dma_copy_is_done(tegrabl_dma_fence_t fence);
+
+/**
+ * @brief Wait until a fence completes
+ *
+ * @param fence fence from a submission
+ *
+ * @return TEGRABL_NO_ERROR once the copies are visible to the CPU,
+ * TEGRABL_ERR_TIMEOUT if a channel of the fence could not be stopped after
+ * hanging, TEGRABL_ERR_INVALID if the fence was never handed out
+ */
+tegrabl_error_t tegrabl_dma_copy_wait(tegrabl_dma_fence_t fence);
+
+#endif /* INCLUDED_TEGRABL_DMA_COPY_H */
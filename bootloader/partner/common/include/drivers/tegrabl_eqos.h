@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, NVIDIA Corporation.  All rights reserved.
+ * Copyright (c) 2018-2021, NVIDIA Corporation.  All rights reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property
  * and proprietary rights in and to this software, related documentation
@@ -15,7 +15,9 @@
 
 tegrabl_error_t tegrabl_eqos_init(void);
 void tegrabl_eqos_send(void *packet, size_t len);
-void tegrabl_eqos_receive(void *packet, size_t *len);
+/* Copies the next frame into packet, *len is set even if it exceeds size */
+void tegrabl_eqos_receive(void *packet, size_t size, size_t *len);
+bool tegrabl_eqos_is_rx_pending(void);
 bool tegrabl_eqos_is_dma_rx_intr_occured(void);
 void tegrabl_eqos_set_mac_addr(uint8_t * const addr);
 void tegrabl_eqos_clear_dma_rx_intr(void);
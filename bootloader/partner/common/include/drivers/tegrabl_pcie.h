@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2020, NVIDIA CORPORATION.  All Rights Reserved.
+ * Copyright (c) 2019-2021, NVIDIA CORPORATION.  All Rights Reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property and
  * proprietary rights in and to this software and related documentation.  Any
@@ -113,11 +113,44 @@ static inline uint32_t tegrabl_pci_resource_start(struct tegrabl_pcie_dev *pdev,
 	return ((pdev)->bar[(index)].start);
 }
 
+/**
+ * @brief Powers up the Host PCIE controller and starts link training without
+ * waiting for the link. Several controllers can be started back to back and
+ * then collected with tegrabl_pcie_wait_link_up() or tegrabl_pcie_init().
+ *
+ * @param[in] ctrl_num Controller number which needs to be started
+ * @param[in] flags Specifies configuration information like link speed Etc.
+ *                  Bits[2:0] : Specify the link speed
+ *
+ * @return TEGRABL_NO_ERROR if successful or already started, appropriate error otherwise
+ */
+tegrabl_error_t tegrabl_pcie_start(uint8_t ctrl_num, uint32_t flags);
+
+/**
+ * @brief Polls the link of all listed controllers started with
+ * tegrabl_pcie_start() and returns the first one to come up.
+ *
+ * @param[in,out] ctrl_nums List of controller numbers terminated with -1.
+ *                          Returned controllers and the ones which failed
+ *                          to link up are removed from the list.
+ *
+ * @return Controller number whose link is up, -1 if none is left training
+ */
+int8_t tegrabl_pcie_wait_link_up(int8_t *ctrl_nums);
+
+/**
+ * @brief Puts a controller started with tegrabl_pcie_start() back in reset,
+ * does nothing if it is not started or failed to link up
+ *
+ * @param[in] ctrl_num Controller number
+ */
+void tegrabl_pcie_stop(uint8_t ctrl_num);
+
 /**
  * @brief Performs initialization of the Host PCIE controller.
  *
  * Below are the steps performed by this API:
- * - Initialize Host controller
+ * - Initialize Host controller, unless tegrabl_pcie_start() already did
  * - Check for PCIe link up
  * - Enumerate connected device that includes
  * - Mapping of endpoint device's resouces into host system memory
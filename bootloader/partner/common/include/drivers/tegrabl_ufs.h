@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2020, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2017-2021, NVIDIA CORPORATION.  All rights reserved.
  *
  * NVIDIA CORPORATION and its licensors retain all intellectual property
  * and proprietary rights in and to this software, related documentation
@@ -11,6 +11,10 @@
 #ifndef INCLUDED_TEGRABL_UFS_H
 #define INCLUDED_TEGRABL_UFS_H
 
+#include <stdint.h>
+#include <stdbool.h>
+#include <tegrabl_error.h>
+
 #define UFS_NO_HS_GEAR	0
 #define UFS_HS_GEAR_1	1
 #define UFS_HS_GEAR_2	2
@@ -94,6 +98,48 @@ struct tegrabl_ufs_platform_params {
 	bool skip_hs_mode_switch;
 };
 
+#define TEGRABL_UFS_PWR_MODE_MAGIC	0x50534655U /* "UFSP" */
+
+/*
+ * @brief struct tegrabl_ufs_pwr_mode_record - HS power mode negotiated with a
+ * UFS device, cached across boots by tegrabl_ufs_complete_hs_mode().
+ *
+ * @magic: TEGRABL_UFS_PWR_MODE_MAGIC when the record is valid
+ * @manufacture_id: manufacturer id of the device it was negotiated with
+ * @max_hs_mode: max_hs_mode of the platform params it was negotiated under
+ * @max_active_lanes: max_active_lanes of the platform params
+ * @tx_gear: PA_TxGear
+ * @rx_gear: PA_RxGear
+ * @tx_lanes: PA_ActiveTxDataLanes
+ * @rx_lanes: PA_ActiveRxDataLanes
+ * @hs_series: PA_HSSeries, UFS_HS_RATE_A or UFS_HS_RATE_B
+ * @termination: PA_TxTermination and PA_RxTermination
+ */
+struct tegrabl_ufs_pwr_mode_record {
+	uint32_t magic;
+	uint16_t manufacture_id;
+	uint8_t max_hs_mode;
+	uint8_t max_active_lanes;
+	uint8_t tx_gear;
+	uint8_t rx_gear;
+	uint8_t tx_lanes;
+	uint8_t rx_lanes;
+	uint8_t hs_series;
+	uint8_t termination;
+};
+
+/**
+ * @brief Finish the HS mode switch that UFS init defers with
+ * CONFIG_ENABLE_UFS_PWR_MODE_CACHE, once the partition manager is up. The
+ * power mode recorded in the UFS-PWRMODE partition is programmed in a single
+ * PA_PWRMODE change if it matches the device and platform limits, else the
+ * power mode is negotiated and the record is refreshed.
+ *
+ * @return TEGRABL_NO_ERROR if UFS is in HS mode or no switch was pending,
+ * else the error of the switch.
+ */
+tegrabl_error_t tegrabl_ufs_complete_hs_mode(void);
+
 uint32_t tegrabl_ufs_get_attribute(uint32_t *pufsattrb, uint32_t attrbidn, uint8_t attrbindex);
 uint32_t tegrabl_ufs_get_descriptor(uint8_t *pufsdesc, uint8_t descidn, uint8_t desc_index);
 uint32_t tegrabl_ufs_set_attribute(uint32_t *pufsattrb, uint32_t attrbidn, uint8_t attrbindex);
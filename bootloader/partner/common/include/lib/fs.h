@@ -37,6 +37,7 @@ enum fs_ioctl_num {
     FS_IOCTL_NULL = 0,
     FS_IOCTL_GET_FILE_ADDR,
     FS_IOCTL_IS_LINEAR,         // If supported, determine if the underlying device is in linear mode.
+    FS_IOCTL_GET_FILE_MAP,      // If supported, return the identity and device extents of the file (struct file_map).
 };
 
 struct file_stat {
@@ -45,6 +46,33 @@ struct file_stat {
     uint64_t capacity;
 };
 
+// on-disk identity of a file, changes whenever the file is rewritten or replaced
+struct file_ident {
+    uint32_t inode;
+    uint32_t generation;
+    uint32_t mtime;
+    uint32_t ctime;
+    uint64_t size;
+    uint32_t map_crc;           // crc32 of the block map stored in the inode
+    uint32_t reserved;
+};
+
+#define FS_MAX_FILE_EXTENTS 32
+
+// a run of file data, offsets in bytes from the start of the file and the block device
+struct file_extent {
+    uint64_t file_offset;
+    uint64_t dev_offset;
+    uint64_t len;
+};
+
+struct file_map {
+    struct file_ident ident;
+    uint32_t num_extents;
+    uint32_t reserved;
+    struct file_extent extents[FS_MAX_FILE_EXTENTS];
+};
+
 struct fs_stat {
     uint64_t free_space;
     uint64_t total_space;
@@ -98,6 +126,9 @@ status_t fs_close_dir(dirhandle *handle) __NONNULL();
 
 status_t fs_stat_fs(const char *mountpoint, struct fs_stat *stat) __NONNULL((1)) __NONNULL((2));
 
+/* read the identity of an inode without walking any path, to revalidate a cached file map */
+status_t fs_stat_inode(const char *mountpoint, uint32_t inode, struct file_ident *ident) __NONNULL((1)) __NONNULL((3));
+
 /* convenience routines */
 ssize_t fs_load_file(const char *path, void *ptr, size_t maxlen) __NONNULL();
 
@@ -134,6 +165,7 @@ struct fs_api {
     status_t (*closedir)(dircookie *) __NONNULL();
 
     status_t (*file_ioctl)(filecookie *, int, void *);
+    status_t (*stat_inode)(fscookie *, uint32_t, struct file_ident *);
 };
 
 struct fs_impl {
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ */
+
+#ifndef INCLUDED_TEGRABL_BACKGROUND_H
+#define INCLUDED_TEGRABL_BACKGROUND_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <tegrabl_error.h>
+
+#if defined(CONFIG_ENABLE_BACKGROUND_TASKS)
+#include <kernel/thread.h>
+#include <kernel/event.h>
+
+/* Stack of a background task thread */
+#ifndef TEGRABL_BACKGROUND_STACK_SIZE
+#define TEGRABL_BACKGROUND_STACK_SIZE (16U * 1024U)
+#endif
+
+/**
+ * @brief Task callback. Unlike a work-queue job it runs on the boot core
+ * as an LK thread and may use drivers, the heap and the console. It may call
+ * tegrabl_background_yield() but must not start or wait for other tasks.
+ */
+typedef tegrabl_error_t (*tegrabl_background_fn_t)(void *arg);
+
+/**
+ * @brief Background task, owned by the caller until it is collected with
+ * tegrabl_background_wait()
+ *
+ * @param fn task callback
+ * @param arg argument to the callback
+ * @param err return value of the callback, valid once done
+ * @param started task was started and not yet collected
+ * @param done callback returned
+ * @param thread thread running the callback, NULL if it ran in place
+ * @param run signalled to lend the task the CPU
+ * @param paused signalled when the task yields or returns
+ */
+struct tegrabl_background_task {
+	tegrabl_background_fn_t fn;
+	void *arg;
+	tegrabl_error_t err;
+	bool started;
+	volatile bool done;
+	thread_t *thread;
+	event_t run;
+	event_t paused;
+};
+
+/**
+ * @brief Start a task on its own thread. Bootloader code is not thread safe,
+ * so the task does not run until a caller of tegrabl_background_yield() or
+ * tegrabl_background_wait() lends it the CPU, and that caller blocks until
+ * the task yields back or returns. Nothing switches inside delays, only at
+ * explicit tegrabl_background_yield() calls.
+ *
+ * Falls back to running the callback before returning if no thread could be
+ * created.
+ *
+ * @param task task to start, must not be started already
+ * @param name thread name
+ * @param fn task callback
+ * @param arg argument to the callback
+ *
+ * @return TEGRABL_NO_ERROR if the task was started or has run
+ */
+tegrabl_error_t tegrabl_background_start(struct tegrabl_background_task *task,
+										 const char *name,
+										 tegrabl_background_fn_t fn, void *arg);
+
+/**
+ * @brief Check if a task is started and not yet collected
+ *
+ * @param task task to check
+ *
+ * @return true if the task must still be waited for
+ */
+bool tegrabl_background_pending(struct tegrabl_background_task *task);
+
+/**
+ * @brief Run a task until it finishes and collect its result. Must be
+ * called for every started task, not from a task.
+ *
+ * @param task task to wait for
+ *
+ * @return return value of the task callback, TEGRABL_ERR_NOT_STARTED if the
+ * task was not started
+ */
+tegrabl_error_t tegrabl_background_wait(struct tegrabl_background_task *task);
+
+/**
+ * @brief Called from a task, hands the CPU back to the thread that lent it.
+ * Called from any other thread, lends the CPU to each pending task until it
+ * yields or finishes.
+ *
+ * Only call it with no driver operation of the caller's own in flight that
+ * a task could touch, e.g. while polling a started transfer but not while
+ * holding a controller lock. The task may run for milliseconds, so a polling
+ * loop must check the hardware status before its timeout.
+ */
+void tegrabl_background_yield(void);
+
+#else
+
+static inline void tegrabl_background_yield(void)
+{
+}
+
+#endif /* CONFIG_ENABLE_BACKGROUND_TASKS */
+
+#endif /* INCLUDED_TEGRABL_BACKGROUND_H */
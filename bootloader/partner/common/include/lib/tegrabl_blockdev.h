@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2020, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2015-2021, NVIDIA CORPORATION.  All rights reserved.
  *
  * NVIDIA CORPORATION and its licensors retain all intellectual property
  * and proprietary rights in and to this software, related documentation
@@ -34,7 +34,8 @@ typedef uint64_t off_t;
 #define TEGRABL_IOCTL_GET_RPMB_WRITE_COUNTER   6U
 #define TEGRABL_IOCTL_BLOCK_DEV_SUSPEND	       7U
 #define TEGRABL_IOCTL_SEND_STATUS		       8U
-#define TEGRABL_IOCTL_INVALID                  9U
+#define TEGRABL_IOCTL_ERASE_SIZE               9U
+#define TEGRABL_IOCTL_INVALID                  10U
 
 #define TEGRABL_BLOCKDEV_WRITE			1U
 #define TEGRABL_BLOCKDEV_READ			2U
@@ -65,6 +66,15 @@ struct tegrabl_blockdev_xfer_info {
 	uint8_t xfer_status;
 };
 
+/**
+* @brief One segment of a vectored transfer, see tegrabl_blockdev_xfer_list()
+*/
+struct tegrabl_blockdev_xfer_segment {
+	void *buf;
+	bnum_t start_block;
+	bnum_t block_count;
+};
+
 #define TEGRABL_BLOCK_DEVICE_ID(storage_type, instance) \
 	((storage_type) << 16 | (instance))
 
@@ -125,6 +135,8 @@ typedef struct tegrabl_bdev {
 		bnum_t block, bnum_t count);
 	tegrabl_error_t (*xfer)(struct tegrabl_blockdev_xfer_info *xfer);
 	tegrabl_error_t (*xfer_wait)(struct tegrabl_blockdev_xfer_info *xfer, time_t timeout, uint8_t *status_flag);
+	tegrabl_error_t (*xfer_list)(struct tegrabl_bdev *dev, uint8_t xfer_type,
+		struct tegrabl_blockdev_xfer_segment *segs, uint32_t num_segs);
 	tegrabl_error_t (*erase)(struct tegrabl_bdev *dev, bnum_t block, bnum_t count,
 		bool is_secure);
 	tegrabl_error_t (*erase_all)(struct tegrabl_bdev *dev, bool is_secure);
@@ -281,7 +293,7 @@ tegrabl_error_t tegrabl_blockdev_erase_all(tegrabl_bdev_t *dev, bool is_secure);
  *
  * @param xfer transfer info
  *
- * @returin TEGRABL_NO_ERROR if success, error code if fails.
+ * @return TEGRABL_NO_ERROR if success, error code if fails.
  */
 tegrabl_error_t tegrabl_blockdev_xfer(struct tegrabl_blockdev_xfer_info *xfer);
 
@@ -292,11 +304,28 @@ tegrabl_error_t tegrabl_blockdev_xfer(struct tegrabl_blockdev_xfer_info *xfer);
 * @param timeout  time to wait for the transfer in us
 * @param xfer status_flag Address of the status flag. XFER_IN_PROGRESS, XFER_COMPLETE
 
-* @returin TEGRABL_NO_ERROR if success, error code if fails.
+* @return TEGRABL_NO_ERROR if success, error code if fails.
 */
 tegrabl_error_t tegrabl_blockdev_xfer_wait(struct tegrabl_blockdev_xfer_info *xfer, time_t timeout,
 		uint8_t *status_flag);
 
+/**
+* @brief Reads or writes a list of segments as one request. Drivers with a
+* xfer_list hook (UFS) issue one command per run of segments that follow each
+* other on the device, whatever their buffers, for the others the
+* segments are transferred one after another, merging the ones that are
+* contiguous both on the device and in memory.
+*
+* @param dev Block device handle.
+* @param xfer_type TEGRABL_BLOCKDEV_READ or TEGRABL_BLOCKDEV_WRITE
+* @param segs segments to transfer, buffers must meet the alignment of the device
+* @param num_segs number of segments
+*
+* @return TEGRABL_NO_ERROR if success, error code if fails.
+*/
+tegrabl_error_t tegrabl_blockdev_xfer_list(tegrabl_bdev_t *dev, uint8_t xfer_type,
+		struct tegrabl_blockdev_xfer_segment *segs, uint32_t num_segs);
+
 /** @brief Executes given ioctl
  *
  *  @param dev Block device handle.
@@ -325,6 +354,15 @@ tegrabl_error_t tegrabl_blockdev_register_device(tegrabl_bdev_t *dev);
  */
 tegrabl_error_t tegrabl_blockdev_unregister_device(tegrabl_bdev_t *dev);
 
+/** @brief Moves a registered block device to the end of the device list,
+ *  for callers which bring up devices out of order
+ *
+ *  @param dev Block device handle.
+ *
+ *  @return TEGRABL_NO_ERROR if success, error code if fails.
+ */
+tegrabl_error_t tegrabl_blockdev_move_to_tail(tegrabl_bdev_t *dev);
+
 /** @brief Initializes the given block device
  *
  *  @param dev Block device handle.
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2016-2021, NVIDIA CORPORATION.  All rights reserved.
  *
  * NVIDIA CORPORATION and its licensors retain all intellectual property
  * and proprietary rights in and to this software, related documentation
@@ -18,7 +18,44 @@
 #ifndef INCLUDED_TEGRABL_BPMP_FW_INTERFACE_H
 #define INCLUDED_TEGRABL_BPMP_FW_INTERFACE_H
 
+#include <stdint.h>
+#include <stdbool.h>
 #include <tegrabl_error.h>
+#include <tegrabl_timer.h>
+
+struct tegrabl_bpmp_mrq;
+
+/**
+ * @brief Completion callback of an asynchronous MRQ. It is invoked from
+ * tegrabl_ccplex_bpmp_process() once BPMP has acked the request, with the
+ * response already copied into the request's resp buffer.
+ *
+ * @param req Completed request, req->status holds the result
+ */
+typedef void (*tegrabl_bpmp_mrq_cb_t)(struct tegrabl_bpmp_mrq *req);
+
+/**
+ * @brief Asynchronous MRQ descriptor. Storage is owned by the caller and
+ * must stay valid until the request completes (req->done is set).
+ */
+struct tegrabl_bpmp_mrq {
+	/* MRQ_ID as per the bpmp-abi */
+	uint32_t mrq;
+	/* Request payload and size */
+	void *req;
+	uint32_t req_size;
+	/* Optional response buffer and size */
+	void *resp;
+	uint32_t resp_size;
+	/* Optional completion callback and its private data */
+	tegrabl_bpmp_mrq_cb_t cb;
+	void *priv;
+	/* Filled in by the IPC layer */
+	tegrabl_error_t status;
+	volatile bool done;
+	time_t start_us;
+	struct tegrabl_bpmp_mrq *next;
+};
 
 /**
  * @brief Performs CCPLEX <-> BPMP IPC initialization.
@@ -48,4 +85,43 @@ tegrabl_error_t tegrabl_ccplex_bpmp_xfer(
 		uint32_t size_in,
 		uint32_t mrq);
 
+/**
+ * @brief Queue a request for BPMP without waiting for the response. Requests
+ * are dispatched to the IVC channel in submission order as soon as the
+ * channel frees up. BPMP serves one request at a time, posting lets the
+ * caller do other work while it does, it does not save round-trips.
+ *
+ * @param req Caller owned request descriptor
+ *
+ * @retval TEGRABL_NO_ERROR if the request was queued, or the error code.
+ */
+tegrabl_error_t tegrabl_ccplex_bpmp_post(struct tegrabl_bpmp_mrq *req);
+
+/**
+ * @brief Make progress on the posted requests without blocking: completes the
+ * in-flight request if BPMP has acked it and dispatches the next queued one.
+ * Callers that post requests and go on with other work can call it from
+ * their own wait loops to keep the queue moving.
+ *
+ * @retval true if requests are still pending, false if the queue is idle.
+ */
+bool tegrabl_ccplex_bpmp_process(void);
+
+/**
+ * @brief Wait until the given request completes.
+ *
+ * @param req Request previously passed to tegrabl_ccplex_bpmp_post()
+ *
+ * @retval status of the request
+ */
+tegrabl_error_t tegrabl_ccplex_bpmp_wait(struct tegrabl_bpmp_mrq *req);
+
+/**
+ * @brief Wait until all posted requests complete.
+ *
+ * @retval TEGRABL_NO_ERROR if all requests posted since the queue was last
+ *         idle succeeded, else the first error among them.
+ */
+tegrabl_error_t tegrabl_ccplex_bpmp_flush(void);
+
 #endif /* INCLUDED_TEGRABL_BPMP_FW_INTERFACE_H */
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2021, NVIDIA Corporation.  All Rights Reserved.
+ *
+ * NVIDIA Corporation and its licensors retain all intellectual property and
+ * proprietary rights in and to this software and related documentation.  Any
+ * use, reproduction, disclosure or distribution of this software and related
+ * documentation without an express license agreement from NVIDIA Corporation
+ * is strictly prohibited.
+ */
+
+#ifndef INCLUDED_TEGRABL_CACHE_RECORD_H
+#define INCLUDED_TEGRABL_CACHE_RECORD_H
+
+#include <stdint.h>
+#include <tegrabl_error.h>
+
+/**
+ * @brief Read a record that an earlier boot cached in an optional partition.
+ * The record is stored behind a header with its version, size and CRC32, and
+ * is only returned if all of them match.
+ *
+ * @param part_name partition holding the record
+ * @param version layout version of the record, bump it when the layout changes
+ * @param buf buffer for the record
+ * @param size size of the record
+ *
+ * @return TEGRABL_NO_ERROR if buf holds a valid record, TEGRABL_ERR_INVALID
+ * if the partition holds no valid record (buf is then undefined), any other
+ * error if the partition cannot be used.
+ */
+tegrabl_error_t tegrabl_cache_record_load(const char *part_name, uint32_t version,
+										  void *buf, uint32_t size);
+
+/**
+ * @brief Cache a record in an optional partition for the next boot
+ *
+ * @param part_name partition to hold the record
+ * @param version layout version of the record
+ * @param buf record to store
+ * @param size size of the record
+ *
+ * @return TEGRABL_NO_ERROR if the record was written, else the error. Caches
+ * are rebuilt when missing, so callers usually only warn on failure.
+ */
+tegrabl_error_t tegrabl_cache_record_store(const char *part_name, uint32_t version,
+										   const void *buf, uint32_t size);
+
+#endif /* INCLUDED_TEGRABL_CACHE_RECORD_H */
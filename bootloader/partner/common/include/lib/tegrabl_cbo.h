@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2020, NVIDIA Corporation.  All Rights Reserved.
+ * Copyright (c) 2018-2021, NVIDIA Corporation.  All Rights Reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property and
  * proprietary rights in and to this software and related documentation.  Any
@@ -37,6 +37,7 @@ struct ip_info {
 	uint8_t ip_netmask[4];
 	uint8_t ip_gateway[4];
 	uint8_t tftp_server_ip[4];
+	uint16_t http_server_port;	/* 0: download over TFTP */
 };
 
 struct cbo_info {
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014-2016, NVIDIA Corporation.  All Rights Reserved.
+ * Copyright (c) 2014-2021, NVIDIA Corporation.  All Rights Reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property and
  * proprietary rights in and to this software and related documentation.  Any
@@ -104,6 +104,46 @@ tegrabl_error_t do_decompress(decompressor *decomp, uint8_t *read_buffer,
 							  uint32_t read_size, uint8_t *out_buffer,
 							  uint32_t *outbuf_size);
 
+struct tegrabl_zstd_stream;
+
+/**
+ * @brief: start a streaming zstd decompression, for content that is read in
+ *         chunks. Only available when the zstd decompressor is built in.
+ *
+ * @param out_buffer: buffer receiving the whole decompressed content
+ * @param outbuf_size: size of out_buffer
+ * @param stream: returns the stream handle
+ *
+ * @return error status
+ */
+tegrabl_error_t tegrabl_zstd_stream_open(void *out_buffer, uint32_t outbuf_size,
+										 struct tegrabl_zstd_stream **stream);
+
+/**
+ * @brief: feed the next chunk of compressed data, chunks may split frames
+ *         and blocks anywhere
+ *
+ * @param stream: handle from tegrabl_zstd_stream_open
+ * @param in_buffer: compressed data
+ * @param in_size: size of in_buffer
+ *
+ * @return error status
+ */
+tegrabl_error_t tegrabl_zstd_stream_write(struct tegrabl_zstd_stream *stream,
+										  const void *in_buffer,
+										  uint32_t in_size);
+
+/**
+ * @brief: finish a streaming decompression and release its workspace
+ *
+ * @param stream: handle from tegrabl_zstd_stream_open
+ * @param written_size: returns the decompressed data size, can be NULL
+ *
+ * @return error if the input ended in the middle of a frame
+ */
+tegrabl_error_t tegrabl_zstd_stream_close(struct tegrabl_zstd_stream *stream,
+										  uint32_t *written_size);
+
 #if defined(__cplusplus)
 }
 #endif
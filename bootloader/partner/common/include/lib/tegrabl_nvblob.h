@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014-2017, NVIDIA Corporation.  All Rights Reserved.
+ * Copyright (c) 2014-2021, NVIDIA Corporation.  All Rights Reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property and
  * proprietary rights in and to this software and related documentation.  Any
@@ -229,14 +229,14 @@ tegrabl_error_t tegrabl_blob_get_entry(tegrabl_blob_handle bh, uint32_t index,
 									   void **entry);
 
 /**
- * @brief Get data corresponding to index-th entry
+ * @brief Get data corresponding to index-th entry. If the entries of the
+ *        blob are compressed one by one, only the size can be queried, the
+ *        data is read with tegrabl_blob_read_entry_data.
  *
  * @param bh Blob-handle
  * @param index index of the desired entry
  * @param data memory-address of the data corresponding to index-th entry,
- *        to be filled,
- *        memory is allocated inside this function, needs to be freed
- *        using blob_close
+ *        to be filled, points into the blob and is freed by blob_close
  * @param size size of the data, to be filled
  *
  * @return TEGRABL_NO_ERROR if successful else appropriate error.
@@ -245,6 +245,32 @@ tegrabl_error_t tegrabl_blob_get_entry_data(tegrabl_blob_handle bh,
 											uint32_t index, uint8_t **data,
 											uint32_t *size);
 
+/**
+ * @brief Copy data corresponding to index-th entry into caller memory. If
+ *        the entry is compressed, it is decompressed straight into buf.
+ *
+ * @param bh Blob-handle
+ * @param index index of the desired entry
+ * @param buf buffer to fill
+ * @param buf_size size of buf
+ * @param size size of the data, to be filled
+ *
+ * @return TEGRABL_NO_ERROR if successful else appropriate error.
+ */
+tegrabl_error_t tegrabl_blob_read_entry_data(tegrabl_blob_handle bh,
+											 uint32_t index, void *buf,
+											 uint32_t buf_size, uint32_t *size);
+
+/**
+ * @brief Check whether the entries of the blob are compressed one by one.
+ *        Their data can then only be read with tegrabl_blob_read_entry_data.
+ *
+ * @param bh Blob-handle
+ *
+ * @return true if the entries are compressed one by one
+ */
+bool tegrabl_blob_is_entry_compressed(tegrabl_blob_handle bh);
+
 /**
  * @brief Free the memory occupied by blob
  *
@@ -35,6 +35,21 @@
 
 #define MAX_PROFILE_STRLEN	55U
 
+/*
+ * Span records share the point-record layout; the first character of the
+ * string tells a begin/end marker apart from a plain profiling point.
+ */
+#define PROFILER_SPAN_BEGIN_MARKER	'>'
+#define PROFILER_SPAN_END_MARKER	'<'
+
+/**
+ * @brief Layout of one record in the profiler page
+ */
+struct tegrabl_profiler_record {
+	char str[MAX_PROFILE_STRLEN + 1U];
+	uint64_t timestamp;
+};
+
 /*
  * @brief enums to record various profiler levels
  */
@@ -94,6 +109,32 @@ uint64_t tegrabl_get_profile_record_timestamp(const char *str);
  */
 void tegrabl_profiler_add_record(const char *str, uint64_t tstamp);
 
+/**
+ * @brief Opens a timeline span. Spans may nest; every begin must be paired
+ * with a tegrabl_profiler_end() carrying the same tag.
+ *
+ * @param tag short name of the boot stage (storage, fs, decompress, ...)
+ */
+void tegrabl_profiler_begin(const char *tag);
+
+/**
+ * @brief Closes the innermost span opened with the same tag
+ *
+ * @param tag short name used for the matching tegrabl_profiler_begin()
+ */
+void tegrabl_profiler_end(const char *tag);
+
+/**
+ * @brief Publishes the cpubl timeline under the given DT node, so that the
+ * kernel can read the boot-stage timings from /chosen/cboot-profiler.
+ *
+ * @param fdt Kernel device tree
+ * @param nodeoffset Offset of the parent (chosen) node
+ *
+ * @return TEGRABL_NO_ERROR if successful, otherwise an appropriate error code
+ */
+tegrabl_error_t tegrabl_profiler_add_dt_node(void *fdt, int nodeoffset);
+
 #else
 
 static inline tegrabl_error_t tegrabl_profiler_init(uint64_t page_addr,
@@ -125,6 +166,25 @@ static inline void tegrabl_profiler_add_record(const char *str, uint64_t tstamp)
 	TEGRABL_UNUSED(tstamp);
 }
 
+static inline void tegrabl_profiler_begin(const char *tag)
+{
+	TEGRABL_UNUSED(tag);
+}
+
+static inline void tegrabl_profiler_end(const char *tag)
+{
+	TEGRABL_UNUSED(tag);
+}
+
+static inline tegrabl_error_t tegrabl_profiler_add_dt_node(void *fdt,
+														   int nodeoffset)
+{
+	TEGRABL_UNUSED(fdt);
+	TEGRABL_UNUSED(nodeoffset);
+
+	return TEGRABL_NO_ERROR;
+}
+
 #endif
 
 /*
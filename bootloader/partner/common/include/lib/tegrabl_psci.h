@@ -11,6 +11,22 @@
 #ifndef INCLUDED_TEGRABL_PSCI_H
 #define INCLUDED_TEGRABL_PSCI_H
 
+#include <stdint.h>
+
+/* PSCI return codes */
+#define TEGRABL_PSCI_RET_SUCCESS			0
+#define TEGRABL_PSCI_RET_NOT_SUPPORTED		(-1)
+#define TEGRABL_PSCI_RET_INVALID_PARAMS		(-2)
+#define TEGRABL_PSCI_RET_DENIED				(-3)
+#define TEGRABL_PSCI_RET_ALREADY_ON			(-4)
+#define TEGRABL_PSCI_RET_ON_PENDING			(-5)
+#define TEGRABL_PSCI_RET_INTERNAL_FAILURE	(-6)
+
+/* AFFINITY_INFO states */
+#define TEGRABL_PSCI_AFFINITY_ON			0
+#define TEGRABL_PSCI_AFFINITY_OFF			1
+#define TEGRABL_PSCI_AFFINITY_ON_PENDING	2
+
 /**
 * @brief reset the board
 */
@@ -21,5 +37,31 @@ void tegrabl_psci_sys_reset(void);
 */
 void tegrabl_psci_sys_off(void);
 
+/**
+* @brief power-on a secondary core
+*
+* @param mpidr MPIDR affinity of the core to be powered on
+* @param entry physical address at which the core starts executing, at the
+*              exception level of the caller with MMU and caches off
+* @param context_id value passed to the core in x0
+*
+* @return TEGRABL_PSCI_RET_SUCCESS or one of the PSCI error codes
+*/
+int32_t tegrabl_psci_cpu_on(uint64_t mpidr, uint64_t entry, uint64_t context_id);
+
+/**
+* @brief power-off the calling core, does not return on success
+*/
+void tegrabl_psci_cpu_off(void);
+
+/**
+* @brief query the power state of a core
+*
+* @param mpidr MPIDR affinity of the core
+*
+* @return one of TEGRABL_PSCI_AFFINITY_* or a PSCI error code
+*/
+int32_t tegrabl_psci_affinity_info(uint64_t mpidr);
+
 #endif /*INCLUDED_TEGRABL_PSCI_H*/
 
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ */
+
+#ifndef INCLUDED_TEGRABL_SHA2_H
+#define INCLUDED_TEGRABL_SHA2_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <tegrabl_error.h>
+#include <tegrabl_compiler.h>
+
+/* macro tegrabl sha2 algo */
+typedef uint32_t tegrabl_sha2_algo_t;
+#define TEGRABL_SHA2_256 0U
+#define TEGRABL_SHA2_512 1U
+
+#define TEGRABL_SHA2_256_DIGEST_SIZE 32U
+#define TEGRABL_SHA2_512_DIGEST_SIZE 64U
+#define TEGRABL_SHA2_MAX_DIGEST_SIZE TEGRABL_SHA2_512_DIGEST_SIZE
+#define TEGRABL_SHA2_MAX_BLOCK_SIZE 128U
+
+/**
+ * @brief State of a hash computed over several updates
+ *
+ * @param algo hash algorithm
+ * @param total_size size of the whole message
+ * @param hashed bytes handed to the engine so far
+ * @param pending bytes held back in block
+ * @param state intermediate hash, for the software engine
+ * @param block partial block carried over to the next update
+ * @param digest digest written by the engine
+ */
+struct tegrabl_sha2_context {
+	tegrabl_sha2_algo_t algo;
+	uint64_t total_size;
+	uint64_t hashed;
+	uint32_t pending;
+	union {
+		uint32_t h256[8];
+		uint64_t h512[8];
+	} state;
+	TEGRABL_DECLARE_ALIGNED(uint8_t block[TEGRABL_SHA2_MAX_BLOCK_SIZE], 64);
+	TEGRABL_DECLARE_ALIGNED(uint8_t digest[TEGRABL_SHA2_MAX_DIGEST_SIZE], 64);
+};
+
+/**
+ * @brief Start a hash. The engine needs the message length up front, so the
+ * caller must know it, as AVB does from the hash descriptor. Only one hash
+ * can be in progress at a time.
+ *
+ * Each update hashes the whole blocks it completes, so a message can be
+ * hashed chunk by chunk as it is read:
+ * - T194: the crypto library only hashes a whole message in one call, so the
+ *   hash is computed in software. Updates touch memory only and may run on a
+ *   work-queue core.
+ * - T186: whole blocks are hashed as they are passed in. This chains engine
+ *   passes through tegrabl_se_sha_process_block(), relying on the engine to
+ *   keep its state between passes and on size_left to find the end of the
+ *   message. The SE driver does not document either, it only ever does that
+ *   for its own 16MB payload split.
+ *
+ * @param context context to initialize
+ * @param algo TEGRABL_SHA2_256 or TEGRABL_SHA2_512
+ * @param total_size size of the whole message
+ *
+ * @return TEGRABL_NO_ERROR if success, TEGRABL_ERR_NOT_SUPPORTED if the
+ * engine cannot do the algorithm
+ */
+tegrabl_error_t tegrabl_sha2_init(struct tegrabl_sha2_context *context,
+								  tegrabl_sha2_algo_t algo, uint64_t total_size);
+
+/**
+ * @brief Pass the next part of the message. It is hashed before returning,
+ * so the caller may reuse the buffer for the next read.
+ *
+ * @param context context from tegrabl_sha2_init()
+ * @param data next part of the message
+ * @param size size of the part
+ *
+ * @return TEGRABL_NO_ERROR if success, specific error if fails
+ */
+tegrabl_error_t tegrabl_sha2_update(struct tegrabl_sha2_context *context,
+									const void *data, size_t size);
+
+/**
+ * @brief Finish the hash, all of the message must have been passed in
+ *
+ * @param context context from tegrabl_sha2_init()
+ * @param digest buffer for the digest, 32 or 64 bytes as per the algorithm
+ *
+ * @return TEGRABL_NO_ERROR if success, specific error if fails
+ */
+tegrabl_error_t tegrabl_sha2_final(struct tegrabl_sha2_context *context,
+								   uint8_t *digest);
+
+/**
+ * @brief Get the digest size of an algorithm
+ *
+ * @param algo TEGRABL_SHA2_256 or TEGRABL_SHA2_512
+ *
+ * @return digest size in bytes
+ */
+static inline uint32_t tegrabl_sha2_digest_size(tegrabl_sha2_algo_t algo)
+{
+	return (algo == TEGRABL_SHA2_512) ? TEGRABL_SHA2_512_DIGEST_SIZE :
+			TEGRABL_SHA2_256_DIGEST_SIZE;
+}
+
+#endif /* INCLUDED_TEGRABL_SHA2_H */
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ */
+
+#ifndef INCLUDED_TEGRABL_WORKQUEUE_H
+#define INCLUDED_TEGRABL_WORKQUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <tegrabl_error.h>
+
+/* Maximum number of secondary cores that can be run as workers */
+#ifndef TEGRABL_WORKQUEUE_MAX_CPUS
+#define TEGRABL_WORKQUEUE_MAX_CPUS 7U
+#endif
+
+/* Stack available to a job running on a secondary core */
+#ifndef TEGRABL_WORKQUEUE_STACK_SIZE
+#define TEGRABL_WORKQUEUE_STACK_SIZE (16U * 1024U)
+#endif
+
+#define TEGRABL_WORK_IDLE		0U
+#define TEGRABL_WORK_QUEUED		1U
+#define TEGRABL_WORK_RUNNING	2U
+#define TEGRABL_WORK_DONE		3U
+
+struct tegrabl_work;
+
+/**
+ * @brief Job callback. Runs on any core, either a secondary worker or the
+ * boot core while it waits. Jobs must be CPU-bound only: no console output,
+ * no heap, no LK kernel calls and no controller accesses.
+ */
+typedef tegrabl_error_t (*tegrabl_work_fn_t)(void *arg);
+
+/**
+ * @brief Work item, owned by the submitter until it is DONE
+ *
+ * @param func job callback
+ * @param arg argument to the callback
+ * @param status return value of the callback, valid once DONE
+ * @param state one of TEGRABL_WORK_*
+ * @param next queue linkage, private to the work-queue
+ */
+struct tegrabl_work {
+	tegrabl_work_fn_t func;
+	void *arg;
+	tegrabl_error_t status;
+	volatile uint32_t state;
+	struct tegrabl_work *next;
+};
+
+/**
+ * @brief Initialize a work item
+ *
+ * @param work work item
+ * @param func job callback
+ * @param arg argument to the callback
+ */
+static inline void tegrabl_work_init(struct tegrabl_work *work,
+									 tegrabl_work_fn_t func, void *arg)
+{
+	work->func = func;
+	work->arg = arg;
+	work->status = TEGRABL_NO_ERROR;
+	work->state = TEGRABL_WORK_IDLE;
+	work->next = NULL;
+}
+
+/**
+ * @brief Queue a work item. Returns immediately; the job runs on an idle
+ * secondary core, or on the boot core in tegrabl_workqueue_wait() if no
+ * worker picked it up by then.
+ *
+ * @param work initialized work item which is not already queued
+ *
+ * @return TEGRABL_NO_ERROR if queued, error otherwise
+ */
+tegrabl_error_t tegrabl_workqueue_submit(struct tegrabl_work *work);
+
+/**
+ * @brief Wait for a work item to complete, running queued jobs on the
+ * calling core meanwhile
+ *
+ * @param work submitted work item
+ *
+ * @return status returned by the job
+ */
+tegrabl_error_t tegrabl_workqueue_wait(struct tegrabl_work *work);
+
+/**
+ * @brief Pop and run one queued job on the calling core
+ *
+ * @return true if a job was run, false if the queue was empty
+ */
+bool tegrabl_workqueue_run_one(void);
+
+/**
+ * @brief Run jobs on the calling core until tegrabl_workqueue_stop() is
+ * called. This is the body of every worker.
+ */
+void tegrabl_workqueue_worker_loop(void);
+
+/**
+ * @brief Ask all workers to leave tegrabl_workqueue_worker_loop() once the
+ * queue is empty
+ */
+void tegrabl_workqueue_stop(void);
+
+#if defined(CONFIG_ENABLE_WORKQUEUE_SMP)
+/**
+ * @brief Power on secondary cores through PSCI and run a worker on each
+ *
+ * @param mpidrs MPIDR of each core to be used, must not contain the boot core
+ * @param count number of entries in mpidrs
+ *
+ * @return number of workers that came online
+ */
+uint32_t tegrabl_workqueue_start_cpus(const uint64_t *mpidrs, uint32_t count);
+
+/**
+ * @brief Stop all workers and power their cores off so that the kernel can
+ * bring them up. Must be called before the MMU is disabled.
+ */
+void tegrabl_workqueue_stop_cpus(void);
+#else
+static inline uint32_t tegrabl_workqueue_start_cpus(const uint64_t *mpidrs,
+													uint32_t count)
+{
+	(void)mpidrs;
+	(void)count;
+	return 0;
+}
+
+static inline void tegrabl_workqueue_stop_cpus(void)
+{
+}
+#endif
+
+#endif /* INCLUDED_TEGRABL_WORKQUEUE_H */
@@ -319,9 +319,12 @@ typedef uint32_t tegrabl_err_reason_t;
 #define TEGRABL_ERR_SHELL 0x7EU
 #define TEGRABL_ERR_PCIE 0x7FU
 #define TEGRABL_ERR_NVME 0x80U
+#define TEGRABL_ERR_PROFILER 0x81U
+#define TEGRABL_ERR_WORKQUEUE 0x82U
+#define TEGRABL_ERR_BACKGROUND 0x83U
 
 /**** This should be last ****/
-#define TEGRABL_ERR_MODULE_END 0x81U
+#define TEGRABL_ERR_MODULE_END 0x84U
 #define TEGRABL_ERR_MODULE_MAX 0xffU
 
 typedef uint32_t tegrabl_err_module_t;
@@ -31,7 +31,10 @@ static uint32_t current_smd;
 #define SMD_INVALID MAX_SMD_COPY
 
 static void *smd_loadaddress;
+/* Contents of the SMD copies on storage as of the last load or flush */
 static void *smd_backup;
+/* Copies on storage known to match smd_backup */
+static bool smd_copy_synced[MAX_SMD_COPY];
 
 static tegrabl_error_t
 tegrabl_a_b_get_rootfs_retry_count(void *smd, uint8_t *rootfs_retry_count);
@@ -1171,6 +1174,7 @@ init:
 	 * are different, flush SMD buffer to SMD partition.
 	 */
 	memcpy(smd_backup, smd_loadaddress, smd_len);
+	smd_copy_synced[current_smd] = true;
 
 	/*
 	 * Initialize the rootfs scratch register
@@ -1264,16 +1268,38 @@ tegrabl_error_t tegrabl_a_b_flush_smd(void *smd)
 	}
 
 	/*
-	 * Always flush both primary SMD and secondary SMD.
+	 * All decisions of this boot are made on the buffer, a copy that already
+	 * holds its contents is not written again.
+	 */
+	if ((smd_backup == NULL) ||
+		(memcmp(smd, smd_backup, sizeof(struct slot_meta_data_v2)) != 0)) {
+		memset(smd_copy_synced, 0, sizeof(smd_copy_synced));
+	}
+
+	/*
+	 * Flush both primary SMD and secondary SMD.
 	 * However, must start with the non-current copy to prevent both
 	 * copies from corrupted.
 	 */
 	bin_copy = (current_smd == SMD_COPY_PRIMARY) ? SMD_COPY_SECONDARY : SMD_COPY_PRIMARY;
-	error = flush_smd_bin_copy(smd, bin_copy);
-	if (error != TEGRABL_NO_ERROR)
-		goto done;
+	if (!smd_copy_synced[bin_copy]) {
+		error = flush_smd_bin_copy(smd, bin_copy);
+		if (error != TEGRABL_NO_ERROR)
+			goto done;
+		smd_copy_synced[bin_copy] = true;
+	}
 	bin_copy = (current_smd == SMD_COPY_PRIMARY) ? SMD_COPY_PRIMARY : SMD_COPY_SECONDARY;
-	error = flush_smd_bin_copy(smd, bin_copy);
+	if (!smd_copy_synced[bin_copy]) {
+		error = flush_smd_bin_copy(smd, bin_copy);
+		if (error != TEGRABL_NO_ERROR)
+			goto done;
+		smd_copy_synced[bin_copy] = true;
+	}
+
+	/* Later flushes, including the one at handoff, compare against this */
+	if (smd_backup != NULL) {
+		memcpy(smd_backup, smd, sizeof(struct slot_meta_data_v2));
+	}
 
 done:
 	return error;
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ */
+
+/*
+ * Drivers, the heap and the BPMP channel are not thread safe, so a task never
+ * runs alongside the code that started it. A task only runs while a thread
+ * lends it the CPU from tegrabl_background_yield() or tegrabl_background_wait()
+ * and blocks until the task gives it back, from its own
+ * tegrabl_background_yield() or by returning. Both sides switch only at those
+ * explicit calls. The foreground yields while it polls storage, DMA and PCIe
+ * transfers it started, which tasks never touch.
+ */
+
+#define MODULE TEGRABL_ERR_BACKGROUND
+
+#include "build_config.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <tegrabl_debug.h>
+#include <tegrabl_error.h>
+#include <tegrabl_background.h>
+#include <kernel/thread.h>
+#include <kernel/mutex.h>
+#include <kernel/event.h>
+
+#if defined(CONFIG_ENABLE_BACKGROUND_TASKS)
+
+#define TEGRABL_BACKGROUND_MAX_TASKS 8U
+
+/* Held by the thread lending the CPU, so only one task runs at a time */
+static mutex_t bg_lock = MUTEX_INITIAL_VALUE(bg_lock);
+static struct tegrabl_background_task *bg_tasks[TEGRABL_BACKGROUND_MAX_TASKS];
+/* Task lent the CPU, only set while bg_lock is held */
+static struct tegrabl_background_task *bg_running;
+
+static int background_thread(void *arg)
+{
+	struct tegrabl_background_task *task = (struct tegrabl_background_task *)arg;
+
+	event_wait(&task->run);
+	task->err = task->fn(task->arg);
+	task->done = true;
+	event_signal(&task->paused, true);
+
+	return 0;
+}
+
+/* Called with bg_lock held, returns once the task yields or is done */
+static void background_lend(struct tegrabl_background_task *task)
+{
+	bg_running = task;
+	event_signal(&task->run, true);
+	event_wait(&task->paused);
+	bg_running = NULL;
+}
+
+tegrabl_error_t tegrabl_background_start(struct tegrabl_background_task *task,
+										 const char *name,
+										 tegrabl_background_fn_t fn, void *arg)
+{
+	uint32_t i;
+
+	if ((task == NULL) || (fn == NULL)) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 0);
+	}
+
+	if (task->started) {
+		return TEGRABL_ERROR(TEGRABL_ERR_BUSY, 0);
+	}
+
+	task->fn = fn;
+	task->arg = arg;
+	task->err = TEGRABL_NO_ERROR;
+	task->done = false;
+	task->thread = NULL;
+	task->started = true;
+
+	for (i = 0; i < TEGRABL_BACKGROUND_MAX_TASKS; i++) {
+		if (bg_tasks[i] == NULL) {
+			break;
+		}
+	}
+
+	if (i < TEGRABL_BACKGROUND_MAX_TASKS) {
+		event_init(&task->run, false, EVENT_FLAG_AUTOUNSIGNAL);
+		event_init(&task->paused, false, EVENT_FLAG_AUTOUNSIGNAL);
+		task->thread = thread_create(name, background_thread, task, DEFAULT_PRIORITY,
+									 TEGRABL_BACKGROUND_STACK_SIZE);
+		if (task->thread != NULL) {
+			bg_tasks[i] = task;
+			thread_detach_and_resume(task->thread);
+			return TEGRABL_NO_ERROR;
+		}
+		event_destroy(&task->run);
+		event_destroy(&task->paused);
+	}
+
+	pr_warn("%s: no thread for %s, running it in place\n", __func__, name);
+	task->err = fn(arg);
+	task->done = true;
+
+	return TEGRABL_NO_ERROR;
+}
+
+bool tegrabl_background_pending(struct tegrabl_background_task *task)
+{
+	return (task != NULL) && task->started;
+}
+
+tegrabl_error_t tegrabl_background_wait(struct tegrabl_background_task *task)
+{
+	uint32_t i;
+
+	if ((task == NULL) || !task->started) {
+		return TEGRABL_ERROR(TEGRABL_ERR_NOT_STARTED, 0);
+	}
+
+	if (task->thread != NULL) {
+		if (task->thread == current_thread) {
+			return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 1);
+		}
+
+		mutex_acquire(&bg_lock);
+		while (!task->done) {
+			background_lend(task);
+		}
+		for (i = 0; i < TEGRABL_BACKGROUND_MAX_TASKS; i++) {
+			if (bg_tasks[i] == task) {
+				bg_tasks[i] = NULL;
+			}
+		}
+		mutex_release(&bg_lock);
+
+		event_destroy(&task->run);
+		event_destroy(&task->paused);
+		task->thread = NULL;
+	}
+	task->started = false;
+
+	return task->err;
+}
+
+void tegrabl_background_yield(void)
+{
+	struct tegrabl_background_task *task = bg_running;
+	uint32_t i;
+
+	/* A task hands the CPU back to the thread that lent it */
+	if ((task != NULL) && (task->thread == current_thread)) {
+		event_signal(&task->paused, true);
+		event_wait(&task->run);
+		return;
+	}
+
+	mutex_acquire(&bg_lock);
+	for (i = 0; i < TEGRABL_BACKGROUND_MAX_TASKS; i++) {
+		task = bg_tasks[i];
+		if ((task != NULL) && !task->done) {
+			background_lend(task);
+		}
+	}
+	mutex_release(&bg_lock);
+}
+
+#endif /* CONFIG_ENABLE_BACKGROUND_TASKS */
@@ -746,6 +746,102 @@ tegrabl_error_t tegrabl_blockdev_xfer_wait(struct tegrabl_blockdev_xfer_info *xf
 fail:
 	return error;
 }
+
+tegrabl_error_t tegrabl_blockdev_xfer_list(tegrabl_bdev_t *dev, uint8_t xfer_type,
+		struct tegrabl_blockdev_xfer_segment *segs, uint32_t num_segs)
+{
+	tegrabl_error_t error = TEGRABL_NO_ERROR;
+	bool is_write = (xfer_type == TEGRABL_BLOCKDEV_WRITE);
+	uint64_t size = 0;
+	uint8_t *buf;
+	bnum_t block;
+	bnum_t count;
+	uint32_t i;
+	uint32_t j;
+
+	if ((dev == NULL) || (segs == NULL) || (num_segs == 0U) ||
+		((xfer_type != TEGRABL_BLOCKDEV_READ) && (xfer_type != TEGRABL_BLOCKDEV_WRITE))) {
+		error = TEGRABL_ERROR(TEGRABL_ERR_INVALID, 27);
+		goto fail;
+	}
+
+	pr_trace("dev '%d', type %u, %u segments\n", dev->device_id, xfer_type, num_segs);
+
+	if (dev->ref <= 0UL) {
+		error = TEGRABL_ERROR(TEGRABL_ERR_INVALID, 28);
+		goto fail;
+	}
+
+	for (i = 0; i < num_segs; i++) {
+		if ((segs[i].block_count == 0U) || !tegrabl_blockdev_buffer_aligned(dev, segs[i].buf)) {
+			error = TEGRABL_ERROR(TEGRABL_ERR_INVALID, 29);
+			goto fail;
+		}
+		/* range check */
+		if ((segs[i].start_block > dev->block_count) ||
+				(segs[i].block_count > (dev->block_count - segs[i].start_block))) {
+			error = TEGRABL_ERROR(TEGRABL_ERR_OVERFLOW, 6);
+			goto fail;
+		}
+		size += (uint64_t)segs[i].block_count << dev->block_size_log2;
+	}
+
+#if defined(CONFIG_ENABLE_BLOCKDEV_KPI)
+	if (is_write) {
+		profile_write_start(dev);
+	} else {
+		profile_read_start(dev);
+	}
+#endif
+
+	if (dev->xfer_list != NULL) {
+		error = dev->xfer_list(dev, xfer_type, segs, num_segs);
+		if (error != TEGRABL_NO_ERROR) {
+			TEGRABL_SET_HIGHEST_MODULE(error);
+			goto fail;
+		}
+	} else {
+		for (i = 0; i < num_segs; i = j) {
+			buf = segs[i].buf;
+			block = segs[i].start_block;
+			count = segs[i].block_count;
+
+			/* Merge what follows on both the device and in memory */
+			for (j = i + 1U; j < num_segs; j++) {
+				if ((segs[j].start_block != (block + count)) ||
+					((uint8_t *)segs[j].buf != (buf + ((size_t)count << dev->block_size_log2)))) {
+					break;
+				}
+				count += segs[j].block_count;
+			}
+
+			if (is_write) {
+				error = dev->write_block(dev, buf, block, count);
+			} else {
+				error = dev->read_block(dev, buf, block, count);
+			}
+			if (error != TEGRABL_NO_ERROR) {
+				TEGRABL_SET_HIGHEST_MODULE(error);
+				goto fail;
+			}
+		}
+	}
+
+#if defined(CONFIG_ENABLE_BLOCKDEV_KPI)
+	if (is_write) {
+		profile_write_end(dev, size);
+	} else {
+		profile_read_end(dev, size);
+	}
+#endif
+
+fail:
+	TEGRABL_UNUSED(size);
+	if (error != TEGRABL_NO_ERROR) {
+		pr_error("Blockdev xfer list: exit error = %x\n", error);
+	}
+	return error;
+}
 #endif
 
 tegrabl_error_t tegrabl_blockdev_ioctl(tegrabl_bdev_t *dev, uint32_t ioctl,
@@ -805,6 +901,7 @@ tegrabl_error_t tegrabl_blockdev_initialize_bdev(tegrabl_bdev_t *dev,
 	dev->write = tegrabl_blockdev_default_write;
 	dev->write_block = tegrabl_blockdev_default_write_block;
 	dev->erase = tegrabl_blockdev_default_erase;
+	dev->xfer_list = NULL;
 	dev->close = NULL;
 #endif
 
@@ -860,6 +957,18 @@ tegrabl_error_t tegrabl_blockdev_unregister_device(tegrabl_bdev_t *dev)
 	return TEGRABL_NO_ERROR;
 }
 
+tegrabl_error_t tegrabl_blockdev_move_to_tail(tegrabl_bdev_t *dev)
+{
+	if (dev == NULL)
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 30);
+
+	/* the list keeps its ref */
+	list_delete(&dev->node);
+	list_add_tail(&bdevs->list, &dev->node);
+
+	return TEGRABL_NO_ERROR;
+}
+
 void tegrabl_blockdev_dump_devices(void)
 {
 	pr_debug("Block devices:\n");
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2019, NVIDIA Corporation.  All Rights Reserved.
+ * Copyright (c) 2016-2021, NVIDIA Corporation.  All Rights Reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property and
  * proprietary rights in and to this software and related documentation.  Any
@@ -14,6 +14,7 @@
 #include <tegrabl_error.h>
 #include <tegrabl_debug.h>
 #include <tegrabl_malloc.h>
+#include <tegrabl_utils.h>
 #include <tegrabl_exit.h>
 #include <tegrabl_nvblob.h>
 #include <tegrabl_partition_manager.h>
@@ -29,6 +30,10 @@
 #define MB2_BL_PARTITION_NAME		"mb2"
 #define MB1_PARTITION_NAME			"mb1"
 
+/* Compare granularity, raised to the erase sector size on QSPI */
+#define UPDATE_CHUNK_SIZE			SZ_64K
+#define UPDATE_ERASED_BYTE			0xFFU
+
 static const char *update_slot_suffix;
 
 static struct tegrabl_bl_update_callbacks callbacks;
@@ -224,11 +229,124 @@ static tegrabl_error_t is_always_ab_partition(const char *part_name,
 }
 
 
+static bool is_erased(const uint8_t *buf, uint32_t size)
+{
+	uint32_t i;
+
+	for (i = 0; i < size; i++) {
+		if (buf[i] != UPDATE_ERASED_BYTE) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * Rewrite only the chunks of the partition that differ from the payload.
+ * Chunks are aligned to the device, not the partition. On QSPI they are at
+ * least one erase sector (64KB or 256KB depending on the part), so that each
+ * one maps to whole sectors. A QSPI partition used to be erased as a whole,
+ * so past the end of the image the chunks must read back erased.
+ */
+static tegrabl_error_t write_partition_diff(struct tegrabl_partition *part,
+											const uint8_t *data, uint32_t size,
+											bool is_qspi)
+{
+	tegrabl_error_t status = TEGRABL_NO_ERROR;
+	tegrabl_bdev_t *bdev = part->block_device;
+	uint32_t log2 = bdev->block_size_log2;
+	uint64_t part_start = part->partition_info->start_sector << log2;
+	uint64_t end = is_qspi ? tegrabl_partition_size(part) : size;
+	uint64_t offset = 0;
+	uint32_t chunk_size = UPDATE_CHUNK_SIZE;
+	uint32_t erase_size = 0;
+	uint64_t len;
+	uint64_t img_len;
+	uint32_t num_chunks = 0;
+	uint32_t num_written = 0;
+	uint8_t *buf = NULL;
+	bool same;
+
+	if (size > tegrabl_partition_size(part)) {
+		status = TEGRABL_ERROR(TEGRABL_ERR_OVERFLOW, 0);
+		pr_error("Image of %u bytes does not fit the partition\n", size);
+		goto done;
+	}
+
+	if (is_qspi &&
+		(tegrabl_blockdev_ioctl(bdev, TEGRABL_IOCTL_ERASE_SIZE, &erase_size) == TEGRABL_NO_ERROR)) {
+		chunk_size = MAX(chunk_size, erase_size);
+	}
+
+	buf = tegrabl_memalign(TEGRABL_BLOCKDEV_MEM_ALIGN_SIZE, chunk_size);
+	if (buf == NULL) {
+		status = TEGRABL_ERROR(TEGRABL_ERR_NO_MEMORY, 1);
+		goto done;
+	}
+
+	while (offset < end) {
+		len = chunk_size - ((part_start + offset) & (chunk_size - 1U));
+		len = MIN(len, end - offset);
+		img_len = (offset < size) ? MIN(len, size - offset) : 0U;
+		num_chunks++;
+
+		status = tegrabl_partition_seek(part, (int64_t)offset, TEGRABL_PARTITION_SEEK_SET);
+		if (status != TEGRABL_NO_ERROR) {
+			goto done;
+		}
+		status = tegrabl_partition_read(part, buf, len);
+		if (status != TEGRABL_NO_ERROR) {
+			goto done;
+		}
+
+		same = (memcmp(buf, data + offset, img_len) == 0) &&
+			   is_erased(buf + img_len, (uint32_t)(len - img_len));
+		if (same) {
+			offset += len;
+			continue;
+		}
+		num_written++;
+
+		if (is_qspi) {
+			status = tegrabl_blockdev_erase(bdev, (bnum_t)((part_start + offset) >> log2),
+											(bnum_t)(len >> log2), false);
+			if (status != TEGRABL_NO_ERROR) {
+				TEGRABL_SET_HIGHEST_MODULE(status);
+				goto done;
+			}
+		}
+
+		if (img_len != 0U) {
+			status = tegrabl_partition_seek(part, (int64_t)offset, TEGRABL_PARTITION_SEEK_SET);
+			if (status != TEGRABL_NO_ERROR) {
+				goto done;
+			}
+			status = tegrabl_partition_write(part, data + offset, img_len);
+			if (status != TEGRABL_NO_ERROR) {
+				goto done;
+			}
+		}
+
+		offset += len;
+	}
+
+	pr_info("Rewrote %u of %u chunks\n", num_written, num_chunks);
+
+done:
+	if (buf != NULL) {
+		tegrabl_free(buf);
+	}
+
+	return status;
+}
+
 static tegrabl_error_t write_partition(const char *part_name, uint8_t *data,
 									   uint32_t size)
 {
 	struct tegrabl_partition part;
 	tegrabl_error_t status = TEGRABL_NO_ERROR;
+	bool is_qspi = false;
 
 	pr_info("Updating partition: %s...\n", part_name);
 	status = tegrabl_partition_open(part_name, &part);
@@ -236,30 +354,28 @@ static tegrabl_error_t write_partition(const char *part_name, uint8_t *data,
 		goto end;
 	}
 #if defined(CONFIG_ENABLE_QSPI)
-	uint32_t storage_type;
-
-	storage_type = tegrabl_blockdev_get_storage_type(part.block_device);
-	if (storage_type == TEGRABL_STORAGE_QSPI_FLASH) {
-		status = tegrabl_partition_erase(&part, false);
-		if (status != TEGRABL_NO_ERROR) {
-			TEGRABL_SET_HIGHEST_MODULE(status);
-			goto end;
-		}
-	}
+	is_qspi = (tegrabl_blockdev_get_storage_type(part.block_device) ==
+			   TEGRABL_STORAGE_QSPI_FLASH);
 #endif
 
 	if (!strncmp(part_name, BR_BCT_PARTITION_NAME,
 				 strlen(BR_BCT_PARTITION_NAME)) &&
 		callbacks.update_bct != NULL) {
+		if (is_qspi) {
+			status = tegrabl_partition_erase(&part, false);
+			if (status != TEGRABL_NO_ERROR) {
+				TEGRABL_SET_HIGHEST_MODULE(status);
+				goto close;
+			}
+		}
 		pr_info("updating bCT\n");
 		status = callbacks.update_bct((uintptr_t)data, size);
-		goto end;
+		goto close;
 	}
 
-	status = tegrabl_partition_write(&part, data, size);
-	if (status != TEGRABL_NO_ERROR) {
-		goto end;
-	}
+	status = write_partition_diff(&part, data, size, is_qspi);
+
+close:
 	tegrabl_partition_close(&part);
 end:
 	return status;
@@ -385,38 +501,34 @@ static tegrabl_error_t update_partition(tegrabl_blob_handle bh,
 				 entry->op_mode, entry->spec_info);
 
 		/* Get partition data address and size in blob */
-		status = tegrabl_blob_get_entry_data(bh, i, &data, &size);
+		status = tegrabl_blob_get_entry_data(bh, i,
+				tegrabl_blob_is_entry_compressed(bh) ? NULL : &data, &size);
 
 		if (status != TEGRABL_NO_ERROR) {
 			goto end;
 		}
 
-#if defined(CONFIG_ENABLE_QSPI)
-	uint32_t storage_type;
-	struct tegrabl_partition part;
-	status = tegrabl_partition_open(entry->partname, &part);
-	if (status != TEGRABL_NO_ERROR) {
-		goto end;
-	}
-	storage_type = tegrabl_blockdev_get_storage_type(part.block_device);
-	if (storage_type == TEGRABL_STORAGE_QSPI_FLASH) {
-		status = tegrabl_partition_erase(&part, false);
-		if (status != TEGRABL_NO_ERROR) {
-			TEGRABL_SET_HIGHEST_MODULE(status);
-			goto end;
-		}
-	}
-#endif
-
-		/* Align data to BLKDEV_MEM_ALIGN byte */
-		if ((uintptr_t)data & (TEGRABL_BLOCKDEV_MEM_ALIGN_SIZE - 1U)) {
+		/*
+		 * Align data to BLKDEV_MEM_ALIGN byte, compressed entries are
+		 * decompressed straight into the aligned buffer
+		 */
+		if ((data == NULL) ||
+			((uintptr_t)data & (TEGRABL_BLOCKDEV_MEM_ALIGN_SIZE - 1U))) {
 			aligned_data = (uint8_t *)tegrabl_memalign(TEGRABL_BLOCKDEV_MEM_ALIGN_SIZE, size);
 			if (aligned_data == NULL) {
 				status = TEGRABL_ERROR(TEGRABL_ERR_NO_MEMORY, 0);
 				pr_error("Update partition: not enough memory\n");
 				goto end;
 			}
-			memcpy(aligned_data, data, size);
+			if (data == NULL) {
+				status = tegrabl_blob_read_entry_data(bh, i, aligned_data, size,
+													  NULL);
+				if (status != TEGRABL_NO_ERROR) {
+					goto end;
+				}
+			} else {
+				memcpy(aligned_data, data, size);
+			}
 			data = aligned_data;
 		}
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2020, NVIDIA Corporation.  All Rights Reserved.
+ * Copyright (c) 2018-2021, NVIDIA Corporation.  All Rights Reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property and
  * proprietary rights in and to this software and related documentation.  Any
@@ -207,6 +207,7 @@ static void parse_ip_info(void *fdt, int32_t offset, struct ip_info *ip_info)
 {
 	tegrabl_error_t err = TEGRABL_NO_ERROR;
 	uint32_t count;
+	uint32_t port;
 	const char *status;
 
 	err = tegrabl_dt_get_prop_u8_array(fdt, offset, boot_cfg_vars[1], 0, ip_info->tftp_server_ip, &count);
@@ -216,6 +217,13 @@ static void parse_ip_info(void *fdt, int32_t offset, struct ip_info *ip_info)
 		print_ip("tftp-server-ip", ip_info->tftp_server_ip);
 	}
 
+	/* Optional, fetch the boot images over HTTP from this port of the same server */
+	if ((tegrabl_dt_get_prop_u32(fdt, offset, "http-server-port", &port) == TEGRABL_NO_ERROR) &&
+		(port != 0U) && (port <= 0xFFFFU)) {
+		ip_info->http_server_port = (uint16_t)port;
+		pr_info("http-server-port: %u\n", port);
+	}
+
 	status = fdt_getprop(fdt, offset, boot_cfg_vars[2], NULL);
 	if (status != NULL) {
 		pr_warn("%s: static-ip info is not required, only tftp-server-ip is required.\n", __func__);
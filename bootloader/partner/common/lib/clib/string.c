@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2019, NVIDIA Corporation.  All rights reserved.
+ * Copyright (c) 2015-2021, NVIDIA Corporation.  All rights reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property and
  * proprietary rights in and to this software and related documentation.  Any
@@ -62,7 +62,8 @@ void tegrabl_clib_dma_register(struct tegrabl_clib_dma *dma_info)
 	}
 }
 
-#if !defined(__ARM_ARCH_7R__)
+/* ARMv7-R and ARMv8 use the assembly versions in memset.S and memcpy.S */
+#if !defined(__ARM_ARCH_7R__) && !defined(__aarch64__)
 void *memset(void *s, int c, size_t n)
 {
 	char *xs = (char *)s;
@@ -164,6 +165,8 @@ void *memcpy(void *dest, const void *src, size_t n)
 }
 #endif
 
+/* ARMv8 has an overlap-aware memmove in memcpy_armv8.S */
+#if !defined(__aarch64__)
 static void *rmemcpy(void *dest, const void *src, size_t n)
 {
 	char *d = (char *)dest + n;
@@ -199,6 +202,7 @@ static void *rmemcpy(void *dest, const void *src, size_t n)
 
 	return dest;
 }
+#endif
 int memcmp(const void *s1, const void *s2, size_t n)
 {
 	const char* p1 = s1;
@@ -243,6 +247,7 @@ void* memchr(const void *s, int c, size_t n)
 	return NULL;
 }
 
+#if !defined(__aarch64__)
 void* memmove(void *dest, const void *src, size_t n)
 {
 	if ((dest == NULL) || (src == NULL)) {
@@ -257,6 +262,7 @@ void* memmove(void *dest, const void *src, size_t n)
 		return rmemcpy(dest, src, n);
 	}
 }
+#endif
 
 char* strcat(char* dest, const char* src)
 {
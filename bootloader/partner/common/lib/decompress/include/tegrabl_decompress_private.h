@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016 - 2017, NVIDIA Corporation.  All Rights Reserved.
+ * Copyright (c) 2016 - 2021, NVIDIA Corporation.  All Rights Reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property and
  * proprietary rights in and to this software and related documentation.  Any
@@ -51,5 +51,19 @@ tegrabl_error_t do_lz4_decompress(void *cntxt, void *in_buffer,
 								  uint32_t outbuf_size, uint32_t *written_size);
 #endif
 
+
+#ifdef CONFIG_ENABLE_ZSTD
+/* zstd algo context initialization, allocates the decoder workspace */
+void *zstd_init(uint32_t compressed_size);
+
+/* zstd algo decompress api */
+tegrabl_error_t do_zstd_decompress(void *cntxt, void *in_buffer,
+								   uint32_t in_size, void *out_buffer,
+								   uint32_t outbuf_size, uint32_t *written_size);
+
+/* zstd algo clean up api */
+tegrabl_error_t zstd_end(void *cntxt);
+#endif
+
 #endif
 
@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2016 - 2017, NVIDIA Corporation.  All Rights Reserved.
+# Copyright (c) 2016 - 2021, NVIDIA Corporation.  All Rights Reserved.
 #
 # NVIDIA Corporation and its licensors retain all intellectual property and
 # proprietary rights in and to this software and related documentation.  Any
@@ -44,6 +44,7 @@ endif
 TEGRABL_DECOMPRESSOR_ZLIB := yes
 #TEGRABL_DECOMPRESSOR_LZF := yes
 TEGRABL_DECOMPRESSOR_LZ4 := yes
+TEGRABL_DECOMPRESSOR_ZSTD := yes
 
 ifeq ($(TEGRABL_DECOMPRESSOR_LZF), yes)
 MODULE_DEFINES += CONFIG_ENABLE_LZF=1
@@ -79,5 +80,12 @@ MODULE_SRCS +=      \
 GLOBAL_INCLUDES += $(EXTERNAL_LIB_DIR)/lz4
 endif
 
+ifeq ($(TEGRABL_DECOMPRESSOR_ZSTD), yes)
+MODULE_DEFINES += CONFIG_ENABLE_ZSTD=1
+
+MODULE_SRCS +=      \
+		$(LOCAL_DIR)/tegrabl_zstd_decompress.c
+endif
+
 include make/module.mk
 
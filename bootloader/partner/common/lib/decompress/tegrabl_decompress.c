@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, NVIDIA Corporation.  All Rights Reserved.
+ * Copyright (c) 2016-2021, NVIDIA Corporation.  All Rights Reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property and
  * proprietary rights in and to this software and related documentation.  Any
@@ -14,6 +14,7 @@
 #include "tegrabl_utils.h"
 #include "tegrabl_decompress.h"
 #include "string.h"
+#include "tegrabl_profiler.h"
 
 #include "tegrabl_decompress_private.h"
 
@@ -37,6 +38,9 @@ static decompressor decompressor_list[] = {
 	ADD_METHOD("lz4-legacy", 0x02, 0x21, NULL, do_lz4_decompress, NULL),
 	ADD_METHOD("lz4", 0x04, 0x22, NULL, do_lz4_decompress, NULL),
 #endif
+#ifdef CONFIG_ENABLE_ZSTD
+	ADD_METHOD("zstd", 0x28, 0xb5, zstd_init, do_zstd_decompress, zstd_end),
+#endif
 };
 
 decompressor *decompress_method(uint8_t *c_magic, uint32_t len)
@@ -110,18 +114,21 @@ tegrabl_error_t do_decompress(decompressor *decomp, uint8_t *read_buffer,
 			 write_buffer);
 
 	/* decompress compressed data */
+	tegrabl_profiler_begin("decompress");
 	err = decomp->decompress(context, read_buffer, read_size, write_buffer,
 							 *outbuf_size, &written_size);
-	if (err != TEGRABL_NO_ERROR) {
-		pr_critical("Failure during decompressing (err: %d)\n", err);
-		return err;
-	}
+	tegrabl_profiler_end("decompress");
 
-	/* call decompressor cleanup */
+	/* call decompressor cleanup, also on failure so its workspace is freed */
 	if (decomp->end) {
 		decomp->end(context);
 	}
 
+	if (err != TEGRABL_NO_ERROR) {
+		pr_critical("Failure during decompressing (err: %d)\n", err);
+		return err;
+	}
+
 	pr_debug("decompress kernel successfully, uncompressed kernel size: %d\n",
 			 written_size);
 
@@ -0,0 +1,1562 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ */
+
+/*
+ * Zstandard (RFC 8878) frame decoder.
+ *
+ * Output always goes to a flat buffer which also serves as the history
+ * window, so the only workspace needed is the entropy tables, one block of
+ * literals and, for the streaming entry points, one block of staged input.
+ * Dictionaries are not supported.
+ */
+
+#define MODULE TEGRABL_ERR_DECOMPRESS
+
+#include "tegrabl_error.h"
+#include "tegrabl_utils.h"
+#include "stdint.h"
+#include "stdbool.h"
+#include "inttypes.h"
+#include "tegrabl_decompress.h"
+#include "tegrabl_decompress_private.h"
+
+#define ZSTD_MAGIC					0xFD2FB528U
+#define ZSTD_SKIPPABLE_MAGIC		0x184D2A50U
+#define ZSTD_SKIPPABLE_MASK			0xFFFFFFF0U
+
+#define ZSTD_MAGIC_SIZE				4U
+#define ZSTD_BLOCK_HEADER_SIZE		3U
+#define ZSTD_CHECKSUM_SIZE			4U
+#define ZSTD_BLOCK_SIZE_MAX			(128U * 1024U)
+#define ZSTD_WINDOW_LOG_MIN			10U
+
+/* Frame header descriptor */
+#define ZSTD_FHD_FCS_FLAG(d)		(((d) >> 6) & 0x3U)
+#define ZSTD_FHD_SINGLE_SEGMENT		(1U << 5)
+#define ZSTD_FHD_RESERVED			(1U << 3)
+#define ZSTD_FHD_CHECKSUM			(1U << 2)
+#define ZSTD_FHD_DICT_ID_FLAG(d)	((d) & 0x3U)
+
+#define ZSTD_BLOCK_RAW				0U
+#define ZSTD_BLOCK_RLE				1U
+#define ZSTD_BLOCK_COMPRESSED		2U
+
+#define ZSTD_LIT_RAW				0U
+#define ZSTD_LIT_RLE				1U
+#define ZSTD_LIT_COMPRESSED			2U
+#define ZSTD_LIT_TREELESS			3U
+
+#define ZSTD_SEQ_PREDEFINED			0U
+#define ZSTD_SEQ_RLE				1U
+#define ZSTD_SEQ_FSE				2U
+#define ZSTD_SEQ_REPEAT				3U
+
+#define HUF_MAX_BITS				11U
+#define HUF_MAX_SYMBOLS				256U
+#define HUF_WEIGHTS_LOG_MAX			6U
+
+#define FSE_LOG_MAX					9U
+#define LL_LOG_MAX					9U
+#define ML_LOG_MAX					9U
+#define OF_LOG_MAX					8U
+#define LL_MAX_SYMBOL				35U
+#define ML_MAX_SYMBOL				52U
+#define OF_MAX_SYMBOL				31U
+
+/* Decoder stages, each waits for a fixed number of input bytes */
+#define ZSTD_STAGE_MAGIC			0U
+#define ZSTD_STAGE_FRAME_DESC		1U
+#define ZSTD_STAGE_FRAME_HEADER		2U
+#define ZSTD_STAGE_BLOCK_HEADER		3U
+#define ZSTD_STAGE_BLOCK			4U
+#define ZSTD_STAGE_CHECKSUM			5U
+#define ZSTD_STAGE_SKIP_SIZE		6U
+#define ZSTD_STAGE_SKIP				7U
+#define ZSTD_STAGE_PADDING			8U
+
+struct fse_entry {
+	uint16_t baseline;
+	uint8_t symbol;
+	uint8_t nb_bits;
+};
+
+struct fse_table {
+	uint32_t log;
+	bool valid;
+	struct fse_entry entry[1U << FSE_LOG_MAX];
+};
+
+struct huf_table {
+	uint32_t max_bits;
+	bool valid;
+	uint8_t symbol[1U << HUF_MAX_BITS];
+	uint8_t nb_bits[1U << HUF_MAX_BITS];
+};
+
+struct tegrabl_zstd_stream {
+	/* output buffer, doubles as the history window */
+	uint8_t *out;
+	uint32_t out_size;
+	uint32_t out_pos;
+
+	/* frame state */
+	uint32_t stage;
+	uint32_t need;
+	uint32_t frame_start;
+	uint32_t frame_count;
+	uint8_t frame_desc;
+	uint8_t block_type;
+	bool last_block;
+	bool has_content_size;
+	uint64_t content_size;
+	uint32_t block_max;
+	uint32_t block_size;
+	uint32_t skip_left;
+	uint32_t rep[3];
+
+	/* entropy tables, kept across the blocks of a frame */
+	struct huf_table huf;
+	struct fse_table ll;
+	struct fse_table of;
+	struct fse_table ml;
+
+	uint8_t literals[ZSTD_BLOCK_SIZE_MAX];
+
+	/* input unit split across two stream writes, allocated on first use */
+	uint8_t *stage_buf;
+	uint32_t staged;
+};
+
+static const uint32_t ll_base[LL_MAX_SYMBOL + 1U] = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+	16, 18, 20, 22, 24, 28, 32, 40, 48, 64, 128, 256, 512, 1024, 2048, 4096,
+	8192, 16384, 32768, 65536,
+};
+
+static const uint8_t ll_bits[LL_MAX_SYMBOL + 1U] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	1, 1, 1, 1, 2, 2, 3, 3, 4, 6, 7, 8, 9, 10, 11, 12,
+	13, 14, 15, 16,
+};
+
+static const uint32_t ml_base[ML_MAX_SYMBOL + 1U] = {
+	3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+	19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34,
+	35, 37, 39, 41, 43, 47, 51, 59, 67, 83, 99, 131, 259, 515, 1027, 2051,
+	4099, 8195, 16387, 32771, 65539,
+};
+
+static const uint8_t ml_bits[ML_MAX_SYMBOL + 1U] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	1, 1, 1, 1, 2, 2, 3, 3, 4, 4, 5, 7, 8, 9, 10, 11,
+	12, 13, 14, 15, 16,
+};
+
+/* Predefined distributions, RFC 8878 section 3.1.1.3.2.2 */
+static const int16_t ll_default_norm[LL_MAX_SYMBOL + 1U] = {
+	4, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1,
+	2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 2, 1, 1, 1, 1, 1,
+	-1, -1, -1, -1,
+};
+
+static const int16_t ml_default_norm[ML_MAX_SYMBOL + 1U] = {
+	1, 4, 3, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1,
+	-1, -1, -1, -1, -1,
+};
+
+static const int16_t of_default_norm[29] = {
+	1, 1, 1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1,
+};
+
+static inline uint32_t zstd_highbit(uint32_t val)
+{
+	return 31U - (uint32_t)__builtin_clz(val);
+}
+
+static inline uint32_t zstd_read_le16(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8);
+}
+
+static inline uint32_t zstd_read_le24(const uint8_t *p)
+{
+	return zstd_read_le16(p) | ((uint32_t)p[2] << 16);
+}
+
+static inline uint32_t zstd_read_le32(const uint8_t *p)
+{
+	return zstd_read_le16(p) | (zstd_read_le16(p + 2) << 16);
+}
+
+static inline uint64_t zstd_read_le64(const uint8_t *p)
+{
+	return (uint64_t)zstd_read_le32(p) | ((uint64_t)zstd_read_le32(p + 4) << 32);
+}
+
+/*
+ * Bits [pos, pos + nbits) of a little-endian bitstream of size bytes, with
+ * bits past the end reading as zero. nbits + 7 must not exceed 64.
+ */
+static inline uint64_t zstd_bits_get(const uint8_t *src, uint32_t size,
+									 uint32_t pos, uint32_t nbits)
+{
+	uint32_t byte = pos >> 3;
+	uint64_t val = 0;
+	uint32_t i;
+
+	if (nbits == 0U) {
+		return 0;
+	}
+
+	if ((byte + 8U) <= size) {
+		val = zstd_read_le64(src + byte);
+	} else {
+		for (i = 0; (byte + i) < size; i++) {
+			val |= (uint64_t)src[byte + i] << (8U * i);
+		}
+	}
+
+	return (val >> (pos & 7U)) & ((1ULL << nbits) - 1ULL);
+}
+
+/*
+ * Backward bitstream used by the Huffman and FSE coded payloads. It is read
+ * from the last byte towards the first through a 64-bit container which
+ * holds the 8 bytes at ptr; consumed counts the bits already taken from its
+ * top and goes beyond 64 if a corrupted stream over-reads.
+ */
+struct zstd_rbits {
+	const uint8_t *start;
+	const uint8_t *ptr;
+	uint64_t container;
+	uint32_t consumed;
+};
+
+static tegrabl_error_t zstd_rbits_init(struct zstd_rbits *br,
+									   const uint8_t *src, uint32_t size)
+{
+	uint32_t i;
+
+	if ((size == 0U) || (src[size - 1U] == 0U)) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 10);
+	}
+
+	br->start = src;
+	/* skip the padding zeros and the end marker bit */
+	br->consumed = 8U - zstd_highbit(src[size - 1U]);
+
+	if (size >= 8U) {
+		br->ptr = src + size - 8U;
+		br->container = zstd_read_le64(br->ptr);
+	} else {
+		/* short stream, the missing top bytes count as consumed */
+		br->ptr = src;
+		br->container = 0;
+		for (i = 0; i < size; i++) {
+			br->container |= (uint64_t)src[i] << (8U * i);
+		}
+		br->consumed += 8U * (8U - size);
+	}
+
+	return TEGRABL_NO_ERROR;
+}
+
+/* Bits left in the stream, negative after an over-read */
+static inline int32_t zstd_rbits_left(const struct zstd_rbits *br)
+{
+	return (int32_t)((uint32_t)(br->ptr - br->start) * 8U) + 64 -
+		(int32_t)br->consumed;
+}
+
+static inline void zstd_rbits_reload(struct zstd_rbits *br)
+{
+	uint32_t bytes = br->consumed >> 3;
+
+	if (br->ptr == br->start) {
+		return;
+	}
+	if ((uint32_t)(br->ptr - br->start) < bytes) {
+		bytes = (uint32_t)(br->ptr - br->start);
+	}
+	br->ptr -= bytes;
+	br->consumed -= bytes * 8U;
+	br->container = zstd_read_le64(br->ptr);
+}
+
+/* Next nbits (at most 31) bits without consuming them, zeros past the start */
+static inline uint32_t zstd_rbits_peek(struct zstd_rbits *br, uint32_t nbits)
+{
+	if (br->consumed > (64U - nbits)) {
+		zstd_rbits_reload(br);
+	}
+	if ((nbits == 0U) || (br->consumed >= 64U)) {
+		return 0;
+	}
+
+	return (uint32_t)(((br->container << br->consumed) >> 1) >> (63U - nbits));
+}
+
+static inline uint32_t zstd_rbits_read(struct zstd_rbits *br, uint32_t nbits)
+{
+	uint32_t val = zstd_rbits_peek(br, nbits);
+
+	br->consumed += nbits;
+
+	return val;
+}
+
+/*
+ * Parse an FSE table description (normalized counts) starting at src and
+ * report the number of bytes used.
+ */
+static tegrabl_error_t fse_read_norm(const uint8_t *src, uint32_t size,
+									 int16_t *norm, uint32_t *num_symbols,
+									 uint32_t max_symbol, uint32_t *log,
+									 uint32_t max_log, uint32_t *consumed)
+{
+	uint32_t pos = 0;
+	uint32_t symbol = 0;
+	int32_t remaining;
+	int32_t threshold;
+	int32_t max;
+	int32_t val;
+	uint32_t nbits;
+	uint32_t bits;
+	uint32_t repeat;
+	uint32_t i;
+
+	if (size == 0U) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 11);
+	}
+
+	*log = (uint32_t)zstd_bits_get(src, size, 0, 4) + 5U;
+	pos = 4;
+	if (*log > max_log) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 12);
+	}
+
+	remaining = (1 << *log) + 1;
+	threshold = 1 << *log;
+	nbits = *log + 1U;
+
+	while ((remaining > 1) && (symbol <= max_symbol)) {
+		bits = (uint32_t)zstd_bits_get(src, size, pos, nbits);
+		max = (2 * threshold - 1) - remaining;
+		if ((int32_t)(bits & (uint32_t)(threshold - 1)) < max) {
+			val = (int32_t)(bits & (uint32_t)(threshold - 1));
+			pos += nbits - 1U;
+		} else {
+			val = (int32_t)(bits & (uint32_t)(2 * threshold - 1));
+			if (val >= threshold) {
+				val -= max;
+			}
+			pos += nbits;
+		}
+
+		/* -1 is the "less than one" probability and still takes a slot */
+		val--;
+		remaining -= (val < 0) ? -val : val;
+		norm[symbol++] = (int16_t)val;
+
+		/* a zero count is followed by 2-bit repeat flags for more zeros */
+		if (val == 0) {
+			do {
+				repeat = (uint32_t)zstd_bits_get(src, size, pos, 2);
+				pos += 2U;
+				if ((symbol + repeat) > (max_symbol + 1U)) {
+					return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 13);
+				}
+				for (i = 0; i < repeat; i++) {
+					norm[symbol++] = 0;
+				}
+			} while ((repeat == 3U) && (pos < (size * 8U)));
+		}
+
+		while (remaining < threshold) {
+			nbits--;
+			threshold >>= 1;
+		}
+	}
+
+	if ((remaining != 1) || (pos > (size * 8U))) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 14);
+	}
+
+	*num_symbols = symbol;
+	*consumed = (pos + 7U) >> 3;
+
+	return TEGRABL_NO_ERROR;
+}
+
+static tegrabl_error_t fse_build_table(struct fse_entry *table,
+									   const int16_t *norm,
+									   uint32_t num_symbols, uint32_t log)
+{
+	uint16_t next[HUF_MAX_SYMBOLS];
+	uint32_t size = 1U << log;
+	uint32_t mask = size - 1U;
+	uint32_t high = size - 1U;
+	uint32_t step = (size >> 1) + (size >> 3) + 3U;
+	uint32_t pos = 0;
+	uint32_t s;
+	uint32_t i;
+	uint32_t state;
+
+	/* "less than one" symbols go to the top of the table */
+	for (s = 0; s < num_symbols; s++) {
+		if (norm[s] == -1) {
+			table[high--].symbol = (uint8_t)s;
+			next[s] = 1;
+		} else {
+			next[s] = (uint16_t)norm[s];
+		}
+	}
+
+	for (s = 0; s < num_symbols; s++) {
+		for (i = 0; (int32_t)i < norm[s]; i++) {
+			table[pos].symbol = (uint8_t)s;
+			do {
+				pos = (pos + step) & mask;
+			} while (pos > high);
+		}
+	}
+
+	if (pos != 0U) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 15);
+	}
+
+	for (i = 0; i < size; i++) {
+		s = table[i].symbol;
+		state = next[s]++;
+		table[i].nb_bits = (uint8_t)(log - zstd_highbit(state));
+		table[i].baseline = (uint16_t)((state << table[i].nb_bits) - size);
+	}
+
+	return TEGRABL_NO_ERROR;
+}
+
+static tegrabl_error_t huf_build_table(struct huf_table *huf,
+									   const uint8_t *weights,
+									   uint32_t num_weights)
+{
+	uint32_t rank_count[HUF_MAX_BITS + 1U];
+	uint32_t rank_idx[HUF_MAX_BITS + 1U];
+	uint8_t bits[HUF_MAX_SYMBOLS];
+	uint32_t total = 0;
+	uint32_t max_bits;
+	uint32_t left;
+	uint32_t last;
+	uint32_t i;
+	uint32_t len;
+
+	if ((num_weights == 0U) || (num_weights >= HUF_MAX_SYMBOLS)) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 16);
+	}
+
+	for (i = 0; i < num_weights; i++) {
+		if (weights[i] > HUF_MAX_BITS) {
+			return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 17);
+		}
+		if (weights[i] > 0U) {
+			total += 1U << (weights[i] - 1U);
+		}
+	}
+	if (total == 0U) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 17);
+	}
+
+	/* the weight of the last symbol completes the tree to a power of two */
+	max_bits = zstd_highbit(total) + 1U;
+	left = (1U << max_bits) - total;
+	if ((max_bits > HUF_MAX_BITS) || ((left & (left - 1U)) != 0U)) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 18);
+	}
+	last = zstd_highbit(left) + 1U;
+
+	memset(rank_count, 0, sizeof(rank_count));
+	for (i = 0; i <= num_weights; i++) {
+		len = (i < num_weights) ? weights[i] : last;
+		bits[i] = (len > 0U) ? (uint8_t)(max_bits + 1U - len) : 0U;
+		rank_count[bits[i]]++;
+	}
+
+	/* longest codes take the lowest table indices */
+	rank_idx[max_bits] = 0;
+	for (i = max_bits; i >= 1U; i--) {
+		rank_idx[i - 1U] = rank_idx[i] + rank_count[i] * (1U << (max_bits - i));
+		memset(&huf->nb_bits[rank_idx[i]], (int)i, rank_idx[i - 1U] - rank_idx[i]);
+	}
+
+	for (i = 0; i <= num_weights; i++) {
+		if (bits[i] != 0U) {
+			len = 1U << (max_bits - bits[i]);
+			memset(&huf->symbol[rank_idx[bits[i]]], (int)i, len);
+			rank_idx[bits[i]] += len;
+		}
+	}
+
+	huf->max_bits = max_bits;
+	huf->valid = true;
+
+	return TEGRABL_NO_ERROR;
+}
+
+/* Huffman tree description, returns the number of bytes it takes */
+static tegrabl_error_t huf_read_table(struct huf_table *huf, const uint8_t *src,
+									  uint32_t size, uint32_t *consumed)
+{
+	struct fse_entry table[1U << HUF_WEIGHTS_LOG_MAX];
+	int16_t norm[HUF_MAX_SYMBOLS];
+	uint8_t weights[HUF_MAX_SYMBOLS];
+	struct zstd_rbits br;
+	uint32_t num_weights = 0;
+	uint32_t num_symbols;
+	uint32_t header;
+	uint32_t log;
+	uint32_t used;
+	uint32_t state1;
+	uint32_t state2;
+	uint32_t i;
+	tegrabl_error_t err;
+
+	if (size == 0U) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 19);
+	}
+
+	header = src[0];
+	if (header >= 128U) {
+		/* 4-bit weights stored directly */
+		num_weights = header - 127U;
+		*consumed = 1U + ((num_weights + 1U) >> 1);
+		if (*consumed > size) {
+			return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 19);
+		}
+		for (i = 0; i < num_weights; i++) {
+			weights[i] = ((i & 1U) != 0U) ? (src[1U + (i >> 1)] & 0xFU) :
+				(src[1U + (i >> 1)] >> 4);
+		}
+		return huf_build_table(huf, weights, num_weights);
+	}
+
+	/* FSE compressed weights, two interleaved states on one table */
+	*consumed = 1U + header;
+	if (*consumed > size) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 19);
+	}
+
+	memset(norm, 0, sizeof(norm));
+	err = fse_read_norm(src + 1, header, norm, &num_symbols, HUF_MAX_SYMBOLS - 1U,
+						&log, HUF_WEIGHTS_LOG_MAX, &used);
+	if (err != TEGRABL_NO_ERROR) {
+		return err;
+	}
+	err = fse_build_table(table, norm, num_symbols, log);
+	if (err != TEGRABL_NO_ERROR) {
+		return err;
+	}
+	err = zstd_rbits_init(&br, src + 1 + used, header - used);
+	if (err != TEGRABL_NO_ERROR) {
+		return err;
+	}
+
+	state1 = zstd_rbits_read(&br, log);
+	state2 = zstd_rbits_read(&br, log);
+
+	/* stop once a state update would read past the start of the stream */
+	while (num_weights < (HUF_MAX_SYMBOLS - 2U)) {
+		weights[num_weights++] = table[state1].symbol;
+		state1 = table[state1].baseline + zstd_rbits_read(&br, table[state1].nb_bits);
+		if (zstd_rbits_left(&br) < 0) {
+			weights[num_weights++] = table[state2].symbol;
+			break;
+		}
+		weights[num_weights++] = table[state2].symbol;
+		state2 = table[state2].baseline + zstd_rbits_read(&br, table[state2].nb_bits);
+		if (zstd_rbits_left(&br) < 0) {
+			weights[num_weights++] = table[state1].symbol;
+			break;
+		}
+	}
+
+	if (zstd_rbits_left(&br) >= 0) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 20);
+	}
+
+	return huf_build_table(huf, weights, num_weights);
+}
+
+/* Caller guarantees that max_bits more bits are in the container */
+#define HUF_DECODE_FAST(br, huf, out)										\
+	do {																	\
+		uint32_t _v = (uint32_t)((((br)->container << (br)->consumed) >> 1) >>	\
+								 (63U - (huf)->max_bits));					\
+		(out) = (huf)->symbol[_v];											\
+		(br)->consumed += (huf)->nb_bits[_v];								\
+	} while (false)
+
+static tegrabl_error_t huf_decode_stream(const struct huf_table *huf,
+										 const uint8_t *src, uint32_t size,
+										 uint8_t *dst, uint32_t count)
+{
+	struct zstd_rbits br;
+	uint32_t val;
+	uint32_t i;
+	tegrabl_error_t err;
+
+	err = zstd_rbits_init(&br, src, size);
+	if (err != TEGRABL_NO_ERROR) {
+		return err;
+	}
+
+	/* four symbols per container refill while far enough from the start */
+	for (i = 0; (i + 4U) <= count; i += 4U) {
+		zstd_rbits_reload(&br);
+		if (br.consumed > (64U - 4U * HUF_MAX_BITS)) {
+			break;
+		}
+		HUF_DECODE_FAST(&br, huf, dst[i]);
+		HUF_DECODE_FAST(&br, huf, dst[i + 1U]);
+		HUF_DECODE_FAST(&br, huf, dst[i + 2U]);
+		HUF_DECODE_FAST(&br, huf, dst[i + 3U]);
+	}
+
+	for (; i < count; i++) {
+		val = zstd_rbits_peek(&br, huf->max_bits);
+		dst[i] = huf->symbol[val];
+		br.consumed += huf->nb_bits[val];
+	}
+
+	if (zstd_rbits_left(&br) != 0) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 21);
+	}
+
+	return TEGRABL_NO_ERROR;
+}
+
+static tegrabl_error_t zstd_decode_literals(struct tegrabl_zstd_stream *zs,
+											const uint8_t *src, uint32_t size,
+											const uint8_t **literals,
+											uint32_t *lit_size,
+											uint32_t *consumed)
+{
+	uint32_t type = src[0] & 0x3U;
+	uint32_t format = (src[0] >> 2) & 0x3U;
+	uint32_t regen;
+	uint32_t csize;
+	uint32_t hsize;
+	uint32_t streams = 4;
+	uint32_t tree_size = 0;
+	uint32_t s[4];
+	uint32_t seg;
+	uint32_t i;
+	uint64_t h;
+	tegrabl_error_t err;
+
+	if ((type == ZSTD_LIT_RAW) || (type == ZSTD_LIT_RLE)) {
+		if ((format & 1U) == 0U) {
+			hsize = 1;
+			regen = (uint32_t)src[0] >> 3;
+		} else if (format == 1U) {
+			hsize = 2;
+			if (size < hsize) {
+				return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 22);
+			}
+			regen = zstd_read_le16(src) >> 4;
+		} else {
+			hsize = 3;
+			if (size < hsize) {
+				return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 22);
+			}
+			regen = zstd_read_le24(src) >> 4;
+		}
+		if (regen > ZSTD_BLOCK_SIZE_MAX) {
+			return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 23);
+		}
+
+		if (type == ZSTD_LIT_RAW) {
+			if ((hsize + regen) > size) {
+				return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 22);
+			}
+			/* no need to copy, sequences read straight from the block */
+			*literals = src + hsize;
+			*consumed = hsize + regen;
+		} else {
+			if (hsize >= size) {
+				return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 22);
+			}
+			memset(zs->literals, src[hsize], regen);
+			*literals = zs->literals;
+			*consumed = hsize + 1U;
+		}
+		*lit_size = regen;
+		return TEGRABL_NO_ERROR;
+	}
+
+	/* Huffman coded literals */
+	hsize = (format < 2U) ? 3U : (format + 2U);
+	if (size < hsize) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 22);
+	}
+	if (format < 2U) {
+		h = zstd_read_le24(src);
+	} else if (format == 2U) {
+		h = zstd_read_le32(src);
+	} else {
+		h = zstd_read_le32(src) | ((uint64_t)src[4] << 32);
+	}
+	if (format == 0U) {
+		streams = 1;
+	}
+	if (format < 2U) {
+		regen = (uint32_t)(h >> 4) & 0x3FFU;
+		csize = (uint32_t)(h >> 14) & 0x3FFU;
+	} else if (format == 2U) {
+		regen = (uint32_t)(h >> 4) & 0x3FFFU;
+		csize = (uint32_t)(h >> 18) & 0x3FFFU;
+	} else {
+		regen = (uint32_t)(h >> 4) & 0x3FFFFU;
+		csize = (uint32_t)(h >> 22) & 0x3FFFFU;
+	}
+	if ((regen > ZSTD_BLOCK_SIZE_MAX) || ((hsize + csize) > size)) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 23);
+	}
+	src += hsize;
+
+	if (type == ZSTD_LIT_COMPRESSED) {
+		err = huf_read_table(&zs->huf, src, csize, &tree_size);
+		if (err != TEGRABL_NO_ERROR) {
+			return err;
+		}
+	} else if (!zs->huf.valid) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 24);
+	}
+	src += tree_size;
+	csize -= tree_size;
+
+	if (streams == 1U) {
+		err = huf_decode_stream(&zs->huf, src, csize, zs->literals, regen);
+	} else {
+		if (csize < 6U) {
+			return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 25);
+		}
+		s[0] = zstd_read_le16(src);
+		s[1] = zstd_read_le16(src + 2);
+		s[2] = zstd_read_le16(src + 4);
+		if ((s[0] + s[1] + s[2] + 6U) > csize) {
+			return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 25);
+		}
+		s[3] = csize - 6U - s[0] - s[1] - s[2];
+		seg = (regen + 3U) / 4U;
+		if ((3U * seg) > regen) {
+			return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 25);
+		}
+		src += 6;
+		err = TEGRABL_NO_ERROR;
+		for (i = 0; (i < 4U) && (err == TEGRABL_NO_ERROR); i++) {
+			err = huf_decode_stream(&zs->huf, src, s[i], zs->literals + i * seg,
+									(i < 3U) ? seg : (regen - 3U * seg));
+			src += s[i];
+		}
+	}
+	if (err != TEGRABL_NO_ERROR) {
+		return err;
+	}
+
+	*literals = zs->literals;
+	*lit_size = regen;
+	*consumed = hsize + tree_size + csize;
+
+	return TEGRABL_NO_ERROR;
+}
+
+static tegrabl_error_t zstd_read_seq_table(struct fse_table *table,
+										   uint32_t mode, const uint8_t *src,
+										   uint32_t size, uint32_t *consumed,
+										   const int16_t *default_norm,
+										   uint32_t default_symbols,
+										   uint32_t default_log,
+										   uint32_t max_symbol,
+										   uint32_t max_log)
+{
+	int16_t norm[ML_MAX_SYMBOL + 1U];
+	uint32_t num_symbols;
+	tegrabl_error_t err;
+
+	*consumed = 0;
+
+	switch (mode) {
+	case ZSTD_SEQ_PREDEFINED:
+		table->log = default_log;
+		err = fse_build_table(table->entry, default_norm, default_symbols,
+							  default_log);
+		break;
+
+	case ZSTD_SEQ_RLE:
+		if ((size == 0U) || (src[0] > max_symbol)) {
+			return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 26);
+		}
+		table->log = 0;
+		table->entry[0].symbol = src[0];
+		table->entry[0].nb_bits = 0;
+		table->entry[0].baseline = 0;
+		*consumed = 1;
+		err = TEGRABL_NO_ERROR;
+		break;
+
+	case ZSTD_SEQ_FSE:
+		err = fse_read_norm(src, size, norm, &num_symbols, max_symbol,
+							&table->log, max_log, consumed);
+		if (err == TEGRABL_NO_ERROR) {
+			err = fse_build_table(table->entry, norm, num_symbols, table->log);
+		}
+		break;
+
+	default:
+		/* repeat the table of the previous block */
+		if (!table->valid) {
+			return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 27);
+		}
+		return TEGRABL_NO_ERROR;
+	}
+
+	table->valid = (err == TEGRABL_NO_ERROR);
+
+	return err;
+}
+
+/* The wild copies below round the length up to 8 bytes */
+#define ZSTD_WILDCOPY_OVERRUN		8U
+
+static inline void zstd_wildcopy(uint8_t *dst, const uint8_t *src,
+								 uint32_t len)
+{
+	uint8_t *end = dst + len;
+
+	/* fixed-size copies are expanded inline even with -fno-builtin */
+	do {
+		__builtin_memcpy(dst, src, 8);
+		dst += 8;
+		src += 8;
+	} while (dst < end);
+}
+
+static inline void zstd_copy_match(uint8_t *dst, uint32_t offset, uint32_t len,
+								   bool wild)
+{
+	const uint8_t *src = dst - offset;
+	uint32_t head;
+	uint32_t i;
+
+	if (!wild) {
+		for (i = 0; i < len; i++) {
+			dst[i] = src[i];
+		}
+		return;
+	}
+
+	if (offset < 8U) {
+		/*
+		 * The match repeats with period offset, so once a few bytes are in
+		 * place it can be copied from a multiple of offset which is at
+		 * least 8 bytes back.
+		 */
+		head = ((8U + offset - 1U) / offset) * offset - offset;
+		for (i = 0; (i < head) && (i < len); i++) {
+			dst[i] = src[i];
+		}
+		if (len <= head) {
+			return;
+		}
+		dst += head;
+		len -= head;
+		src = dst - (head + offset);
+	}
+
+	zstd_wildcopy(dst, src, len);
+}
+
+static tegrabl_error_t zstd_decode_sequences(struct tegrabl_zstd_stream *zs,
+											 const uint8_t *src, uint32_t size,
+											 const uint8_t *literals,
+											 uint32_t lit_size)
+{
+	struct zstd_rbits br;
+	const struct fse_entry *ll;
+	const struct fse_entry *of;
+	const struct fse_entry *ml;
+	uint32_t ll_state;
+	uint32_t of_state;
+	uint32_t ml_state;
+	uint32_t num_seq;
+	uint32_t modes;
+	uint32_t pos;
+	uint32_t used;
+	uint32_t lit_len;
+	uint32_t match_len;
+	uint32_t offset;
+	uint32_t idx;
+	uint32_t code;
+	uint32_t room;
+	const uint8_t *lit_end = literals + lit_size;
+	tegrabl_error_t err;
+
+	if (size == 0U) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 28);
+	}
+
+	if (src[0] < 128U) {
+		num_seq = src[0];
+		pos = 1;
+	} else if (src[0] < 255U) {
+		if (size < 2U) {
+			return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 28);
+		}
+		num_seq = ((src[0] - 128U) << 8) + src[1];
+		pos = 2;
+	} else {
+		if (size < 3U) {
+			return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 28);
+		}
+		num_seq = zstd_read_le16(src + 1) + 0x7F00U;
+		pos = 3;
+	}
+
+	if (num_seq > 0U) {
+		if (pos >= size) {
+			return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 28);
+		}
+		modes = src[pos++];
+		if ((modes & 0x3U) != 0U) {
+			return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 29);
+		}
+
+		err = zstd_read_seq_table(&zs->ll, modes >> 6, src + pos, size - pos,
+								  &used, ll_default_norm, LL_MAX_SYMBOL + 1U, 6,
+								  LL_MAX_SYMBOL, LL_LOG_MAX);
+		if (err != TEGRABL_NO_ERROR) {
+			return err;
+		}
+		pos += used;
+		err = zstd_read_seq_table(&zs->of, (modes >> 4) & 0x3U, src + pos,
+								  size - pos, &used, of_default_norm,
+								  ARRAY_SIZE(of_default_norm), 5,
+								  OF_MAX_SYMBOL, OF_LOG_MAX);
+		if (err != TEGRABL_NO_ERROR) {
+			return err;
+		}
+		pos += used;
+		err = zstd_read_seq_table(&zs->ml, (modes >> 2) & 0x3U, src + pos,
+								  size - pos, &used, ml_default_norm,
+								  ML_MAX_SYMBOL + 1U, 6, ML_MAX_SYMBOL,
+								  ML_LOG_MAX);
+		if (err != TEGRABL_NO_ERROR) {
+			return err;
+		}
+		pos += used;
+
+		if (pos > size) {
+			return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 28);
+		}
+		err = zstd_rbits_init(&br, src + pos, size - pos);
+		if (err != TEGRABL_NO_ERROR) {
+			return err;
+		}
+
+		ll = zs->ll.entry;
+		of = zs->of.entry;
+		ml = zs->ml.entry;
+		ll_state = zstd_rbits_read(&br, zs->ll.log);
+		of_state = zstd_rbits_read(&br, zs->of.log);
+		ml_state = zstd_rbits_read(&br, zs->ml.log);
+
+		while (num_seq-- > 0U) {
+			code = of[of_state].symbol;
+			offset = (1U << code) + zstd_rbits_read(&br, code);
+			code = ml[ml_state].symbol;
+			match_len = ml_base[code] + zstd_rbits_read(&br, ml_bits[code]);
+			code = ll[ll_state].symbol;
+			lit_len = ll_base[code] + zstd_rbits_read(&br, ll_bits[code]);
+
+			if (num_seq > 0U) {
+				ll_state = ll[ll_state].baseline +
+					zstd_rbits_read(&br, ll[ll_state].nb_bits);
+				ml_state = ml[ml_state].baseline +
+					zstd_rbits_read(&br, ml[ml_state].nb_bits);
+				of_state = of[of_state].baseline +
+					zstd_rbits_read(&br, of[of_state].nb_bits);
+			}
+
+			if (offset > 3U) {
+				offset -= 3U;
+				zs->rep[2] = zs->rep[1];
+				zs->rep[1] = zs->rep[0];
+				zs->rep[0] = offset;
+			} else {
+				/* repeat offsets are shifted by one after empty literals */
+				idx = offset - 1U + ((lit_len == 0U) ? 1U : 0U);
+				if (idx == 0U) {
+					offset = zs->rep[0];
+				} else {
+					offset = (idx < 3U) ? zs->rep[idx] : (zs->rep[0] - 1U);
+					if (idx > 1U) {
+						zs->rep[2] = zs->rep[1];
+					}
+					zs->rep[1] = zs->rep[0];
+					zs->rep[0] = offset;
+				}
+			}
+
+			room = zs->out_size - zs->out_pos;
+			if ((lit_len > (uint32_t)(lit_end - literals)) ||
+				((uint64_t)lit_len + match_len > room)) {
+				return TEGRABL_ERROR(TEGRABL_ERR_OVERFLOW, 1);
+			}
+			if (((lit_len + ZSTD_WILDCOPY_OVERRUN) <= (uint32_t)(lit_end - literals)) &&
+				((lit_len + ZSTD_WILDCOPY_OVERRUN) <= room)) {
+				zstd_wildcopy(zs->out + zs->out_pos, literals, lit_len);
+			} else {
+				memcpy(zs->out + zs->out_pos, literals, lit_len);
+			}
+			literals += lit_len;
+			zs->out_pos += lit_len;
+			room -= lit_len;
+
+			if ((offset == 0U) || (offset > (zs->out_pos - zs->frame_start))) {
+				return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 30);
+			}
+			zstd_copy_match(zs->out + zs->out_pos, offset, match_len,
+							(match_len + ZSTD_WILDCOPY_OVERRUN) <= room);
+			zs->out_pos += match_len;
+		}
+
+		if (zstd_rbits_left(&br) != 0) {
+			return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 31);
+		}
+	} else if (pos != size) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 28);
+	}
+
+	/* trailing literals */
+	lit_len = (uint32_t)(lit_end - literals);
+	if (lit_len > (zs->out_size - zs->out_pos)) {
+		return TEGRABL_ERROR(TEGRABL_ERR_OVERFLOW, 1);
+	}
+	memcpy(zs->out + zs->out_pos, literals, lit_len);
+	zs->out_pos += lit_len;
+
+	return TEGRABL_NO_ERROR;
+}
+
+static tegrabl_error_t zstd_decode_block(struct tegrabl_zstd_stream *zs,
+										 const uint8_t *src)
+{
+	const uint8_t *literals;
+	uint32_t lit_size;
+	uint32_t used;
+	tegrabl_error_t err;
+
+	switch (zs->block_type) {
+	case ZSTD_BLOCK_RAW:
+		if (zs->block_size > (zs->out_size - zs->out_pos)) {
+			return TEGRABL_ERROR(TEGRABL_ERR_OVERFLOW, 2);
+		}
+		memcpy(zs->out + zs->out_pos, src, zs->block_size);
+		zs->out_pos += zs->block_size;
+		return TEGRABL_NO_ERROR;
+
+	case ZSTD_BLOCK_RLE:
+		if (zs->block_size > (zs->out_size - zs->out_pos)) {
+			return TEGRABL_ERROR(TEGRABL_ERR_OVERFLOW, 2);
+		}
+		memset(zs->out + zs->out_pos, src[0], zs->block_size);
+		zs->out_pos += zs->block_size;
+		return TEGRABL_NO_ERROR;
+
+	default:
+		break;
+	}
+
+	if (zs->block_size == 0U) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 32);
+	}
+
+	err = zstd_decode_literals(zs, src, zs->block_size, &literals, &lit_size,
+							   &used);
+	if (err != TEGRABL_NO_ERROR) {
+		return err;
+	}
+
+	return zstd_decode_sequences(zs, src + used, zs->block_size - used,
+								 literals, lit_size);
+}
+
+#define XXH_PRIME64_1	0x9E3779B185EBCA87ULL
+#define XXH_PRIME64_2	0xC2B2AE3D27D4EB4FULL
+#define XXH_PRIME64_3	0x165667B19E3779F9ULL
+#define XXH_PRIME64_4	0x85EBCA77C2B2AE63ULL
+#define XXH_PRIME64_5	0x27D4EB2F165667C5ULL
+
+static inline uint64_t xxh_rotl64(uint64_t x, uint32_t r)
+{
+	return (x << r) | (x >> (64U - r));
+}
+
+static inline uint64_t xxh64_round(uint64_t acc, uint64_t input)
+{
+	acc += input * XXH_PRIME64_2;
+	acc = xxh_rotl64(acc, 31);
+	return acc * XXH_PRIME64_1;
+}
+
+static inline uint64_t xxh64_merge(uint64_t acc, uint64_t val)
+{
+	acc ^= xxh64_round(0, val);
+	return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+/* XXH64 with seed 0, the content checksum of a zstd frame */
+static uint64_t zstd_xxh64(const uint8_t *p, uint32_t len)
+{
+	const uint8_t *end = p + len;
+	uint64_t v1 = XXH_PRIME64_1 + XXH_PRIME64_2;
+	uint64_t v2 = XXH_PRIME64_2;
+	uint64_t v3 = 0;
+	uint64_t v4 = 0ULL - XXH_PRIME64_1;
+	uint64_t h;
+
+	if (len >= 32U) {
+		do {
+			v1 = xxh64_round(v1, zstd_read_le64(p));
+			v2 = xxh64_round(v2, zstd_read_le64(p + 8));
+			v3 = xxh64_round(v3, zstd_read_le64(p + 16));
+			v4 = xxh64_round(v4, zstd_read_le64(p + 24));
+			p += 32;
+		} while ((uint32_t)(end - p) >= 32U);
+
+		h = xxh_rotl64(v1, 1) + xxh_rotl64(v2, 7) + xxh_rotl64(v3, 12) +
+			xxh_rotl64(v4, 18);
+		h = xxh64_merge(h, v1);
+		h = xxh64_merge(h, v2);
+		h = xxh64_merge(h, v3);
+		h = xxh64_merge(h, v4);
+	} else {
+		h = XXH_PRIME64_5;
+	}
+
+	h += len;
+
+	while ((uint32_t)(end - p) >= 8U) {
+		h ^= xxh64_round(0, zstd_read_le64(p));
+		h = xxh_rotl64(h, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+		p += 8;
+	}
+	if ((uint32_t)(end - p) >= 4U) {
+		h ^= (uint64_t)zstd_read_le32(p) * XXH_PRIME64_1;
+		h = xxh_rotl64(h, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+		p += 4;
+	}
+	while (p < end) {
+		h ^= (uint64_t)(*p++) * XXH_PRIME64_5;
+		h = xxh_rotl64(h, 11) * XXH_PRIME64_1;
+	}
+
+	h ^= h >> 33;
+	h *= XXH_PRIME64_2;
+	h ^= h >> 29;
+	h *= XXH_PRIME64_3;
+	h ^= h >> 32;
+
+	return h;
+}
+
+static tegrabl_error_t zstd_frame_header(struct tegrabl_zstd_stream *zs,
+										 const uint8_t *src)
+{
+	uint8_t desc = zs->frame_desc;
+	uint32_t dict_size = (0x04020100U >> (8U * ZSTD_FHD_DICT_ID_FLAG(desc))) & 0xFFU;
+	uint32_t fcs_flag = ZSTD_FHD_FCS_FLAG(desc);
+	uint64_t window = 0;
+	uint32_t exponent;
+	uint32_t i;
+
+	if ((desc & ZSTD_FHD_SINGLE_SEGMENT) == 0U) {
+		exponent = ((uint32_t)src[0] >> 3) + ZSTD_WINDOW_LOG_MIN;
+		window = 1ULL << exponent;
+		window += (window >> 3) * (src[0] & 0x7U);
+		src++;
+	}
+
+	for (i = 0; i < dict_size; i++) {
+		if (src[i] != 0U) {
+			pr_error("zstd: dictionaries are not supported\n");
+			return TEGRABL_ERROR(TEGRABL_ERR_NOT_SUPPORTED, 0);
+		}
+	}
+	src += dict_size;
+
+	zs->has_content_size = (fcs_flag != 0U) ||
+		((desc & ZSTD_FHD_SINGLE_SEGMENT) != 0U);
+	switch (fcs_flag) {
+	case 0:
+		zs->content_size = zs->has_content_size ? src[0] : 0U;
+		break;
+	case 1:
+		zs->content_size = zstd_read_le16(src) + 256U;
+		break;
+	case 2:
+		zs->content_size = zstd_read_le32(src);
+		break;
+	default:
+		zs->content_size = zstd_read_le64(src);
+		break;
+	}
+
+	/* single segment frames use the content size as window */
+	if (window == 0ULL) {
+		window = zs->content_size;
+	}
+	zs->block_max = (window < ZSTD_BLOCK_SIZE_MAX) ? (uint32_t)window :
+		ZSTD_BLOCK_SIZE_MAX;
+
+	if (zs->has_content_size &&
+		(zs->content_size > (uint64_t)(zs->out_size - zs->out_pos))) {
+		pr_error("zstd: content size %"PRIu64" does not fit output buffer\n",
+				 zs->content_size);
+		return TEGRABL_ERROR(TEGRABL_ERR_OVERFLOW, 3);
+	}
+
+	return TEGRABL_NO_ERROR;
+}
+
+static tegrabl_error_t zstd_frame_end(struct tegrabl_zstd_stream *zs)
+{
+	if (zs->has_content_size &&
+		(zs->content_size != (uint64_t)(zs->out_pos - zs->frame_start))) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 33);
+	}
+
+	zs->frame_count++;
+	zs->stage = ZSTD_STAGE_MAGIC;
+	zs->need = ZSTD_MAGIC_SIZE;
+
+	return TEGRABL_NO_ERROR;
+}
+
+/* Consume one input unit of zs->need bytes and set up the next one */
+static tegrabl_error_t zstd_process(struct tegrabl_zstd_stream *zs,
+									const uint8_t *src)
+{
+	uint32_t magic;
+	uint32_t header;
+	uint8_t desc;
+	uint64_t csum;
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+
+	switch (zs->stage) {
+	case ZSTD_STAGE_MAGIC:
+		magic = zstd_read_le32(src);
+		if (magic == ZSTD_MAGIC) {
+			zs->stage = ZSTD_STAGE_FRAME_DESC;
+			zs->need = 1;
+		} else if ((magic & ZSTD_SKIPPABLE_MASK) == ZSTD_SKIPPABLE_MAGIC) {
+			zs->stage = ZSTD_STAGE_SKIP_SIZE;
+			zs->need = 4;
+		} else if ((magic == 0U) && (zs->frame_count != 0U)) {
+			/* partitions and blobs may be zero padded after the last frame */
+			zs->stage = ZSTD_STAGE_PADDING;
+			zs->need = 0;
+		} else {
+			pr_error("zstd: bad frame magic 0x%08x\n", magic);
+			err = TEGRABL_ERROR(TEGRABL_ERR_INVALID, 1);
+		}
+		break;
+
+	case ZSTD_STAGE_FRAME_DESC:
+		desc = src[0];
+		if ((desc & ZSTD_FHD_RESERVED) != 0U) {
+			err = TEGRABL_ERROR(TEGRABL_ERR_INVALID, 2);
+			break;
+		}
+		zs->frame_desc = desc;
+		zs->need = ((desc & ZSTD_FHD_SINGLE_SEGMENT) == 0U) ? 1U : 0U;
+		zs->need += (0x04020100U >> (8U * ZSTD_FHD_DICT_ID_FLAG(desc))) & 0xFFU;
+		if (ZSTD_FHD_FCS_FLAG(desc) != 0U) {
+			zs->need += 1U << ZSTD_FHD_FCS_FLAG(desc);
+		} else if ((desc & ZSTD_FHD_SINGLE_SEGMENT) != 0U) {
+			zs->need += 1U;
+		}
+		zs->stage = ZSTD_STAGE_FRAME_HEADER;
+		break;
+
+	case ZSTD_STAGE_FRAME_HEADER:
+		err = zstd_frame_header(zs, src);
+		if (err != TEGRABL_NO_ERROR) {
+			break;
+		}
+		zs->frame_start = zs->out_pos;
+		zs->rep[0] = 1;
+		zs->rep[1] = 4;
+		zs->rep[2] = 8;
+		zs->huf.valid = false;
+		zs->ll.valid = false;
+		zs->of.valid = false;
+		zs->ml.valid = false;
+		zs->stage = ZSTD_STAGE_BLOCK_HEADER;
+		zs->need = ZSTD_BLOCK_HEADER_SIZE;
+		break;
+
+	case ZSTD_STAGE_BLOCK_HEADER:
+		header = zstd_read_le24(src);
+		zs->last_block = (header & 1U) != 0U;
+		zs->block_type = (uint8_t)((header >> 1) & 0x3U);
+		zs->block_size = header >> 3;
+		if ((zs->block_type > ZSTD_BLOCK_COMPRESSED) ||
+			(zs->block_size > zs->block_max)) {
+			err = TEGRABL_ERROR(TEGRABL_ERR_INVALID, 3);
+			break;
+		}
+		zs->need = (zs->block_type == ZSTD_BLOCK_RLE) ? 1U : zs->block_size;
+		zs->stage = ZSTD_STAGE_BLOCK;
+		break;
+
+	case ZSTD_STAGE_BLOCK:
+		err = zstd_decode_block(zs, src);
+		if (err != TEGRABL_NO_ERROR) {
+			break;
+		}
+		if (!zs->last_block) {
+			zs->stage = ZSTD_STAGE_BLOCK_HEADER;
+			zs->need = ZSTD_BLOCK_HEADER_SIZE;
+		} else if ((zs->frame_desc & ZSTD_FHD_CHECKSUM) != 0U) {
+			zs->stage = ZSTD_STAGE_CHECKSUM;
+			zs->need = ZSTD_CHECKSUM_SIZE;
+		} else {
+			err = zstd_frame_end(zs);
+		}
+		break;
+
+	case ZSTD_STAGE_CHECKSUM:
+		csum = zstd_xxh64(zs->out + zs->frame_start,
+						  zs->out_pos - zs->frame_start);
+		if ((uint32_t)csum != zstd_read_le32(src)) {
+			pr_error("zstd: content checksum mismatch\n");
+			err = TEGRABL_ERROR(TEGRABL_ERR_VERIFY_FAILED, 0);
+			break;
+		}
+		err = zstd_frame_end(zs);
+		break;
+
+	case ZSTD_STAGE_SKIP_SIZE:
+		zs->skip_left = zstd_read_le32(src);
+		zs->stage = ZSTD_STAGE_SKIP;
+		zs->need = 0;
+		break;
+
+	default:
+		err = TEGRABL_ERROR(TEGRABL_ERR_INVALID_STATE, 0);
+		break;
+	}
+
+	return err;
+}
+
+static void zstd_stream_reset(struct tegrabl_zstd_stream *zs, void *out_buffer,
+							  uint32_t outbuf_size)
+{
+	zs->out = out_buffer;
+	zs->out_size = outbuf_size;
+	zs->out_pos = 0;
+	zs->frame_start = 0;
+	zs->frame_count = 0;
+	zs->stage = ZSTD_STAGE_MAGIC;
+	zs->need = ZSTD_MAGIC_SIZE;
+	zs->staged = 0;
+}
+
+tegrabl_error_t tegrabl_zstd_stream_open(void *out_buffer, uint32_t outbuf_size,
+										 struct tegrabl_zstd_stream **stream)
+{
+	struct tegrabl_zstd_stream *zs;
+
+	if ((out_buffer == NULL) || (stream == NULL)) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 4);
+	}
+
+	zs = zstd_init(0);
+	if (zs == NULL) {
+		return TEGRABL_ERROR(TEGRABL_ERR_NO_MEMORY, 0);
+	}
+
+	zstd_stream_reset(zs, out_buffer, outbuf_size);
+	*stream = zs;
+
+	return TEGRABL_NO_ERROR;
+}
+
+tegrabl_error_t tegrabl_zstd_stream_write(struct tegrabl_zstd_stream *zs,
+										  const void *in_buffer,
+										  uint32_t in_size)
+{
+	const uint8_t *in = in_buffer;
+	const uint8_t *unit;
+	uint32_t len;
+	tegrabl_error_t err;
+
+	if ((zs == NULL) || ((in == NULL) && (in_size != 0U))) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 5);
+	}
+
+	while (true) {
+		if (zs->stage == ZSTD_STAGE_SKIP) {
+			/* skippable frames can be large, drop them without staging */
+			len = MIN(zs->skip_left, in_size);
+			zs->skip_left -= len;
+			in += len;
+			in_size -= len;
+			if (zs->skip_left != 0U) {
+				break;
+			}
+			zs->stage = ZSTD_STAGE_MAGIC;
+			zs->need = ZSTD_MAGIC_SIZE;
+			continue;
+		}
+
+		if (zs->stage == ZSTD_STAGE_PADDING) {
+			for (len = 0; len < in_size; len++) {
+				if (in[len] != 0U) {
+					pr_error("zstd: trailing garbage after last frame\n");
+					return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 7);
+				}
+			}
+			break;
+		}
+
+		if ((zs->staged == 0U) && (in_size >= zs->need)) {
+			/* whole unit available, decode in place */
+			unit = in;
+			in += zs->need;
+			in_size -= zs->need;
+		} else {
+			if (in_size == 0U) {
+				break;
+			}
+			if (zs->stage_buf == NULL) {
+				zs->stage_buf = tegrabl_malloc(ZSTD_BLOCK_SIZE_MAX);
+				if (zs->stage_buf == NULL) {
+					return TEGRABL_ERROR(TEGRABL_ERR_NO_MEMORY, 1);
+				}
+			}
+			len = MIN(zs->need - zs->staged, in_size);
+			memcpy(zs->stage_buf + zs->staged, in, len);
+			zs->staged += len;
+			in += len;
+			in_size -= len;
+			if (zs->staged < zs->need) {
+				break;
+			}
+			unit = zs->stage_buf;
+			zs->staged = 0;
+		}
+
+		err = zstd_process(zs, unit);
+		if (err != TEGRABL_NO_ERROR) {
+			return err;
+		}
+	}
+
+	return TEGRABL_NO_ERROR;
+}
+
+tegrabl_error_t tegrabl_zstd_stream_close(struct tegrabl_zstd_stream *zs,
+										  uint32_t *written_size)
+{
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+
+	if (zs == NULL) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 6);
+	}
+
+	if (((zs->stage != ZSTD_STAGE_MAGIC) && (zs->stage != ZSTD_STAGE_PADDING)) ||
+		(zs->staged != 0U) || (zs->frame_count == 0U)) {
+		pr_error("zstd: truncated input\n");
+		err = TEGRABL_ERROR(TEGRABL_ERR_UNDERFLOW, 0);
+	}
+
+	if (written_size != NULL) {
+		*written_size = zs->out_pos;
+	}
+
+	zstd_end(zs);
+
+	return err;
+}
+
+void *zstd_init(uint32_t compressed_size)
+{
+	struct tegrabl_zstd_stream *zs;
+
+	(void)compressed_size;
+
+	zs = tegrabl_malloc(sizeof(*zs));
+	if (zs == NULL) {
+		pr_error("zstd: failed to allocate %u bytes of workspace\n",
+				 (uint32_t)sizeof(*zs));
+		return NULL;
+	}
+	zs->stage_buf = NULL;
+
+	return zs;
+}
+
+tegrabl_error_t do_zstd_decompress(void *cntxt, void *in_buffer,
+								   uint32_t in_size, void *out_buffer,
+								   uint32_t outbuf_size, uint32_t *written_size)
+{
+	struct tegrabl_zstd_stream *zs = (struct tegrabl_zstd_stream *)cntxt;
+	tegrabl_error_t err;
+
+	pr_debug("inbuf=0x%p (size:0x%x), outbuf=0x%p\n", in_buffer, in_size,
+			 out_buffer);
+
+	zstd_stream_reset(zs, out_buffer, outbuf_size);
+
+	/* the whole input is in memory, only a truncated one ends up staged */
+	err = tegrabl_zstd_stream_write(zs, in_buffer, in_size);
+	if (err != TEGRABL_NO_ERROR) {
+		return err;
+	}
+
+	if (((zs->stage != ZSTD_STAGE_MAGIC) && (zs->stage != ZSTD_STAGE_PADDING)) ||
+		(zs->staged != 0U) || (zs->frame_count == 0U)) {
+		pr_error("zstd: truncated input\n");
+		return TEGRABL_ERROR(TEGRABL_ERR_UNDERFLOW, 0);
+	}
+
+	*written_size = zs->out_pos;
+	pr_debug("%s: decompressed data-size: %d\n", __func__, *written_size);
+
+	return TEGRABL_NO_ERROR;
+}
+
+tegrabl_error_t zstd_end(void *cntxt)
+{
+	struct tegrabl_zstd_stream *zs = (struct tegrabl_zstd_stream *)cntxt;
+
+	if (zs != NULL) {
+		tegrabl_free(zs->stage_buf);
+		tegrabl_free(zs);
+	}
+
+	return TEGRABL_NO_ERROR;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2020, NVIDIA Corporation.  All Rights Reserved.
+ * Copyright (c) 2018-2021, NVIDIA Corporation.  All Rights Reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property and
  * proprietary rights in and to this software and related documentation.  Any
@@ -15,14 +15,47 @@
 #include <tegrabl_utils.h>
 #include <tegrabl_malloc.h>
 #include <tegrabl_partition_manager.h>
+#include <tegrabl_cache_record.h>
 #include <tegrabl_file_manager.h>
 #include <tegrabl_debug.h>
 #include <inttypes.h>
 #include <tegrabl_error.h>
 #include <fs.h>
 #include <tegrabl_cbo.h>
+#include <tegrabl_profiler.h>
+
+#define BOOT_MAP_PARTITION		"BOOT-MAP"
+#define BOOT_MAP_VERSION		2U
+#define BOOT_MAP_MAX_ENTRIES	8U
+
+/**
+ * @brief Resolved location of a file read through the filesystem on an earlier boot
+ *
+ * @param path full path of the file, mount prefix included
+ * @param start_sector start of the filesystem on the device
+ * @param map identity of the inode and its extents on the device
+ */
+struct boot_map_entry {
+	char path[FS_MAX_PATH_LEN];
+	uint32_t start_sector;
+	uint32_t reserved;
+	struct file_map map;
+};
+
+/**
+ * @brief Boot map record kept in the BOOT_MAP_PARTITION
+ *
+ * @param num_entries number of valid entries
+ */
+struct boot_map {
+	uint32_t num_entries;
+	uint32_t reserved;
+	struct boot_map_entry entries[BOOT_MAP_MAX_ENTRIES];
+};
 
 static struct tegrabl_fm_handle *fm_handle;
+static struct boot_map *boot_map;
+static bool boot_map_loaded;
 
 static char *usb_prefix = "/usb";
 static char *sdcard_prefix = "/sd";
@@ -205,7 +238,9 @@ tegrabl_error_t tegrabl_fm_read_partition(struct tegrabl_bdev *bdev,
 	}
 
 	/* Read the partition */
+	tegrabl_profiler_begin("storage");
 	err = tegrabl_partition_read(&partition, load_address, partition_size);
+	tegrabl_profiler_end("storage");
 	if (err != TEGRABL_NO_ERROR) {
 		pr_error("Error reading partition %s\n", partition_name);
 		TEGRABL_SET_HIGHEST_MODULE(err);
@@ -221,6 +256,185 @@ fail:
 	return err;
 }
 
+/* Read in the boot map once per boot, NULL if there is no usable partition */
+static struct boot_map *boot_map_get(void)
+{
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+
+	if (boot_map_loaded) {
+		goto done;
+	}
+	boot_map_loaded = true;
+
+	boot_map = tegrabl_malloc(sizeof(struct boot_map));
+	if (boot_map == NULL) {
+		pr_warn("Failed to allocate memory for boot map\n");
+		goto done;
+	}
+
+	err = tegrabl_cache_record_load(BOOT_MAP_PARTITION, BOOT_MAP_VERSION, boot_map, sizeof(struct boot_map));
+	if ((err != TEGRABL_NO_ERROR) && (TEGRABL_ERROR_REASON(err) != TEGRABL_ERR_INVALID)) {
+		pr_debug("No usable %s partition, boot map disabled\n", BOOT_MAP_PARTITION);
+		tegrabl_free(boot_map);
+		boot_map = NULL;
+		goto done;
+	}
+
+	if ((err != TEGRABL_NO_ERROR) || (boot_map->num_entries > BOOT_MAP_MAX_ENTRIES)) {
+		/* Start over with an empty map, it is rebuilt as files are read */
+		memset(boot_map, 0, sizeof(struct boot_map));
+	}
+
+done:
+	return boot_map;
+}
+
+static struct boot_map_entry *boot_map_find(struct boot_map *map, struct tegrabl_fm_handle *handle,
+											const char *path)
+{
+	uint32_t i;
+
+	for (i = 0; i < map->num_entries; i++) {
+		if ((map->entries[i].start_sector == handle->start_sector) &&
+			(strncmp(map->entries[i].path, path, sizeof(map->entries[i].path)) == 0)) {
+			return &map->entries[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void boot_map_store(struct boot_map *map)
+{
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+
+	err = tegrabl_cache_record_store(BOOT_MAP_PARTITION, BOOT_MAP_VERSION, map, sizeof(struct boot_map));
+	if (err != TEGRABL_NO_ERROR) {
+		/* Not fatal, the next boot just walks the filesystem again */
+		pr_warn("Failed to store boot map (err 0x%08x)\n", err);
+	}
+}
+
+/**
+* @brief Load a file straight from the extents recorded on an earlier boot. Only the inode is
+* read to check that the file is unchanged, the directory walk and extent tree are skipped.
+*
+* @return TEGRABL_NO_ERROR if the file was loaded, error if the caller has to use the filesystem.
+*/
+static tegrabl_error_t boot_map_read(struct tegrabl_fm_handle *handle, const char *path,
+									 void *load_address, uint32_t *size)
+{
+	struct boot_map *map = boot_map_get();
+	struct boot_map_entry *entry = NULL;
+	struct file_extent *extent = NULL;
+	struct file_ident ident;
+	uint64_t len;
+	uint32_t i;
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+
+	if (map == NULL) {
+		err = TEGRABL_ERROR(TEGRABL_ERR_NOT_SUPPORTED, 0x0);
+		goto fail;
+	}
+
+	entry = boot_map_find(map, handle, path);
+	if (entry == NULL) {
+		err = TEGRABL_ERROR(TEGRABL_ERR_NOT_FOUND, 0x0);
+		goto fail;
+	}
+
+	if ((fs_stat_inode(handle->mount_path, entry->map.ident.inode, &ident) != 0x0) ||
+		(memcmp(&ident, &entry->map.ident, sizeof(ident)) != 0)) {
+		pr_info("Boot map entry for %s is stale\n", path);
+		err = TEGRABL_ERROR(TEGRABL_ERR_INVALID, 0x5);
+		goto fail;
+	}
+
+	if (*size < ident.size) {
+		err = TEGRABL_ERROR(TEGRABL_ERR_OVERFLOW, 0x3);
+		goto fail;
+	}
+
+	tegrabl_profiler_begin("fs");
+	for (i = 0; i < entry->map.num_extents; i++) {
+		extent = &entry->map.extents[i];
+		if (extent->file_offset >= ident.size) {
+			break;
+		}
+		len = MIN(extent->len, ident.size - extent->file_offset);
+		err = tegrabl_blockdev_read(handle->bdev, (uint8_t *)load_address + extent->file_offset,
+									extent->dev_offset, len);
+		if (err != TEGRABL_NO_ERROR) {
+			break;
+		}
+	}
+	tegrabl_profiler_end("fs");
+	if (err != TEGRABL_NO_ERROR) {
+		pr_error("file %s read from boot map failed!!\n", path);
+		goto fail;
+	}
+
+	*size = (uint32_t)ident.size;
+
+fail:
+	return err;
+}
+
+/* Record where the file lives so that the next boot can skip the filesystem walk */
+static void boot_map_update(struct tegrabl_fm_handle *handle, const char *path, filehandle *fh)
+{
+	struct boot_map *map = boot_map_get();
+	struct boot_map_entry *entry = NULL;
+	struct file_map *file_map = NULL;
+	uint32_t idx;
+
+	if ((map == NULL) || (strlen(path) >= FS_MAX_PATH_LEN)) {
+		return;
+	}
+
+	file_map = tegrabl_malloc(sizeof(struct file_map));
+	if (file_map == NULL) {
+		return;
+	}
+
+	entry = boot_map_find(map, handle, path);
+
+	if (fs_file_ioctl(fh, FS_IOCTL_GET_FILE_MAP, file_map) != 0x0) {
+		/* Not mappable (fs type, sparse, too fragmented), drop any old entry */
+		if (entry != NULL) {
+			idx = (uint32_t)(entry - map->entries);
+			memmove(entry, entry + 1, (map->num_entries - idx - 1U) * sizeof(*entry));
+			map->num_entries--;
+			memset(&map->entries[map->num_entries], 0, sizeof(*entry));
+			boot_map_store(map);
+		}
+		goto done;
+	}
+
+	if (entry != NULL) {
+		if (memcmp(&entry->map, file_map, sizeof(*file_map)) == 0) {
+			goto done;
+		}
+	} else {
+		/* Reuse the last slot once the map is full */
+		if (map->num_entries < BOOT_MAP_MAX_ENTRIES) {
+			map->num_entries++;
+		}
+		entry = &map->entries[map->num_entries - 1U];
+	}
+
+	memset(entry, 0, sizeof(*entry));
+	strcpy(entry->path, path);
+	entry->start_sector = handle->start_sector;
+	memcpy(&entry->map, file_map, sizeof(*file_map));
+
+	pr_info("Boot map: %s cached (%u extents)\n", path, file_map->num_extents);
+	boot_map_store(map);
+
+done:
+	tegrabl_free(file_map);
+}
+
 /**
 * @brief Read the file from the filesystem if possible, otherwise read form the partiton.
 *
@@ -274,6 +488,11 @@ tegrabl_error_t tegrabl_fm_read(struct tegrabl_fm_handle *handle,
 
 	pr_info("rootfs path: %s\n", path);
 
+	err = boot_map_read(handle, path, load_address, size);
+	if (err == TEGRABL_NO_ERROR) {
+		goto loaded;
+	}
+
 	status = fs_open_file(path, &fh);
 	if (status != 0x0) {
 		pr_error("file %s open failed!!\n", path);
@@ -294,7 +513,9 @@ tegrabl_error_t tegrabl_fm_read(struct tegrabl_fm_handle *handle,
 		goto load_from_partition;
 	}
 
+	tegrabl_profiler_begin("fs");
 	status = fs_read_file(fh, load_address, 0x0, stat.size);
+	tegrabl_profiler_end("fs");
 	if (status < 0) {
 		pr_error("file %s read failed!!\n", path);
 		err = TEGRABL_ERROR(TEGRABL_ERR_READ_FAILED, 0x1);
@@ -302,6 +523,10 @@ tegrabl_error_t tegrabl_fm_read(struct tegrabl_fm_handle *handle,
 	}
 
 	*size = stat.size;
+	boot_map_update(handle, path, fh);
+
+loaded:
+	err = TEGRABL_NO_ERROR;
 	if (is_file_loaded_from_fs) {
 		*is_file_loaded_from_fs = true;
 	}
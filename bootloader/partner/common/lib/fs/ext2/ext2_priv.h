@@ -57,6 +57,7 @@ typedef struct {
 
     struct cache_block ind_cache[3]; // cache of indirect blocks as they're scanned
     struct ext2fs_dinode inode;
+    inodenum_t inum;
 } ext2_file_t;
 
 /* internal routines */
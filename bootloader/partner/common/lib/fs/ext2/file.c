@@ -59,6 +59,7 @@ int ext2_open_file(fscookie *cookie, const char *path, filecookie **fcookie)
     }
 
     file->ext2 = ext2;
+    file->inum = inum;
     *fcookie = (filecookie *)file;
 
     return 0;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2020, NVIDIA Corporation.  All Rights Reserved.
+ * Copyright (c) 2019-2021, NVIDIA Corporation.  All Rights Reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property and
  * proprietary rights in and to this software and related documentation.  Any
@@ -24,6 +24,9 @@
 
 #define LOCAL_TRACE    0
 
+/* Extents longer than this are uninitialized (preallocated) and read as zeros */
+#define EXT4_EXTENT_MAX_INIT_LEN    32768U
+
 /**
  * @brief Extent tree header
  *        This describes how extents are arranged as a tree.
@@ -179,10 +182,23 @@ fail:
     return err;
 }
 
+/* Extents can go in one vectored request if they map to whole device blocks */
+static bool ext4_extents_xfer_list_ok(ext2_t *ext2, void *buf)
+{
+    uint32_t fs_blk_size = E2FS_BLOCK_SIZE(ext2->super_blk);
+    uint32_t dev_blk_size = TEGRABL_BLOCKDEV_BLOCK_SIZE(ext2->dev);
+
+    return ((fs_blk_size % dev_blk_size) == 0U) &&
+           ((ext2->fs_offset % dev_blk_size) == 0U) &&
+           ((fs_blk_size % ext2->dev->buf_align_size) == 0U) &&
+           (((uintptr_t)buf % ext2->dev->buf_align_size) == 0U);
+}
+
 static int ext4_read_extent(ext2_t *ext2, struct ext4_extent_header *extent_header, void *buf,
                             off_t *total_bytes_read)
 {
     struct ext4_extent *extent = NULL;
+    struct tegrabl_blockdev_xfer_segment *segs = NULL;
     uint8_t *buf_ptr = NULL;
     off_t blk_addr;
     off_t extent_len_bytes = 0;
@@ -197,6 +213,11 @@ static int ext4_read_extent(ext2_t *ext2, struct ext4_extent_header *extent_head
     buf_ptr = (uint8_t *)buf;
     extent = (struct ext4_extent *)((uintptr_t)extent_header + sizeof(struct ext4_extent_header));
 
+    /* Read all the extents of this node in one request when possible */
+    if ((extent_header->entries > 1U) && ext4_extents_xfer_list_ok(ext2, buf)) {
+        segs = malloc(extent_header->entries * sizeof(struct tegrabl_blockdev_xfer_segment));
+    }
+
     for (i = 0; i < extent_header->entries; i++) {
         /* Calculate destination address */
         buf_ptr = (uint8_t *)(buf + (extent->block_no * E2FS_BLOCK_SIZE(ext2->super_blk)));
@@ -210,14 +231,29 @@ static int ext4_read_extent(ext2_t *ext2, struct ext4_extent_header *extent_head
         extent_len_bytes = extent->len * E2FS_BLOCK_SIZE(ext2->super_blk);
         LTRACEF("entry:%u: start data blk: %lu, addr: 0x%lx, len: %u\n", i, data_blk, blk_addr, extent->len);
         LTRACEF("num bytes to read: %lu, buf ptr: %p\n", extent_len_bytes, buf_ptr);
-        err = tegrabl_blockdev_read(ext2->dev, buf_ptr, blk_addr, extent_len_bytes);
+        if (segs != NULL) {
+            segs[i].buf = buf_ptr;
+            segs[i].start_block = (bnum_t)(blk_addr >> ext2->dev->block_size_log2);
+            segs[i].block_count = (bnum_t)(extent_len_bytes >> ext2->dev->block_size_log2);
+        } else {
+            err = tegrabl_blockdev_read(ext2->dev, buf_ptr, blk_addr, extent_len_bytes);
+            if (err != TEGRABL_NO_ERROR) {
+                TRACEF("blockdev read failed\n");
+                err = ERR_GENERIC;
+                goto fail;
+            }
+        }
+        bytes_read += extent_len_bytes;
+        extent++;
+    }
+
+    if (segs != NULL) {
+        err = tegrabl_blockdev_xfer_list(ext2->dev, TEGRABL_BLOCKDEV_READ, segs, extent_header->entries);
         if (err != TEGRABL_NO_ERROR) {
-            TRACEF("blockdev read failed\n");
+            TRACEF("blockdev xfer list failed\n");
             err = ERR_GENERIC;
             goto fail;
         }
-        bytes_read += extent_len_bytes;
-        extent++;
     }
 
     if (total_bytes_read) {
@@ -230,6 +266,9 @@ static int ext4_read_extent(ext2_t *ext2, struct ext4_extent_header *extent_head
     LTRACEF("bytes_read %lu\n", *total_bytes_read);
 
 fail:
+    if (segs) {
+        free(segs);
+    }
     return err;
 }
 
@@ -685,6 +724,7 @@ int ext4_open_file(fscookie *cookie, const char *path, filecookie **fcookie)
     }
 
     file->ext2 = ext2;
+    file->inum = inum;
     *fcookie = (filecookie *)file;
 
 fail:
@@ -707,6 +747,172 @@ ssize_t ext4_read_file(filecookie *fcookie, void *buf, off_t offset, size_t len)
     return ext4_read_data_from_extent(file->ext2, &file->inode, buf);
 }
 
+static void ext4_fill_file_ident(ext2_t *ext2, inodenum_t inum, struct ext2fs_dinode *inode,
+                                 struct file_ident *ident)
+{
+    memset(ident, 0, sizeof(*ident));
+    ident->inode = inum;
+    ident->generation = inode->e2di_gen;
+    ident->mtime = inode->e2di_mtime;
+    ident->ctime = inode->e2di_ctime;
+    ident->size = ext2_file_len(ext2, inode);
+    ident->map_crc = tegrabl_utils_crc32(0, inode->e2di_blocks, sizeof(inode->e2di_blocks));
+}
+
+static int ext4_map_leaf(ext2_t *ext2, struct ext4_extent_header *extent_header, struct file_map *map)
+{
+    struct ext4_extent *extent = NULL;
+    struct file_extent *cur = NULL;
+    struct file_extent *prev = NULL;
+    uint32_t blk_size = E2FS_BLOCK_SIZE(ext2->super_blk);
+    off_t data_blk;
+    uint16_t i;
+
+    if (!validate_extents_magic(extent_header) || (extent_header->depth != 0)) {
+        return ERR_NOT_SUPPORTED;
+    }
+
+    extent = (struct ext4_extent *)((uintptr_t)extent_header + sizeof(struct ext4_extent_header));
+
+    for (i = 0; i < extent_header->entries; i++, extent++) {
+        if (extent->len > EXT4_EXTENT_MAX_INIT_LEN) {
+            return ERR_NOT_SUPPORTED;
+        }
+        if (map->num_extents >= FS_MAX_FILE_EXTENTS) {
+            return ERR_TOO_BIG;
+        }
+
+        data_blk = extent->start_hi;
+        data_blk = (data_blk << 32U) | extent->start_lo;
+
+        cur = &map->extents[map->num_extents];
+        cur->file_offset = (uint64_t)extent->block_no * blk_size;
+        cur->dev_offset = (data_blk * blk_size) + ext2->fs_offset;
+        cur->len = (uint64_t)extent->len * blk_size;
+
+        /* Merge runs that are contiguous both in the file and on the device */
+        prev = (map->num_extents > 0U) ? (cur - 1) : NULL;
+        if ((prev != NULL) &&
+            ((prev->file_offset + prev->len) == cur->file_offset) &&
+            ((prev->dev_offset + prev->len) == cur->dev_offset)) {
+            prev->len += cur->len;
+        } else {
+            map->num_extents++;
+        }
+    }
+
+    return 0;
+}
+
+static int ext4_get_file_map(ext2_file_t *file, struct file_map *map)
+{
+    ext2_t *ext2 = file->ext2;
+    struct ext4_extent_header *extent_header = NULL;
+    struct ext4_extent_idx *extent_idx = NULL;
+    uint32_t blk_size = E2FS_BLOCK_SIZE(ext2->super_blk);
+    uint64_t covered = 0;
+    off_t blk_addr;
+    void *buf = NULL;
+    uint32_t i;
+    int err = 0;
+
+    LTRACE_ENTRY;
+
+    memset(map, 0, sizeof(*map));
+
+    if (!S_ISREG(file->inode.e2di_mode) || !IS_EXTENTS(file->inode.e2di_flags)) {
+        return ERR_NOT_SUPPORTED;
+    }
+
+    extent_header = (struct ext4_extent_header *)file->inode.e2di_blocks;
+    if (!validate_extents_magic(extent_header)) {
+        return ERR_NOT_VALID;
+    }
+
+    if (extent_header->depth == 0) {
+        err = ext4_map_leaf(ext2, extent_header, map);
+    } else if (extent_header->depth == 1) {
+        buf = tegrabl_memalign(SZ_64K, blk_size);
+        if (buf == NULL) {
+            return ERR_NO_MEMORY;
+        }
+
+        extent_idx = (struct ext4_extent_idx *)((uintptr_t)extent_header + sizeof(struct ext4_extent_header));
+        for (i = 0; i < extent_header->entries; i++, extent_idx++) {
+            blk_addr = extent_idx->leaf_hi;
+            blk_addr = ((blk_addr << 32U) | extent_idx->leaf_lo) * blk_size;
+            blk_addr += ext2->fs_offset;
+
+            err = tegrabl_blockdev_read(ext2->dev, buf, blk_addr, blk_size);
+            if (err != TEGRABL_NO_ERROR) {
+                TRACEF("blockdev read failed\n");
+                err = ERR_GENERIC;
+                break;
+            }
+            err = ext4_map_leaf(ext2, (struct ext4_extent_header *)buf, map);
+            if (err < 0) {
+                break;
+            }
+        }
+        free(buf);
+    } else {
+        err = ERR_NOT_SUPPORTED;
+    }
+
+    if (err < 0) {
+        return err;
+    }
+
+    ext4_fill_file_ident(ext2, file->inum, &file->inode, &map->ident);
+
+    /* Only hand out maps without holes, sparse files stay on the fs path */
+    for (i = 0; i < map->num_extents; i++) {
+        if (map->extents[i].file_offset != covered) {
+            return ERR_NOT_SUPPORTED;
+        }
+        covered += map->extents[i].len;
+    }
+    if (covered < map->ident.size) {
+        return ERR_NOT_SUPPORTED;
+    }
+
+    LTRACEF("inode %u: %u extents\n", file->inum, map->num_extents);
+
+    return 0;
+}
+
+static int ext4_file_ioctl(filecookie *fcookie, int request, void *argp)
+{
+    ext2_file_t *file = (ext2_file_t *)fcookie;
+
+    switch (request) {
+    case FS_IOCTL_GET_FILE_MAP:
+        return ext4_get_file_map(file, (struct file_map *)argp);
+    default:
+        return ERR_NOT_SUPPORTED;
+    }
+}
+
+static int ext4_stat_inode(fscookie *cookie, uint32_t inum, struct file_ident *ident)
+{
+    ext2_t *ext2 = (ext2_t *)cookie;
+    struct ext2fs_dinode inode;
+    int err;
+
+    if ((inum == 0U) || (inum > ext2->super_blk.e2fs_icount)) {
+        return ERR_NOT_VALID;
+    }
+
+    err = ext2_load_inode(ext2, inum, &inode);
+    if (err < 0) {
+        return err;
+    }
+
+    ext4_fill_file_ident(ext2, inum, &inode, ident);
+
+    return 0;
+}
+
 static const struct fs_api ext4_api = {
     .mount = ext4_mount,
     .unmount = ext2_unmount,
@@ -714,6 +920,8 @@ static const struct fs_api ext4_api = {
     .stat = ext2_stat_file,
     .read = ext4_read_file,
     .close = ext2_close_file,
+    .file_ioctl = ext4_file_ioctl,
+    .stat_inode = ext4_stat_inode,
 };
 
 STATIC_FS_IMPL(ext4, &ext4_api);
@@ -480,6 +480,28 @@ status_t fs_stat_fs(const char *mountpoint, struct fs_stat *stat)
     return result;
 }
 
+status_t fs_stat_inode(const char *mountpoint, uint32_t inode, struct file_ident *ident)
+{
+    LTRACEF("mountpoint %s inode %u ident %p\n", mountpoint, inode, ident);
+
+    const char *newpath;
+    struct fs_mount *mount = find_mount(mountpoint, &newpath);
+    if (!mount) {
+        return ERR_NOT_FOUND;
+    }
+
+    if (!mount->api->stat_inode) {
+        put_mount(mount);
+        return ERR_NOT_SUPPORTED;
+    }
+
+    status_t result = mount->api->stat_inode(mount->cookie, inode, ident);
+
+    put_mount(mount);
+
+    return result;
+}
+
 
 ssize_t fs_load_file(const char *path, void *ptr, size_t maxlen)
 {
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2018, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2016-2021, NVIDIA CORPORATION.  All rights reserved.
  *
  * NVIDIA CORPORATION and its licensors retain all intellectual property
  * and proprietary rights in and to this software, related documentation
@@ -67,6 +67,12 @@
 /* Timeout to receive response from BPMP is 1 sec */
 #define TIMEOUT_RESPONSE_FROM_BPMP  1000000 /* in microseconds */
 
+/*
+ * Timeout for BPMP to ack an MRQ, same as the former 1000000 polls 50us
+ * apart. Clock and EMC requests can keep BPMP busy for a long while.
+ */
+#define TIMEOUT_MRQ_ACK_FROM_BPMP   (TIMEOUT_RESPONSE_FROM_BPMP * 50LLU) /* in microseconds */
+
 /**
  * Holds frame data for an IPC request
  */
@@ -118,6 +124,12 @@ static struct ivc ivc_ccplex_bpmp_channels[NO_OF_CHANNELS];
 static struct ccplex_bpmp_ipc *s_ipc_callbacks;
 static uint32_t channel_id;
 
+/* Posted requests waiting for the channel, and the one BPMP is working on */
+static struct tegrabl_bpmp_mrq *s_mrq_head;
+static struct tegrabl_bpmp_mrq *s_mrq_tail;
+static struct tegrabl_bpmp_mrq *s_mrq_inflight;
+static tegrabl_error_t s_mrq_first_err;
+
 /*
  *=============================================================================
  *      IVC wrappers for CCPLEX <-> BPMP communication.
@@ -221,19 +233,15 @@ static bool tegrabl_can_ccplex_ring_bpmpdb(void)
 
 static tegrabl_error_t tegrabl_ccplex_bpmp_wait_for_slave_ack(uint32_t channel)
 {
-	uint32_t timeout = TIMEOUT_RESPONSE_FROM_BPMP;
+	time_t start_us = tegrabl_get_timestamp_us();
 
+	/* Poll the frame directly, BPMP usually turns MRQs around in a few us */
 	do {
 		if (tegrabl_ccplex_bpmp_slave_acked(channel) == TEGRABL_NO_ERROR) {
 			pr_debug("%s: Got ack from slave\n", __func__);
 			return TEGRABL_NO_ERROR;
 		}
-
-		/*TODO - Replace with timer delay (Bug 200188318)*/
-		tegrabl_udelay(50);
-
-		timeout--;
-	} while (timeout);
+	} while ((tegrabl_get_timestamp_us() - start_us) < TIMEOUT_MRQ_ACK_FROM_BPMP);
 
 	pr_error("%s: Didn't get response from BPMP, exiting\n", __func__);
 	return TEGRABL_ERR_TIMEOUT;
@@ -373,54 +381,198 @@ tegrabl_error_t tegrabl_ipc_init(void)
 	return e;
 }
 
+static void tegrabl_ccplex_bpmp_complete(struct tegrabl_bpmp_mrq *req,
+										 tegrabl_error_t status)
+{
+	if ((status != TEGRABL_NO_ERROR) && (s_mrq_first_err == TEGRABL_NO_ERROR)) {
+		s_mrq_first_err = status;
+	}
+
+	req->status = status;
+	req->next = NULL;
+	req->done = true;
+
+	if (req->cb != NULL) {
+		req->cb(req);
+	}
+}
+
 /*
- * Atomic send/receive API, which means it waits until slave acks
+ * Push the head of the pending queue into the IVC channel
  */
-tegrabl_error_t tegrabl_ccplex_bpmp_xfer(
-		void *p_out,
-		void *p_in,
-		uint32_t size_out,
-		uint32_t size_in,
-		uint32_t mrq)
+static void tegrabl_ccplex_bpmp_dispatch(void)
 {
+	struct tegrabl_bpmp_mrq *req;
+	struct frame_data *p;
+
+	while ((s_mrq_inflight == NULL) && (s_mrq_head != NULL)) {
+		req = s_mrq_head;
+		s_mrq_head = req->next;
+		if (s_mrq_head == NULL) {
+			s_mrq_tail = NULL;
+		}
+
+		p = s_ipc_callbacks->get_next_out_frame(channel_id);
+		if (p == NULL) {
+			pr_error("Failed to get next output frame!\n");
+			tegrabl_ccplex_bpmp_complete(req, TEGRABL_ERR_INVALID_STATE);
+			continue;
+		}
+
+		p->mrq = req->mrq;
+		p->flags = FLAG_DO_ACK;
+		memcpy(p->data, req->req, req->req_size);
+
+		req->start_us = tegrabl_get_timestamp_us();
+		s_mrq_inflight = req;
+
+		/* signal the slave */
+		s_ipc_callbacks->signal_slave(channel_id);
+	}
+}
+
+/*
+ * Complete the in-flight request if BPMP has responded to it
+ */
+static void tegrabl_ccplex_bpmp_reap(void)
+{
+	struct tegrabl_bpmp_mrq *req = s_mrq_inflight;
 	tegrabl_error_t e = TEGRABL_NO_ERROR;
 	struct frame_data *p;
 
-	if (p_out == NULL) {
-		pr_error("%s: out buffer is null, exiting\n", __func__);
-		return -1;
+	if (req == NULL) {
+		return;
+	}
+
+	if (tegrabl_ccplex_bpmp_slave_acked(channel_id) != TEGRABL_NO_ERROR) {
+		if ((tegrabl_get_timestamp_us() - req->start_us) >=
+			TIMEOUT_MRQ_ACK_FROM_BPMP) {
+			pr_error("%s: Didn't get response from BPMP for mrq %u\n",
+					 __func__, req->mrq);
+			s_mrq_inflight = NULL;
+			tegrabl_ccplex_bpmp_complete(req, TEGRABL_ERR_TIMEOUT);
+		}
+		return;
+	}
+
+	/* retrieve the frame */
+	p = s_ipc_callbacks->get_cur_in_frame(channel_id);
+	if (p == NULL) {
+		pr_error("Failed to query current input frame\n");
+		e = TEGRABL_ERR_INVALID_STATE;
+	} else if ((req->resp_size != 0U) && (req->resp != NULL)) {
+		memcpy(req->resp, p->data, req->resp_size);
+	}
+
+	if (s_ipc_callbacks->free_master(channel_id) != TEGRABL_NO_ERROR) {
+		e = TEGRABL_ERR_INVALID_STATE;
+	}
+
+	s_mrq_inflight = NULL;
+	tegrabl_ccplex_bpmp_complete(req, e);
+}
+
+bool tegrabl_ccplex_bpmp_process(void)
+{
+	tegrabl_ccplex_bpmp_reap();
+	tegrabl_ccplex_bpmp_dispatch();
+
+	return (s_mrq_inflight != NULL) || (s_mrq_head != NULL);
+}
+
+tegrabl_error_t tegrabl_ccplex_bpmp_post(struct tegrabl_bpmp_mrq *req)
+{
+	tegrabl_error_t e = TEGRABL_NO_ERROR;
+
+	if ((req == NULL) || (req->req == NULL) ||
+		(req->req_size > MSG_DATA_SZ) || (req->resp_size > MSG_DATA_SZ)) {
+		pr_error("%s: invalid request\n", __func__);
+		return TEGRABL_ERR_BAD_PARAMETER;
 	}
 
 	NV_CHECK_ERROR_CLEANUP(tegrabl_do_sanity_check());
 
-	p = s_ipc_callbacks->get_next_out_frame(channel_id);
-	if (!p) {
-		NV_CHECK_PRINT_ERR(TEGRABL_ERR_INVALID_STATE,
-						   "Failed to get next output frame!\n");
+	req->status = TEGRABL_ERR_XFER_IN_PROGRESS;
+	req->done = false;
+	req->next = NULL;
+
+	/* A new batch starts once the queue has drained */
+	if ((s_mrq_inflight == NULL) && (s_mrq_head == NULL)) {
+		s_mrq_first_err = TEGRABL_NO_ERROR;
+	}
+
+	if (s_mrq_tail != NULL) {
+		s_mrq_tail->next = req;
+	} else {
+		s_mrq_head = req;
 	}
+	s_mrq_tail = req;
 
-	p->mrq = mrq;
-	p->flags = FLAG_DO_ACK;
-	memcpy(p->data, p_out, size_out);
+	/* Kick the channel right away if it is idle */
+	tegrabl_ccplex_bpmp_dispatch();
 
-	/* signal the slave */
-	s_ipc_callbacks->signal_slave(channel_id);
+fail:
+	return e;
+}
 
-	/* wait for slave to ack */
-	NV_CHECK_ERROR_CLEANUP(
-						   s_ipc_callbacks->wait_for_slave_ack(channel_id));
+tegrabl_error_t tegrabl_ccplex_bpmp_wait(struct tegrabl_bpmp_mrq *req)
+{
+	if (req == NULL) {
+		return TEGRABL_ERR_BAD_PARAMETER;
+	}
 
-	/* retrieve the frame */
-	p = s_ipc_callbacks->get_cur_in_frame(channel_id);
-	if (!p) {
-		NV_CHECK_PRINT_ERR(TEGRABL_ERR_INVALID_STATE,
-						   "Failed to query current input frame\n");
+	while (!req->done) {
+		if (!tegrabl_ccplex_bpmp_process() && !req->done) {
+			/* Never posted, nothing will complete it */
+			return TEGRABL_ERR_NOT_STARTED;
+		}
+	}
+
+	return req->status;
+}
+
+tegrabl_error_t tegrabl_ccplex_bpmp_flush(void)
+{
+	tegrabl_error_t e;
+
+	while (tegrabl_ccplex_bpmp_process()) {
+		;
 	}
 
-	if ((size_in) && (p_in != NULL)) {
-		memcpy(p_in, p->data, size_in);
+	e = s_mrq_first_err;
+	s_mrq_first_err = TEGRABL_NO_ERROR;
+
+	return e;
+}
+
+/*
+ * Atomic send/receive API, which means it waits until slave acks
+ */
+tegrabl_error_t tegrabl_ccplex_bpmp_xfer(
+		void *p_out,
+		void *p_in,
+		uint32_t size_out,
+		uint32_t size_in,
+		uint32_t mrq)
+{
+	tegrabl_error_t e = TEGRABL_NO_ERROR;
+	struct tegrabl_bpmp_mrq req;
+
+	if (p_out == NULL) {
+		pr_error("%s: out buffer is null, exiting\n", __func__);
+		return -1;
 	}
-	NV_CHECK_ERROR_CLEANUP(s_ipc_callbacks->free_master(channel_id));
+
+	memset(&req, 0, sizeof(req));
+	req.mrq = mrq;
+	req.req = p_out;
+	req.req_size = size_out;
+	req.resp = p_in;
+	req.resp_size = (p_in != NULL) ? size_in : 0U;
+
+	/* Requests posted earlier are completed first, preserving order */
+	NV_CHECK_ERROR_CLEANUP(tegrabl_ccplex_bpmp_post(&req));
+	NV_CHECK_ERROR_CLEANUP(tegrabl_ccplex_bpmp_wait(&req));
 
 	return TEGRABL_NO_ERROR;
 
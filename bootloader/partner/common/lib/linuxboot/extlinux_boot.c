@@ -30,6 +30,7 @@
 #include <extlinux_boot.h>
 #include <linux_load.h>
 #include <tegrabl_auth.h>
+#include <tegrabl_dma_copy.h>
 
 #define EXTLINUX_CONF_PATH			"/boot/extlinux/extlinux.conf"
 #define EXTLINUX_CONF_MAX_SIZE		4096UL
@@ -377,6 +378,7 @@ static tegrabl_error_t load_binary_with_sig(struct tegrabl_fm_handle *fm_handle,
 	uint32_t sigheader_size = 0;
 	uint32_t file_size;
 	void *load_addr;
+	tegrabl_dma_fence_t fence;
 	tegrabl_error_t err = TEGRABL_NO_ERROR;
 
 #if defined(CONFIG_ENABLE_SECURE_BOOT)
@@ -541,7 +543,13 @@ load_from_partition:
 		goto exit;
 	}
 	if (load_addr != bin_load_addr) {
-		memmove(bin_load_addr, load_addr, bin_max_size);
+		err = tegrabl_dma_copy_submit(bin_load_addr, load_addr, bin_max_size, &fence);
+		if (err == TEGRABL_NO_ERROR) {
+			err = tegrabl_dma_copy_wait(fence);
+		}
+		if (err != TEGRABL_NO_ERROR) {
+			goto exit;
+		}
 	}
 	*load_size = file_size;
 
@@ -67,9 +67,15 @@ tegrabl_load_from_partition(struct tegrabl_kernel_bin *kernel,
 	uint32_t boot_img_size;
 	tegrabl_error_t err = TEGRABL_NO_ERROR;
 	struct tegrabl_img_dtb_fdt *img_dtb_fdt = NULL;
+#if defined(CONFIG_DT_SUPPORT)
+	struct tegrabl_binary_async_load dtb_load;
+#endif
 
 	TEGRABL_UNUSED(kernel_dtbo);
 	TEGRABL_UNUSED(boot_to_recovery);
+#if defined(CONFIG_DT_SUPPORT)
+	dtb_load.xfer = NULL;
+#endif
 
 #if defined(CONFIG_ENABLE_L4T_RECOVERY)
 	img_dtb_fdt = boot_to_recovery ? &img_dtb_fdt_table[1] : &img_dtb_fdt_table[0];
@@ -90,6 +96,17 @@ tegrabl_load_from_partition(struct tegrabl_kernel_bin *kernel,
 		goto boot_image_load_done;
 	}
 
+#if defined(CONFIG_DT_SUPPORT)
+	/* With the kernel and its DTB on different UFS LUNs, read the DTB while the kernel loads */
+	err = tegrabl_dt_get_fdt_handle(img_dtb_fdt->preload_dtb_bin_type, dtb_load_addr);
+	if ((err != TEGRABL_NO_ERROR) || (*dtb_load_addr == NULL)) {
+		err = tegrabl_load_binary_async(img_dtb_fdt->dtb_bin_type, img_dtb_fdt->img_bin_type, &dtb_load);
+		if (err != TEGRABL_NO_ERROR) {
+			pr_debug("%s is loaded after the kernel\n", img_dtb_fdt->dtb_name_str);
+		}
+	}
+#endif
+
 	err = tegrabl_load_binary(img_dtb_fdt->img_bin_type, boot_img_load_addr,
 					&boot_img_size);
 	if (err != TEGRABL_NO_ERROR) {
@@ -115,9 +132,15 @@ boot_image_load_done:
 	/* Check whether kernel dtb is already loaded in memory */
 	err = tegrabl_dt_get_fdt_handle(img_dtb_fdt->preload_dtb_bin_type, dtb_load_addr);
 	if ((err != TEGRABL_NO_ERROR) || (*dtb_load_addr == NULL)) {
-		/* Load kernel dtb or recovery dtb */
-		err = tegrabl_load_binary(img_dtb_fdt->dtb_bin_type,
-						dtb_load_addr, NULL);
+		err = TEGRABL_ERROR(TEGRABL_ERR_NOT_STARTED, 0);
+		if (dtb_load.xfer != NULL) {
+			err = tegrabl_load_binary_async_wait(&dtb_load, dtb_load_addr, NULL);
+		}
+		if (err != TEGRABL_NO_ERROR) {
+			/* Load kernel dtb or recovery dtb */
+			err = tegrabl_load_binary(img_dtb_fdt->dtb_bin_type,
+							dtb_load_addr, NULL);
+		}
 		if (err != TEGRABL_NO_ERROR) {
 			goto fail;
 		}
@@ -157,6 +180,12 @@ boot_image_load_done:
 #endif /* CONFIG_DT_SUPPORT */
 
 fail:
+#if defined(CONFIG_DT_SUPPORT)
+	/* Don't leave the DTB read in flight when the kernel failed to load */
+	if (dtb_load.xfer != NULL) {
+		(void)tegrabl_load_binary_async_wait(&dtb_load, NULL, NULL);
+	}
+#endif
 	return err;
 }
 
@@ -36,6 +36,8 @@
 #include <tegrabl_exit.h>
 #include <tegrabl_linuxboot_utils.h>
 #include <fixed_boot.h>
+#include <tegrabl_profiler.h>
+#include <tegrabl_dma_copy.h>
 #if defined(CONFIG_ENABLE_USB_SD_BOOT) || defined(CONFIG_ENABLE_NVME_BOOT)
 #include <removable_boot.h>
 #endif
@@ -57,6 +59,8 @@
 static uint64_t ramdisk_load;
 static uint64_t ramdisk_size;
 static char *bootimg_cmdline;
+/* Last kernel/ramdisk copy, these run while the kernel DTB is prepared */
+static tegrabl_dma_fence_t extract_fence;
 
 #if defined(CONFIG_OS_IS_ANDROID)
 static union tegrabl_bootimg_header *android_hdr;
@@ -65,6 +69,25 @@ static union tegrabl_bootimg_header *android_hdr;
 #define HAS_BOOT_IMG_HDR(ptr)	\
 			((memcmp((ptr)->magic, ANDROID_MAGIC, ANDROID_MAGIC_SIZE) == 0) ? true : false)
 
+/*
+ * Queue a copy out of the boot image. A copy overlapping one still in flight
+ * is rejected as busy, wait for the earlier copies then and queue it again.
+ */
+static tegrabl_error_t extract_copy_submit(void *dst, const void *src, size_t size)
+{
+	tegrabl_error_t err;
+
+	err = tegrabl_dma_copy_submit(dst, src, size, &extract_fence);
+	if (TEGRABL_ERROR_REASON(err) == TEGRABL_ERR_BUSY) {
+		err = tegrabl_dma_copy_wait(extract_fence);
+		if (err == TEGRABL_NO_ERROR) {
+			err = tegrabl_dma_copy_submit(dst, src, size, &extract_fence);
+		}
+	}
+
+	return err;
+}
+
 #if defined(CONFIG_ENABLE_L4T_RECOVERY)
 struct tegrabl_kernel_bootctrl dummy_kernel_bootctrl = {
 	.magic_number = KERNEL_BOOTCTRL_MAGIC_NUMBER,
@@ -221,7 +244,11 @@ static tegrabl_error_t extract_kernel(void *boot_img_load_addr,
 	if (!is_compressed) {
 		pr_info("Copying kernel image (%u bytes) from %p to %p ... ",
 				kernel_size, (char *)payload_addr, *kernel_load_addr);
-		memmove(*kernel_load_addr, (char *)payload_addr, kernel_size);
+		err = extract_copy_submit(*kernel_load_addr, (char *)payload_addr, kernel_size);
+		if (err != TEGRABL_NO_ERROR) {
+			pr_error("\nError %d copying kernel\n", err);
+			goto fail;
+		}
 	} else {
 		pr_info("Decompressing kernel image (%u bytes) from %p to %p ... ",
 				kernel_size, (char *)payload_addr, *kernel_load_addr);
@@ -266,7 +293,11 @@ static tegrabl_error_t extract_ramdisk(void *boot_img_load_addr)
 	if (ramdisk_offset != ramdisk_load) {
 		pr_info("Move ramdisk (len: %"PRIu64") from 0x%"PRIx64" to 0x%"PRIx64
 				"\n", ramdisk_size, ramdisk_offset, ramdisk_load);
-		memmove((void *)((uintptr_t)ramdisk_load), (void *)((uintptr_t)ramdisk_offset), ramdisk_size);
+		err = extract_copy_submit((void *)((uintptr_t)ramdisk_load), (void *)((uintptr_t)ramdisk_offset),
+								  ramdisk_size);
+		if (err != TEGRABL_NO_ERROR) {
+			goto fail;
+		}
 	}
 
 	bootimg_cmdline = (char *)hdr->cmdline;
@@ -296,11 +327,18 @@ static tegrabl_error_t extract_kernel_dtb(void **kernel_dtb, void *kernel_dtbo)
 		goto fail;
 	}
 
+	/* Start the ramdisk segments on any channel the kernel copy freed up */
+	(void)tegrabl_dma_copy_is_done(extract_fence);
+
+	tegrabl_profiler_begin("dt-fixup");
 	err = tegrabl_linuxboot_update_dtb(*kernel_dtb);
+	tegrabl_profiler_end("dt-fixup");
 	if (err != TEGRABL_NO_ERROR) {
 		goto fail;
 	}
 
+	(void)tegrabl_dma_copy_is_done(extract_fence);
+
 #if defined(CONFIG_ENABLE_EXTLINUX_BOOT)
 	if (extlinux_boot_get_status()) {
 		err = extlinux_boot_update_bootargs(*kernel_dtb);
@@ -317,8 +355,13 @@ static tegrabl_error_t extract_kernel_dtb(void **kernel_dtb, void *kernel_dtbo)
 		pr_warn("Booting with default kernel-dtb!!!\n");
 		err = TEGRABL_NO_ERROR;
 	}
+	(void)tegrabl_dma_copy_is_done(extract_fence);
 #endif
 
+	/* Publish the boot timeline collected so far; failure is not fatal */
+	(void)tegrabl_profiler_add_dt_node(*kernel_dtb,
+									   fdt_path_offset(*kernel_dtb, "/chosen"));
+
 fail:
 	return err;
 }
@@ -368,12 +411,18 @@ static bool nvme_load_kernel_and_dtb(char *boot_dev,
 		return false;
 	}
 
-	i = 0;
+	/* Train all links at once, then boot from the controllers as they come up */
+	for (i = 0; pcie_ctrl_nums[i] >= 0; i++) {
+		err = tegrabl_pcie_start((uint8_t)pcie_ctrl_nums[i], 1);
+		if (err != TEGRABL_NO_ERROR) {
+			pr_warn("%s: failed to start PCIe controller %d, err: 0x%x\n", __func__, pcie_ctrl_nums[i], err);
+		}
+	}
+
 	while (!is_load_done) {
-		ctrl_num = pcie_ctrl_nums[i++];
+		ctrl_num = tegrabl_pcie_wait_link_up(pcie_ctrl_nums);
 		pr_debug("%s: NVME kernel load from ctrl=%d.\n", __func__, ctrl_num);
 		if (ctrl_num < 0) {
-			tegrabl_free((void *)pcie_ctrl_nums);
 			break;
 		}
 
@@ -388,10 +437,16 @@ static bool nvme_load_kernel_and_dtb(char *boot_dev,
 			pr_error("%s (%d) boot failed, err: 0x%x\n", "NVME", ctrl_num, err);
 			continue;
 		}
-		tegrabl_free((void *)pcie_ctrl_nums);
-		return true;
+		is_load_done = true;
+	}
+
+	/* Controllers left in the list were not needed */
+	for (i = 0; pcie_ctrl_nums[i] >= 0; i++) {
+		tegrabl_pcie_stop((uint8_t)pcie_ctrl_nums[i]);
 	}
-	return false;
+
+	tegrabl_free((void *)pcie_ctrl_nums);
+	return is_load_done;
 }
 #endif	/* CONFIG_ENABLE_NVME_BOOT */
 
@@ -403,6 +458,7 @@ tegrabl_error_t tegrabl_load_kernel_and_dtb(struct tegrabl_kernel_bin *kernel,
 											uint32_t data_size)
 {
 	tegrabl_error_t err = TEGRABL_NO_ERROR;
+	tegrabl_error_t cleanup_err;
 	void *kernel_dtbo = NULL;
 	bool is_load_done = false;
 	uint32_t i;
@@ -566,9 +622,22 @@ tegrabl_error_t tegrabl_load_kernel_and_dtb(struct tegrabl_kernel_bin *kernel,
 	pr_info("%s: Done\n", __func__);
 
 fail:
+	/* Kernel and ramdisk must be in place before returning, even on failure */
+	cleanup_err = tegrabl_dma_copy_wait(extract_fence);
+	if (cleanup_err != TEGRABL_NO_ERROR) {
+		pr_error("Error (%u) moving the kernel and ramdisk\n", cleanup_err);
+		if (err == TEGRABL_NO_ERROR) {
+			err = cleanup_err;
+		}
+	}
+
 #if defined(CONFIG_ENABLE_SECURE_BOOT)
 	pr_debug("%s: completing auth ...\n", __func__);
-	err = tegrabl_auth_complete();
+	cleanup_err = tegrabl_auth_complete();
+	/* Report the first error */
+	if (err == TEGRABL_NO_ERROR) {
+		err = cleanup_err;
+	}
 #endif
 
 	tegrabl_free(kernel_dtbo);
@@ -587,6 +656,7 @@ tegrabl_error_t tegrabl_load_kernel_and_dtb(struct tegrabl_kernel_bin *kernel,
 											uint32_t data_size)
 {
 	tegrabl_error_t err = TEGRABL_NO_ERROR;
+	tegrabl_error_t cleanup_err;
 	void *kernel_dtbo = NULL;
 	void *boot_img_load_addr = NULL;
 	void *ramdisk_load_addr = NULL;
@@ -647,9 +717,22 @@ tegrabl_error_t tegrabl_load_kernel_and_dtb(struct tegrabl_kernel_bin *kernel,
 	pr_info("%s: Done\n", __func__);
 
 fail:
+	/* Kernel and ramdisk must be in place before returning, even on failure */
+	cleanup_err = tegrabl_dma_copy_wait(extract_fence);
+	if (cleanup_err != TEGRABL_NO_ERROR) {
+		pr_error("Error (%u) moving the kernel and ramdisk\n", cleanup_err);
+		if (err == TEGRABL_NO_ERROR) {
+			err = cleanup_err;
+		}
+	}
+
 #if defined(CONFIG_ENABLE_SECURE_BOOT)
 	pr_debug("%s: completing auth ...\n", __func__);
-	err = tegrabl_auth_complete();
+	cleanup_err = tegrabl_auth_complete();
+	/* Report the first error */
+	if (err == TEGRABL_NO_ERROR) {
+		err = cleanup_err;
+	}
 #endif
 	tegrabl_free(kernel_dtbo);
 
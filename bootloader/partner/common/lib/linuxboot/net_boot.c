@@ -13,6 +13,7 @@
 #define MODULE TEGRABL_ERR_LINUXBOOT
 
 #include "build_config.h"
+#include <stddef.h>
 #include <string.h>
 #include <tegrabl_error.h>
 #include <tegrabl_debug.h>
@@ -21,8 +22,13 @@
 #include <lwip/init.h>
 #include <lwip/dhcp.h>
 #include <lwip/snmp.h>
+#include <lwip/timeouts.h>
 #include <lwip/apps/tftp_client.h>
+#include <lwip/apps/http_client.h>
 #include <platform/interrupts.h>
+#include <kernel/thread.h>
+#include <kernel/event.h>
+#include <kernel/mutex.h>
 #include <tegrabl_board_info.h>
 #include <tegrabl_eqos.h>
 #include <tegrabl_cbo.h>
@@ -30,13 +36,18 @@
 #include <tegrabl_binary_types.h>
 #include <tegrabl_linuxboot_helper.h>
 #include <tegrabl_linuxboot_utils.h>
+#include <tegrabl_utils.h>
 #include <net_boot.h>
+#include <net_boot_lease.h>
 
 #define TFTP_SERVER_IP						"10.24.238.35"
 #define TFTP_MAX_RRQ_RETRIES				(5)
 
 #define MAC_RX_CH0_INTR						(32 + 194)
+/* Frames fed to lwIP per pass before the RX worker lets other threads run */
+#define NET_RX_BUDGET						16U
 #define DHCP_TIMEOUT_MS						(20 * 1000)
+#define DHCP_POLL_INTERVAL_MS				(1)
 
 #define AUX_INFO_DHCP_TIMEOUT				1
 #define AUX_INFO_DTB_RD_REQ_TIMEOUT			2
@@ -45,9 +56,28 @@
 #define AUX_INFO_BOOT_IMAGE_RECV_ERR		5
 #define AUX_INFO_TFTP_CLIENT_INIT_FAILED	6
 #define AUX_INFO_TFTP_CLIENT_INIT_FAILED	6
+#define AUX_INFO_RX_WORKER_INIT_FAILED		7
+#define AUX_INFO_HTTP_DTB_RECV_ERR			8
+#define AUX_INFO_HTTP_BOOT_IMAGE_RECV_ERR	9
 
 static struct netif netif;
 struct netif *saved_netif;
+static struct net_boot_lease dhcp_lease;
+
+static mutex_t lwip_lock = MUTEX_INITIAL_VALUE(lwip_lock);
+static event_t net_rx_event = EVENT_INITIAL_VALUE(net_rx_event, false, EVENT_FLAG_AUTOUNSIGNAL);
+static thread_t *net_rx_thread;
+static volatile bool net_rx_stop;
+
+void lwip_core_lock(void)
+{
+	mutex_acquire(&lwip_lock);
+}
+
+void lwip_core_unlock(void)
+{
+	mutex_release(&lwip_lock);
+}
 
 static void convert_ip_str_to_int(char * const ip_addr_str, uint8_t * const ip_addr_int)
 {
@@ -74,7 +104,6 @@ err_t pass_network_packet_to_ethernet_controller(struct netif *netif, struct pbu
 	 */
 	for (tx_data = p; tx_data != NULL; tx_data = tx_data->next) {
 		tegrabl_eqos_send(tx_data->payload, tx_data->len);
-		unmask_interrupt(MAC_RX_CH0_INTR);   /* Enable interrupt */
 	}
 
 	/* Increment packet counters */
@@ -104,13 +133,9 @@ err_t process_ethernet_frame(void)
 		goto fail;
 	}
 
-	tegrabl_eqos_receive(&payload, &len);
-	/* cboot only supports TFTP. Packages with size larger
-	 * than standard TFTP package (with 512 bytes TFTP
-	 * data for each package) will be dropped.
-	 * Ping (ICMP) with size less than 512 is also supported.
-	 */
-	if (len > 562) {
+	tegrabl_eqos_receive(&payload, sizeof(payload), &len);
+	/* Full size frames are needed for TCP (HTTP boot), larger ones were not copied */
+	if (len > sizeof(payload)) {
 		LINK_STATS_INC(link.memerr);
 		LINK_STATS_INC(link.drop);
 		MIB2_STATS_NETIF_INC(netif, ifindiscards);
@@ -146,6 +171,8 @@ err_t process_ethernet_frame(void)
 		pr_error("Network layer failed to process packet, err: %d\n", err);
 		goto fail;
 	}
+	/* The stack owns the pbuf once it accepted it */
+	p = NULL;
 
 fail:
 	if (p != NULL) {
@@ -161,19 +188,89 @@ static void netif_status_callback(struct netif *netif)
 	pr_info("netif status changed %s\n", ip4addr_ntoa(netif_ip4_addr(netif)));
 }
 
+/* RX only kicks the worker, it stays masked until the worker drained the ring */
 static handler_return_t pass_ethernet_frame_to_network_stack(void *arg)
 {
 	TEGRABL_UNUSED(arg);
 
 	mask_interrupt(MAC_RX_CH0_INTR);
-	/* TODO: Handle or defer using RESCHED */
+	event_signal(&net_rx_event, false);
+
+	return INT_RESCHEDULE;
+}
+
+/* Feed up to budget received frames to lwIP, returns how many were pending */
+static uint32_t net_rx_poll(uint32_t budget)
+{
+	uint32_t count = 0;
+
 	if (tegrabl_eqos_is_dma_rx_intr_occured()) {
 		tegrabl_eqos_clear_dma_rx_intr();
-		process_ethernet_frame();			   /* Call LWIP to process RX */
 	}
+
+	lwip_core_lock();
+	while ((count < budget) && tegrabl_eqos_is_rx_pending()) {
+		process_ethernet_frame();
+		count++;
+	}
+	lwip_core_unlock();
+
+	return count;
+}
+
+static int net_rx_worker(void *arg)
+{
+	TEGRABL_UNUSED(arg);
+
+	while (true) {
+		event_wait(&net_rx_event);
+		if (net_rx_stop) {
+			break;
+		}
+
+		/*
+		 * Keep polling with the interrupt off for as long as frames keep
+		 * coming, so a bulk transfer does not take an interrupt per frame.
+		 * A frame landing after the last empty pass raises RI again and
+		 * fires as soon as the interrupt is unmasked. The worker runs at the
+		 * priority of the boot thread and background tasks, so yielding
+		 * after each budget lets them run in between.
+		 */
+		while (net_rx_poll(NET_RX_BUDGET) != 0U) {
+			thread_yield();
+		}
+		unmask_interrupt(MAC_RX_CH0_INTR);
+	}
+
+	return 0;
+}
+
+static tegrabl_error_t net_rx_worker_start(void)
+{
+	net_rx_stop = false;
+	net_rx_thread = thread_create("net-rx", net_rx_worker, NULL, DEFAULT_PRIORITY, DEFAULT_STACK_SIZE);
+	if (net_rx_thread == NULL) {
+		pr_error("Failed to create network RX worker\n");
+		return TEGRABL_ERROR(TEGRABL_ERR_INIT_FAILED, AUX_INFO_RX_WORKER_INIT_FAILED);
+	}
+	thread_resume(net_rx_thread);
+
 	unmask_interrupt(MAC_RX_CH0_INTR);
 
-	return INT_NO_RESCHEDULE;
+	return TEGRABL_NO_ERROR;
+}
+
+static void net_rx_worker_stop(void)
+{
+	if (net_rx_thread == NULL) {
+		return;
+	}
+
+	mask_interrupt(MAC_RX_CH0_INTR);
+	net_rx_stop = true;
+	event_signal(&net_rx_event, true);
+	thread_join(net_rx_thread, NULL, INFINITE_TIME);
+	net_rx_thread = NULL;
 }
 
 static err_t platform_netif_init(struct netif *netif)
@@ -220,6 +317,31 @@ done:
 	return (err_t)error;
 }
 
+/* Persist the lease lwIP acquired on nif */
+static void dhcp_lease_store(struct net_boot_lease *cached, struct netif *nif)
+{
+	struct dhcp *dhcp = netif_dhcp_data(nif);
+	struct net_boot_lease lease;
+
+	memset(&lease, 0, sizeof(lease));
+	memcpy(lease.mac, nif->hwaddr, sizeof(lease.mac));
+	memcpy(lease.ip, &dhcp->offered_ip_addr.addr, 4);
+	memcpy(lease.netmask, &dhcp->offered_sn_mask.addr, 4);
+	memcpy(lease.gateway, &dhcp->offered_gw_addr.addr, 4);
+	memcpy(lease.server, &ip_2_ip4(&dhcp->server_ip_addr)->addr, 4);
+	memcpy(lease.tftp_server, &dhcp->offered_si_addr.addr, 4);
+
+	(void)net_boot_lease_store(cached, &lease);
+}
+
+/* Run the lwIP timers that are due */
+static void net_boot_check_timeouts(void)
+{
+	lwip_core_lock();
+	sys_check_timeouts();
+	lwip_core_unlock();
+}
+
 static tegrabl_error_t net_boot_stack_init(void)
 {
 	uint8_t *ip_addr = NULL;
@@ -227,6 +349,7 @@ static tegrabl_error_t net_boot_stack_init(void)
 	struct ip_info info = {0};
 	time_t start_time_ms;
 	time_t elapsed_time_ms;
+	ip4_addr_t cached_ip;
 	ip4_addr_t static_ip;
 	ip4_addr_t netmask;
 	ip4_addr_t gateway;
@@ -242,16 +365,33 @@ static tegrabl_error_t net_boot_stack_init(void)
 		goto fail;
 	}
 
+	err = net_rx_worker_start();
+	if (err != TEGRABL_NO_ERROR) {
+		goto fail;
+	}
+
 	info = tegrabl_get_ip_info();
 
 	if (info.is_dhcp_enabled) {
 
-		pr_info("DHCP: Init: Requesting IP ...\n");
+		if (net_boot_lease_load(&dhcp_lease, netif.hwaddr)) {
+			pr_info("DHCP: Init-Reboot: Requesting %d.%d.%d.%d ...\n", dhcp_lease.ip[0], dhcp_lease.ip[1],
+					dhcp_lease.ip[2], dhcp_lease.ip[3]);
+			memcpy(&cached_ip.addr, dhcp_lease.ip, 4);
+		} else {
+			pr_info("DHCP: Init: Requesting IP ...\n");
+			cached_ip.addr = 0;
+		}
 
+		lwip_core_lock();
 		/* Bring an interface up, available for processing */
 		netif_set_up(&netif);
-
-		err = (tegrabl_error_t)dhcp_start(&netif);
+		if (cached_ip.addr != 0U) {
+			err = (tegrabl_error_t)dhcp_start_reboot(&netif, &cached_ip);
+		} else {
+			err = (tegrabl_error_t)dhcp_start(&netif);
+		}
+		lwip_core_unlock();
 		if (err != TEGRABL_NO_ERROR) {
 			pr_error("DHCP failed\n");
 			goto fail;
@@ -259,6 +399,7 @@ static tegrabl_error_t net_boot_stack_init(void)
 
 		start_time_ms = tegrabl_get_timestamp_ms();
 
+		/* OFFER/ACK are handled as they arrive, lwIP's timers drive retransmits */
 		while (dhcp_supplied_address(&netif) == 0) {
 			elapsed_time_ms = tegrabl_get_timestamp_ms() - start_time_ms;
 			if (elapsed_time_ms > DHCP_TIMEOUT_MS) {
@@ -266,17 +407,24 @@ static tegrabl_error_t net_boot_stack_init(void)
 				err = TEGRABL_ERROR(TEGRABL_ERR_TIMEOUT, AUX_INFO_DHCP_TIMEOUT);
 				goto fail;
 			}
-			tegrabl_mdelay(500);
-			dhcp_fine_tmr();
+			net_boot_check_timeouts();
+			/* Sleep rather than spin, so that the RX worker gets the CPU right away */
+			thread_sleep(DHCP_POLL_INTERVAL_MS);
 		}
 
+		lwip_core_lock();
+		dhcp_lease_store(&dhcp_lease, &netif);
+		lwip_core_unlock();
+
 	} else {
 		pr_info("Configure Static IP ...\n");
 		memcpy(&static_ip.addr, &info.static_ip, 4);
 		memcpy(&netmask.addr, &info.ip_netmask, 4);
 		memcpy(&gateway.addr, &info.ip_gateway, 4);
+		lwip_core_lock();
 		netif_set_addr(&netif, &static_ip, &netmask, &gateway);
 		netif_set_up(&netif);
+		lwip_core_unlock();
 	}
 
 	ip_addr = (uint8_t *)(&(netif.ip_addr.addr));
@@ -285,11 +433,20 @@ static tegrabl_error_t net_boot_stack_init(void)
 	return err;
 
 fail:
+	net_rx_worker_stop();
 	tegrabl_eqos_deinit();
 	netif_remove(&netif);
 	return err;
 }
 
+static void net_boot_stack_deinit(void)
+{
+	net_rx_worker_stop();
+	tegrabl_eqos_deinit();
+	netif_set_down(&netif);
+	netif_remove(&netif);
+}
+
 static tegrabl_error_t download_kernel_and_dtb_from_tftp(uint8_t *tftp_server_ip,
 														 void *boot_img_load_addr,
 														 void *dtb_load_addr,
@@ -312,7 +469,9 @@ static tegrabl_error_t download_kernel_and_dtb_from_tftp(uint8_t *tftp_server_ip
 		if (ret == ERR_OK) {
 			break;
 		} else if (ret == ERR_CONN) {
+			lwip_core_lock();
 			etharp_tmr();
+			lwip_core_unlock();
 			tegrabl_mdelay(10);
 			continue;
 		} else if (ret != ERR_OK) {
@@ -348,9 +507,37 @@ static tegrabl_error_t download_kernel_and_dtb_from_tftp(uint8_t *tftp_server_ip
 	}
 
 fail:
-	tegrabl_eqos_deinit();
-	netif_set_down(&netif);
-	netif_remove(&netif);
+	net_boot_stack_deinit();
+
+	return err;
+}
+
+static tegrabl_error_t download_kernel_and_dtb_from_http(uint8_t *http_server_ip,
+														 uint16_t port,
+														 void *boot_img_load_addr,
+														 void *dtb_load_addr,
+														 uint32_t *boot_img_size)
+{
+	err_t ret = 0;
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+
+	ret = http_client_get(http_server_ip, port, "/" KERNEL_DTB, dtb_load_addr, DTB_MAX_SIZE, NULL);
+	if (ret != ERR_OK) {
+		pr_error("Failed to get %s over HTTP, err: %d\n", KERNEL_DTB, ret);
+		err = TEGRABL_ERROR(TEGRABL_ERR_INVALID, AUX_INFO_HTTP_DTB_RECV_ERR);
+		goto fail;
+	}
+
+	ret = http_client_get(http_server_ip, port, "/" BOOT_IMAGE, boot_img_load_addr, BOOT_IMAGE_MAX_SIZE,
+						  boot_img_size);
+	if (ret != ERR_OK) {
+		pr_error("Failed to get %s over HTTP, err: %d\n", BOOT_IMAGE, ret);
+		err = TEGRABL_ERROR(TEGRABL_ERR_INVALID, AUX_INFO_HTTP_BOOT_IMAGE_RECV_ERR);
+		goto fail;
+	}
+
+fail:
+	net_boot_stack_deinit();
 
 	return err;
 }
@@ -383,12 +570,27 @@ tegrabl_error_t net_boot_load_kernel_and_dtb(void **boot_img_load_addr, void **d
 		goto fail;
 	}
 
-	/* Download kernel iand dtb from tftp */
+	/* Download kernel and dtb from tftp or http */
 	info = tegrabl_get_ip_info();
-	err = download_kernel_and_dtb_from_tftp(info.tftp_server_ip,
-											*boot_img_load_addr,
-											*dtb_load_addr,
-											&boot_img_size);
+	if (info.is_dhcp_enabled && ((info.tftp_server_ip[0] | info.tftp_server_ip[1] |
+									info.tftp_server_ip[2] | info.tftp_server_ip[3]) == 0U)) {
+		/* No server configured, use the next-server of the lease */
+		memcpy(info.tftp_server_ip, dhcp_lease.tftp_server, 4);
+		pr_info("TFTP server (DHCP): %d.%d.%d.%d\n", info.tftp_server_ip[0], info.tftp_server_ip[1],
+				info.tftp_server_ip[2], info.tftp_server_ip[3]);
+	}
+	if (info.http_server_port != 0U) {
+		err = download_kernel_and_dtb_from_http(info.tftp_server_ip,
+												info.http_server_port,
+												*boot_img_load_addr,
+												*dtb_load_addr,
+												&boot_img_size);
+	} else {
+		err = download_kernel_and_dtb_from_tftp(info.tftp_server_ip,
+												*boot_img_load_addr,
+												*dtb_load_addr,
+												&boot_img_size);
+	}
 	if (err != TEGRABL_NO_ERROR) {
 		goto fail;
 	}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited
+ */
+
+#define MODULE TEGRABL_ERR_LINUXBOOT
+
+#include "build_config.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <tegrabl_error.h>
+#include <tegrabl_debug.h>
+#include <tegrabl_cache_record.h>
+#include <net_boot_lease.h>
+
+bool net_boot_lease_load(struct net_boot_lease *lease, const uint8_t *mac)
+{
+	static const uint8_t no_ip[4];
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+
+	err = tegrabl_cache_record_load(NET_BOOT_LEASE_PARTITION, NET_BOOT_LEASE_VERSION, lease, sizeof(*lease));
+	if ((err != TEGRABL_NO_ERROR) || (memcmp(lease->mac, mac, sizeof(lease->mac)) != 0) ||
+		(memcmp(lease->ip, no_ip, sizeof(no_ip)) == 0)) {
+		memset(lease, 0, sizeof(*lease));
+		return false;
+	}
+
+	return true;
+}
+
+bool net_boot_lease_store(struct net_boot_lease *cached, const struct net_boot_lease *lease)
+{
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+
+	if (memcmp(lease, cached, sizeof(*lease)) == 0) {
+		return false;
+	}
+	memcpy(cached, lease, sizeof(*lease));
+
+	err = tegrabl_cache_record_store(NET_BOOT_LEASE_PARTITION, NET_BOOT_LEASE_VERSION, lease, sizeof(*lease));
+	if (err != TEGRABL_NO_ERROR) {
+		if (TEGRABL_ERROR_REASON(err) != TEGRABL_ERR_NOT_FOUND) {
+			pr_warn("DHCP: failed to cache lease (err 0x%08x)\n", err);
+		}
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited
+ */
+
+#ifndef INCLUDED_NET_BOOT_LEASE_H
+#define INCLUDED_NET_BOOT_LEASE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Optional partition holding the last DHCP lease, caching is off without it */
+#define NET_BOOT_LEASE_PARTITION			"DHCP-LEASE"
+#define NET_BOOT_LEASE_VERSION				2U
+
+/**
+ * @brief Last lease, persisted so that the next boot can start in INIT-REBOOT
+ *
+ * @param mac MAC address the lease was given to
+ * @param ip leased address
+ * @param netmask subnet mask option
+ * @param gateway router option
+ * @param server address of the DHCP server
+ * @param tftp_server next-server (siaddr) of the lease
+ */
+struct net_boot_lease {
+	uint8_t mac[6];
+	uint8_t reserved[2];
+	uint8_t ip[4];
+	uint8_t netmask[4];
+	uint8_t gateway[4];
+	uint8_t server[4];
+	uint8_t tftp_server[4];
+};
+
+/**
+ * @brief Read back the lease of the previous boot
+ *
+ * @param lease filled with the cached lease, zeroed if there is none
+ * @param mac MAC address of the interface to boot from
+ *
+ * @return true if a lease for this MAC with an address was cached
+ */
+bool net_boot_lease_load(struct net_boot_lease *lease, const uint8_t *mac);
+
+/**
+ * @brief Persist a lease. The partition is only written when the lease
+ * differs from the cached one, failures only warn as the next boot just runs
+ * a full DISCOVER.
+ *
+ * @param cached lease of the previous boot, updated to the new lease
+ * @param lease lease just acquired
+ *
+ * @return true if the lease changed and was written out
+ */
+bool net_boot_lease_store(struct net_boot_lease *cached, const struct net_boot_lease *lease);
+
+#endif /* INCLUDED_NET_BOOT_LEASE_H */
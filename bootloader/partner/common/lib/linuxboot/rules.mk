@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2015-2019, NVIDIA Corporation.  All Rights Reserved.
+# Copyright (c) 2015-2021, NVIDIA Corporation.  All Rights Reserved.
 #
 # NVIDIA Corporation and its licensors retain all intellectual property and
 # proprietary rights in and to this software and related documentation.  Any
@@ -57,6 +57,7 @@ ifneq ($(filter t19x, $(TARGET_FAMILY)),)
 MODULE_SRCS += \
 	$(LOCAL_DIR)/removable_boot.c \
 	$(LOCAL_DIR)/net_boot.c \
+	$(LOCAL_DIR)/net_boot_lease.c \
 	$(LOCAL_DIR)/extlinux_boot.c
 endif
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014-2017, NVIDIA CORPORATION.  All Rights Reserved.
+ * Copyright (c) 2014-2021, NVIDIA CORPORATION.  All Rights Reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property and
  * proprietary rights in and to this software and related documentation.  Any
@@ -30,6 +30,24 @@
 #define LEGACY_BLOB_HEADER_LEN 36
 #define MAX_BLOB_SIZE (60 * 1024 * 1024)
 
+/*
+ * Set in the header version of blobs whose entries are compressed one by one.
+ * The entry table is followed by one blob_entry_index per entry, the entry
+ * offset points at the stored data and the entry size is its original size.
+ */
+#define BLOB_VERSION_ENTRY_COMPRESSED 0x80000000U
+
+/**
+ * @brief per-entry index of an entry compressed blob
+ *
+ * @stored_size bytes stored at the entry offset, equals the entry size if
+ *              the entry is not compressed
+ */
+struct blob_entry_index {
+	uint32_t stored_size;
+	uint32_t reserved;
+};
+
 /**
  * @brief blob signed header
  *
@@ -104,6 +122,72 @@ static uint8_t parse_entry(tegrabl_blob_type_t t, union blob_entry *e,
 	return 1;
 }
 
+static bool is_entry_compressed(struct blob_header *blobheader)
+{
+	return (blobheader->version & BLOB_VERSION_ENTRY_COMPRESSED) != 0U;
+}
+
+static uint32_t entry_size(tegrabl_blob_type_t t)
+{
+	switch (t) {
+	case BLOB_UPDATE:
+		return sizeof(struct tegrabl_image_entry);
+	case BLOB_BMP:
+		return sizeof(struct tegrabl_bmp_entry);
+	default:
+		return 0;
+	}
+}
+
+static struct blob_entry_index *get_entry_index(struct blob_header *blobheader,
+												uint32_t index)
+{
+	uint8_t *table = (uint8_t *)blobheader + blobheader->entries_offset +
+					 (blobheader->num_entries * entry_size(blobheader->type));
+
+	return (struct blob_entry_index *)table + index;
+}
+
+/*
+ * Copy the data of one entry into out, decompressing it if it is stored
+ * compressed. Only used on entry compressed blobs.
+ */
+static tegrabl_error_t entry_decompress(struct blob_header *blobheader,
+										uint32_t index, uint32_t offset,
+										uint32_t length, uint8_t *out)
+{
+	uint8_t *src = (uint8_t *)blobheader + offset;
+	uint32_t stored_size = get_entry_index(blobheader, index)->stored_size;
+	uint32_t written = length;
+	decompressor *decomp = NULL;
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+
+	if (stored_size == length) {
+		memcpy(out, src, length);
+		return TEGRABL_NO_ERROR;
+	}
+
+	if (!is_compressed_content(src, &decomp)) {
+		pr_error("%s: entry %u is not compressed\n", __func__, index);
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 1);
+	}
+
+	err = do_decompress(decomp, src, stored_size, out, &written);
+	if (err != TEGRABL_NO_ERROR) {
+		pr_error("%s: entry %u decompression failed (err=%d)\n", __func__,
+				 index, err);
+		return err;
+	}
+
+	if (written != length) {
+		pr_error("%s: entry %u is %u bytes, expected %u\n", __func__, index,
+				 written, length);
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 2);
+	}
+
+	return TEGRABL_NO_ERROR;
+}
+
 static tegrabl_error_t blob_decompress(void **blob_buf, uint32_t *blob_asize,
 									   void *header, uint32_t hdr_size,
 									   uint32_t data_size, decompressor *decomp)
@@ -272,7 +356,7 @@ tegrabl_error_t tegrabl_blob_init(char *part_name, uint8_t *bptr,
 		}
 
 		struct blob_header *blobheader = (struct blob_header *)header;
-		if (is_compressed_content(
+		if (!is_entry_compressed(blobheader) && is_compressed_content(
 				(uint8_t *)header + blobheader->entries_offset, &decomp)) {
 			pr_info("decompressing %s blob ...\n", part_name);
 			error = blob_decompress(&blob_buf, (uint32_t *)&blob_asize, header,
@@ -562,7 +646,12 @@ tegrabl_error_t tegrabl_blob_get_entry_data(tegrabl_blob_handle b,
 		goto fail;
 	}
 
-	if (data) {
+	if (is_entry_compressed(blob_header) && data) {
+		/* The entry only exists compressed, it is read into caller memory */
+		pr_error("%s: entry %u is compressed\n", __func__, index);
+		error = TEGRABL_ERROR(TEGRABL_ERR_NOT_SUPPORTED, 0);
+		goto fail;
+	} else if (data) {
 		*data = bh->start + bh->offset + offset;
 	}
 	if (size) {
@@ -572,9 +661,76 @@ fail:
 	return error;
 }
 
+tegrabl_error_t tegrabl_blob_read_entry_data(tegrabl_blob_handle b,
+	uint32_t index, void *buf, uint32_t buf_size, uint32_t *size)
+{
+	struct blob_info *bh = (struct blob_info *)b;
+	struct blob_header *blob_header = NULL;
+	uint32_t offset = 0;
+	uint32_t length = 0;
+	void *entry = NULL;
+	tegrabl_error_t error = TEGRABL_NO_ERROR;
+
+	if (!(bh && bh->start) || (buf == NULL)) {
+		error = TEGRABL_ERROR(TEGRABL_ERR_INVALID, 4);
+		goto fail;
+	}
+
+	blob_header = (struct blob_header *)(bh->start + bh->offset);
+	if (index >= blob_header->num_entries) {
+		error = TEGRABL_ERROR(TEGRABL_ERR_INVALID, 5);
+		goto fail;
+	}
+
+	error = tegrabl_blob_get_entry(b, index, &entry);
+	if (error != TEGRABL_NO_ERROR) {
+		goto fail;
+	}
+
+	if (parse_entry(blob_header->type, (union blob_entry *)entry, &offset,
+					&length) == 0) {
+		error = TEGRABL_ERROR(TEGRABL_ERR_INVALID, 6);
+		goto fail;
+	}
+
+	if (length > buf_size) {
+		error = TEGRABL_ERROR(TEGRABL_ERR_OVERFLOW, 0);
+		pr_error("%s: entry %u is %u bytes, buffer is %u\n", __func__, index,
+				 length, buf_size);
+		goto fail;
+	}
+
+	if (is_entry_compressed(blob_header)) {
+		error = entry_decompress(blob_header, index, offset, length, buf);
+		if (error != TEGRABL_NO_ERROR) {
+			goto fail;
+		}
+	} else {
+		memcpy(buf, (uint8_t *)blob_header + offset, length);
+	}
+
+	if (size) {
+		*size = length;
+	}
+fail:
+	return error;
+}
+
+bool tegrabl_blob_is_entry_compressed(tegrabl_blob_handle b)
+{
+	struct blob_info *bh = (struct blob_info *)b;
+
+	if (!(bh && bh->start)) {
+		return false;
+	}
+
+	return is_entry_compressed((struct blob_header *)(bh->start + bh->offset));
+}
+
 void tegrabl_blob_close(tegrabl_blob_handle b)
 {
 	struct blob_info *bh = (struct blob_info *)b;
+
 	if (!bh) {
 		return;
 	}
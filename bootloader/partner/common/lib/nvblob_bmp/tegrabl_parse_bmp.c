@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014-2017, NVIDIA Corporation.  All Rights Reserved.
+ * Copyright (c) 2014-2021, NVIDIA Corporation.  All Rights Reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property and
  * proprietary rights in and to this software and related documentation.  Any
@@ -14,11 +14,25 @@
 #include <tegrabl_nvblob.h>
 #include <tegrabl_debug.h>
 #include <tegrabl_error.h>
+#include <tegrabl_malloc.h>
 
 tegrabl_blob_handle bh;
 bool is_initialized;
 uint32_t num_images;
 
+/* Last image read out of a blob whose entries are compressed one by one */
+static uint8_t *bmp_data;
+static int bmp_data_entry = -1;
+
+static void free_bmp_data(void)
+{
+	if (bmp_data != NULL) {
+		tegrabl_free(bmp_data);
+		bmp_data = NULL;
+	}
+	bmp_data_entry = -1;
+}
+
 static tegrabl_bmp_resolution_t get_optimal_bmp_resolution(
 	uint32_t panel_resolution, bool is_panel_portrait, uint32_t rotation_angle)
 {
@@ -91,6 +105,7 @@ fail:
 
 void tegrabl_unload_bmp_blob(void)
 {
+	free_bmp_data();
 	tegrabl_blob_close(bh);
 	is_initialized = false;
 }
@@ -141,10 +156,36 @@ tegrabl_error_t tegrabl_get_bmp(struct tegrabl_bmp_image *img)
 		goto fail;
 	}
 
-	error = tegrabl_blob_get_entry_data(bh, desired_entry, &(img->bmp),
-										&bmp_length);
-	if (error != TEGRABL_NO_ERROR) {
-		goto fail;
+	if (!tegrabl_blob_is_entry_compressed(bh)) {
+		error = tegrabl_blob_get_entry_data(bh, desired_entry, &(img->bmp),
+											&bmp_length);
+		if (error != TEGRABL_NO_ERROR) {
+			goto fail;
+		}
+	} else {
+		error = tegrabl_blob_get_entry_data(bh, desired_entry, NULL,
+											&bmp_length);
+		if (error != TEGRABL_NO_ERROR) {
+			goto fail;
+		}
+
+		/* The previous image is dropped, callers use one image at a time */
+		if (desired_entry != bmp_data_entry) {
+			free_bmp_data();
+			bmp_data = tegrabl_malloc(bmp_length);
+			if (bmp_data == NULL) {
+				error = TEGRABL_ERROR(TEGRABL_ERR_NO_MEMORY, 3);
+				goto fail;
+			}
+			error = tegrabl_blob_read_entry_data(bh, desired_entry, bmp_data,
+												 bmp_length, NULL);
+			if (error != TEGRABL_NO_ERROR) {
+				free_bmp_data();
+				goto fail;
+			}
+			bmp_data_entry = desired_entry;
+		}
+		img->bmp = bmp_data;
 	}
 
 	img->image_size = bmp_length;
@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2015 - 2017, NVIDIA Corporation.  All Rights Reserved.
+# Copyright (c) 2015 - 2021, NVIDIA Corporation.  All Rights Reserved.
 #
 # NVIDIA Corporation and its licensors retain all intellectual property and
 # proprietary rights in and to this software and related documentation.  Any
@@ -17,7 +17,8 @@ GLOBAL_INCLUDES += \
 	$(LOCAL_DIR)/../../include/lib
 
 MODULE_SRCS += \
-	$(LOCAL_DIR)/tegrabl_partition_manager.c
+	$(LOCAL_DIR)/tegrabl_partition_manager.c \
+	$(LOCAL_DIR)/tegrabl_cache_record.c
 
 include make/module.mk
 
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2021, NVIDIA Corporation.  All Rights Reserved.
+ *
+ * NVIDIA Corporation and its licensors retain all intellectual property and
+ * proprietary rights in and to this software and related documentation.  Any
+ * use, reproduction, disclosure or distribution of this software and related
+ * documentation without an express license agreement from NVIDIA Corporation
+ * is strictly prohibited.
+ */
+
+#define MODULE TEGRABL_ERR_PARTITION_MANAGER
+
+#include "build_config.h"
+#include <stdint.h>
+#include <string.h>
+#include <tegrabl_utils.h>
+#include <tegrabl_malloc.h>
+#include <tegrabl_debug.h>
+#include <tegrabl_blockdev.h>
+#include <tegrabl_partition_manager.h>
+#include <tegrabl_cache_record.h>
+
+#define CACHE_RECORD_MAGIC 0x43524543U /* "CERC" */
+
+#define AUX_INFO_CACHE_RECORD_PARAMS	30
+#define AUX_INFO_CACHE_RECORD_SIZE		31
+#define AUX_INFO_CACHE_RECORD_HEADER	32
+#define AUX_INFO_CACHE_RECORD_CRC		33
+#define AUX_INFO_CACHE_RECORD_NO_MEM	34
+
+struct cache_record_header {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t size;
+	/* CRC32 of the record that follows the header */
+	uint32_t crc;
+};
+
+static tegrabl_error_t cache_record_open(const char *part_name, uint32_t size,
+										 struct tegrabl_partition *part)
+{
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+
+	err = tegrabl_partition_open(part_name, part);
+	if (err != TEGRABL_NO_ERROR) {
+		pr_debug("No %s partition, record not cached\n", part_name);
+		return err;
+	}
+
+	if (tegrabl_partition_size(part) < (sizeof(struct cache_record_header) + size)) {
+		pr_warn("%s partition too small for a %u byte record\n", part_name, size);
+		tegrabl_partition_close(part);
+		return TEGRABL_ERROR(TEGRABL_ERR_OVERFLOW, AUX_INFO_CACHE_RECORD_SIZE);
+	}
+
+	return TEGRABL_NO_ERROR;
+}
+
+tegrabl_error_t tegrabl_cache_record_load(const char *part_name, uint32_t version,
+										  void *buf, uint32_t size)
+{
+	struct cache_record_header header;
+	struct tegrabl_partition part;
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+
+	if ((part_name == NULL) || (buf == NULL) || (size == 0U)) {
+		return TEGRABL_ERROR(TEGRABL_ERR_BAD_PARAMETER, AUX_INFO_CACHE_RECORD_PARAMS);
+	}
+
+	err = cache_record_open(part_name, size, &part);
+	if (err != TEGRABL_NO_ERROR) {
+		return err;
+	}
+
+	err = tegrabl_partition_read(&part, &header, sizeof(header));
+	if (err != TEGRABL_NO_ERROR) {
+		goto done;
+	}
+
+	if ((header.magic != CACHE_RECORD_MAGIC) || (header.version != version) ||
+		(header.size != size)) {
+		err = TEGRABL_ERROR(TEGRABL_ERR_INVALID, AUX_INFO_CACHE_RECORD_HEADER);
+		goto done;
+	}
+
+	err = tegrabl_partition_read(&part, buf, size);
+	if (err != TEGRABL_NO_ERROR) {
+		goto done;
+	}
+
+	if (header.crc != tegrabl_utils_crc32(0, buf, size)) {
+		err = TEGRABL_ERROR(TEGRABL_ERR_INVALID, AUX_INFO_CACHE_RECORD_CRC);
+	}
+
+done:
+	tegrabl_partition_close(&part);
+	return err;
+}
+
+tegrabl_error_t tegrabl_cache_record_store(const char *part_name, uint32_t version,
+										   const void *buf, uint32_t size)
+{
+	struct cache_record_header *header = NULL;
+	struct tegrabl_partition part;
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+
+	if ((part_name == NULL) || (buf == NULL) || (size == 0U)) {
+		return TEGRABL_ERROR(TEGRABL_ERR_BAD_PARAMETER, AUX_INFO_CACHE_RECORD_PARAMS);
+	}
+
+	err = cache_record_open(part_name, size, &part);
+	if (err != TEGRABL_NO_ERROR) {
+		return err;
+	}
+
+	/* Header and record go out in one write */
+	header = tegrabl_malloc(sizeof(*header) + size);
+	if (header == NULL) {
+		err = TEGRABL_ERROR(TEGRABL_ERR_NO_MEMORY, AUX_INFO_CACHE_RECORD_NO_MEM);
+		goto done;
+	}
+	header->magic = CACHE_RECORD_MAGIC;
+	header->version = version;
+	header->size = size;
+	memcpy(header + 1, buf, size);
+	header->crc = tegrabl_utils_crc32(0, header + 1, size);
+
+#if defined(CONFIG_ENABLE_QSPI)
+	if (tegrabl_blockdev_get_storage_type(part.block_device) == TEGRABL_STORAGE_QSPI_FLASH) {
+		err = tegrabl_partition_erase(&part, false);
+		if (err != TEGRABL_NO_ERROR) {
+			goto done;
+		}
+	}
+#endif
+
+	err = tegrabl_partition_seek(&part, 0, TEGRABL_PARTITION_SEEK_SET);
+	if (err != TEGRABL_NO_ERROR) {
+		goto done;
+	}
+	err = tegrabl_partition_write(&part, header, sizeof(*header) + size);
+
+done:
+	if (header != NULL) {
+		tegrabl_free(header);
+	}
+	tegrabl_partition_close(&part);
+	return err;
+}
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ */
+
+#define MODULE TEGRABL_ERR_PROFILER
+
+#include "build_config.h"
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+#include <libfdt.h>
+#include <tegrabl_error.h>
+#include <tegrabl_debug.h>
+#include <tegrabl_timer.h>
+#include <tegrabl_devicetree.h>
+#include <tegrabl_profiler.h>
+
+/* Without CONFIG_BOOT_PROFILER the header provides inline stubs */
+#if defined(CONFIG_BOOT_PROFILER)
+
+#define PROFILER_DT_NODE	"cboot-profiler"
+
+/* Records of this stage, carved out of the shared profiler page */
+static struct tegrabl_profiler_record *s_records;
+static uint32_t s_max_records;
+
+/*
+ * Index of the next free record. Slots are claimed with an atomic increment so
+ * that records can be added from interrupt context or from secondary cores
+ * without a lock; a slot only becomes visible once its timestamp is written.
+ */
+static uint32_t s_next_record;
+static uint32_t s_dropped_records;
+
+static inline uint32_t profiler_num_records(void)
+{
+	uint32_t count = __atomic_load_n(&s_next_record, __ATOMIC_ACQUIRE);
+
+	return (count < s_max_records) ? count : s_max_records;
+}
+
+tegrabl_error_t tegrabl_profiler_init(uint64_t page_addr,
+									  uint32_t offset,
+									  uint32_t size)
+{
+	if ((page_addr == 0ULL) ||
+		((offset + size) > TEGRABL_PROFILER_PAGE_SIZE) ||
+		(size < sizeof(struct tegrabl_profiler_record))) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 0);
+	}
+
+	s_records = (struct tegrabl_profiler_record *)(uintptr_t)(page_addr + offset);
+	s_max_records = size / (uint32_t)sizeof(struct tegrabl_profiler_record);
+	s_dropped_records = 0;
+
+	memset(s_records, 0, size);
+	__atomic_store_n(&s_next_record, 0, __ATOMIC_RELEASE);
+
+	return TEGRABL_NO_ERROR;
+}
+
+tegrabl_error_t tegrabl_profiler_relocate(uintptr_t new_profiler_page_addr)
+{
+	struct tegrabl_profiler_record *new_records;
+	uint64_t start = tegrabl_get_timestamp_us();
+	uint32_t size;
+
+	if (s_records == NULL) {
+		return TEGRABL_ERROR(TEGRABL_ERR_NOT_INITIALIZED, 0);
+	}
+
+	if (new_profiler_page_addr == 0UL) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 1);
+	}
+
+	size = s_max_records * (uint32_t)sizeof(struct tegrabl_profiler_record);
+	new_records = (struct tegrabl_profiler_record *)
+		(new_profiler_page_addr + CPUBL_PROFILER_OFFSET);
+	memmove(new_records, s_records, size);
+	s_records = new_records;
+
+	tegrabl_profiler_add_record("profiler relocate start", start);
+	tegrabl_profiler_add_record("profiler relocate end", 0);
+
+	return TEGRABL_NO_ERROR;
+}
+
+void tegrabl_profiler_add_record(const char *str, uint64_t tstamp)
+{
+	struct tegrabl_profiler_record *record;
+	uint32_t idx;
+
+	if ((s_records == NULL) || (str == NULL)) {
+		return;
+	}
+
+	if (tstamp == 0ULL) {
+		tstamp = tegrabl_get_timestamp_us();
+	}
+
+	idx = __atomic_fetch_add(&s_next_record, 1U, __ATOMIC_RELAXED);
+	if (idx >= s_max_records) {
+		__atomic_fetch_add(&s_dropped_records, 1U, __ATOMIC_RELAXED);
+		return;
+	}
+
+	record = &s_records[idx];
+	strncpy(record->str, str, MAX_PROFILE_STRLEN);
+	record->str[MAX_PROFILE_STRLEN] = '\0';
+	__atomic_store_n(&record->timestamp, tstamp, __ATOMIC_RELEASE);
+}
+
+static void profiler_add_span_record(char marker, const char *tag)
+{
+	char str[MAX_PROFILE_STRLEN + 1U];
+
+	if (tag == NULL) {
+		return;
+	}
+
+	str[0] = marker;
+	strncpy(&str[1], tag, MAX_PROFILE_STRLEN - 1U);
+	str[MAX_PROFILE_STRLEN] = '\0';
+
+	tegrabl_profiler_add_record(str, 0);
+}
+
+void tegrabl_profiler_begin(const char *tag)
+{
+	profiler_add_span_record(PROFILER_SPAN_BEGIN_MARKER, tag);
+}
+
+void tegrabl_profiler_end(const char *tag)
+{
+	profiler_add_span_record(PROFILER_SPAN_END_MARKER, tag);
+}
+
+uint64_t tegrabl_get_profile_record_timestamp(const char *str)
+{
+	uint32_t count = profiler_num_records();
+	uint32_t i;
+
+	if ((s_records == NULL) || (str == NULL)) {
+		return 0;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (strncmp(s_records[i].str, str, MAX_PROFILE_STRLEN) == 0) {
+			return __atomic_load_n(&s_records[i].timestamp, __ATOMIC_ACQUIRE);
+		}
+	}
+
+	return 0;
+}
+
+void tegrabl_profiler_dump(void)
+{
+	uint32_t count = profiler_num_records();
+	uint64_t tstamp;
+	uint64_t prev = 0;
+	uint64_t delta;
+	uint32_t i;
+
+	if (s_records == NULL) {
+		return;
+	}
+
+	pr_info("cpubl profiler: %u records, %u dropped\n", count,
+			s_dropped_records);
+
+	for (i = 0; i < count; i++) {
+		tstamp = __atomic_load_n(&s_records[i].timestamp, __ATOMIC_ACQUIRE);
+		if (tstamp == 0ULL) {
+			continue;
+		}
+		delta = (prev != 0ULL) ? (tstamp - prev) : 0ULL;
+		pr_info("%-55s %10"PRIu64" us (+%"PRIu64")\n", s_records[i].str, tstamp,
+				delta);
+		prev = tstamp;
+	}
+}
+
+tegrabl_error_t tegrabl_profiler_add_dt_node(void *fdt, int nodeoffset)
+{
+	uint32_t count = profiler_num_records();
+	uint64_t tstamp;
+	int node;
+	int err;
+	uint32_t i;
+
+	if (s_records == NULL) {
+		return TEGRABL_NO_ERROR;
+	}
+
+	node = tegrabl_add_subnode_if_absent(fdt, nodeoffset, PROFILER_DT_NODE);
+	if (node < 0) {
+		return TEGRABL_ERROR(TEGRABL_ERR_ADD_FAILED, 0);
+	}
+
+	/* Start from a clean node if the DTB is fixed up more than once */
+	(void)fdt_delprop(fdt, node, "timestamps-us");
+	(void)fdt_delprop(fdt, node, "events");
+
+	err = fdt_setprop_string(fdt, node, "compatible", "nvidia,cboot-profiler");
+	if (err < 0) {
+		goto fail;
+	}
+
+	err = fdt_setprop_cell(fdt, node, "dropped-records", s_dropped_records);
+	if (err < 0) {
+		goto fail;
+	}
+
+	/* Parallel arrays: one 64-bit timestamp and one string per record */
+	for (i = 0; i < count; i++) {
+		tstamp = __atomic_load_n(&s_records[i].timestamp, __ATOMIC_ACQUIRE);
+		if (tstamp == 0ULL) {
+			continue;
+		}
+		err = fdt_appendprop_u64(fdt, node, "timestamps-us", tstamp);
+		if (err < 0) {
+			goto fail;
+		}
+		err = fdt_appendprop_string(fdt, node, "events", s_records[i].str);
+		if (err < 0) {
+			goto fail;
+		}
+	}
+
+	pr_debug("Updated %s info to DTB\n", PROFILER_DT_NODE);
+
+	return TEGRABL_NO_ERROR;
+
+fail:
+	pr_error("%s: Unable to update /chosen/%s (%s)\n", __func__,
+			 PROFILER_DT_NODE, fdt_strerror(err));
+	return TEGRABL_ERROR(TEGRABL_ERR_ADD_FAILED, 1);
+}
+
+#endif /* CONFIG_BOOT_PROFILER */
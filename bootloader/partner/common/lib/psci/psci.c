@@ -8,6 +8,8 @@
  * license agreement from NVIDIA Corporation is strictly prohibited.
  */
 
+#include <stdint.h>
+#include <tegrabl_arm64_smccc.h>
 #include "psci_priv.h"
 
 /**
@@ -26,3 +28,39 @@ void tegrabl_psci_sys_off(void)
 	tegrabl_psci_smc(TEGRABL_PSCI_0_2_SYSTEM_OFF, 0, 0, 0);
 }
 
+
+/**
+* @brief power-on a secondary core
+*/
+int32_t tegrabl_psci_cpu_on(uint64_t mpidr, uint64_t entry, uint64_t context_id)
+{
+	struct tegrabl_arm64_smc64_params regs = { {
+		TEGRABL_PSCI_0_2_FN64_CPU_ON, mpidr, entry, context_id
+	} };
+
+	tegrabl_arm64_send_smc64(&regs);
+
+	return (int32_t)regs.reg[0];
+}
+
+/**
+* @brief power-off the calling core
+*/
+void tegrabl_psci_cpu_off(void)
+{
+	tegrabl_psci_smc(TEGRABL_PSCI_0_2_CPU_OFF, 0, 0, 0);
+}
+
+/**
+* @brief query the power state of a core
+*/
+int32_t tegrabl_psci_affinity_info(uint64_t mpidr)
+{
+	struct tegrabl_arm64_smc64_params regs = { {
+		TEGRABL_PSCI_0_2_FN64_AFFINITY_INFO, mpidr, 0
+	} };
+
+	tegrabl_arm64_send_smc64(&regs);
+
+	return (int32_t)regs.reg[0];
+}
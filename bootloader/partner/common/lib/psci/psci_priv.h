@@ -18,6 +18,12 @@
 /* Only the PSCI FN ids which are currently needed by BL are added */
  #define TEGRABL_PSCI_0_2_SYSTEM_OFF    (TEGRABL_PSCI_0_2_BASE + 0x8)
  #define TEGRABL_PSCI_0_2_SYSTEM_RESET  (TEGRABL_PSCI_0_2_BASE + 0x9)
+ #define TEGRABL_PSCI_0_2_CPU_OFF       (TEGRABL_PSCI_0_2_BASE + 0x2)
+
+/* SMC64 variants, needed where an argument is a 64-bit address or MPIDR */
+#define TEGRABL_PSCI_0_2_FN64_BASE		0xC4000000
+ #define TEGRABL_PSCI_0_2_FN64_CPU_ON         (TEGRABL_PSCI_0_2_FN64_BASE + 0x3)
+ #define TEGRABL_PSCI_0_2_FN64_AFFINITY_INFO  (TEGRABL_PSCI_0_2_FN64_BASE + 0x4)
 
 extern __attribute__((__noreturn__)) unsigned long (tegrabl_psci_smc)(
 										unsigned long, unsigned long,
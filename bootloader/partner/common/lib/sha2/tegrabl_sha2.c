@@ -0,0 +1,412 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ */
+
+#define MODULE TEGRABL_ERR_SE_CRYPTO
+
+#include "build_config.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <tegrabl_debug.h>
+#include <tegrabl_error.h>
+#include <tegrabl_utils.h>
+#include <tegrabl_sha2.h>
+#if defined(IS_T186)
+#include <tegrabl_se.h>
+#endif
+
+#define SHA2_256_BLOCK_SIZE 64U
+#define SHA2_512_BLOCK_SIZE 128U
+/* One engine pass must stay under 16MB, see tegrabl_se_sha_process_payload() */
+#define SHA2_MAX_PASS_SIZE (8U * 1024U * 1024U)
+
+static inline uint32_t sha2_block_size(struct tegrabl_sha2_context *context)
+{
+	return (context->algo == TEGRABL_SHA2_512) ? SHA2_512_BLOCK_SIZE : SHA2_256_BLOCK_SIZE;
+}
+
+#if defined(IS_T186)
+/*
+ * Assumes the engine keeps the intermediate state between passes, that all
+ * passes but the last may be any whole number of blocks and that size_left
+ * tells it where the message ends. The SE driver relies on this for its own
+ * payload split but does not document it as an API.
+ */
+static tegrabl_error_t sha2_engine_pass(struct tegrabl_sha2_context *context,
+										const uint8_t *data, uint32_t size)
+{
+	struct se_sha_input_params sha_input;
+	struct se_sha_context sha_context;
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+
+	sha_context.hash_algorithm = (context->algo == TEGRABL_SHA2_512) ?
+								 SE_SHAMODE_SHA512 : SE_SHAMODE_SHA256;
+	sha_context.input_size = (uint32_t)context->total_size;
+	sha_input.block_addr = (uintptr_t)data;
+	sha_input.block_size = size;
+	sha_input.size_left = (uint32_t)(context->total_size - context->hashed);
+	sha_input.hash_addr = (uintptr_t)context->digest;
+
+	err = tegrabl_se_sha_process_block(&sha_input, &sha_context);
+	if (err != TEGRABL_NO_ERROR) {
+		pr_error("%s: sha pass failed at %llu (err 0x%08x)\n", __func__,
+				 (unsigned long long)context->hashed, err);
+		return err;
+	}
+	context->hashed += size;
+
+	return TEGRABL_NO_ERROR;
+}
+
+static tegrabl_error_t sha2_engine_update(struct tegrabl_sha2_context *context,
+										  const uint8_t *data, size_t size)
+{
+	uint32_t block_size = sha2_block_size(context);
+	uint32_t len;
+	size_t whole;
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+
+	/* Top up the carried block, it is only hashed once more data follows */
+	if (context->pending != 0U) {
+		len = (uint32_t)MIN(block_size - context->pending, size);
+		memcpy(&context->block[context->pending], data, len);
+		context->pending += len;
+		data += len;
+		size -= len;
+		if (size == 0UL) {
+			return TEGRABL_NO_ERROR;
+		}
+		err = sha2_engine_pass(context, context->block, block_size);
+		if (err != TEGRABL_NO_ERROR) {
+			return err;
+		}
+		context->pending = 0;
+	}
+
+	/* Hold back the last block, the engine pads the message in the final pass */
+	whole = ((size - 1UL) / block_size) * block_size;
+	while (whole != 0UL) {
+		len = (uint32_t)MIN(whole, SHA2_MAX_PASS_SIZE);
+		err = sha2_engine_pass(context, data, len);
+		if (err != TEGRABL_NO_ERROR) {
+			return err;
+		}
+		data += len;
+		size -= len;
+		whole -= len;
+	}
+
+	memcpy(context->block, data, size);
+	context->pending = (uint32_t)size;
+
+	return TEGRABL_NO_ERROR;
+}
+
+static tegrabl_error_t sha2_engine_final(struct tegrabl_sha2_context *context)
+{
+	return sha2_engine_pass(context, context->block, context->pending);
+}
+#else
+/*
+ * The T194 crypto library has no multi-part SHA, so the message is hashed in
+ * software as it is passed in. This is plain C over memory only, so updates
+ * may run on a work-queue core.
+ */
+#define ROTR32(x, n) (((x) >> (n)) | ((x) << (32U - (n))))
+#define ROTR64(x, n) (((x) >> (n)) | ((x) << (64U - (n))))
+
+static const uint32_t sha256_k[64] = {
+	0x428a2f98U, 0x71374491U, 0xb5c0fbcfU, 0xe9b5dba5U, 0x3956c25bU, 0x59f111f1U,
+	0x923f82a4U, 0xab1c5ed5U, 0xd807aa98U, 0x12835b01U, 0x243185beU, 0x550c7dc3U,
+	0x72be5d74U, 0x80deb1feU, 0x9bdc06a7U, 0xc19bf174U, 0xe49b69c1U, 0xefbe4786U,
+	0x0fc19dc6U, 0x240ca1ccU, 0x2de92c6fU, 0x4a7484aaU, 0x5cb0a9dcU, 0x76f988daU,
+	0x983e5152U, 0xa831c66dU, 0xb00327c8U, 0xbf597fc7U, 0xc6e00bf3U, 0xd5a79147U,
+	0x06ca6351U, 0x14292967U, 0x27b70a85U, 0x2e1b2138U, 0x4d2c6dfcU, 0x53380d13U,
+	0x650a7354U, 0x766a0abbU, 0x81c2c92eU, 0x92722c85U, 0xa2bfe8a1U, 0xa81a664bU,
+	0xc24b8b70U, 0xc76c51a3U, 0xd192e819U, 0xd6990624U, 0xf40e3585U, 0x106aa070U,
+	0x19a4c116U, 0x1e376c08U, 0x2748774cU, 0x34b0bcb5U, 0x391c0cb3U, 0x4ed8aa4aU,
+	0x5b9cca4fU, 0x682e6ff3U, 0x748f82eeU, 0x78a5636fU, 0x84c87814U, 0x8cc70208U,
+	0x90befffaU, 0xa4506cebU, 0xbef9a3f7U, 0xc67178f2U,
+};
+
+static const uint64_t sha512_k[80] = {
+	0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL,
+	0xe9b5dba58189dbbcULL, 0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL,
+	0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL, 0xd807aa98a3030242ULL,
+	0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+	0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL,
+	0xc19bf174cf692694ULL, 0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL,
+	0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL, 0x2de92c6f592b0275ULL,
+	0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+	0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL,
+	0xbf597fc7beef0ee4ULL, 0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL,
+	0x06ca6351e003826fULL, 0x142929670a0e6e70ULL, 0x27b70a8546d22ffcULL,
+	0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+	0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL,
+	0x92722c851482353bULL, 0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL,
+	0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL, 0xd192e819d6ef5218ULL,
+	0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+	0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL,
+	0x34b0bcb5e19b48a8ULL, 0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL,
+	0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL, 0x748f82ee5defb2fcULL,
+	0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+	0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL,
+	0xc67178f2e372532bULL, 0xca273eceea26619cULL, 0xd186b8c721c0c207ULL,
+	0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL, 0x06f067aa72176fbaULL,
+	0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+	0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL,
+	0x431d67c49c100d4cULL, 0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL,
+	0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL,
+};
+
+static const uint32_t sha256_iv[8] = {
+	0x6a09e667U, 0xbb67ae85U, 0x3c6ef372U, 0xa54ff53aU,
+	0x510e527fU, 0x9b05688cU, 0x1f83d9abU, 0x5be0cd19U,
+};
+
+static const uint64_t sha512_iv[8] = {
+	0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL,
+	0xa54ff53a5f1d36f1ULL, 0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL,
+	0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL,
+};
+
+static void sha256_block(uint32_t *h, const uint8_t *data)
+{
+	uint32_t w[64];
+	uint32_t v[8];
+	uint32_t s0, s1, t1, t2;
+	uint32_t i;
+
+	for (i = 0; i < 16U; i++) {
+		w[i] = ((uint32_t)data[4U * i] << 24) | ((uint32_t)data[4U * i + 1U] << 16) |
+			   ((uint32_t)data[4U * i + 2U] << 8) | (uint32_t)data[4U * i + 3U];
+	}
+	for (i = 16; i < 64U; i++) {
+		s0 = ROTR32(w[i - 15U], 7U) ^ ROTR32(w[i - 15U], 18U) ^ (w[i - 15U] >> 3);
+		s1 = ROTR32(w[i - 2U], 17U) ^ ROTR32(w[i - 2U], 19U) ^ (w[i - 2U] >> 10);
+		w[i] = w[i - 16U] + s0 + w[i - 7U] + s1;
+	}
+
+	memcpy(v, h, sizeof(v));
+	for (i = 0; i < 64U; i++) {
+		s1 = ROTR32(v[4], 6U) ^ ROTR32(v[4], 11U) ^ ROTR32(v[4], 25U);
+		t1 = v[7] + s1 + ((v[4] & v[5]) ^ (~v[4] & v[6])) + sha256_k[i] + w[i];
+		s0 = ROTR32(v[0], 2U) ^ ROTR32(v[0], 13U) ^ ROTR32(v[0], 22U);
+		t2 = s0 + ((v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]));
+		memmove(&v[1], &v[0], 7U * sizeof(v[0]));
+		v[4] += t1;
+		v[0] = t1 + t2;
+	}
+
+	for (i = 0; i < 8U; i++) {
+		h[i] += v[i];
+	}
+}
+
+static void sha512_block(uint64_t *h, const uint8_t *data)
+{
+	uint64_t w[80];
+	uint64_t v[8];
+	uint64_t s0, s1, t1, t2;
+	uint32_t i, j;
+
+	for (i = 0; i < 16U; i++) {
+		w[i] = 0;
+		for (j = 0; j < 8U; j++) {
+			w[i] = (w[i] << 8) | data[8U * i + j];
+		}
+	}
+	for (i = 16; i < 80U; i++) {
+		s0 = ROTR64(w[i - 15U], 1U) ^ ROTR64(w[i - 15U], 8U) ^ (w[i - 15U] >> 7);
+		s1 = ROTR64(w[i - 2U], 19U) ^ ROTR64(w[i - 2U], 61U) ^ (w[i - 2U] >> 6);
+		w[i] = w[i - 16U] + s0 + w[i - 7U] + s1;
+	}
+
+	memcpy(v, h, sizeof(v));
+	for (i = 0; i < 80U; i++) {
+		s1 = ROTR64(v[4], 14U) ^ ROTR64(v[4], 18U) ^ ROTR64(v[4], 41U);
+		t1 = v[7] + s1 + ((v[4] & v[5]) ^ (~v[4] & v[6])) + sha512_k[i] + w[i];
+		s0 = ROTR64(v[0], 28U) ^ ROTR64(v[0], 34U) ^ ROTR64(v[0], 39U);
+		t2 = s0 + ((v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]));
+		memmove(&v[1], &v[0], 7U * sizeof(v[0]));
+		v[4] += t1;
+		v[0] = t1 + t2;
+	}
+
+	for (i = 0; i < 8U; i++) {
+		h[i] += v[i];
+	}
+}
+
+static void sha2_engine_block(struct tegrabl_sha2_context *context,
+							  const uint8_t *data)
+{
+	if (context->algo == TEGRABL_SHA2_512) {
+		sha512_block(context->state.h512, data);
+	} else {
+		sha256_block(context->state.h256, data);
+	}
+}
+
+static void sha2_engine_init(struct tegrabl_sha2_context *context)
+{
+	if (context->algo == TEGRABL_SHA2_512) {
+		memcpy(context->state.h512, sha512_iv, sizeof(sha512_iv));
+	} else {
+		memcpy(context->state.h256, sha256_iv, sizeof(sha256_iv));
+	}
+}
+
+static tegrabl_error_t sha2_engine_update(struct tegrabl_sha2_context *context,
+										  const uint8_t *data, size_t size)
+{
+	uint32_t block_size = sha2_block_size(context);
+	uint32_t len;
+
+	if (context->pending != 0U) {
+		len = (uint32_t)MIN(block_size - context->pending, size);
+		memcpy(&context->block[context->pending], data, len);
+		context->pending += len;
+		data += len;
+		size -= len;
+		if (context->pending < block_size) {
+			return TEGRABL_NO_ERROR;
+		}
+		sha2_engine_block(context, context->block);
+		context->hashed += block_size;
+		context->pending = 0;
+	}
+
+	while (size >= block_size) {
+		sha2_engine_block(context, data);
+		context->hashed += block_size;
+		data += block_size;
+		size -= block_size;
+	}
+
+	memcpy(context->block, data, size);
+	context->pending = (uint32_t)size;
+
+	return TEGRABL_NO_ERROR;
+}
+
+static tegrabl_error_t sha2_engine_final(struct tegrabl_sha2_context *context)
+{
+	uint32_t block_size = sha2_block_size(context);
+	/* Message length in bits, in the last 8 bytes of the 8 or 16 byte field */
+	uint64_t bits = context->total_size * 8ULL;
+	uint32_t i;
+
+	context->block[context->pending++] = 0x80U;
+	if (context->pending > (block_size - (block_size / 8U))) {
+		memset(&context->block[context->pending], 0, block_size - context->pending);
+		sha2_engine_block(context, context->block);
+		context->pending = 0;
+	}
+	memset(&context->block[context->pending], 0, block_size - context->pending);
+	for (i = 0; i < 8U; i++) {
+		context->block[block_size - 1U - i] = (uint8_t)(bits >> (8U * i));
+	}
+	sha2_engine_block(context, context->block);
+
+	for (i = 0; i < tegrabl_sha2_digest_size(context->algo); i++) {
+		if (context->algo == TEGRABL_SHA2_512) {
+			context->digest[i] = (uint8_t)(context->state.h512[i / 8U] >> (56U - (8U * (i % 8U))));
+		} else {
+			context->digest[i] = (uint8_t)(context->state.h256[i / 4U] >> (24U - (8U * (i % 4U))));
+		}
+	}
+
+	return TEGRABL_NO_ERROR;
+}
+#endif
+
+tegrabl_error_t tegrabl_sha2_init(struct tegrabl_sha2_context *context,
+								  tegrabl_sha2_algo_t algo, uint64_t total_size)
+{
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+
+	if ((context == NULL) || (total_size == 0ULL) || (total_size > UINT32_MAX)) {
+		err = TEGRABL_ERROR(TEGRABL_ERR_BAD_PARAMETER, 0);
+		TEGRABL_SET_ERROR_STRING(err, "context: %p, size: %llu", context,
+								 (unsigned long long)total_size);
+		return err;
+	}
+
+	if ((algo != TEGRABL_SHA2_256) && (algo != TEGRABL_SHA2_512)) {
+		err = TEGRABL_ERROR(TEGRABL_ERR_NOT_SUPPORTED, 0);
+		TEGRABL_SET_ERROR_STRING(err, "algo %u", algo);
+		return err;
+	}
+
+	memset(context, 0, sizeof(*context));
+	context->algo = algo;
+	context->total_size = total_size;
+#if !defined(IS_T186)
+	sha2_engine_init(context);
+#endif
+
+	return TEGRABL_NO_ERROR;
+}
+
+tegrabl_error_t tegrabl_sha2_update(struct tegrabl_sha2_context *context,
+									const void *data, size_t size)
+{
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+
+	if ((context == NULL) || ((data == NULL) && (size != 0UL))) {
+		err = TEGRABL_ERROR(TEGRABL_ERR_BAD_PARAMETER, 1);
+		TEGRABL_SET_ERROR_STRING(err, "context: %p, data: %p", context, data);
+		return err;
+	}
+
+	if (size > (context->total_size - context->hashed - context->pending)) {
+		err = TEGRABL_ERROR(TEGRABL_ERR_OVERFLOW, 0);
+		TEGRABL_SET_ERROR_STRING(err, "%llu bytes past the message",
+								 (unsigned long long)(context->hashed + context->pending + size -
+													  context->total_size));
+		return err;
+	}
+
+	if (size == 0UL) {
+		return TEGRABL_NO_ERROR;
+	}
+
+	return sha2_engine_update(context, (const uint8_t *)data, size);
+}
+
+tegrabl_error_t tegrabl_sha2_final(struct tegrabl_sha2_context *context,
+								   uint8_t *digest)
+{
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+
+	if ((context == NULL) || (digest == NULL)) {
+		err = TEGRABL_ERROR(TEGRABL_ERR_BAD_PARAMETER, 2);
+		TEGRABL_SET_ERROR_STRING(err, "context: %p, digest: %p", context, digest);
+		return err;
+	}
+
+	if ((context->hashed + context->pending) != context->total_size) {
+		err = TEGRABL_ERROR(TEGRABL_ERR_INVALID_STATE, 0);
+		TEGRABL_SET_ERROR_STRING(err, "%llu of %llu bytes hashed",
+								 (unsigned long long)(context->hashed + context->pending),
+								 (unsigned long long)context->total_size);
+		return err;
+	}
+
+	err = sha2_engine_final(context);
+	if (err != TEGRABL_NO_ERROR) {
+		return err;
+	}
+
+	memcpy(digest, context->digest, tegrabl_sha2_digest_size(context->algo));
+
+	return TEGRABL_NO_ERROR;
+}
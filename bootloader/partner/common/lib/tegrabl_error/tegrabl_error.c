@@ -230,6 +230,9 @@ const char *module_strings[TEGRABL_ERR_MODULE_END] = {
 	ADD_ERROR_MODULE(CONFIG_STORAGE),
 	ADD_ERROR_MODULE(USBMSD),
 	ADD_ERROR_MODULE(CBO),
+	ADD_ERROR_MODULE(PROFILER),
+	ADD_ERROR_MODULE(WORKQUEUE),
+	ADD_ERROR_MODULE(BACKGROUND),
 };
 
 /**
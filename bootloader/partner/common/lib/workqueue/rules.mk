@@ -0,0 +1,26 @@
+#
+# Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+#
+# NVIDIA CORPORATION and its licensors retain all intellectual property
+# and proprietary rights in and to this software and related documentation
+# and any modifications thereto.  Any use, reproduction, disclosure or
+# distribution of this software and related documentation without an express
+# license agreement from NVIDIA CORPORATION is strictly prohibited.
+#
+
+LOCAL_DIR := $(GET_LOCAL_DIR)
+
+MODULE := $(LOCAL_DIR)
+
+GLOBAL_INCLUDES += \
+	$(LOCAL_DIR)/../../include \
+	$(LOCAL_DIR)/../../include/lib
+
+MODULE_SRCS += \
+	$(LOCAL_DIR)/tegrabl_workqueue.c \
+	$(LOCAL_DIR)/tegrabl_workqueue_cpu.c \
+	$(LOCAL_DIR)/secondary_entry.S
+
+MODULE_ASMFLAGS += -D_ASSEMBLY_=1
+
+include make/module.mk
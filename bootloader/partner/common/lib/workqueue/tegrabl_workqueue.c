@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ */
+
+/*
+ * Scheduler independent core of the work-queue. It only relies on compiler
+ * atomics and on the WFE/SEV hints, so it does not care whether its callers
+ * are secondary cores brought up through PSCI or the boot core.
+ */
+
+#define MODULE TEGRABL_ERR_WORKQUEUE
+
+#include "build_config.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <tegrabl_error.h>
+#include <tegrabl_workqueue.h>
+
+#if defined(__aarch64__)
+#define workqueue_wait_event()	__asm__ volatile("wfe" ::: "memory")
+#define workqueue_send_event()	__asm__ volatile("dsb ish; sev" ::: "memory")
+#else
+#define workqueue_wait_event()	__asm__ volatile("" ::: "memory")
+#define workqueue_send_event()	__asm__ volatile("" ::: "memory")
+#endif
+
+static uint32_t s_lock;
+static struct tegrabl_work *s_head;
+static struct tegrabl_work *s_tail;
+static uint32_t s_stop;
+
+static inline void workqueue_lock(void)
+{
+	while (__atomic_exchange_n(&s_lock, 1U, __ATOMIC_ACQUIRE) != 0U) {
+		while (__atomic_load_n(&s_lock, __ATOMIC_RELAXED) != 0U) {
+			/* Spin on a plain load so that the line stays shared */
+		}
+	}
+}
+
+static inline void workqueue_unlock(void)
+{
+	__atomic_store_n(&s_lock, 0U, __ATOMIC_RELEASE);
+}
+
+tegrabl_error_t tegrabl_workqueue_submit(struct tegrabl_work *work)
+{
+	if ((work == NULL) || (work->func == NULL)) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 0);
+	}
+
+	if ((work->state == TEGRABL_WORK_QUEUED) ||
+		(work->state == TEGRABL_WORK_RUNNING)) {
+		return TEGRABL_ERROR(TEGRABL_ERR_BUSY, 0);
+	}
+
+	work->status = TEGRABL_NO_ERROR;
+	work->next = NULL;
+	work->state = TEGRABL_WORK_QUEUED;
+
+	workqueue_lock();
+	if (s_tail != NULL) {
+		s_tail->next = work;
+	} else {
+		s_head = work;
+	}
+	s_tail = work;
+	workqueue_unlock();
+
+	workqueue_send_event();
+
+	return TEGRABL_NO_ERROR;
+}
+
+static struct tegrabl_work *workqueue_pop(void)
+{
+	struct tegrabl_work *work;
+
+	/* Cheap unlocked peek so that idle workers do not bounce the lock */
+	if (__atomic_load_n(&s_head, __ATOMIC_RELAXED) == NULL) {
+		return NULL;
+	}
+
+	workqueue_lock();
+	work = s_head;
+	if (work != NULL) {
+		s_head = work->next;
+		if (s_head == NULL) {
+			s_tail = NULL;
+		}
+		work->state = TEGRABL_WORK_RUNNING;
+	}
+	workqueue_unlock();
+
+	return work;
+}
+
+bool tegrabl_workqueue_run_one(void)
+{
+	struct tegrabl_work *work;
+
+	work = workqueue_pop();
+	if (work == NULL) {
+		return false;
+	}
+
+	work->status = work->func(work->arg);
+
+	/* Publishes status and everything the job wrote */
+	__atomic_store_n(&work->state, TEGRABL_WORK_DONE, __ATOMIC_RELEASE);
+	workqueue_send_event();
+
+	return true;
+}
+
+tegrabl_error_t tegrabl_workqueue_wait(struct tegrabl_work *work)
+{
+	if ((work == NULL) || (work->state == TEGRABL_WORK_IDLE)) {
+		return TEGRABL_ERROR(TEGRABL_ERR_INVALID, 1);
+	}
+
+	while (__atomic_load_n(&work->state, __ATOMIC_ACQUIRE) != TEGRABL_WORK_DONE) {
+		/* Help out rather than idle; this also covers the no-worker case */
+		if (!tegrabl_workqueue_run_one()) {
+			workqueue_wait_event();
+		}
+	}
+
+	return work->status;
+}
+
+void tegrabl_workqueue_worker_loop(void)
+{
+	while (true) {
+		if (tegrabl_workqueue_run_one()) {
+			continue;
+		}
+		if (__atomic_load_n(&s_stop, __ATOMIC_ACQUIRE) != 0U) {
+			break;
+		}
+		/*
+		 * An event sent between the checks above and WFE is latched in the
+		 * event register, so a submit cannot be missed here.
+		 */
+		workqueue_wait_event();
+	}
+}
+
+void tegrabl_workqueue_stop(void)
+{
+	__atomic_store_n(&s_stop, 1U, __ATOMIC_RELEASE);
+	workqueue_send_event();
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ */
+
+#define MODULE TEGRABL_ERR_WORKQUEUE
+
+#include "build_config.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <arch/arm64.h>
+#include <arch/ops.h>
+#include <tegrabl_debug.h>
+#include <tegrabl_timer.h>
+#include <tegrabl_psci.h>
+#include <tegrabl_workqueue.h>
+#include "workqueue_priv.h"
+
+#if defined(CONFIG_ENABLE_WORKQUEUE_SMP)
+
+#define WORKQUEUE_CPU_ON_TIMEOUT_US		10000U
+#define WORKQUEUE_CPU_OFF_TIMEOUT_US	10000U
+
+static struct workqueue_cpu_context s_cpu_ctx[TEGRABL_WORKQUEUE_MAX_CPUS];
+static uint8_t s_cpu_stacks[TEGRABL_WORKQUEUE_MAX_CPUS][TEGRABL_WORKQUEUE_STACK_SIZE]
+	__attribute__((aligned(16)));
+static uint32_t s_num_cpus;
+
+void tegrabl_workqueue_secondary_main(struct workqueue_cpu_context *ctx)
+{
+	__atomic_store_n(&ctx->state, WQ_CPU_ONLINE, __ATOMIC_RELEASE);
+	__asm__ volatile("dsb ish; sev" ::: "memory");
+
+	tegrabl_workqueue_worker_loop();
+
+	__atomic_store_n(&ctx->state, WQ_CPU_STOPPED, __ATOMIC_RELEASE);
+	__asm__ volatile("dsb ish; sev" ::: "memory");
+
+	/* Firmware takes care of cache maintenance on the way down */
+	tegrabl_psci_cpu_off();
+}
+
+static void workqueue_save_context(struct workqueue_cpu_context *ctx,
+								   uint32_t idx)
+{
+	ctx->mair = ARM64_READ_TARGET_SYSREG(MAIR_ELx);
+	ctx->tcr = ARM64_READ_TARGET_SYSREG(TCR_ELx);
+	ctx->ttbr0 = ARM64_READ_TARGET_SYSREG(TTBR0_ELx);
+	ctx->sctlr = ARM64_READ_TARGET_SYSREG(SCTLR_ELx);
+	ctx->vbar = ARM64_READ_TARGET_SYSREG(VBAR_ELx);
+#if ARM64_WITH_EL2
+	ctx->hcr = ARM64_READ_SYSREG(hcr_el2);
+	ctx->cptr = ARM64_READ_SYSREG(cptr_el2);
+#else
+	ctx->hcr = 0;
+	ctx->cptr = ARM64_READ_SYSREG(cpacr_el1);
+#endif
+	ctx->sp = (uint64_t)(uintptr_t)&s_cpu_stacks[idx][TEGRABL_WORKQUEUE_STACK_SIZE];
+}
+
+uint32_t tegrabl_workqueue_start_cpus(const uint64_t *mpidrs, uint32_t count)
+{
+	struct workqueue_cpu_context *ctx;
+	time_t start;
+	int32_t ret;
+	uint32_t i;
+
+	if ((mpidrs == NULL) || (s_num_cpus != 0U)) {
+		return s_num_cpus;
+	}
+
+	if (count > TEGRABL_WORKQUEUE_MAX_CPUS) {
+		count = TEGRABL_WORKQUEUE_MAX_CPUS;
+	}
+
+	/* The trampoline runs uncached until it has turned on the MMU */
+	arch_clean_cache_range((addr_t)tegrabl_workqueue_secondary_entry, 256);
+
+	for (i = 0; i < count; i++) {
+		ctx = &s_cpu_ctx[s_num_cpus];
+		workqueue_save_context(ctx, s_num_cpus);
+		ctx->mpidr = mpidrs[i];
+		ctx->state = WQ_CPU_OFFLINE;
+		arch_clean_cache_range((addr_t)ctx, sizeof(*ctx));
+
+		ret = tegrabl_psci_cpu_on(mpidrs[i],
+								  (uint64_t)(uintptr_t)tegrabl_workqueue_secondary_entry,
+								  (uint64_t)(uintptr_t)ctx);
+		if (ret != TEGRABL_PSCI_RET_SUCCESS) {
+			pr_warn("workqueue: cpu 0x%"PRIx64" power-on failed (%d)\n",
+					mpidrs[i], ret);
+			continue;
+		}
+
+		start = tegrabl_get_timestamp_us();
+		while (__atomic_load_n(&ctx->state, __ATOMIC_ACQUIRE) != WQ_CPU_ONLINE) {
+			if ((tegrabl_get_timestamp_us() - start) > WORKQUEUE_CPU_ON_TIMEOUT_US) {
+				break;
+			}
+		}
+
+		if (ctx->state != WQ_CPU_ONLINE) {
+			/* Core may still come up later; keep its context reserved */
+			pr_warn("workqueue: cpu 0x%"PRIx64" did not come online\n",
+					mpidrs[i]);
+		}
+		s_num_cpus++;
+	}
+
+	pr_info("workqueue: %u secondary cores started\n", s_num_cpus);
+
+	return s_num_cpus;
+}
+
+void tegrabl_workqueue_stop_cpus(void)
+{
+	struct workqueue_cpu_context *ctx;
+	time_t start;
+	uint32_t i;
+
+	tegrabl_workqueue_stop();
+
+	for (i = 0; i < s_num_cpus; i++) {
+		ctx = &s_cpu_ctx[i];
+		start = tegrabl_get_timestamp_us();
+		while (tegrabl_psci_affinity_info(ctx->mpidr) != TEGRABL_PSCI_AFFINITY_OFF) {
+			if ((tegrabl_get_timestamp_us() - start) > WORKQUEUE_CPU_OFF_TIMEOUT_US) {
+				pr_error("workqueue: cpu 0x%"PRIx64" did not power off\n",
+						 ctx->mpidr);
+				break;
+			}
+		}
+	}
+
+	s_num_cpus = 0;
+}
+
+#endif /* CONFIG_ENABLE_WORKQUEUE_SMP */
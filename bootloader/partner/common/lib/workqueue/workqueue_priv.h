@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ */
+
+#ifndef INCLUDED_WORKQUEUE_PRIV_H
+#define INCLUDED_WORKQUEUE_PRIV_H
+
+/* Offsets into struct workqueue_cpu_context, shared with secondary_entry.S */
+#define WQ_CTX_MAIR		0x00
+#define WQ_CTX_TCR		0x08
+#define WQ_CTX_TTBR0	0x10
+#define WQ_CTX_SCTLR	0x18
+#define WQ_CTX_VBAR		0x20
+#define WQ_CTX_HCR		0x28
+#define WQ_CTX_CPTR		0x30
+#define WQ_CTX_SP		0x38
+
+#define WQ_CPU_OFFLINE	0U
+#define WQ_CPU_ONLINE	1U
+#define WQ_CPU_STOPPED	2U
+
+#if !defined(_ASSEMBLY_)
+
+#include <stdint.h>
+
+/**
+ * @brief State handed to a secondary core through PSCI CPU_ON. The boot
+ * core's translation regime is replayed as is, so that all cores share one
+ * set of page tables and the same memory attributes.
+ */
+struct workqueue_cpu_context {
+	uint64_t mair;
+	uint64_t tcr;
+	uint64_t ttbr0;
+	uint64_t sctlr;
+	uint64_t vbar;
+	uint64_t hcr;
+	uint64_t cptr;
+	uint64_t sp;
+	uint64_t mpidr;
+	volatile uint32_t state;
+} __attribute__((aligned(64)));
+
+/**
+ * @brief PSCI entry point of the secondary cores, x0 holds the context
+ */
+void tegrabl_workqueue_secondary_entry(void);
+
+/**
+ * @brief C entry of a secondary core, called with MMU and caches enabled
+ */
+void tegrabl_workqueue_secondary_main(struct workqueue_cpu_context *ctx);
+
+#endif /* _ASSEMBLY_ */
+
+#endif /* INCLUDED_WORKQUEUE_PRIV_H */
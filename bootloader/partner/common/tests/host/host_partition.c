@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ */
+
+#define MODULE TEGRABL_ERR_PARTITION_MANAGER
+
+#include "build_config.h"
+#include <stdlib.h>
+#include <string.h>
+#include <tegrabl_error.h>
+#include <tegrabl_partition_manager.h>
+#include "host_partition.h"
+
+#define HOST_MAX_PARTITIONS 4U
+
+struct host_partition {
+	struct tegrabl_partition_info info;
+	uint8_t *data;
+};
+
+static struct host_partition partitions[HOST_MAX_PARTITIONS];
+static uint32_t writes;
+
+uint8_t *host_partition_add(const char *name, size_t size)
+{
+	uint32_t i;
+
+	for (i = 0; i < HOST_MAX_PARTITIONS; i++) {
+		if ((partitions[i].data == NULL) || (strcmp(partitions[i].info.name, name) == 0)) {
+			break;
+		}
+	}
+	if (i == HOST_MAX_PARTITIONS) {
+		abort();
+	}
+
+	free(partitions[i].data);
+	memset(&partitions[i].info, 0, sizeof(partitions[i].info));
+	strncpy(partitions[i].info.name, name, MAX_PARTITION_NAME - 1);
+	partitions[i].info.total_size = size;
+	partitions[i].data = malloc(size);
+	if (partitions[i].data == NULL) {
+		abort();
+	}
+	memset(partitions[i].data, 0xFF, size);
+
+	return partitions[i].data;
+}
+
+void host_partition_reset(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < HOST_MAX_PARTITIONS; i++) {
+		free(partitions[i].data);
+		partitions[i].data = NULL;
+	}
+	writes = 0;
+}
+
+uint32_t host_partition_writes(void)
+{
+	return writes;
+}
+
+static struct host_partition *host_partition_get(struct tegrabl_partition *partition)
+{
+	return (struct host_partition *)partition->partition_info;
+}
+
+tegrabl_error_t tegrabl_partition_open(const char *partition_name, struct tegrabl_partition *partition)
+{
+	uint32_t i;
+
+	for (i = 0; i < HOST_MAX_PARTITIONS; i++) {
+		if ((partitions[i].data != NULL) && (strcmp(partitions[i].info.name, partition_name) == 0)) {
+			partition->partition_info = &partitions[i].info;
+			partition->block_device = NULL;
+			partition->offset = 0;
+			return TEGRABL_NO_ERROR;
+		}
+	}
+
+	return TEGRABL_ERROR(TEGRABL_ERR_NOT_FOUND, 0);
+}
+
+void tegrabl_partition_close(struct tegrabl_partition *partition)
+{
+	partition->partition_info = NULL;
+}
+
+uint64_t tegrabl_partition_size(struct tegrabl_partition *partition)
+{
+	return partition->partition_info->total_size;
+}
+
+tegrabl_error_t tegrabl_partition_read(struct tegrabl_partition *partition, void *buf, size_t num_bytes)
+{
+	if ((partition->offset + num_bytes) > partition->partition_info->total_size) {
+		return TEGRABL_ERROR(TEGRABL_ERR_OVERFLOW, 0);
+	}
+
+	memcpy(buf, host_partition_get(partition)->data + partition->offset, num_bytes);
+	partition->offset += num_bytes;
+
+	return TEGRABL_NO_ERROR;
+}
+
+tegrabl_error_t tegrabl_partition_write(struct tegrabl_partition *partition, const void *buf, size_t num_bytes)
+{
+	if ((partition->offset + num_bytes) > partition->partition_info->total_size) {
+		return TEGRABL_ERROR(TEGRABL_ERR_OVERFLOW, 1);
+	}
+
+	memcpy(host_partition_get(partition)->data + partition->offset, buf, num_bytes);
+	partition->offset += num_bytes;
+	writes++;
+
+	return TEGRABL_NO_ERROR;
+}
+
+tegrabl_error_t tegrabl_partition_seek(struct tegrabl_partition *partition, int64_t offset,
+									   tegrabl_partition_seek_t origin)
+{
+	int64_t base = 0;
+
+	if (origin == TEGRABL_PARTITION_SEEK_CUR) {
+		base = (int64_t)partition->offset;
+	} else if (origin == TEGRABL_PARTITION_SEEK_END) {
+		base = (int64_t)partition->partition_info->total_size;
+	}
+
+	if (((base + offset) < 0) || ((uint64_t)(base + offset) > partition->partition_info->total_size)) {
+		return TEGRABL_ERROR(TEGRABL_ERR_OVERFLOW, 2);
+	}
+	partition->offset = (uint64_t)(base + offset);
+
+	return TEGRABL_NO_ERROR;
+}
+
+tegrabl_error_t tegrabl_partition_erase(struct tegrabl_partition *partition, bool secure)
+{
+	(void)secure;
+
+	memset(host_partition_get(partition)->data, 0xFF, partition->partition_info->total_size);
+
+	return TEGRABL_NO_ERROR;
+}
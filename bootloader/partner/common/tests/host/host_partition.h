@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ */
+
+#ifndef INCLUDED_HOST_PARTITION_H
+#define INCLUDED_HOST_PARTITION_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * RAM backed stand-in for the partition manager. Partitions are created
+ * filled with 0xFF like erased flash.
+ */
+
+/**
+ * @brief Add a partition, replacing one of the same name
+ *
+ * @param name partition name
+ * @param size size in bytes
+ *
+ * @return contents of the partition
+ */
+uint8_t *host_partition_add(const char *name, size_t size);
+
+/**
+ * @brief Drop all partitions and reset the counters
+ */
+void host_partition_reset(void);
+
+/**
+ * @brief Number of tegrabl_partition_write() calls since the last reset
+ */
+uint32_t host_partition_writes(void);
+
+#endif /* INCLUDED_HOST_PARTITION_H */
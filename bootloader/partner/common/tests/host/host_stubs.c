@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ */
+
+/*
+ * Console and heap of the bootloader, backed by stdio and libc. Console
+ * output is only shown with HOST_TEST_VERBOSE set in the environment.
+ */
+
+/* posix_memalign(); the tests themselves are built as plain C99 */
+#define _POSIX_C_SOURCE 200112L
+
+#include "build_config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <tegrabl_debug.h>
+#include <tegrabl_malloc.h>
+#include "host_test.h"
+
+uint32_t host_test_failures;
+
+int tegrabl_printf(const char *format, ...)
+{
+	va_list ap;
+	int ret = 0;
+
+	if (getenv("HOST_TEST_VERBOSE") != NULL) {
+		va_start(ap, format);
+		ret = vprintf(format, ap);
+		va_end(ap);
+	}
+
+	return ret;
+}
+
+void *tegrabl_malloc(size_t size)
+{
+	return malloc(size);
+}
+
+void *tegrabl_memalign(size_t alignment, size_t size)
+{
+	void *ptr = NULL;
+
+	if (posix_memalign(&ptr, (alignment < sizeof(void *)) ? sizeof(void *) : alignment, size) != 0) {
+		return NULL;
+	}
+
+	return ptr;
+}
+
+void *tegrabl_calloc(size_t nmemb, size_t size)
+{
+	return calloc(nmemb, size);
+}
+
+void tegrabl_free(const void *ptr)
+{
+	free((void *)ptr);
+}
+
+void *tegrabl_alloc(tegrabl_heap_type_t heap_type, size_t size)
+{
+	(void)heap_type;
+
+	return malloc(size);
+}
+
+void tegrabl_dealloc(tegrabl_heap_type_t heap_type, const void *ptr)
+{
+	(void)heap_type;
+
+	free((void *)ptr);
+}
+
+void *tegrabl_alloc_align(tegrabl_heap_type_t heap_type, size_t alignment, size_t size)
+{
+	(void)heap_type;
+
+	return tegrabl_memalign(alignment, size);
+}
+
+void host_test_run(const char *name, void (*fn)(void))
+{
+	uint32_t failures = host_test_failures;
+
+	fn();
+	printf("%s: %s\n", (host_test_failures == failures) ? "PASS" : "FAIL", name);
+}
+
+int host_test_done(void)
+{
+	if (host_test_failures != 0U) {
+		printf("%u check(s) failed\n", host_test_failures);
+		return 1;
+	}
+
+	return 0;
+}
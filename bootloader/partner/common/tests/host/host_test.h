@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ */
+
+#ifndef INCLUDED_HOST_TEST_H
+#define INCLUDED_HOST_TEST_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+extern uint32_t host_test_failures;
+
+/* Records a failure and carries on, so one run reports every broken case */
+#define CHECK(cond)														\
+	do {																\
+		if (!(cond)) {													\
+			(void)fprintf(stderr, "%s:%d: CHECK(%s) failed\n",			\
+						  __FILE__, __LINE__, #cond);					\
+			host_test_failures++;										\
+		}																\
+	} while (false)
+
+#define CHECK_EQ(a, b)		CHECK((a) == (b))
+
+/**
+ * @brief Run one test case and report it
+ *
+ * @param name name of the case
+ * @param fn case to run
+ */
+void host_test_run(const char *name, void (*fn)(void));
+
+/**
+ * @brief Report the result of all cases run
+ *
+ * @return exit status for main()
+ */
+int host_test_done(void);
+
+#endif /* INCLUDED_HOST_TEST_H */
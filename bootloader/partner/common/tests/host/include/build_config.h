@@ -0,0 +1,16 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ */
+
+#ifndef INCLUDED_BUILD_CONFIG_H
+#define INCLUDED_BUILD_CONFIG_H
+
+/* Host builds take their CONFIG_* options from the Makefile */
+
+#endif /* INCLUDED_BUILD_CONFIG_H */
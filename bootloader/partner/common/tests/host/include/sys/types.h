@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ */
+
+#ifndef INCLUDED_HOST_SYS_TYPES_H
+#define INCLUDED_HOST_SYS_TYPES_H
+
+/*
+ * Stands in for the bootloader's sys/types.h. The host one declares off_t
+ * and time_t, which the bootloader headers define themselves.
+ */
+
+#include <limits.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef unsigned int uint;
+typedef uintptr_t addr_t;
+typedef int status_t;
+typedef signed long int ssize_t;
+
+#endif /* INCLUDED_HOST_SYS_TYPES_H */
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ */
+
+#include "build_config.h"
+#include <string.h>
+#include <tegrabl_error.h>
+#include <tegrabl_utils.h>
+#include <tegrabl_cache_record.h>
+#include "host_test.h"
+#include "host_partition.h"
+
+#define TEST_PARTITION "CACHE"
+#define TEST_VERSION 3U
+#define TEST_RECORD_SIZE 100U
+
+/* Header in front of the record: magic, version, size, CRC32 */
+#define TEST_HEADER_SIZE 16U
+#define TEST_CRC_OFFSET 12U
+
+static uint8_t test_record[TEST_RECORD_SIZE];
+
+static void test_record_fill(uint8_t seed)
+{
+	uint32_t i;
+
+	for (i = 0; i < TEST_RECORD_SIZE; i++) {
+		test_record[i] = (uint8_t)(seed + (i * 13U));
+	}
+}
+
+static uint32_t test_get32(const uint8_t *p)
+{
+	uint32_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static void test_crc32(void)
+{
+	static const char check[] = "123456789";
+
+	/* The record CRC is the common CRC-32, so host tools can write records */
+	CHECK_EQ(tegrabl_utils_crc32(0, (void *)check, 9), 0xCBF43926U);
+}
+
+static void test_round_trip(void)
+{
+	uint8_t buf[TEST_RECORD_SIZE];
+	uint8_t *data;
+
+	host_partition_reset();
+	data = host_partition_add(TEST_PARTITION, 512);
+	test_record_fill(1);
+
+	CHECK_EQ(tegrabl_cache_record_store(TEST_PARTITION, TEST_VERSION, test_record, TEST_RECORD_SIZE),
+			 TEGRABL_NO_ERROR);
+	CHECK_EQ(host_partition_writes(), 1U);
+
+	CHECK(memcmp(data, "CERC", 4) == 0);
+	CHECK_EQ(test_get32(data + 4), TEST_VERSION);
+	CHECK_EQ(test_get32(data + 8), TEST_RECORD_SIZE);
+	CHECK_EQ(test_get32(data + TEST_CRC_OFFSET), tegrabl_utils_crc32(0, test_record, TEST_RECORD_SIZE));
+	CHECK(memcmp(data + TEST_HEADER_SIZE, test_record, TEST_RECORD_SIZE) == 0);
+	CHECK_EQ(data[TEST_HEADER_SIZE + TEST_RECORD_SIZE], 0xFFU);
+
+	memset(buf, 0, sizeof(buf));
+	CHECK_EQ(tegrabl_cache_record_load(TEST_PARTITION, TEST_VERSION, buf, TEST_RECORD_SIZE), TEGRABL_NO_ERROR);
+	CHECK(memcmp(buf, test_record, TEST_RECORD_SIZE) == 0);
+
+	/* A newer record replaces the old one */
+	test_record_fill(2);
+	CHECK_EQ(tegrabl_cache_record_store(TEST_PARTITION, TEST_VERSION, test_record, TEST_RECORD_SIZE),
+			 TEGRABL_NO_ERROR);
+	CHECK_EQ(tegrabl_cache_record_load(TEST_PARTITION, TEST_VERSION, buf, TEST_RECORD_SIZE), TEGRABL_NO_ERROR);
+	CHECK(memcmp(buf, test_record, TEST_RECORD_SIZE) == 0);
+}
+
+static void test_blank_partition(void)
+{
+	uint8_t buf[TEST_RECORD_SIZE];
+	tegrabl_error_t err;
+
+	host_partition_reset();
+	host_partition_add(TEST_PARTITION, 512);
+
+	err = tegrabl_cache_record_load(TEST_PARTITION, TEST_VERSION, buf, TEST_RECORD_SIZE);
+	CHECK_EQ(TEGRABL_ERROR_REASON(err), TEGRABL_ERR_INVALID);
+}
+
+static void test_header_mismatch(void)
+{
+	uint8_t buf[TEST_RECORD_SIZE];
+	tegrabl_error_t err;
+
+	host_partition_reset();
+	host_partition_add(TEST_PARTITION, 512);
+	test_record_fill(3);
+	CHECK_EQ(tegrabl_cache_record_store(TEST_PARTITION, TEST_VERSION, test_record, TEST_RECORD_SIZE),
+			 TEGRABL_NO_ERROR);
+
+	err = tegrabl_cache_record_load(TEST_PARTITION, TEST_VERSION + 1U, buf, TEST_RECORD_SIZE);
+	CHECK_EQ(TEGRABL_ERROR_REASON(err), TEGRABL_ERR_INVALID);
+
+	err = tegrabl_cache_record_load(TEST_PARTITION, TEST_VERSION, buf, TEST_RECORD_SIZE - 4U);
+	CHECK_EQ(TEGRABL_ERROR_REASON(err), TEGRABL_ERR_INVALID);
+}
+
+static void test_crc_mismatch(void)
+{
+	uint8_t buf[TEST_RECORD_SIZE];
+	uint8_t *data;
+	tegrabl_error_t err;
+
+	host_partition_reset();
+	data = host_partition_add(TEST_PARTITION, 512);
+	test_record_fill(4);
+	CHECK_EQ(tegrabl_cache_record_store(TEST_PARTITION, TEST_VERSION, test_record, TEST_RECORD_SIZE),
+			 TEGRABL_NO_ERROR);
+
+	/* Last byte of the record */
+	data[TEST_HEADER_SIZE + TEST_RECORD_SIZE - 1U] ^= 0x80U;
+	err = tegrabl_cache_record_load(TEST_PARTITION, TEST_VERSION, buf, TEST_RECORD_SIZE);
+	CHECK_EQ(TEGRABL_ERROR_REASON(err), TEGRABL_ERR_INVALID);
+	data[TEST_HEADER_SIZE + TEST_RECORD_SIZE - 1U] ^= 0x80U;
+	CHECK_EQ(tegrabl_cache_record_load(TEST_PARTITION, TEST_VERSION, buf, TEST_RECORD_SIZE), TEGRABL_NO_ERROR);
+
+	/* The stored CRC itself */
+	data[TEST_CRC_OFFSET] ^= 0x01U;
+	err = tegrabl_cache_record_load(TEST_PARTITION, TEST_VERSION, buf, TEST_RECORD_SIZE);
+	CHECK_EQ(TEGRABL_ERROR_REASON(err), TEGRABL_ERR_INVALID);
+}
+
+static void test_partition_too_small(void)
+{
+	uint8_t buf[TEST_RECORD_SIZE];
+	tegrabl_error_t err;
+
+	host_partition_reset();
+	host_partition_add(TEST_PARTITION, TEST_HEADER_SIZE + TEST_RECORD_SIZE - 1U);
+	test_record_fill(5);
+
+	err = tegrabl_cache_record_store(TEST_PARTITION, TEST_VERSION, test_record, TEST_RECORD_SIZE);
+	CHECK_EQ(TEGRABL_ERROR_REASON(err), TEGRABL_ERR_OVERFLOW);
+	CHECK_EQ(host_partition_writes(), 0U);
+
+	err = tegrabl_cache_record_load(TEST_PARTITION, TEST_VERSION, buf, TEST_RECORD_SIZE);
+	CHECK_EQ(TEGRABL_ERROR_REASON(err), TEGRABL_ERR_OVERFLOW);
+
+	/* An exact fit is enough */
+	host_partition_reset();
+	host_partition_add(TEST_PARTITION, TEST_HEADER_SIZE + TEST_RECORD_SIZE);
+	CHECK_EQ(tegrabl_cache_record_store(TEST_PARTITION, TEST_VERSION, test_record, TEST_RECORD_SIZE),
+			 TEGRABL_NO_ERROR);
+	CHECK_EQ(tegrabl_cache_record_load(TEST_PARTITION, TEST_VERSION, buf, TEST_RECORD_SIZE), TEGRABL_NO_ERROR);
+}
+
+static void test_no_partition(void)
+{
+	uint8_t buf[TEST_RECORD_SIZE];
+	tegrabl_error_t err;
+
+	host_partition_reset();
+	test_record_fill(6);
+
+	err = tegrabl_cache_record_store(TEST_PARTITION, TEST_VERSION, test_record, TEST_RECORD_SIZE);
+	CHECK_EQ(TEGRABL_ERROR_REASON(err), TEGRABL_ERR_NOT_FOUND);
+	err = tegrabl_cache_record_load(TEST_PARTITION, TEST_VERSION, buf, TEST_RECORD_SIZE);
+	CHECK_EQ(TEGRABL_ERROR_REASON(err), TEGRABL_ERR_NOT_FOUND);
+}
+
+static void test_bad_parameters(void)
+{
+	uint8_t buf[TEST_RECORD_SIZE];
+
+	host_partition_reset();
+	host_partition_add(TEST_PARTITION, 512);
+
+	CHECK_EQ(TEGRABL_ERROR_REASON(tegrabl_cache_record_load(NULL, TEST_VERSION, buf, TEST_RECORD_SIZE)),
+			 TEGRABL_ERR_BAD_PARAMETER);
+	CHECK_EQ(TEGRABL_ERROR_REASON(tegrabl_cache_record_load(TEST_PARTITION, TEST_VERSION, NULL,
+															TEST_RECORD_SIZE)),
+			 TEGRABL_ERR_BAD_PARAMETER);
+	CHECK_EQ(TEGRABL_ERROR_REASON(tegrabl_cache_record_store(TEST_PARTITION, TEST_VERSION, buf, 0)),
+			 TEGRABL_ERR_BAD_PARAMETER);
+	CHECK_EQ(host_partition_writes(), 0U);
+}
+
+int main(void)
+{
+	host_test_run("cache record: crc32", test_crc32);
+	host_test_run("cache record: round trip", test_round_trip);
+	host_test_run("cache record: blank partition", test_blank_partition);
+	host_test_run("cache record: header mismatch", test_header_mismatch);
+	host_test_run("cache record: crc mismatch", test_crc_mismatch);
+	host_test_run("cache record: partition too small", test_partition_too_small);
+	host_test_run("cache record: no partition", test_no_partition);
+	host_test_run("cache record: bad parameters", test_bad_parameters);
+
+	return host_test_done();
+}
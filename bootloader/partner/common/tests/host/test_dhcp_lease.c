@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ */
+
+#include "build_config.h"
+#include <string.h>
+#include <net_boot_lease.h>
+#include "host_test.h"
+#include "host_partition.h"
+
+static const uint8_t test_mac[6] = { 0x00, 0x04, 0x4b, 0x01, 0x02, 0x03 };
+
+static void test_lease_fill(struct net_boot_lease *lease)
+{
+	static const uint8_t ip[4] = { 192, 168, 1, 42 };
+	static const uint8_t netmask[4] = { 255, 255, 255, 0 };
+	static const uint8_t gateway[4] = { 192, 168, 1, 1 };
+	static const uint8_t server[4] = { 192, 168, 1, 2 };
+	static const uint8_t tftp_server[4] = { 192, 168, 1, 3 };
+
+	memset(lease, 0, sizeof(*lease));
+	memcpy(lease->mac, test_mac, sizeof(lease->mac));
+	memcpy(lease->ip, ip, 4);
+	memcpy(lease->netmask, netmask, 4);
+	memcpy(lease->gateway, gateway, 4);
+	memcpy(lease->server, server, 4);
+	memcpy(lease->tftp_server, tftp_server, 4);
+}
+
+static void test_no_partition(void)
+{
+	struct net_boot_lease cached;
+	struct net_boot_lease lease;
+
+	host_partition_reset();
+	memset(&cached, 0xA5, sizeof(cached));
+
+	CHECK(!net_boot_lease_load(&cached, test_mac));
+	CHECK_EQ(cached.ip[0], 0U);
+
+	test_lease_fill(&lease);
+	CHECK(!net_boot_lease_store(&cached, &lease));
+	CHECK(memcmp(&cached, &lease, sizeof(lease)) == 0);
+}
+
+static void test_blank_partition(void)
+{
+	struct net_boot_lease cached;
+
+	host_partition_reset();
+	host_partition_add(NET_BOOT_LEASE_PARTITION, 4096);
+
+	CHECK(!net_boot_lease_load(&cached, test_mac));
+}
+
+static void test_round_trip(void)
+{
+	struct net_boot_lease cached;
+	struct net_boot_lease lease;
+
+	host_partition_reset();
+	host_partition_add(NET_BOOT_LEASE_PARTITION, 4096);
+
+	CHECK(!net_boot_lease_load(&cached, test_mac));
+	test_lease_fill(&lease);
+	CHECK(net_boot_lease_store(&cached, &lease));
+	CHECK_EQ(host_partition_writes(), 1U);
+
+	/* Next boot */
+	memset(&cached, 0, sizeof(cached));
+	CHECK(net_boot_lease_load(&cached, test_mac));
+	CHECK(memcmp(&cached, &lease, sizeof(lease)) == 0);
+}
+
+static void test_unchanged_lease_not_written(void)
+{
+	struct net_boot_lease cached;
+	struct net_boot_lease lease;
+
+	host_partition_reset();
+	host_partition_add(NET_BOOT_LEASE_PARTITION, 4096);
+
+	test_lease_fill(&lease);
+	memset(&cached, 0, sizeof(cached));
+	CHECK(net_boot_lease_store(&cached, &lease));
+	CHECK(net_boot_lease_load(&cached, test_mac));
+	CHECK(!net_boot_lease_store(&cached, &lease));
+	CHECK_EQ(host_partition_writes(), 1U);
+
+	/* A new address from the server is cached again */
+	lease.ip[3] = 43;
+	CHECK(net_boot_lease_store(&cached, &lease));
+	CHECK_EQ(host_partition_writes(), 2U);
+	CHECK(net_boot_lease_load(&cached, test_mac));
+	CHECK_EQ(cached.ip[3], 43U);
+}
+
+static void test_other_mac(void)
+{
+	static const uint8_t other_mac[6] = { 0x00, 0x04, 0x4b, 0x0a, 0x0b, 0x0c };
+	struct net_boot_lease cached;
+	struct net_boot_lease lease;
+
+	host_partition_reset();
+	host_partition_add(NET_BOOT_LEASE_PARTITION, 4096);
+
+	test_lease_fill(&lease);
+	memset(&cached, 0, sizeof(cached));
+	CHECK(net_boot_lease_store(&cached, &lease));
+
+	/* Module moved to another carrier, the lease is not for this interface */
+	CHECK(!net_boot_lease_load(&cached, other_mac));
+	CHECK_EQ(cached.ip[0], 0U);
+}
+
+static void test_no_address(void)
+{
+	struct net_boot_lease cached;
+	struct net_boot_lease lease;
+
+	host_partition_reset();
+	host_partition_add(NET_BOOT_LEASE_PARTITION, 4096);
+
+	test_lease_fill(&lease);
+	memset(lease.ip, 0, sizeof(lease.ip));
+	memset(&cached, 0, sizeof(cached));
+	CHECK(net_boot_lease_store(&cached, &lease));
+
+	CHECK(!net_boot_lease_load(&cached, test_mac));
+}
+
+static void test_corrupt_record(void)
+{
+	struct net_boot_lease cached;
+	struct net_boot_lease lease;
+	uint8_t *data;
+
+	host_partition_reset();
+	data = host_partition_add(NET_BOOT_LEASE_PARTITION, 4096);
+
+	test_lease_fill(&lease);
+	memset(&cached, 0, sizeof(cached));
+	CHECK(net_boot_lease_store(&cached, &lease));
+
+	/* Flip a bit of the leased address behind the record header */
+	data[16 + 8] ^= 0x01;
+	CHECK(!net_boot_lease_load(&cached, test_mac));
+}
+
+int main(void)
+{
+	host_test_run("dhcp lease: no partition", test_no_partition);
+	host_test_run("dhcp lease: blank partition", test_blank_partition);
+	host_test_run("dhcp lease: round trip", test_round_trip);
+	host_test_run("dhcp lease: unchanged lease not written", test_unchanged_lease_not_written);
+	host_test_run("dhcp lease: other MAC", test_other_mac);
+	host_test_run("dhcp lease: no address", test_no_address);
+	host_test_run("dhcp lease: corrupt record", test_corrupt_record);
+
+	return host_test_done();
+}
@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ */
+
+#include "build_config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <tegrabl_error.h>
+#include <tegrabl_nvblob.h>
+#include "host_test.h"
+#include "host_partition.h"
+
+/* Mirrors the blob generator, see tegrabl_nvblob.c */
+#define NVBLOB_MAGIC "NVIDIA__BLOB__V2"
+#define NVBLOB_VERSION 0x00020000U
+#define NVBLOB_VERSION_ENTRY_COMPRESSED 0x80000000U
+#define NVBLOB_PARTITION "BLOB"
+
+#define NVBLOB_TEXT_LINES 200U
+#define NVBLOB_TEXT_SIZE (NVBLOB_TEXT_LINES * 21U)
+#define NVBLOB_RAW_SIZE 300U
+
+/* zstd -19 --check of nvblob_gen_text() */
+static const uint8_t nvblob_text_frame[201] = {
+	0x28, 0xb5, 0x2f, 0xfd, 0x64, 0x68, 0x0f, 0xdd, 0x05, 0x00, 0xf2, 0xce,
+	0x21, 0x14, 0xd0, 0x65, 0x39, 0x85, 0x44, 0x45, 0x42, 0x75, 0x06, 0x04,
+	0x2d, 0xa5, 0x94, 0x32, 0xa5, 0x44, 0x1d, 0x3a, 0xa1, 0x03, 0x83, 0xa2,
+	0x91, 0xb8, 0xcb, 0x55, 0xd1, 0x48, 0xdc, 0xe5, 0xa8, 0x68, 0x24, 0xee,
+	0x72, 0x53, 0x34, 0x12, 0x77, 0x39, 0x29, 0x1a, 0x89, 0xbb, 0x5c, 0x14,
+	0x8d, 0xc4, 0x5d, 0xee, 0x45, 0x23, 0x71, 0x97, 0x73, 0xd1, 0x48, 0xdc,
+	0xe5, 0x5a, 0x34, 0x12, 0x77, 0x39, 0x16, 0x8d, 0xc4, 0x5d, 0x6e, 0x5c,
+	0xd1, 0x48, 0xdc, 0xe5, 0xaa, 0x68, 0x24, 0xee, 0x72, 0x54, 0x34, 0x12,
+	0x77, 0xb9, 0x29, 0x1a, 0x89, 0xbb, 0x9c, 0x14, 0x8d, 0xc4, 0x5d, 0x2e,
+	0x8a, 0x46, 0xe2, 0x2e, 0xf7, 0xa2, 0x91, 0xb8, 0xcb, 0xb9, 0x68, 0x24,
+	0xee, 0x72, 0x2d, 0x1a, 0x89, 0xbb, 0x1c, 0x8b, 0x46, 0xe2, 0x2e, 0x07,
+	0x23, 0x18, 0x02, 0x00, 0x0e, 0x84, 0x82, 0x01, 0x82, 0x00, 0x03, 0xa1,
+	0x20, 0x70, 0x28, 0x04, 0x80, 0xc8, 0xa8, 0x11, 0x90, 0x5f, 0xd8, 0xdf,
+	0xe0, 0xe7, 0x21, 0x04, 0xff, 0x08, 0x01, 0xc7, 0x0f, 0xe8, 0x6b, 0x77,
+	0xfb, 0xed, 0x6e, 0xbf, 0xdd, 0xed, 0xb7, 0xbb, 0xfd, 0x8e, 0x4f, 0x80,
+	0xa4, 0x37, 0xfd, 0xf4, 0xa6, 0x9f, 0xde, 0xf4, 0xd3, 0x9b, 0x7e, 0xed,
+	0x18, 0x9c, 0x81, 0x55, 0x05, 0x26, 0x27, 0x62, 0xc5,
+};
+
+struct nvblob_entry_index {
+	uint32_t stored_size;
+	uint32_t reserved;
+};
+
+/* Entry 0 is the text, compressed if the blob is; entry 1 is stored as is */
+struct nvblob_layout {
+	struct blob_header header;
+	struct tegrabl_image_entry entries[2];
+	struct nvblob_entry_index index[2];
+};
+
+static uint8_t nvblob_text[NVBLOB_TEXT_SIZE];
+static uint8_t nvblob_raw[NVBLOB_RAW_SIZE];
+
+static void nvblob_gen_text(uint8_t *buf)
+{
+	char line[22];
+	uint32_t i;
+
+	for (i = 0; i < NVBLOB_TEXT_LINES; i++) {
+		(void)snprintf(line, sizeof(line), "blob entry line %04u\n", i);
+		memcpy(buf + (i * 21U), line, 21U);
+	}
+}
+
+static void nvblob_gen_raw(uint8_t *buf)
+{
+	uint32_t i;
+
+	for (i = 0; i < NVBLOB_RAW_SIZE; i++) {
+		buf[i] = (uint8_t)(i * 7U);
+	}
+}
+
+/*
+ * Write a two entry blob to the partition and return where the data of
+ * entry 0 starts in it
+ */
+static uint8_t *nvblob_make(bool compressed)
+{
+	struct nvblob_layout layout;
+	uint32_t entries_size = compressed ? sizeof(layout) : offsetof(struct nvblob_layout, index);
+	uint32_t text_stored = compressed ? sizeof(nvblob_text_frame) : NVBLOB_TEXT_SIZE;
+	uint32_t size = entries_size + text_stored + NVBLOB_RAW_SIZE;
+	uint8_t *part;
+
+	memset(&layout, 0, sizeof(layout));
+	memcpy(layout.header.magic, NVBLOB_MAGIC, UPDATE_MAGIC_SIZE);
+	layout.header.version = NVBLOB_VERSION | (compressed ? NVBLOB_VERSION_ENTRY_COMPRESSED : 0U);
+	layout.header.size = size;
+	layout.header.entries_offset = sizeof(layout.header);
+	layout.header.num_entries = 2;
+	layout.header.type = BLOB_UPDATE;
+	layout.header.uncomp_size = size;
+
+	strcpy(layout.entries[0].partname, "kernel");
+	layout.entries[0].image_offset = entries_size;
+	layout.entries[0].image_size = NVBLOB_TEXT_SIZE;
+	strcpy(layout.entries[1].partname, "kernel-dtb");
+	layout.entries[1].image_offset = entries_size + text_stored;
+	layout.entries[1].image_size = NVBLOB_RAW_SIZE;
+	layout.index[0].stored_size = text_stored;
+	layout.index[1].stored_size = NVBLOB_RAW_SIZE;
+
+	host_partition_reset();
+	part = host_partition_add(NVBLOB_PARTITION, size + 4096U);
+	memcpy(part, &layout, entries_size);
+	memcpy(part + entries_size, compressed ? nvblob_text_frame : nvblob_text, text_stored);
+	memcpy(part + entries_size + text_stored, nvblob_raw, NVBLOB_RAW_SIZE);
+
+	return part + entries_size;
+}
+
+static tegrabl_blob_handle nvblob_open(void)
+{
+	tegrabl_blob_handle bh = 0;
+
+	CHECK_EQ(tegrabl_blob_init(NVBLOB_PARTITION, NULL, &bh), TEGRABL_NO_ERROR);
+	return bh;
+}
+
+static void test_compressed_entries(void)
+{
+	tegrabl_blob_handle bh;
+	uint8_t *buf = malloc(NVBLOB_TEXT_SIZE);
+	uint32_t size = 0;
+
+	nvblob_make(true);
+	bh = nvblob_open();
+	CHECK(tegrabl_blob_is_entry_compressed(bh));
+
+	memset(buf, 0, NVBLOB_TEXT_SIZE);
+	CHECK_EQ(tegrabl_blob_read_entry_data(bh, 0, buf, NVBLOB_TEXT_SIZE, &size), TEGRABL_NO_ERROR);
+	CHECK_EQ(size, NVBLOB_TEXT_SIZE);
+	CHECK(memcmp(buf, nvblob_text, NVBLOB_TEXT_SIZE) == 0);
+
+	/* Stored entries of a compressed blob are copied */
+	memset(buf, 0, NVBLOB_TEXT_SIZE);
+	CHECK_EQ(tegrabl_blob_read_entry_data(bh, 1, buf, NVBLOB_TEXT_SIZE, &size), TEGRABL_NO_ERROR);
+	CHECK_EQ(size, NVBLOB_RAW_SIZE);
+	CHECK(memcmp(buf, nvblob_raw, NVBLOB_RAW_SIZE) == 0);
+
+	tegrabl_blob_close(bh);
+	free(buf);
+}
+
+static void test_compressed_entry_pointer(void)
+{
+	tegrabl_blob_handle bh;
+	uint8_t *data = NULL;
+	uint32_t size = 0;
+	tegrabl_error_t err;
+
+	nvblob_make(true);
+	bh = nvblob_open();
+
+	/* Compressed data must not be handed out as the entry */
+	err = tegrabl_blob_get_entry_data(bh, 0, &data, &size);
+	CHECK_EQ(TEGRABL_ERROR_REASON(err), TEGRABL_ERR_NOT_SUPPORTED);
+	CHECK(data == NULL);
+
+	/* The size alone is the original one */
+	CHECK_EQ(tegrabl_blob_get_entry_data(bh, 0, NULL, &size), TEGRABL_NO_ERROR);
+	CHECK_EQ(size, NVBLOB_TEXT_SIZE);
+
+	tegrabl_blob_close(bh);
+}
+
+static void test_buffer_too_small(void)
+{
+	tegrabl_blob_handle bh;
+	uint8_t *buf = malloc(NVBLOB_TEXT_SIZE);
+	uint32_t size = 0;
+	tegrabl_error_t err;
+
+	nvblob_make(true);
+	bh = nvblob_open();
+
+	err = tegrabl_blob_read_entry_data(bh, 0, buf, NVBLOB_TEXT_SIZE - 1U, &size);
+	CHECK_EQ(TEGRABL_ERROR_REASON(err), TEGRABL_ERR_OVERFLOW);
+	CHECK_EQ(size, 0U);
+
+	tegrabl_blob_close(bh);
+	free(buf);
+}
+
+static void test_bad_index(void)
+{
+	tegrabl_blob_handle bh;
+	uint8_t buf[16];
+	tegrabl_error_t err;
+
+	nvblob_make(true);
+	bh = nvblob_open();
+
+	err = tegrabl_blob_read_entry_data(bh, 2, buf, sizeof(buf), NULL);
+	CHECK_EQ(TEGRABL_ERROR_REASON(err), TEGRABL_ERR_INVALID);
+	err = tegrabl_blob_read_entry_data(bh, 0, NULL, NVBLOB_TEXT_SIZE, NULL);
+	CHECK_EQ(TEGRABL_ERROR_REASON(err), TEGRABL_ERR_INVALID);
+
+	tegrabl_blob_close(bh);
+}
+
+static void test_corrupt_entry(void)
+{
+	tegrabl_blob_handle bh;
+	uint8_t *buf = malloc(NVBLOB_TEXT_SIZE);
+	uint8_t *text;
+
+	/* The frame checksum catches a flipped bit in the middle of the data */
+	text = nvblob_make(true);
+	text[sizeof(nvblob_text_frame) / 2U] ^= 0x10U;
+	bh = nvblob_open();
+	CHECK(tegrabl_blob_read_entry_data(bh, 0, buf, NVBLOB_TEXT_SIZE, NULL) != TEGRABL_NO_ERROR);
+	tegrabl_blob_close(bh);
+
+	/* Stored size differs from the entry size but the data is no frame */
+	text = nvblob_make(true);
+	text[0] ^= 0xFFU;
+	bh = nvblob_open();
+	CHECK_EQ(TEGRABL_ERROR_REASON(tegrabl_blob_read_entry_data(bh, 0, buf, NVBLOB_TEXT_SIZE, NULL)),
+			 TEGRABL_ERR_INVALID);
+	tegrabl_blob_close(bh);
+
+	free(buf);
+}
+
+static void test_entry_size_mismatch(void)
+{
+	struct nvblob_layout *layout;
+	tegrabl_blob_handle bh;
+	uint8_t *buf = malloc(NVBLOB_TEXT_SIZE + 100U);
+	uint8_t *text;
+	tegrabl_error_t err;
+
+	/* The entry claims more than the frame holds */
+	text = nvblob_make(true);
+	layout = (struct nvblob_layout *)(text - sizeof(*layout));
+	layout->entries[0].image_size = NVBLOB_TEXT_SIZE + 100U;
+	bh = nvblob_open();
+	err = tegrabl_blob_read_entry_data(bh, 0, buf, NVBLOB_TEXT_SIZE + 100U, NULL);
+	CHECK_EQ(TEGRABL_ERROR_REASON(err), TEGRABL_ERR_INVALID);
+	tegrabl_blob_close(bh);
+
+	free(buf);
+}
+
+static void test_plain_blob(void)
+{
+	tegrabl_blob_handle bh;
+	uint8_t *buf = malloc(NVBLOB_TEXT_SIZE);
+	uint8_t *data = NULL;
+	uint32_t size = 0;
+
+	nvblob_make(false);
+	bh = nvblob_open();
+	CHECK(!tegrabl_blob_is_entry_compressed(bh));
+
+	CHECK_EQ(tegrabl_blob_read_entry_data(bh, 0, buf, NVBLOB_TEXT_SIZE, &size), TEGRABL_NO_ERROR);
+	CHECK_EQ(size, NVBLOB_TEXT_SIZE);
+	CHECK(memcmp(buf, nvblob_text, NVBLOB_TEXT_SIZE) == 0);
+
+	CHECK_EQ(tegrabl_blob_get_entry_data(bh, 1, &data, &size), TEGRABL_NO_ERROR);
+	CHECK_EQ(size, NVBLOB_RAW_SIZE);
+	CHECK((data != NULL) && (memcmp(data, nvblob_raw, NVBLOB_RAW_SIZE) == 0));
+
+	tegrabl_blob_close(bh);
+	free(buf);
+}
+
+int main(void)
+{
+	nvblob_gen_text(nvblob_text);
+	nvblob_gen_raw(nvblob_raw);
+
+	host_test_run("nvblob: compressed entries", test_compressed_entries);
+	host_test_run("nvblob: compressed entry pointer", test_compressed_entry_pointer);
+	host_test_run("nvblob: buffer too small", test_buffer_too_small);
+	host_test_run("nvblob: bad index", test_bad_index);
+	host_test_run("nvblob: corrupt entry", test_corrupt_entry);
+	host_test_run("nvblob: entry size mismatch", test_entry_size_mismatch);
+	host_test_run("nvblob: plain blob", test_plain_blob);
+
+	return host_test_done();
+}
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ */
+
+#include "build_config.h"
+#include <string.h>
+#include <tegrabl_qspi_flash_erase_plan.h>
+#include "host_test.h"
+
+#define TEST_SECTOR 0x10000U
+#define TEST_SMALL 0x1000U
+#define TEST_BLOCK 0x200U
+#define TEST_PARAM_END 0x8000U
+#define TEST_MAX_UNITS 64U
+
+struct test_plan {
+	struct qspi_erase_unit units[TEST_MAX_UNITS];
+	uint32_t count;
+};
+
+static void test_plan_run(struct test_plan *tp, uint32_t offset, uint32_t end,
+						  uint32_t param_end, bool uniform)
+{
+	struct qspi_erase_plan plan;
+
+	memset(tp, 0, sizeof(*tp));
+	qspi_erase_plan_init(&plan, offset, end, TEST_SECTOR, TEST_SMALL, param_end, uniform);
+	while ((tp->count < TEST_MAX_UNITS) && qspi_erase_plan_next(&plan, &tp->units[tp->count])) {
+		tp->count++;
+	}
+}
+
+static bool test_unit_is(const struct qspi_erase_unit *unit, uint32_t base, uint32_t size,
+						 uint32_t start, uint32_t end)
+{
+	return (unit->unit == base) && (unit->unit_size == size) &&
+		(unit->start == start) && (unit->end == end);
+}
+
+static void test_full_sectors(void)
+{
+	struct test_plan tp;
+
+	test_plan_run(&tp, 0x10000U, 0x30000U, 0, false);
+	CHECK_EQ(tp.count, 2U);
+	CHECK(test_unit_is(&tp.units[0], 0x10000U, TEST_SECTOR, 0x10000U, 0x20000U));
+	CHECK(test_unit_is(&tp.units[1], 0x20000U, TEST_SECTOR, 0x20000U, 0x30000U));
+
+	/* Full sectors are erased whole even where 4KB erases are supported */
+	test_plan_run(&tp, 0x10000U, 0x20000U, 0, true);
+	CHECK_EQ(tp.count, 1U);
+	CHECK(test_unit_is(&tp.units[0], 0x10000U, TEST_SECTOR, 0x10000U, 0x20000U));
+}
+
+static void test_empty_range(void)
+{
+	struct test_plan tp;
+
+	test_plan_run(&tp, 0x10000U, 0x10000U, 0, true);
+	CHECK_EQ(tp.count, 0U);
+}
+
+static void test_no_small_erase(void)
+{
+	struct test_plan tp;
+
+	/* Without parameter sectors a partial sector is erased whole */
+	test_plan_run(&tp, 0x11000U, 0x12000U, 0, false);
+	CHECK_EQ(tp.count, 1U);
+	CHECK(test_unit_is(&tp.units[0], 0x10000U, TEST_SECTOR, 0x11000U, 0x12000U));
+}
+
+static void test_parameter_sectors(void)
+{
+	struct test_plan tp;
+
+	test_plan_run(&tp, 0x1000U, 0x3000U, TEST_PARAM_END, false);
+	CHECK_EQ(tp.count, 2U);
+	CHECK(test_unit_is(&tp.units[0], 0x1000U, TEST_SMALL, 0x1000U, 0x2000U));
+	CHECK(test_unit_is(&tp.units[1], 0x2000U, TEST_SMALL, 0x2000U, 0x3000U));
+
+	/* Crossing the end of the parameter sectors needs the sector erase */
+	test_plan_run(&tp, 0x7000U, 0x9000U, TEST_PARAM_END, false);
+	CHECK_EQ(tp.count, 1U);
+	CHECK(test_unit_is(&tp.units[0], 0, TEST_SECTOR, 0x7000U, 0x9000U));
+
+	/* Past the parameter sectors */
+	test_plan_run(&tp, 0x11000U, 0x12000U, TEST_PARAM_END, false);
+	CHECK_EQ(tp.count, 1U);
+	CHECK(test_unit_is(&tp.units[0], 0x10000U, TEST_SECTOR, 0x11000U, 0x12000U));
+}
+
+static void test_partial_small_units(void)
+{
+	struct test_plan tp;
+
+	/* Block aligned range inside two sub-sectors, the rest of each is kept */
+	test_plan_run(&tp, 0x10800U, 0x11800U, 0, true);
+	CHECK_EQ(tp.count, 2U);
+	CHECK(test_unit_is(&tp.units[0], 0x10000U, TEST_SMALL, 0x10800U, 0x11000U));
+	CHECK(test_unit_is(&tp.units[1], 0x11000U, TEST_SMALL, 0x11000U, 0x11800U));
+
+	/* End of a sector */
+	test_plan_run(&tp, 0x1F000U, 0x20000U, 0, true);
+	CHECK_EQ(tp.count, 1U);
+	CHECK(test_unit_is(&tp.units[0], 0x1F000U, TEST_SMALL, 0x1F000U, 0x20000U));
+}
+
+static void test_small_erase_ratio(void)
+{
+	struct test_plan tp;
+	uint32_t limit = (TEST_SECTOR / TEST_SMALL) / QSPI_SMALL_ERASE_RATIO;
+	uint32_t i;
+
+	test_plan_run(&tp, 0x20000U, 0x20000U + (limit * TEST_SMALL), 0, true);
+	CHECK_EQ(tp.count, limit);
+	for (i = 0; i < tp.count; i++) {
+		CHECK_EQ(tp.units[i].unit_size, TEST_SMALL);
+	}
+
+	/* One more 4KB erase costs more than the sector erase */
+	test_plan_run(&tp, 0x20000U, 0x20000U + ((limit + 1U) * TEST_SMALL), 0, true);
+	CHECK_EQ(tp.count, 1U);
+	CHECK(test_unit_is(&tp.units[0], 0x20000U, TEST_SECTOR, 0x20000U,
+					   0x20000U + ((limit + 1U) * TEST_SMALL)));
+
+	/* Partial sub-sectors count as whole ones */
+	test_plan_run(&tp, 0x20200U, 0x20000U + (limit * TEST_SMALL) + TEST_BLOCK, 0, true);
+	CHECK_EQ(tp.count, 1U);
+	CHECK_EQ(tp.units[0].unit_size, TEST_SECTOR);
+}
+
+static void test_spanning_sectors(void)
+{
+	struct test_plan tp;
+
+	test_plan_run(&tp, 0xF000U, 0x32000U, 0, true);
+	CHECK_EQ(tp.count, 5U);
+	CHECK(test_unit_is(&tp.units[0], 0xF000U, TEST_SMALL, 0xF000U, 0x10000U));
+	CHECK(test_unit_is(&tp.units[1], 0x10000U, TEST_SECTOR, 0x10000U, 0x20000U));
+	CHECK(test_unit_is(&tp.units[2], 0x20000U, TEST_SECTOR, 0x20000U, 0x30000U));
+	CHECK(test_unit_is(&tp.units[3], 0x30000U, TEST_SMALL, 0x30000U, 0x31000U));
+	CHECK(test_unit_is(&tp.units[4], 0x31000U, TEST_SMALL, 0x31000U, 0x32000U));
+
+	/* Each end is planned on its own */
+	test_plan_run(&tp, 0x8000U, 0x11000U, TEST_PARAM_END, false);
+	CHECK_EQ(tp.count, 2U);
+	CHECK(test_unit_is(&tp.units[0], 0, TEST_SECTOR, 0x8000U, 0x10000U));
+	CHECK(test_unit_is(&tp.units[1], 0x10000U, TEST_SECTOR, 0x10000U, 0x11000U));
+}
+
+static void test_units_tile_range(void)
+{
+	struct test_plan tp;
+	uint32_t seed = 1;
+	uint32_t offset;
+	uint32_t end;
+	uint32_t next;
+	uint32_t i;
+	uint32_t n;
+
+	for (n = 0; n < 2000U; n++) {
+		seed = (seed * 1103515245U) + 12345U;
+		offset = ((seed >> 8) % 0x300U) * TEST_BLOCK;
+		seed = (seed * 1103515245U) + 12345U;
+		end = offset + ((((seed >> 8) % 0x100U) + 1U) * TEST_BLOCK);
+
+		test_plan_run(&tp, offset, end, TEST_PARAM_END, (n & 1U) != 0U);
+		CHECK(tp.count < TEST_MAX_UNITS);
+
+		next = offset;
+		for (i = 0; i < tp.count; i++) {
+			const struct qspi_erase_unit *unit = &tp.units[i];
+
+			CHECK((unit->unit_size == TEST_SECTOR) || (unit->unit_size == TEST_SMALL));
+			CHECK_EQ(unit->unit & (unit->unit_size - 1U), 0U);
+			CHECK_EQ(unit->start, next);
+			CHECK(unit->start < unit->end);
+			CHECK(unit->start >= unit->unit);
+			CHECK(unit->end <= (unit->unit + unit->unit_size));
+			next = unit->end;
+		}
+		CHECK_EQ(next, end);
+	}
+}
+
+int main(void)
+{
+	host_test_run("qspi erase plan: full sectors", test_full_sectors);
+	host_test_run("qspi erase plan: empty range", test_empty_range);
+	host_test_run("qspi erase plan: no small erase", test_no_small_erase);
+	host_test_run("qspi erase plan: parameter sectors", test_parameter_sectors);
+	host_test_run("qspi erase plan: partial small units", test_partial_small_units);
+	host_test_run("qspi erase plan: small erase ratio", test_small_erase_ratio);
+	host_test_run("qspi erase plan: spanning sectors", test_spanning_sectors);
+	host_test_run("qspi erase plan: units tile range", test_units_tile_range);
+
+	return host_test_done();
+}
@@ -0,0 +1,519 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ */
+
+#include "build_config.h"
+#include <stdlib.h>
+#include <string.h>
+#include <tegrabl_error.h>
+#include <tegrabl_decompress.h>
+#include "host_test.h"
+
+/*
+ * Frames made by the reference zstd CLI from the zstd_gen_*() contents below:
+ *   zstd_text_frame: zstd -19 --check, content size in the header
+ *   zstd_random_frame: zstd -1 --no-check, a raw block
+ *   zstd_mixed_frame: zstd -3 --no-check from a pipe, no content size, several
+ *                     blocks with RLE and compressed blocks
+ */
+#define ZSTD_TEXT_SIZE		8000U
+#define ZSTD_RANDOM_SIZE	512U
+#define ZSTD_MIXED_SIZE		303000U
+
+static const uint8_t zstd_text_frame[1660] = {
+	0x28, 0xb5, 0x2f, 0xfd, 0x64, 0x40, 0x1e, 0x75, 0x33, 0x00, 0x02, 0xcb,
+	0x19, 0x14, 0xa0, 0x35, 0xe9, 0x4f, 0xb6, 0x7f, 0xcb, 0x26, 0x3f, 0x93,
+	0xff, 0x85, 0x6c, 0xa3, 0xff, 0xff, 0x7d, 0x6f, 0x5a, 0xa1, 0x1f, 0xbf,
+	0xf7, 0xf6, 0x9e, 0xdd, 0xf0, 0x7b, 0xb3, 0xb3, 0xdb, 0x7b, 0xfb, 0x7f,
+	0xb5, 0x1f, 0xfb, 0x8a, 0x1d, 0xbb, 0x5d, 0xec, 0xef, 0xb1, 0xc5, 0x8e,
+	0xdd, 0xb6, 0xb1, 0xc3, 0xde, 0xec, 0x9e, 0x1d, 0x36, 0x81, 0xc4, 0x56,
+	0x49, 0x04, 0x5b, 0x27, 0x24, 0x18, 0x3d, 0xe9, 0x24, 0xe4, 0xa3, 0xde,
+	0x06, 0x15, 0x8c, 0x2a, 0x2d, 0x0a, 0x71, 0x8b, 0x32, 0x80, 0xd1, 0xa9,
+	0x01, 0x21, 0x22, 0x29, 0x41, 0x72, 0x08, 0x34, 0x52, 0xa9, 0x2d, 0x55,
+	0x18, 0x03, 0x31, 0x82, 0x3a, 0x47, 0x32, 0x08, 0x83, 0x20, 0xa8, 0x12,
+	0xc7, 0x49, 0x52, 0x19, 0xf6, 0x37, 0x22, 0x10, 0x08, 0x0c, 0x08, 0xc6,
+	0x79, 0xa2, 0xcc, 0xee, 0x01, 0x22, 0x10, 0x64, 0x0e, 0x82, 0x32, 0x9a,
+	0x6e, 0x98, 0xc9, 0x91, 0x26, 0x49, 0x73, 0x3a, 0x56, 0xaf, 0xf1, 0x3d,
+	0x1c, 0x83, 0x7e, 0x00, 0xee, 0x3a, 0x6a, 0xa9, 0xc0, 0xa0, 0x3e, 0x0a,
+	0xa9, 0x88, 0xe6, 0xd2, 0x38, 0xa2, 0x76, 0xc7, 0x4d, 0x89, 0x1c, 0x0c,
+	0x79, 0x50, 0xc5, 0x33, 0x64, 0x65, 0xb9, 0x4a, 0xcd, 0xae, 0x72, 0xf2,
+	0x96, 0x83, 0x73, 0x7e, 0xff, 0xc6, 0x31, 0xa5, 0xea, 0x85, 0xc5, 0x00,
+	0xfb, 0x55, 0x26, 0x09, 0x49, 0x85, 0x07, 0x57, 0x30, 0x7a, 0xbd, 0xa7,
+	0xf3, 0xcb, 0x78, 0xe2, 0x49, 0xb6, 0x67, 0x35, 0x97, 0xce, 0x72, 0xb7,
+	0x54, 0x41, 0xcc, 0x93, 0x31, 0xaf, 0x4e, 0x72, 0x6b, 0xae, 0x97, 0x4a,
+	0x47, 0xdd, 0x7b, 0xf2, 0x03, 0x1c, 0x87, 0x59, 0x3b, 0x88, 0x1e, 0x15,
+	0x6e, 0x42, 0xb5, 0xa5, 0x7d, 0x5e, 0xa0, 0x0d, 0xac, 0xdc, 0xf0, 0x46,
+	0x12, 0x59, 0xb5, 0x84, 0xc5, 0x1a, 0xb5, 0x5f, 0xf7, 0xc4, 0xf6, 0x81,
+	0xd6, 0xf7, 0x3d, 0x24, 0x69, 0x07, 0x16, 0xbc, 0xfd, 0xcf, 0xd8, 0x7b,
+	0x8c, 0xec, 0x39, 0x56, 0xb7, 0x93, 0x04, 0x38, 0xbc, 0xb7, 0x0b, 0x4f,
+	0x29, 0x62, 0x8a, 0xd0, 0x92, 0x71, 0xde, 0xd0, 0xf9, 0x7d, 0x08, 0x44,
+	0xef, 0x91, 0xb4, 0xc3, 0xa6, 0x09, 0x11, 0x74, 0x4f, 0x4a, 0x58, 0x56,
+	0x7e, 0xef, 0xf8, 0x69, 0xa3, 0x3b, 0x2a, 0xe0, 0x2f, 0x40, 0x43, 0x49,
+	0xe8, 0x36, 0xe4, 0x43, 0xcf, 0x53, 0xce, 0x03, 0x47, 0x05, 0x21, 0x6b,
+	0x69, 0xdb, 0x7a, 0x2f, 0x40, 0x61, 0xec, 0x8b, 0xed, 0x2c, 0x0e, 0xf8,
+	0xf8, 0xa6, 0x41, 0x42, 0xe4, 0x06, 0xc3, 0xf7, 0xa8, 0x17, 0x52, 0x3f,
+	0x20, 0x5a, 0x9c, 0x27, 0x65, 0x8d, 0xf6, 0x76, 0x66, 0x08, 0xe1, 0x8e,
+	0xe6, 0x54, 0x90, 0x6c, 0x14, 0xdf, 0x9e, 0xa6, 0xef, 0xd8, 0x45, 0xf5,
+	0x9d, 0x22, 0x51, 0xf2, 0x80, 0x48, 0xf7, 0x55, 0x18, 0xa1, 0x59, 0xd1,
+	0x90, 0x8d, 0xe3, 0x87, 0x61, 0x61, 0x50, 0x3b, 0xc1, 0x60, 0xbe, 0x6b,
+	0x91, 0x31, 0x93, 0xa5, 0xeb, 0x53, 0xc6, 0x85, 0x97, 0xd5, 0x45, 0x9b,
+	0x51, 0xe2, 0x29, 0x81, 0x5f, 0x08, 0xb5, 0xe4, 0x66, 0x70, 0x02, 0xa2,
+	0x66, 0xac, 0x34, 0x0a, 0xda, 0x3f, 0x03, 0x05, 0x85, 0x1f, 0xc1, 0x90,
+	0xdb, 0x02, 0xcb, 0x09, 0x2b, 0xbc, 0x83, 0xdb, 0x30, 0x12, 0x9a, 0x68,
+	0x40, 0x30, 0x80, 0xad, 0x2a, 0x94, 0x5d, 0x40, 0x01, 0x9f, 0x68, 0x14,
+	0x46, 0x85, 0x94, 0x1c, 0x19, 0x9a, 0x0b, 0x21, 0x43, 0x22, 0xd4, 0x14,
+	0xf3, 0xbe, 0x0e, 0x0c, 0xf3, 0x06, 0xe1, 0x0f, 0x6c, 0xb5, 0xda, 0xea,
+	0xf0, 0xf8, 0x28, 0xad, 0x5d, 0x40, 0xfc, 0x92, 0xe5, 0x03, 0x21, 0x3d,
+	0x42, 0xbf, 0xc0, 0x6f, 0x46, 0x3a, 0x2a, 0x8b, 0x9d, 0xdd, 0xa8, 0x12,
+	0xd3, 0x88, 0x4e, 0x59, 0xc0, 0xcd, 0x84, 0xc1, 0x00, 0xa3, 0x12, 0xf3,
+	0x18, 0x91, 0x3c, 0x58, 0x4d, 0x16, 0xb9, 0x9b, 0xac, 0xfc, 0x6e, 0x9e,
+	0xf1, 0x07, 0x23, 0xb8, 0x61, 0x40, 0xf3, 0x50, 0xc5, 0x31, 0x4e, 0x77,
+	0x23, 0xac, 0x63, 0x74, 0xaf, 0x16, 0x35, 0x30, 0x96, 0x2f, 0xe0, 0x8b,
+	0xd8, 0xb7, 0x84, 0xaa, 0x52, 0xe6, 0x27, 0xcf, 0xad, 0x46, 0x53, 0x01,
+	0x40, 0xbf, 0x07, 0xd0, 0xe2, 0xd3, 0x80, 0x82, 0x38, 0xcc, 0x58, 0x7d,
+	0xb5, 0x26, 0xbe, 0xc7, 0x8d, 0xa8, 0x8b, 0x30, 0x03, 0x70, 0x50, 0x55,
+	0x85, 0x81, 0x15, 0xf9, 0x16, 0xbc, 0xfc, 0x2d, 0xc7, 0x0b, 0xd4, 0xe0,
+	0x07, 0xf2, 0x09, 0xbb, 0x82, 0xb6, 0x44, 0xea, 0xa2, 0x5f, 0x53, 0xbb,
+	0xc9, 0xe5, 0xb7, 0xd4, 0x7b, 0x2f, 0x78, 0x85, 0x60, 0x4a, 0x03, 0xec,
+	0xa2, 0xe3, 0x22, 0x43, 0x02, 0x24, 0xe0, 0xac, 0x10, 0x6a, 0xee, 0x76,
+	0xf6, 0x57, 0x14, 0xd1, 0x35, 0x2e, 0xac, 0x93, 0x36, 0xa4, 0x14, 0xb2,
+	0x9c, 0x05, 0x0a, 0x65, 0xe5, 0x18, 0x23, 0x60, 0xd7, 0x11, 0x32, 0x03,
+	0xfd, 0xae, 0xc3, 0x0a, 0xcf, 0xed, 0x45, 0x69, 0x39, 0xa2, 0x5b, 0x83,
+	0x24, 0x06, 0x94, 0xce, 0x6e, 0x31, 0x72, 0x40, 0x31, 0x7e, 0xee, 0x5d,
+	0x06, 0x56, 0x67, 0x3e, 0x71, 0xea, 0x73, 0xb2, 0x46, 0xd3, 0x53, 0x19,
+	0x75, 0xde, 0x58, 0x8a, 0x68, 0x5d, 0x93, 0xf6, 0xd8, 0xa1, 0x0d, 0xb3,
+	0x67, 0x01, 0x8f, 0x48, 0xc8, 0xec, 0xac, 0x51, 0xd7, 0x4d, 0xf9, 0x4d,
+	0x69, 0x22, 0x63, 0xac, 0xf2, 0xbc, 0xfb, 0xdf, 0x09, 0x81, 0x39, 0xde,
+	0x81, 0x51, 0xac, 0x2a, 0x72, 0x87, 0xc6, 0xcd, 0x38, 0xa8, 0x22, 0x76,
+	0x4d, 0x8e, 0xda, 0xfc, 0xb5, 0x8d, 0x0d, 0xc6, 0x0e, 0xde, 0x8d, 0x86,
+	0xc1, 0x25, 0xbe, 0x18, 0x59, 0x5f, 0x68, 0x5c, 0xed, 0x9d, 0xc7, 0xef,
+	0xf6, 0x5a, 0x82, 0x44, 0xf2, 0x53, 0xcb, 0x03, 0xcb, 0x18, 0x68, 0x2b,
+	0xcd, 0xc8, 0x9e, 0xad, 0xa4, 0xc4, 0x81, 0xcb, 0x60, 0xdb, 0x88, 0x6a,
+	0x7e, 0x75, 0x81, 0x97, 0x1f, 0xc5, 0x9f, 0x6a, 0x81, 0xc7, 0xbb, 0x1f,
+	0x51, 0xcd, 0x2e, 0x89, 0x5d, 0xea, 0x64, 0xf5, 0xa5, 0x14, 0x43, 0x04,
+	0xcd, 0x47, 0x3e, 0x84, 0x56, 0x81, 0x53, 0xfa, 0x97, 0x68, 0x0d, 0x72,
+	0x08, 0xab, 0x79, 0x1f, 0xa0, 0xaf, 0x2b, 0xe2, 0x19, 0xca, 0x64, 0x90,
+	0xb9, 0x8c, 0x09, 0x81, 0x11, 0x97, 0x8d, 0x1b, 0x42, 0xc3, 0xe4, 0x2d,
+	0xab, 0x12, 0x58, 0x4a, 0xeb, 0x76, 0xe9, 0xe3, 0x0e, 0xd6, 0xec, 0xf1,
+	0xba, 0xf0, 0x3f, 0x2f, 0xaf, 0x72, 0x1f, 0x5c, 0x4d, 0xcb, 0x5c, 0xdb,
+	0x01, 0xe3, 0x08, 0xf6, 0x7f, 0xfd, 0xcc, 0x5d, 0xfa, 0xa9, 0xbf, 0x6d,
+	0x3e, 0x83, 0xd1, 0x23, 0xd9, 0x08, 0x27, 0x49, 0xdb, 0xed, 0x85, 0x66,
+	0x9b, 0xfe, 0x00, 0xef, 0xf3, 0xc5, 0x4f, 0xb1, 0xb5, 0x17, 0xb9, 0xc6,
+	0x17, 0xc3, 0x44, 0xb0, 0x95, 0xac, 0x3c, 0xfd, 0xc5, 0x10, 0x13, 0x9a,
+	0x99, 0x78, 0x5a, 0x54, 0x29, 0x82, 0x56, 0xa8, 0xb2, 0x05, 0x35, 0x61,
+	0x42, 0xc4, 0xc5, 0x07, 0x6a, 0xf0, 0x21, 0x42, 0xae, 0xc5, 0xce, 0x39,
+	0xd9, 0x2c, 0xe6, 0x5e, 0x53, 0x78, 0x3a, 0x9f, 0x93, 0x4c, 0x86, 0xa2,
+	0x86, 0xba, 0x4f, 0x88, 0xcd, 0x13, 0x49, 0xc9, 0xee, 0x2d, 0x82, 0xe0,
+	0xa9, 0x9b, 0x41, 0x30, 0xc2, 0x05, 0x92, 0x85, 0xda, 0xc5, 0xcf, 0x86,
+	0xaf, 0x29, 0x77, 0xb3, 0xe3, 0xf0, 0x89, 0x02, 0xf4, 0xd3, 0xc4, 0x66,
+	0x9f, 0x2b, 0x74, 0xb7, 0x3b, 0xd3, 0x19, 0x1a, 0x07, 0x7b, 0x1c, 0x8d,
+	0xd7, 0x59, 0xaa, 0x48, 0xc1, 0xe3, 0x64, 0x24, 0x72, 0xf2, 0x7d, 0x5d,
+	0x94, 0x1e, 0x09, 0x46, 0xbb, 0x2b, 0x91, 0x79, 0x4d, 0x02, 0x18, 0x9b,
+	0x8f, 0xa1, 0x21, 0xdd, 0x15, 0x23, 0x73, 0x12, 0x2c, 0x2b, 0x5c, 0x90,
+	0x1a, 0x65, 0xcc, 0x1f, 0x3f, 0x52, 0xf0, 0x95, 0x24, 0xb0, 0x98, 0xa2,
+	0x49, 0xb1, 0xb7, 0xb4, 0x30, 0x89, 0x33, 0x24, 0x6f, 0x58, 0x0c, 0xcc,
+	0x7c, 0x8d, 0xc0, 0x16, 0xbf, 0x07, 0x09, 0x69, 0x90, 0xae, 0x03, 0x29,
+	0xc5, 0xfb, 0xa4, 0x79, 0x23, 0x4c, 0xf1, 0xcf, 0x30, 0x62, 0x83, 0xef,
+	0x41, 0x0b, 0x5c, 0xb5, 0x03, 0x70, 0x7f, 0x71, 0x29, 0x0a, 0xf4, 0x0b,
+	0x19, 0x7b, 0x25, 0x20, 0xfb, 0x8c, 0x7c, 0x2c, 0x82, 0x96, 0x44, 0xa9,
+	0x8b, 0xab, 0x3a, 0x2a, 0xcc, 0xc0, 0x58, 0xaf, 0x0b, 0xa0, 0x45, 0xf4,
+	0x2a, 0x9f, 0x28, 0x0e, 0xf7, 0xc6, 0xc3, 0x20, 0x51, 0xd0, 0xff, 0x6a,
+	0x1b, 0x6c, 0x23, 0xc9, 0x36, 0x6f, 0xfe, 0x0c, 0x05, 0x39, 0x79, 0xf1,
+	0xd0, 0x6a, 0xd1, 0x76, 0xb0, 0xfe, 0x59, 0x48, 0xd3, 0x2e, 0x87, 0x77,
+	0xaf, 0x9c, 0xfa, 0xe2, 0x8b, 0xe6, 0x0f, 0x0c, 0xd7, 0xbc, 0x7b, 0x96,
+	0xcf, 0x84, 0x26, 0x2c, 0xc1, 0x68, 0x01, 0xa3, 0xab, 0x03, 0xda, 0xe1,
+	0x5e, 0xa9, 0xb7, 0xa4, 0xfd, 0x88, 0x2f, 0x5c, 0x69, 0x44, 0x2f, 0x03,
+	0x5e, 0xb2, 0xba, 0x44, 0xf9, 0xc2, 0xeb, 0x41, 0xff, 0x5b, 0x5e, 0x06,
+	0x8d, 0x32, 0x2a, 0x0f, 0xc8, 0x53, 0x0d, 0x9e, 0x1f, 0x87, 0xe7, 0x52,
+	0xa9, 0xba, 0xf1, 0xbb, 0x64, 0x5b, 0xf5, 0x06, 0xda, 0x92, 0x2c, 0x75,
+	0x8c, 0x80, 0xe1, 0xf4, 0xf7, 0x6a, 0xeb, 0x8a, 0x85, 0x08, 0x7a, 0xb4,
+	0x4b, 0x9d, 0xb6, 0xdf, 0x47, 0x87, 0x3b, 0x30, 0xbc, 0x01, 0xf6, 0x29,
+	0x10, 0x71, 0xa7, 0xe0, 0xfc, 0xfa, 0x36, 0x5e, 0xf2, 0xfd, 0xf2, 0x3e,
+	0xda, 0x9c, 0x90, 0x6f, 0x8c, 0x37, 0x38, 0xa6, 0x78, 0x07, 0x6e, 0xcd,
+	0x87, 0x56, 0xe9, 0xcd, 0xc7, 0xc6, 0xae, 0x92, 0x1f, 0x22, 0x04, 0xce,
+	0xd9, 0xee, 0x5f, 0x8f, 0xb9, 0xd3, 0x85, 0x1d, 0x49, 0xc2, 0x00, 0x13,
+	0x33, 0x78, 0xd8, 0xf0, 0xfe, 0x05, 0x12, 0xd1, 0x9e, 0x07, 0x42, 0x6c,
+	0x83, 0x92, 0x56, 0x60, 0x41, 0xb6, 0xe0, 0x3b, 0xf9, 0x67, 0x32, 0x01,
+	0x6e, 0x46, 0x74, 0x56, 0x12, 0x76, 0x51, 0x5c, 0xf3, 0x89, 0x89, 0x9d,
+	0x80, 0x36, 0x75, 0x04, 0x2a, 0x4a, 0x0a, 0x92, 0x22, 0xd7, 0x16, 0x51,
+	0x91, 0xc8, 0xaa, 0x43, 0x8e, 0x19, 0x93, 0xc7, 0x12, 0x6e, 0x0e, 0x71,
+	0x5d, 0xc7, 0xb4, 0xac, 0x26, 0xde, 0x13, 0xa7, 0x5b, 0xff, 0xe3, 0x25,
+	0x62, 0xba, 0xa0, 0x2c, 0xcf, 0x2a, 0x57, 0xbf, 0x01, 0x20, 0x2b, 0xd2,
+	0x7a, 0x2e, 0xfd, 0x8e, 0x94, 0x23, 0x44, 0x6b, 0x3b, 0x6f, 0x7b, 0x8f,
+	0xd9, 0xfc, 0xe1, 0x39, 0xd0, 0x9d, 0x42, 0xcb, 0x1d, 0x9f, 0x0d, 0x79,
+	0x46, 0x76, 0x91, 0xca, 0x32, 0x90, 0x09, 0x76, 0xa4, 0x59, 0xcf, 0x98,
+	0x0c, 0xc5, 0x98, 0xb5, 0xd1, 0x39, 0x37, 0xa1, 0x71, 0xbf, 0x1f, 0x22,
+	0x08, 0x69, 0x84, 0xae, 0x9f, 0x95, 0x09, 0xea, 0xfa, 0x69, 0x68, 0xec,
+	0xb2, 0xf3, 0xdf, 0x80, 0xa8, 0x6e, 0xf9, 0x9f, 0x45, 0xde, 0xa3, 0x53,
+	0xfa, 0x59, 0x3e, 0x76, 0x65, 0xb2, 0xb1, 0x8d, 0xbf, 0x3c, 0x6b, 0xf0,
+	0x22, 0x53, 0xd8, 0xdf, 0x70, 0xfd, 0x12, 0x66, 0x3c, 0xee, 0x70, 0x25,
+	0x95, 0x6f, 0x72, 0x46, 0xe3, 0x7e, 0xe0, 0x3d, 0x33, 0x82, 0xd1, 0x8d,
+	0xf3, 0x67, 0x54, 0x4e, 0x91, 0x34, 0xa8, 0xba, 0xfe, 0xd4, 0x22, 0x26,
+	0x4e, 0xda, 0xbb, 0xa7, 0x71, 0x6e, 0x1e, 0x93, 0x0e, 0x81, 0x22, 0xab,
+	0xfb, 0xa7, 0x3d, 0x3b, 0xef, 0xe8, 0x6e, 0xc3, 0xbe, 0x30, 0x2c, 0x4e,
+	0x7f, 0x95, 0x4e, 0x4a, 0x72, 0x63, 0xe9, 0x3f, 0x03, 0x97, 0xf5, 0xc9,
+	0x9b, 0x04, 0xe9, 0x5f, 0x55, 0x8d, 0x81, 0x90, 0x2c, 0x7a, 0x87, 0x42,
+	0x12, 0x21, 0x57, 0x40, 0x0c, 0x65, 0x1f, 0xad, 0x41, 0x4c, 0xbc, 0x82,
+	0x7c, 0x99, 0x50, 0xae, 0xfe, 0xc4, 0x19, 0xe8, 0x18, 0x43, 0x13, 0x8b,
+	0xc4, 0xd3, 0x63, 0x85, 0xcf, 0xcc, 0x4e, 0x14, 0x31, 0x69, 0x9e, 0x74,
+	0x76, 0x79, 0x2e, 0xee, 0x66, 0xc8, 0x9a, 0xc8, 0xe0, 0xeb, 0xd9, 0x4b,
+	0xd3, 0x50, 0xfc, 0xa2, 0xd9, 0x6f, 0xa8, 0xe5, 0x5a, 0x1d, 0xa3, 0xda,
+	0xb4, 0x0f, 0x8d, 0x26, 0x38, 0x5f, 0x1c, 0x58, 0x90, 0x67, 0xd3, 0x0a,
+	0x59, 0xba, 0x20, 0x74,
+};
+
+static const uint8_t zstd_random_frame[522] = {
+	0x28, 0xb5, 0x2f, 0xfd, 0x60, 0x00, 0x01, 0x01, 0x10, 0x00, 0x71, 0x24,
+	0xff, 0x4e, 0x9d, 0x3a, 0xa3, 0x9b, 0xe9, 0xe2, 0xb2, 0x42, 0x1b, 0x03,
+	0x2c, 0x7f, 0xb2, 0xe0, 0x1e, 0x57, 0x53, 0xdc, 0xc0, 0x9c, 0x6d, 0x16,
+	0x81, 0x80, 0x93, 0x5e, 0x8e, 0x50, 0x11, 0x06, 0x56, 0xb7, 0x36, 0x05,
+	0x7c, 0x20, 0xd8, 0xf4, 0xca, 0xb1, 0x90, 0x64, 0x97, 0x5d, 0x2d, 0x0d,
+	0x27, 0x8c, 0xe1, 0x53, 0x84, 0xdd, 0xa2, 0xa0, 0x4a, 0x80, 0x47, 0x20,
+	0xf0, 0xa6, 0xdb, 0x47, 0x0b, 0x8e, 0xa9, 0xbd, 0x00, 0xa1, 0x80, 0x18,
+	0xb5, 0x30, 0xab, 0xf4, 0xbe, 0x46, 0x2a, 0xdb, 0x72, 0x0b, 0x9a, 0x91,
+	0x8e, 0x50, 0x59, 0x30, 0xba, 0x9d, 0x61, 0x9a, 0x9a, 0x6c, 0x5e, 0xc9,
+	0xc6, 0xed, 0x77, 0x76, 0x45, 0xe8, 0x50, 0x93, 0xfd, 0x3a, 0xcb, 0x25,
+	0x98, 0x63, 0xf7, 0xea, 0x66, 0xb1, 0xbc, 0x6a, 0xb4, 0x7f, 0xbf, 0xc7,
+	0x1a, 0x13, 0x00, 0xfe, 0x42, 0x8d, 0xa9, 0xef, 0xad, 0x6f, 0x9d, 0xc2,
+	0xe3, 0x41, 0x38, 0x27, 0xa6, 0xcb, 0xd1, 0xea, 0x9c, 0x62, 0x64, 0x60,
+	0xeb, 0xd7, 0x06, 0x2f, 0x4f, 0x75, 0x85, 0xe9, 0x2f, 0x9c, 0xc4, 0x01,
+	0x21, 0x73, 0x4b, 0x9d, 0x68, 0x2f, 0x9b, 0xb6, 0xf0, 0x77, 0xa7, 0x17,
+	0x39, 0x5c, 0x19, 0xb7, 0xc2, 0x6b, 0xbf, 0xdf, 0x66, 0x58, 0xb7, 0xb5,
+	0x35, 0xbd, 0xd9, 0x98, 0x41, 0x74, 0xca, 0xd5, 0xec, 0x0b, 0x53, 0x35,
+	0x1e, 0xc9, 0x70, 0xe3, 0x04, 0xd4, 0x8c, 0x27, 0xbd, 0xe9, 0x85, 0x7e,
+	0x80, 0x2b, 0xd7, 0x89, 0xc0, 0x91, 0x8f, 0x4e, 0xbc, 0x62, 0x6a, 0x58,
+	0x18, 0x56, 0xb2, 0x2d, 0xda, 0xbe, 0x50, 0x9b, 0x75, 0x57, 0x9a, 0x5c,
+	0x35, 0x24, 0x55, 0x98, 0xb7, 0xed, 0x71, 0xb3, 0xcd, 0xcd, 0xfc, 0x02,
+	0x5e, 0x5b, 0xcc, 0xcd, 0xbd, 0xf0, 0x68, 0x2b, 0xf8, 0x7b, 0x9b, 0x3c,
+	0xa4, 0x78, 0x51, 0x30, 0x95, 0x74, 0x1a, 0xb6, 0x1b, 0xb2, 0xf3, 0x2e,
+	0x30, 0x64, 0xbf, 0x48, 0x21, 0xfa, 0xfc, 0x6d, 0x29, 0x12, 0x2e, 0x85,
+	0x8d, 0x70, 0x80, 0x95, 0xab, 0xa1, 0x24, 0xb4, 0x7f, 0xa4, 0xe4, 0xda,
+	0x24, 0x3c, 0x6d, 0x02, 0xcc, 0x48, 0xd2, 0x2d, 0xaf, 0xc7, 0xcc, 0xb1,
+	0x72, 0xe0, 0x27, 0x6d, 0x87, 0x91, 0xf2, 0x4a, 0x05, 0x6f, 0xe3, 0x99,
+	0x77, 0x01, 0x6d, 0xca, 0x23, 0x2d, 0x1a, 0xf9, 0x4a, 0x48, 0x93, 0xd4,
+	0xe0, 0x32, 0xe4, 0x56, 0x39, 0x12, 0x77, 0xe0, 0x36, 0x27, 0x4b, 0x25,
+	0x5f, 0x32, 0xd9, 0x6e, 0x7b, 0xf7, 0x3f, 0xb9, 0x23, 0x56, 0x13, 0x2f,
+	0xc7, 0x7e, 0x80, 0x72, 0xae, 0xb6, 0x0a, 0x3e, 0x6d, 0x3b, 0x96, 0xee,
+	0x58, 0xc1, 0x20, 0x49, 0x67, 0xfc, 0xb8, 0x38, 0x18, 0xd2, 0x22, 0xc4,
+	0xc5, 0x93, 0xc3, 0xf9, 0xf5, 0xdc, 0x37, 0x18, 0x21, 0x82, 0x27, 0xa7,
+	0x76, 0x1e, 0xd3, 0xd5, 0x0b, 0xad, 0xd7, 0xb6, 0x10, 0xcd, 0xa6, 0xde,
+	0x79, 0x0a, 0x3c, 0xc8, 0x99, 0xca, 0x8a, 0x9f, 0x3c, 0x4e, 0x1e, 0xdb,
+	0xb5, 0x4e, 0x76, 0x36, 0x69, 0xa4, 0x9c, 0x7b, 0x4a, 0x9d, 0x6b, 0xa9,
+	0xd0, 0x54, 0x18, 0xf3, 0xea, 0xb2, 0x67, 0x13, 0x65, 0x7b, 0x26, 0x79,
+	0x49, 0xf6, 0x52, 0xd2, 0xb5, 0xb4, 0x7f, 0x63, 0xab, 0xe6, 0xf1, 0xbe,
+	0x56, 0xcf, 0xef, 0x52, 0x50, 0xcc, 0xd3, 0x50, 0x53, 0x7b, 0x46, 0x67,
+	0xec, 0x6c, 0x43, 0xda, 0xa1, 0xfa, 0x46, 0x6e, 0x10, 0xb0, 0x39, 0xb1,
+	0x89, 0xce, 0x96, 0x13, 0x9c, 0x60, 0x45, 0x61, 0x1f, 0x6d, 0xb0, 0x0e,
+	0x30, 0xc9, 0x88, 0xdc, 0xad, 0xec, 0xd1, 0x55, 0x9e, 0x74, 0x98, 0xa6,
+	0x24, 0xb2, 0xea, 0x4a, 0x53, 0xd5, 0x7c, 0x0e, 0x8e, 0x29, 0x91, 0xf0,
+	0xd0, 0xf6, 0x93, 0x54, 0x7a, 0x6b,
+};
+
+static const uint8_t zstd_mixed_frame[861] = {
+	0x28, 0xb5, 0x2f, 0xfd, 0x00, 0x58, 0x54, 0x00, 0x00, 0x10, 0x00, 0x00,
+	0x01, 0x00, 0xfb, 0xff, 0x39, 0xc0, 0x02, 0xdc, 0x19, 0x00, 0xd2, 0xcf,
+	0x29, 0x1b, 0x70, 0x49, 0xda, 0x06, 0x24, 0xe5, 0x7f, 0xbb, 0xb6, 0x79,
+	0x2b, 0xd1, 0x6c, 0xa1, 0x56, 0xff, 0xbf, 0x44, 0x00, 0xaa, 0x00, 0x03,
+	0xf7, 0x7f, 0x56, 0x06, 0x1d, 0x2f, 0x48, 0xce, 0x14, 0x12, 0x10, 0x0e,
+	0x0c, 0x0a, 0x08, 0x06, 0x04, 0x02, 0xca, 0xf6, 0x2d, 0x1a, 0x79, 0xd6,
+	0x2d, 0xba, 0x98, 0x35, 0x5b, 0x4f, 0xb3, 0x4f, 0x9b, 0x79, 0xd1, 0xac,
+	0x4f, 0x4f, 0x7d, 0xaa, 0xb2, 0x62, 0xd6, 0xfa, 0x54, 0xb5, 0x78, 0x59,
+	0xdc, 0xb3, 0x9e, 0xf5, 0xb4, 0x5d, 0xe6, 0xe7, 0x53, 0x9f, 0x4c, 0x8c,
+	0x6c, 0xa6, 0xcf, 0xa1, 0x07, 0xb3, 0x6f, 0xf1, 0x59, 0xb6, 0x59, 0x9f,
+	0xcc, 0xf4, 0xc9, 0x4f, 0x7d, 0x32, 0xb3, 0x8b, 0x05, 0x25, 0x8c, 0x62,
+	0xd6, 0x5c, 0xcc, 0x5a, 0x99, 0xe9, 0xd3, 0x39, 0xf4, 0x70, 0x8b, 0x55,
+	0x50, 0xc2, 0x20, 0x2e, 0x8a, 0x81, 0x28, 0x86, 0xa7, 0x3e, 0x95, 0x41,
+	0x0f, 0x22, 0x43, 0xd4, 0x65, 0x71, 0xa5, 0x4f, 0x85, 0x96, 0x05, 0x5a,
+	0x16, 0xf6, 0x66, 0x5e, 0x11, 0x84, 0x50, 0xad, 0x4f, 0xc5, 0x6c, 0xdd,
+	0xa2, 0xcb, 0x82, 0xa1, 0x53, 0x46, 0x9e, 0x3d, 0x8b, 0xb0, 0x03, 0x20,
+	0x81, 0x49, 0xa8, 0xb1, 0x22, 0x22, 0x49, 0x52, 0x2b, 0x8d, 0x01, 0x31,
+	0x04, 0x15, 0x84, 0x49, 0xeb, 0xa5, 0x0f, 0x12, 0x40, 0xc0, 0x81, 0x96,
+	0xa8, 0x89, 0xd8, 0x15, 0x51, 0x8d, 0xfd, 0xff, 0x7f, 0x0e, 0xea, 0xcd,
+	0x23, 0xfd, 0x44, 0x50, 0x02, 0x17, 0x77, 0x7d, 0x8a, 0x62, 0xf5, 0x7f,
+	0xe9, 0xd2, 0xda, 0x2a, 0x20, 0xcd, 0xd8, 0x43, 0x91, 0xfd, 0xd4, 0xb2,
+	0x32, 0x12, 0x81, 0xc7, 0x0a, 0x37, 0x8e, 0xe7, 0xbd, 0xec, 0x31, 0x53,
+	0xfe, 0xc5, 0xa2, 0xff, 0x59, 0x4a, 0xb6, 0x15, 0x15, 0xd0, 0xf5, 0xec,
+	0xf7, 0xd1, 0x3b, 0x41, 0x34, 0x6b, 0x8c, 0xd4, 0x90, 0x9e, 0x4a, 0xa6,
+	0x36, 0x10, 0x78, 0x45, 0x41, 0x5d, 0x16, 0x51, 0x9b, 0x28, 0x53, 0x71,
+	0x08, 0xaa, 0x05, 0xd9, 0xcf, 0x3e, 0xa2, 0x90, 0x5a, 0x91, 0x28, 0x7f,
+	0x3b, 0xbc, 0x94, 0x32, 0xa7, 0x56, 0x54, 0x3c, 0x3b, 0x0d, 0x5a, 0x16,
+	0x12, 0x77, 0x76, 0x55, 0xc3, 0xa4, 0x88, 0x5a, 0x18, 0x7c, 0x12, 0x3d,
+	0x18, 0xc3, 0xf2, 0x19, 0x91, 0x89, 0xe4, 0xc8, 0xa6, 0x9a, 0x3d, 0x44,
+	0x27, 0xc3, 0x43, 0x13, 0xb8, 0x8f, 0xe0, 0x39, 0x13, 0xab, 0x4f, 0x8a,
+	0xdb, 0x25, 0x16, 0x72, 0xb0, 0x43, 0x8c, 0x41, 0x37, 0xf4, 0x7b, 0x4a,
+	0xf2, 0xd0, 0x77, 0xc1, 0x28, 0x97, 0x26, 0x7a, 0x4c, 0xb9, 0xd9, 0x83,
+	0xe4, 0x13, 0xf0, 0x80, 0x2b, 0x98, 0xc1, 0xbb, 0x71, 0x77, 0x1d, 0xda,
+	0xb4, 0xa1, 0xf6, 0x84, 0x52, 0x66, 0xc6, 0xab, 0x92, 0x0d, 0x44, 0x23,
+	0xa0, 0xea, 0xb6, 0xa3, 0x26, 0x04, 0x67, 0x4d, 0xb4, 0x23, 0x2d, 0xc9,
+	0xe7, 0x1c, 0x04, 0xc1, 0xf9, 0x93, 0x14, 0x48, 0x4f, 0xb4, 0x30, 0x5a,
+	0xeb, 0xe0, 0x13, 0x9b, 0x92, 0xdf, 0xb4, 0xe1, 0xae, 0xea, 0x14, 0xbd,
+	0xb3, 0x78, 0x27, 0x9c, 0xf7, 0x8e, 0x73, 0x40, 0x18, 0xd2, 0x57, 0x48,
+	0xa4, 0x18, 0x71, 0x3d, 0xa9, 0x63, 0x3b, 0xf7, 0x14, 0x2a, 0x78, 0x3c,
+	0xf0, 0x22, 0x66, 0xe9, 0x39, 0x75, 0x85, 0x41, 0x17, 0x9a, 0xe8, 0x00,
+	0xdd, 0x6a, 0xa5, 0xf1, 0x20, 0x7e, 0xf5, 0x5a, 0x2f, 0x1f, 0x5b, 0x7a,
+	0xf3, 0xd2, 0xd5, 0xdf, 0x5e, 0x82, 0xa2, 0x26, 0x9b, 0x30, 0x64, 0x3b,
+	0x26, 0x33, 0x0c, 0x3c, 0xb3, 0x05, 0x09, 0x28, 0x14, 0xd9, 0xe5, 0x61,
+	0x60, 0x5a, 0x10, 0xda, 0x10, 0x20, 0xfe, 0x66, 0x7d, 0x19, 0xab, 0x73,
+	0x94, 0x5f, 0x24, 0x10, 0x38, 0xc0, 0xeb, 0x2d, 0xaf, 0x66, 0x9c, 0x58,
+	0x3d, 0xd0, 0x93, 0xcf, 0x79, 0xab, 0x74, 0x43, 0x27, 0x76, 0xd3, 0xe2,
+	0x5e, 0xc1, 0x45, 0xa9, 0x38, 0xf7, 0x90, 0x66, 0x43, 0x4b, 0x9f, 0x77,
+	0x65, 0xf4, 0x94, 0x36, 0x50, 0xff, 0x5d, 0xb0, 0xc6, 0xdc, 0xe2, 0xa3,
+	0xbd, 0x8f, 0xfa, 0x8c, 0xa2, 0x6b, 0xaa, 0x15, 0xd3, 0x01, 0x3e, 0xf4,
+	0x0b, 0x47, 0xb0, 0xf3, 0x61, 0x42, 0x3b, 0x5a, 0x89, 0x61, 0x60, 0xcb,
+	0xb0, 0x79, 0x41, 0x3c, 0x21, 0x44, 0x05, 0x14, 0xc7, 0x90, 0x62, 0xba,
+	0x78, 0x97, 0xed, 0x4d, 0x98, 0xce, 0x40, 0x05, 0xb8, 0x14, 0x39, 0x2d,
+	0x61, 0xdc, 0x4a, 0xd9, 0x83, 0x8e, 0x92, 0xa4, 0xf2, 0xb6, 0xa3, 0x28,
+	0x8b, 0xc6, 0xb9, 0x4e, 0x11, 0x3f, 0x9c, 0x8f, 0xd4, 0x7c, 0xf3, 0xcc,
+	0x07, 0x60, 0xda, 0x00, 0xfc, 0x92, 0x1c, 0xf5, 0x40, 0x02, 0xae, 0x55,
+	0xc2, 0x85, 0xc5, 0x74, 0xff, 0x7b, 0x4b, 0xf8, 0x17, 0xe3, 0x3b, 0x83,
+	0x71, 0x75, 0xf3, 0xb0, 0x26, 0xd1, 0xa7, 0x94, 0x55, 0x22, 0x57, 0x9e,
+	0x27, 0x1a, 0xb8, 0x0f, 0x3c, 0xf0, 0xea, 0x39, 0xc0, 0x4f, 0xd7, 0x3c,
+	0x38, 0x88, 0xb8, 0xbf, 0x29, 0xa0, 0xa1, 0x70, 0xb2, 0x98, 0x3a, 0x89,
+	0x11, 0xb7, 0xd8, 0x36, 0x06, 0x5f, 0xac, 0x41, 0xdd, 0x50, 0x60, 0xf1,
+	0xcd, 0xa8, 0x05, 0xc4, 0x96, 0xab, 0x0d, 0xba, 0x25, 0x4e, 0x88, 0xd4,
+	0xbb, 0x68, 0xd2, 0x62, 0x91, 0x35, 0x70, 0x83, 0x52, 0x8b, 0x69, 0xa6,
+	0xdb, 0xe0, 0x49, 0x57, 0xce, 0xa6, 0xe7, 0x6d, 0xd8, 0x99, 0x97, 0x2b,
+	0xc5, 0x29, 0xc1, 0x83, 0xd2, 0x4a, 0x6b, 0x23, 0xa3, 0xad, 0x5d, 0x09,
+	0x00, 0x43, 0x43, 0x81, 0xfc, 0x5f, 0x91, 0x11, 0xb9, 0x20, 0x41, 0x53,
+	0x51, 0x95, 0x8d, 0x46, 0x01, 0x00, 0x1a, 0x1d, 0x38, 0xe1, 0xec, 0x1c,
+	0xa8, 0x0a, 0x62, 0xa3, 0xda, 0x01, 0x03, 0x84, 0x5c, 0x6f, 0xbb, 0xa7,
+	0xda, 0xb4, 0x95, 0x95, 0xef, 0xbd, 0xc4, 0xa2, 0x7e, 0xd6, 0xa1, 0xc5,
+	0xe2, 0xa1, 0xe1, 0x55, 0xc8, 0x70, 0x53, 0x04, 0x34, 0xba, 0xed, 0xf7,
+	0x76, 0x4f, 0xef, 0x37, 0x37, 0x52, 0x35, 0x02, 0xe5, 0x13, 0x09, 0x00,
+	0x40, 0xfb, 0x0d, 0x4b, 0xf1, 0x34, 0xb4, 0x00, 0x3d, 0x4d, 0x00, 0x00,
+	0x08, 0x38, 0x01, 0x00, 0x94, 0x1f, 0x1d, 0x08, 0x01,
+};
+
+
+static const char *const zstd_words[] = {
+	"cboot", "kernel", "ramdisk", "partition", "sdmmc", "ufs", "qspi", "nvme",
+	"the", "of", "a", "boot", "load", "image", "dtb", "blob",
+};
+
+static uint32_t zstd_lcg(uint32_t *seed)
+{
+	*seed = (*seed * 1103515245U) + 12345U;
+	return *seed >> 16;
+}
+
+static void zstd_gen_text(uint8_t *buf, size_t size, uint32_t seed)
+{
+	const char *word;
+	size_t len;
+	size_t n = 0;
+
+	while (n < size) {
+		word = zstd_words[zstd_lcg(&seed) % 16U];
+		len = strlen(word);
+		if (len > (size - n)) {
+			len = size - n;
+		}
+		memcpy(buf + n, word, len);
+		n += len;
+		if (n < size) {
+			buf[n++] = ((zstd_lcg(&seed) % 8U) == 0U) ? '\n' : ' ';
+		}
+	}
+}
+
+static void zstd_gen_random(uint8_t *buf, size_t size, uint32_t seed)
+{
+	size_t i;
+
+	for (i = 0; i < size; i++) {
+		buf[i] = (uint8_t)(zstd_lcg(&seed) >> 3);
+	}
+}
+
+static void zstd_gen_mixed(uint8_t *buf)
+{
+	size_t i;
+
+	memset(buf, 0, 200000);
+	zstd_gen_text(buf + 200000, 3000, 3);
+	for (i = 0; i < 100000U; i++) {
+		buf[203000U + i] = (uint8_t)"0123456789abcdef"[i % 16U];
+	}
+}
+
+/* One-shot decode through the decompressor table, as the kernel loader does */
+static tegrabl_error_t zstd_decode(const uint8_t *in, uint32_t in_size, uint8_t *out, uint32_t *out_size)
+{
+	decompressor *decomp = NULL;
+	uint8_t *copy;
+	tegrabl_error_t err;
+
+	copy = malloc(in_size);
+	memcpy(copy, in, in_size);
+	if (!is_compressed_content(copy, &decomp) || (strcmp(decomp->name, "zstd") != 0)) {
+		free(copy);
+		return TEGRABL_ERR_NOT_SUPPORTED;
+	}
+	err = do_decompress(decomp, copy, in_size, out, out_size);
+	free(copy);
+
+	return err;
+}
+
+static void test_text_frame(void)
+{
+	uint8_t expect[ZSTD_TEXT_SIZE];
+	uint8_t out[ZSTD_TEXT_SIZE + 64U];
+	uint32_t out_size = sizeof(out);
+
+	zstd_gen_text(expect, sizeof(expect), 1);
+	CHECK_EQ(zstd_decode(zstd_text_frame, sizeof(zstd_text_frame), out, &out_size), TEGRABL_NO_ERROR);
+	CHECK_EQ(out_size, ZSTD_TEXT_SIZE);
+	CHECK(memcmp(out, expect, sizeof(expect)) == 0);
+}
+
+static void test_raw_block(void)
+{
+	uint8_t expect[ZSTD_RANDOM_SIZE];
+	uint8_t out[ZSTD_RANDOM_SIZE];
+	uint32_t out_size = sizeof(out);
+
+	zstd_gen_random(expect, sizeof(expect), 2);
+	CHECK_EQ(zstd_decode(zstd_random_frame, sizeof(zstd_random_frame), out, &out_size), TEGRABL_NO_ERROR);
+	CHECK_EQ(out_size, ZSTD_RANDOM_SIZE);
+	CHECK(memcmp(out, expect, sizeof(expect)) == 0);
+}
+
+static void test_multi_block(void)
+{
+	uint8_t *expect = malloc(ZSTD_MIXED_SIZE);
+	uint8_t *out = malloc(ZSTD_MIXED_SIZE);
+	uint32_t out_size = ZSTD_MIXED_SIZE;
+
+	zstd_gen_mixed(expect);
+	CHECK_EQ(zstd_decode(zstd_mixed_frame, sizeof(zstd_mixed_frame), out, &out_size), TEGRABL_NO_ERROR);
+	CHECK_EQ(out_size, ZSTD_MIXED_SIZE);
+	CHECK(memcmp(out, expect, ZSTD_MIXED_SIZE) == 0);
+
+	free(expect);
+	free(out);
+}
+
+/* Skippable frame, two frames back to back and zero padding up to a partition size */
+static void test_concatenated_frames(void)
+{
+	static const uint8_t skippable[] = { 0x50, 0x2a, 0x4d, 0x18, 0x03, 0x00, 0x00, 0x00, 0xde, 0xad, 0x00 };
+	uint8_t expect[ZSTD_TEXT_SIZE + ZSTD_RANDOM_SIZE];
+	uint8_t out[ZSTD_TEXT_SIZE + ZSTD_RANDOM_SIZE];
+	uint8_t *in;
+	uint32_t in_size;
+	uint32_t out_size = sizeof(out);
+	decompressor *decomp = NULL;
+
+	in_size = sizeof(zstd_text_frame) + sizeof(skippable) + sizeof(zstd_random_frame) + 4096U;
+	in = calloc(1, in_size);
+	memcpy(in, zstd_text_frame, sizeof(zstd_text_frame));
+	memcpy(in + sizeof(zstd_text_frame), skippable, sizeof(skippable));
+	memcpy(in + sizeof(zstd_text_frame) + sizeof(skippable), zstd_random_frame, sizeof(zstd_random_frame));
+
+	zstd_gen_text(expect, ZSTD_TEXT_SIZE, 1);
+	zstd_gen_random(expect + ZSTD_TEXT_SIZE, ZSTD_RANDOM_SIZE, 2);
+
+	CHECK(is_compressed_content(in, &decomp));
+	CHECK_EQ(do_decompress(decomp, in, in_size, out, &out_size), TEGRABL_NO_ERROR);
+	CHECK_EQ(out_size, sizeof(expect));
+	CHECK(memcmp(out, expect, sizeof(expect)) == 0);
+
+	free(in);
+}
+
+static void test_bad_checksum(void)
+{
+	uint8_t in[sizeof(zstd_text_frame)];
+	uint8_t out[ZSTD_TEXT_SIZE];
+	uint32_t out_size = sizeof(out);
+
+	memcpy(in, zstd_text_frame, sizeof(in));
+	in[sizeof(in) - 1U] ^= 0x01U;
+	CHECK(zstd_decode(in, sizeof(in), out, &out_size) != TEGRABL_NO_ERROR);
+}
+
+static void test_truncated(void)
+{
+	uint8_t out[ZSTD_TEXT_SIZE];
+	uint32_t out_size = sizeof(out);
+
+	CHECK(zstd_decode(zstd_text_frame, sizeof(zstd_text_frame) - 100U, out, &out_size) != TEGRABL_NO_ERROR);
+}
+
+static void test_output_too_small(void)
+{
+	uint8_t out[ZSTD_TEXT_SIZE + 16U];
+	uint32_t out_size = ZSTD_TEXT_SIZE - 1U;
+
+	/* The guard bytes past the given size must stay untouched */
+	memset(out, 0x5a, sizeof(out));
+	CHECK(zstd_decode(zstd_text_frame, sizeof(zstd_text_frame), out, &out_size) != TEGRABL_NO_ERROR);
+	CHECK_EQ(out[ZSTD_TEXT_SIZE - 1U], 0x5aU);
+	CHECK_EQ(out[ZSTD_TEXT_SIZE], 0x5aU);
+}
+
+/* The stream API must not care where the input is split */
+static void test_stream_chunks(void)
+{
+	static const uint32_t chunk_sizes[] = { 1, 3, 7, 64, 1000, 100000 };
+	uint8_t *expect = malloc(ZSTD_MIXED_SIZE);
+	uint8_t *out = malloc(ZSTD_MIXED_SIZE);
+	struct tegrabl_zstd_stream *stream = NULL;
+	uint32_t written;
+	uint32_t offset;
+	uint32_t chunk;
+	uint32_t i;
+
+	zstd_gen_mixed(expect);
+
+	for (i = 0; i < (sizeof(chunk_sizes) / sizeof(chunk_sizes[0])); i++) {
+		memset(out, 0, ZSTD_MIXED_SIZE);
+		written = 0;
+		CHECK_EQ(tegrabl_zstd_stream_open(out, ZSTD_MIXED_SIZE, &stream), TEGRABL_NO_ERROR);
+		for (offset = 0; offset < sizeof(zstd_mixed_frame); offset += chunk) {
+			chunk = chunk_sizes[i];
+			if (chunk > (sizeof(zstd_mixed_frame) - offset)) {
+				chunk = sizeof(zstd_mixed_frame) - offset;
+			}
+			CHECK_EQ(tegrabl_zstd_stream_write(stream, zstd_mixed_frame + offset, chunk), TEGRABL_NO_ERROR);
+		}
+		CHECK_EQ(tegrabl_zstd_stream_close(stream, &written), TEGRABL_NO_ERROR);
+		CHECK_EQ(written, ZSTD_MIXED_SIZE);
+		CHECK(memcmp(out, expect, ZSTD_MIXED_SIZE) == 0);
+	}
+
+	free(expect);
+	free(out);
+}
+
+static void test_stream_ends_mid_frame(void)
+{
+	uint8_t out[ZSTD_TEXT_SIZE];
+	struct tegrabl_zstd_stream *stream = NULL;
+
+	CHECK_EQ(tegrabl_zstd_stream_open(out, sizeof(out), &stream), TEGRABL_NO_ERROR);
+	CHECK_EQ(tegrabl_zstd_stream_write(stream, zstd_text_frame, sizeof(zstd_text_frame) / 2U), TEGRABL_NO_ERROR);
+	CHECK(tegrabl_zstd_stream_close(stream, NULL) != TEGRABL_NO_ERROR);
+}
+
+int main(void)
+{
+	host_test_run("zstd: compressed blocks and checksum", test_text_frame);
+	host_test_run("zstd: raw block", test_raw_block);
+	host_test_run("zstd: several blocks without content size", test_multi_block);
+	host_test_run("zstd: skippable and concatenated frames", test_concatenated_frames);
+	host_test_run("zstd: bad checksum", test_bad_checksum);
+	host_test_run("zstd: truncated frame", test_truncated);
+	host_test_run("zstd: output buffer too small", test_output_too_small);
+	host_test_run("zstd: stream in chunks", test_stream_chunks);
+	host_test_run("zstd: stream ends mid frame", test_stream_ends_mid_frame);
+
+	return host_test_done();
+}
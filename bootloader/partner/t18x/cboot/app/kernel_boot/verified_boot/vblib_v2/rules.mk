@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2015-2018, NVIDIA Corporation.  All Rights Reserved.
+# Copyright (c) 2015-2021, NVIDIA Corporation.  All Rights Reserved.
 #
 # NVIDIA Corporation and its licensors retain all intellectual property and
 # proprietary rights in and to this software and related documentation.  Any
@@ -15,6 +15,8 @@ MODULE := $(LOCAL_DIR)
 MODULE_DEPS += \
 	../../common/lib/external/mincrypt \
 	../../common/lib/external/libavb \
+	../../common/lib/sha2 \
+	../../common/lib/workqueue \
 	../common/soc/t186/pkc_ops
 
 ifneq ($(TARGET_FAMILY), t19x)
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2018, NVIDIA Corporation.	All Rights Reserved.
+ * Copyright (c) 2015-2021, NVIDIA Corporation.	All Rights Reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property and
  * proprietary rights in and to this software and related documentation.  Any
@@ -30,6 +30,9 @@
 #include <tegrabl_exit.h>
 #include <tegrabl_cache.h>
 #include <tegrabl_linuxboot_helper.h>
+#include <tegrabl_profiler.h>
+#include <tegrabl_sha2.h>
+#include <tegrabl_workqueue.h>
 #include <libfdt.h>
 #include <libavb/libavb.h>
 
@@ -49,6 +52,43 @@ static inline AvbIOResult is_device_unlocked(AvbOps *ops, bool *is_unlocked)
 	return AVB_IO_RESULT_OK;
 }
 
+/*
+ * libavb hashes an image right after reading it. Reads of at least
+ * AVB_DEFERRED_READ_SIZE are therefore only recorded by read_from_partition()
+ * and done by hash_salt_image(), chunk by chunk, hashing each chunk on a
+ * work-queue core while the next one is read.
+ */
+#define AVB_DEFERRED_READ_SIZE (1024U * 1024U)
+#define AVB_HASH_CHUNK_SIZE (4U * 1024U * 1024U)
+
+struct avb_deferred_read {
+	struct tegrabl_partition part;
+	uint8_t *buffer;
+	size_t size;
+	bool pending;
+};
+
+struct avb_hash_chunk {
+	struct tegrabl_sha2_context *context;
+	const uint8_t *data;
+	size_t size;
+};
+
+static struct avb_deferred_read s_deferred_read;
+
+static tegrabl_error_t complete_deferred_read(void)
+{
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+
+	if (s_deferred_read.pending) {
+		s_deferred_read.pending = false;
+		err = tegrabl_partition_read(&s_deferred_read.part,
+									 s_deferred_read.buffer, s_deferred_read.size);
+	}
+
+	return err;
+}
+
 static void *boot_img_laddr;
 static void *kernel_dtb_laddr;
 static AvbIOResult read_from_partition(AvbOps *ops, const char *partition,
@@ -64,6 +104,11 @@ static AvbIOResult read_from_partition(AvbOps *ops, const char *partition,
 
 	TEGRABL_UNUSED(ops);
 
+	/* The previous image was not hashed the usual way, read it now */
+	if (complete_deferred_read() != TEGRABL_NO_ERROR) {
+		return AVB_IO_RESULT_ERROR_IO;
+	}
+
 	suffix = tegrabl_a_b_get_part_suffix(partition);
 	part_info = tegrabl_fastboot_get_partinfo(partition);
 	tegra_part_name = tegrabl_fastboot_get_tegra_part_name(suffix, part_info);
@@ -95,6 +140,18 @@ static AvbIOResult read_from_partition(AvbOps *ops, const char *partition,
 	if (err != TEGRABL_NO_ERROR) {
 		return AVB_IO_RESULT_ERROR_RANGE_OUTSIDE_PARTITION;
 	}
+
+	if (num_bytes >= AVB_DEFERRED_READ_SIZE) {
+		if ((uint64_t)offset + num_bytes > tegrabl_partition_size(&part)) {
+			return AVB_IO_RESULT_ERROR_RANGE_OUTSIDE_PARTITION;
+		}
+		s_deferred_read.part = part;
+		s_deferred_read.buffer = buffer;
+		s_deferred_read.size = num_bytes;
+		s_deferred_read.pending = true;
+		goto done;
+	}
+
 	err = tegrabl_partition_read(&part, buffer, num_bytes);
 	if (err != TEGRABL_NO_ERROR) {
 		return AVB_IO_RESULT_ERROR_IO;
@@ -133,44 +190,118 @@ static AvbIOResult get_unique_guid_for_partition(AvbOps *ops,
 	return AVB_IO_RESULT_OK;
 }
 
+static tegrabl_error_t hash_chunk(void *arg)
+{
+	struct avb_hash_chunk *chunk = (struct avb_hash_chunk *)arg;
+
+	return tegrabl_sha2_update(chunk->context, chunk->data, chunk->size);
+}
+
+/* Read the deferred image into payload and hash payload as it comes in */
+static tegrabl_error_t hash_deferred_read(struct tegrabl_sha2_context *context,
+										  const uint8_t *payload, size_t size)
+{
+	struct avb_deferred_read *rd = &s_deferred_read;
+	struct avb_hash_chunk chunk;
+	struct tegrabl_work work;
+	size_t done = 0;
+	size_t len;
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+	tegrabl_error_t hash_err = TEGRABL_NO_ERROR;
+
+	rd->pending = false;
+
+	/* Salt in front of the image */
+	err = tegrabl_sha2_update(context, payload, (size_t)(rd->buffer - payload));
+	if (err != TEGRABL_NO_ERROR) {
+		goto fail;
+	}
+
+	len = MIN(rd->size, AVB_HASH_CHUNK_SIZE);
+	err = tegrabl_partition_read(&rd->part, rd->buffer, len);
+	if (err != TEGRABL_NO_ERROR) {
+		goto fail;
+	}
+
+	while (done < rd->size) {
+		chunk.context = context;
+		chunk.data = rd->buffer + done;
+		chunk.size = len;
+		tegrabl_work_init(&work, hash_chunk, &chunk);
+		err = tegrabl_workqueue_submit(&work);
+		if (err != TEGRABL_NO_ERROR) {
+			goto fail;
+		}
+
+		done += len;
+		len = MIN(rd->size - done, AVB_HASH_CHUNK_SIZE);
+		if (len != 0UL) {
+			err = tegrabl_partition_read(&rd->part, rd->buffer + done, len);
+		}
+
+		/* The job uses chunk and work, it must finish even if the read failed */
+		hash_err = tegrabl_workqueue_wait(&work);
+		if (err == TEGRABL_NO_ERROR) {
+			err = hash_err;
+		}
+		if (err != TEGRABL_NO_ERROR) {
+			goto fail;
+		}
+	}
+
+	/* Anything libavb placed after the image */
+	err = tegrabl_sha2_update(context, rd->buffer + rd->size,
+							  (size_t)(payload + size - (rd->buffer + rd->size)));
+
+fail:
+	return err;
+}
+
 static AvbIOResult hash_salt_image(AvbOps *ops, const uint8_t *payload,
 								   size_t size, uint8_t *digest,
 								   const char *algorithm)
 {
-#if defined(IS_T186)
-	struct se_sha_input_params sha_input;
-	struct se_sha_context sha_context;
-#endif
+	struct tegrabl_sha2_context sha_context;
+	tegrabl_sha2_algo_t algo;
 	tegrabl_error_t ret = TEGRABL_NO_ERROR;
 
 	TEGRABL_UNUSED(ops);
 	TEGRABL_ASSERT(payload);
 	TEGRABL_ASSERT(digest);
 
-#if defined(IS_T186)
 	/* Vbmeta hash algorithm: SHA256, SHA512 */
 	if (!strcmp(algorithm, "sha512")) {
-		sha_context.hash_algorithm = SE_SHAMODE_SHA512;
+		algo = TEGRABL_SHA2_512;
 	} else if (!strcmp(algorithm, "sha256")) {
-		sha_context.hash_algorithm = SE_SHAMODE_SHA256;
+		algo = TEGRABL_SHA2_256;
 	} else {
 		pr_error("Hash algorithm not supported: %s\n", algorithm);
 		return AVB_IO_RESULT_ERROR_IO;
 	}
 
-	sha_context.input_size = (uint32_t)size;
-	sha_input.block_addr = (uintptr_t)payload;
-	sha_input.block_size = (uint32_t)size;
-	sha_input.size_left = (uint32_t)size;
-	sha_input.hash_addr = (uintptr_t)digest;
-
-	ret = tegrabl_se_sha_process_payload(&sha_input, &sha_context);
-#else
-	TEGRABL_UNUSED(algorithm);
-	ret = tegrabl_crypto_compute_sha2((uint8_t *)payload, size, digest);
-#endif
+	tegrabl_profiler_begin("hash");
+	ret = tegrabl_sha2_init(&sha_context, algo, size);
+	if (ret != TEGRABL_NO_ERROR) {
+		/* Nothing else can complete a deferred read into this payload */
+		if (complete_deferred_read() != TEGRABL_NO_ERROR) {
+			pr_error("Failed to read image\n");
+		}
+	} else if (s_deferred_read.pending && (s_deferred_read.buffer >= payload) &&
+			   ((s_deferred_read.buffer + s_deferred_read.size) <= (payload + size))) {
+		ret = hash_deferred_read(&sha_context, payload, size);
+	} else {
+		ret = complete_deferred_read();
+		if (ret == TEGRABL_NO_ERROR) {
+			ret = tegrabl_sha2_update(&sha_context, payload, size);
+		}
+	}
+	if (ret == TEGRABL_NO_ERROR) {
+		ret = tegrabl_sha2_final(&sha_context, digest);
+	}
+	tegrabl_profiler_end("hash");
 
 	if (ret != TEGRABL_NO_ERROR) {
+		pr_error("Failed to hash image (err 0x%08x)\n", ret);
 		return AVB_IO_RESULT_ERROR_IO;
 	}
 
@@ -281,6 +412,12 @@ status_t verified_boot_get_boot_state(boot_state_t *bs,
 							 AVB_HASHTREE_ERROR_MODE_RESTART_AND_INVALIDATE,
 							 slot_data);
 
+	/* libavb may have freed the buffer of a read it never hashed */
+	if (s_deferred_read.pending) {
+		pr_warn("Dropping unhashed read of %s\n", s_deferred_read.part.partition_info->name);
+		s_deferred_read.pending = false;
+	}
+
 	/**
 	 * Orange state:
 	 * Device is unlocked
@@ -0,0 +1,521 @@
+/*
+ * Copyright (c) 2021, NVIDIA Corporation.  All rights reserved.
+ *
+ * NVIDIA Corporation and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA Corporation is strictly prohibited.
+ */
+
+/*
+ * Minimal HTTP/1.1 client for network boot: one GET at a time, identity
+ * transfer coding only, body copied straight into the destination buffer.
+ */
+
+#include "lwip/apps/http_client.h"
+#include "lwip/ip_addr.h"
+#include "lwip/def.h"
+#include <string.h>
+#include <stdio.h>
+#include <kernel/thread.h>
+
+#if LWIP_TCP
+
+#include "lwip/tcp.h"
+#include "lwip/timeouts.h"
+
+#define HTTP_MAX_HEADER_SIZE           1024U
+#define HTTP_MAX_REQUEST_SIZE          256U
+#define HTTP_MAX_ATTEMPTS              5U
+#define HTTP_IDLE_TIMEOUT_MS           5000U
+#define HTTP_POLL_INTERVAL_MS          1U
+
+#define HTTP_STATUS_OK                 200U
+#define HTTP_STATUS_PARTIAL_CONTENT    206U
+
+#define PROGRESS_BAR                   1U
+#define PROGRESS_BAR_INTERVAL_BYTES    (1024U * 1024U)
+#define MIN_CONSOLE_ROW_SIZE           80U
+
+struct http_client_priv {
+    struct tcp_pcb *pcb;
+    ip_addr_t server_ip;
+    u16_t port;
+    const char *path;
+    u8_t *dst_mem_addr;
+    u32_t dst_size;
+    u32_t rcvd_bytes;
+    u32_t content_length;
+    bool has_length;
+    u16_t status;
+    char hdr[HTTP_MAX_HEADER_SIZE];
+    u32_t hdr_len;
+    bool is_hdr_done;
+    bool is_done;
+    err_t err;
+    time_t last_rx_time_ms;
+};
+
+static struct http_client_priv http_client;
+static char *prefix_str = "HTTP Client:";
+static u32_t bar_cnt;
+
+static u32_t
+parse_u32(const char *str, const char **next)
+{
+    u32_t val = 0;
+
+    while (*str == ' ') {
+        str++;
+    }
+    while ((*str >= '0') && (*str <= '9')) {
+        val = (val * 10U) + (u32_t)(*str - '0');
+        str++;
+    }
+    if (next != NULL) {
+        *next = str;
+    }
+
+    return val;
+}
+
+/* Returns the value of a header field, NULL if the response does not have it */
+static const char *
+find_field(const char *name)
+{
+    size_t name_len = strlen(name);
+    const char *line = http_client.hdr;
+
+    while ((line = strstr(line, "\r\n")) != NULL) {
+        line += 2;
+        if (lwip_strnicmp(line, name, name_len) == 0) {
+            return line + name_len;
+        }
+    }
+
+    return NULL;
+}
+
+static err_t
+parse_header(void)
+{
+    const char *val;
+    u32_t start;
+    u32_t total;
+
+    if (strncmp(http_client.hdr, "HTTP/1.", 7) != 0) {
+        LWIP_DEBUGF(HTTP_CLIENT_DEBUG | LWIP_DBG_STATE, ("%s Malformed response\n", prefix_str));
+        return ERR_VAL;
+    }
+    http_client.status = (u16_t)parse_u32(http_client.hdr + 8, NULL);
+
+    val = find_field("Transfer-Encoding:");
+    if (val != NULL) {
+        LWIP_DEBUGF(HTTP_CLIENT_DEBUG | LWIP_DBG_STATE, ("%s Transfer encodings not supported\n", prefix_str));
+        return ERR_VAL;
+    }
+
+    switch (http_client.status) {
+
+    case HTTP_STATUS_OK:
+        /* Whole file, also when a Range request was ignored by the server */
+        http_client.rcvd_bytes = 0;
+        http_client.has_length = false;
+        bar_cnt = 0;
+        val = find_field("Content-Length:");
+        if (val != NULL) {
+            http_client.content_length = parse_u32(val, NULL);
+            http_client.has_length = true;
+        }
+        break;
+
+    case HTTP_STATUS_PARTIAL_CONTENT:
+        /* Content-Range: bytes <start>-<end>/<total> */
+        val = find_field("Content-Range:");
+        if (val == NULL) {
+            return ERR_VAL;
+        }
+        while (*val == ' ') {
+            val++;
+        }
+        if (lwip_strnicmp(val, "bytes", 5) != 0) {
+            return ERR_VAL;
+        }
+        start = parse_u32(val + 5, &val);
+        if ((start != http_client.rcvd_bytes) || (*val != '-')) {
+            LWIP_DEBUGF(HTTP_CLIENT_DEBUG | LWIP_DBG_STATE, ("%s Unexpected range start %u\n", prefix_str, start));
+            return ERR_VAL;
+        }
+        (void)parse_u32(val + 1, &val);
+        if ((*val == '/') && (val[1] != '*')) {
+            total = parse_u32(val + 1, NULL);
+            http_client.content_length = total;
+            http_client.has_length = true;
+        }
+        break;
+
+    default:
+        LWIP_DEBUGF(HTTP_CLIENT_DEBUG | LWIP_DBG_STATE,
+                    ("%s %s: HTTP status %u\n", prefix_str, http_client.path, http_client.status));
+        return ERR_VAL;
+    }
+
+    /* The size is known up front, refuse a file that cannot fit */
+    if (http_client.has_length && (http_client.content_length > http_client.dst_size)) {
+        LWIP_DEBUGF(HTTP_CLIENT_DEBUG | LWIP_DBG_STATE,
+                    ("%s Destination size %u is smaller than the file size %u\n",
+                        prefix_str, http_client.dst_size, http_client.content_length));
+        return ERR_MEM;
+    }
+
+    return ERR_OK;
+}
+
+static void
+finish(err_t err)
+{
+    if (!http_client.is_done) {
+        http_client.err = err;
+        http_client.is_done = true;
+    }
+}
+
+/* Returns ERR_ABRT if the connection had to be aborted */
+static err_t
+close_conn(void)
+{
+    struct tcp_pcb *pcb = http_client.pcb;
+    err_t ret = ERR_OK;
+
+    if (pcb == NULL) {
+        return ERR_OK;
+    }
+    http_client.pcb = NULL;
+
+    tcp_arg(pcb, NULL);
+    tcp_recv(pcb, NULL);
+    tcp_err(pcb, NULL);
+    if (tcp_close(pcb) != ERR_OK) {
+        tcp_abort(pcb);
+        ret = ERR_ABRT;
+    }
+
+    return ret;
+}
+
+static void
+abort_conn(err_t err)
+{
+    struct tcp_pcb *pcb = http_client.pcb;
+
+    finish(err);
+    if (pcb != NULL) {
+        http_client.pcb = NULL;
+        tcp_err(pcb, NULL);
+        tcp_abort(pcb);
+    }
+}
+
+static void
+update_progress_bar(u32_t data_len_bytes)
+{
+#if PROGRESS_BAR
+    bool old_setting;
+
+    if ((http_client.rcvd_bytes / PROGRESS_BAR_INTERVAL_BYTES) ==
+        ((http_client.rcvd_bytes - data_len_bytes) / PROGRESS_BAR_INTERVAL_BYTES)) {
+        return;
+    }
+
+    old_setting = tegrabl_enable_timestamp(false);
+    tegrabl_printf("#");
+    bar_cnt++;
+    /* Enter a newline if bar crosses the minimum row size */
+    if ((bar_cnt % MIN_CONSOLE_ROW_SIZE) == 0) {
+        tegrabl_printf("\n");
+    }
+    (void)tegrabl_enable_timestamp(old_setting);
+#else
+    LWIP_UNUSED_ARG(data_len_bytes);
+#endif
+}
+
+static err_t
+recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+    struct pbuf *q;
+    u8_t *data_ptr;
+    u32_t data_len_bytes;
+    u32_t i;
+    err_t ret = ERR_OK;
+
+    LWIP_UNUSED_ARG(arg);
+
+    if ((p == NULL) || (err != ERR_OK)) {
+        if (p != NULL) {
+            pbuf_free(p);
+        }
+        /* Server closed; complete only if the whole body is there */
+        if (http_client.is_hdr_done &&
+            (!http_client.has_length || (http_client.rcvd_bytes == http_client.content_length))) {
+            finish(ERR_OK);
+        } else {
+            finish(ERR_CLSD);
+        }
+        return close_conn();
+    }
+
+    http_client.last_rx_time_ms = tegrabl_get_timestamp_ms();
+
+    for (q = p; q != NULL; q = q->next) {
+        data_ptr = (u8_t *)q->payload;
+        data_len_bytes = q->len;
+
+        /* Collect the response header, it may span several segments */
+        i = 0;
+        while (!http_client.is_hdr_done && (i < data_len_bytes)) {
+            if (http_client.hdr_len >= (HTTP_MAX_HEADER_SIZE - 1U)) {
+                LWIP_DEBUGF(HTTP_CLIENT_DEBUG | LWIP_DBG_STATE, ("%s Response header too long\n", prefix_str));
+                ret = ERR_VAL;
+                goto fail;
+            }
+            http_client.hdr[http_client.hdr_len++] = (char)data_ptr[i++];
+            if ((http_client.hdr_len >= 4U) &&
+                (memcmp(&http_client.hdr[http_client.hdr_len - 4U], "\r\n\r\n", 4) == 0)) {
+                http_client.hdr[http_client.hdr_len] = '\0';
+                http_client.is_hdr_done = true;
+                ret = parse_header();
+                if (ret != ERR_OK) {
+                    goto fail;
+                }
+            }
+        }
+        data_ptr += i;
+        data_len_bytes -= i;
+        if (data_len_bytes == 0U) {
+            continue;
+        }
+
+        if (((http_client.dst_size - http_client.rcvd_bytes) < data_len_bytes) ||
+            (http_client.has_length &&
+             ((http_client.content_length - http_client.rcvd_bytes) < data_len_bytes))) {
+            LWIP_DEBUGF(HTTP_CLIENT_DEBUG | LWIP_DBG_STATE, ("%s Body overruns the destination\n", prefix_str));
+            ret = ERR_MEM;
+            goto fail;
+        }
+
+        memcpy(http_client.dst_mem_addr + http_client.rcvd_bytes, data_ptr, data_len_bytes);
+        http_client.rcvd_bytes += data_len_bytes;
+        update_progress_bar(data_len_bytes);
+    }
+
+    /* Data is consumed at once, re-open the window for all of it */
+    tcp_recved(pcb, p->tot_len);
+    pbuf_free(p);
+
+    if (http_client.is_hdr_done && http_client.has_length &&
+        (http_client.rcvd_bytes == http_client.content_length)) {
+        finish(ERR_OK);
+        return close_conn();
+    }
+
+    return ERR_OK;
+
+fail:
+    pbuf_free(p);
+    abort_conn(ret);
+    return ERR_ABRT;
+}
+
+static void
+conn_err(void *arg, err_t err)
+{
+    LWIP_UNUSED_ARG(arg);
+
+    /* The pcb is already freed */
+    http_client.pcb = NULL;
+    finish(err);
+}
+
+static err_t
+connected(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+    char req[HTTP_MAX_REQUEST_SIZE];
+    int len;
+    int ret;
+
+    LWIP_UNUSED_ARG(arg);
+    LWIP_UNUSED_ARG(pcb);
+
+    if (err != ERR_OK) {
+        abort_conn(err);
+        return ERR_ABRT;
+    }
+
+    /* Each part is checked before the next one is placed after it */
+    len = snprintf(req, sizeof(req), "GET %s HTTP/1.1\r\nHost: %s:%u\r\n",
+                   http_client.path, ipaddr_ntoa(&http_client.server_ip), http_client.port);
+    if ((len < 0) || ((u32_t)len >= sizeof(req))) {
+        goto too_long;
+    }
+    if (http_client.rcvd_bytes != 0U) {
+        /* Resume after the bytes that already landed */
+        ret = snprintf(req + len, sizeof(req) - len, "Range: bytes=%u-\r\n", http_client.rcvd_bytes);
+        if ((ret < 0) || ((u32_t)ret >= (sizeof(req) - len))) {
+            goto too_long;
+        }
+        len += ret;
+    }
+    ret = snprintf(req + len, sizeof(req) - len, "Connection: close\r\n\r\n");
+    if ((ret < 0) || ((u32_t)ret >= (sizeof(req) - len))) {
+        goto too_long;
+    }
+    len += ret;
+
+    ret = tcp_write(http_client.pcb, req, (u16_t)len, TCP_WRITE_FLAG_COPY);
+    if (ret == ERR_OK) {
+        ret = tcp_output(http_client.pcb);
+    }
+    if (ret != ERR_OK) {
+        LWIP_DEBUGF(HTTP_CLIENT_DEBUG | LWIP_DBG_STATE, ("%s Failed to send request: err: %d\n", prefix_str, ret));
+        abort_conn((err_t)ret);
+        return ERR_ABRT;
+    }
+
+    return ERR_OK;
+
+too_long:
+    LWIP_DEBUGF(HTTP_CLIENT_DEBUG | LWIP_DBG_STATE, ("%s Request too long\n", prefix_str));
+    abort_conn(ERR_ARG);
+    return ERR_ABRT;
+}
+
+static err_t
+start_request(void)
+{
+    struct tcp_pcb *pcb;
+    err_t ret;
+
+    http_client.hdr_len = 0;
+    http_client.is_hdr_done = false;
+    http_client.is_done = false;
+    http_client.err = ERR_OK;
+    http_client.status = 0;
+    http_client.last_rx_time_ms = tegrabl_get_timestamp_ms();
+
+    pcb = tcp_new_ip_type(IPADDR_TYPE_V4);
+    if (pcb == NULL) {
+        LWIP_DEBUGF(HTTP_CLIENT_DEBUG | LWIP_DBG_STATE, ("%s Failed to allocate TCP PCB\n", prefix_str));
+        return ERR_MEM;
+    }
+    tcp_arg(pcb, NULL);
+    tcp_recv(pcb, recv);
+    tcp_err(pcb, conn_err);
+    http_client.pcb = pcb;
+
+    ret = tcp_connect(pcb, &http_client.server_ip, http_client.port, connected);
+    if (ret != ERR_OK) {
+        LWIP_DEBUGF(HTTP_CLIENT_DEBUG | LWIP_DBG_STATE, ("%s Failed to connect: err: %d\n", prefix_str, ret));
+        abort_conn(ret);
+    }
+
+    return ret;
+}
+
+/* Called and returns with the lwIP core lock held */
+static err_t
+wait_for_completion(void)
+{
+    while (!http_client.is_done) {
+        if ((tegrabl_get_timestamp_ms() - http_client.last_rx_time_ms) > HTTP_IDLE_TIMEOUT_MS) {
+            LWIP_DEBUGF(HTTP_CLIENT_DEBUG | LWIP_DBG_STATE, ("%s Connection timed out\n", prefix_str));
+            abort_conn(ERR_TIMEOUT);
+            break;
+        }
+        /* TCP retransmits and delayed ACKs are driven by lwIP's timers */
+        sys_check_timeouts();
+
+        /* Segments arrive on the RX worker, sleep so that it can run */
+        lwip_core_unlock();
+        thread_sleep(HTTP_POLL_INTERVAL_MS);
+        lwip_core_lock();
+    }
+
+    return http_client.err;
+}
+
+err_t
+http_client_get(const u8_t * const server_ip,
+                u16_t port,
+                const char * const path,
+                void * const dst_addr,
+                u32_t dst_size,
+                u32_t * const file_size)
+{
+    time_t start_time_ms;
+    time_t elapsed_ms;
+    u32_t attempt;
+    err_t ret = ERR_OK;
+
+    lwip_core_lock();
+
+    if ((server_ip == NULL) || (path == NULL) || (path[0] != '/') || (dst_addr == NULL)) {
+        ret = ERR_ARG;
+        LWIP_DEBUGF(HTTP_CLIENT_DEBUG | LWIP_DBG_STATE, ("%s Invalid args\n", prefix_str));
+        goto done;
+    }
+
+    memset(&http_client, 0, sizeof(http_client));
+    http_client.server_ip.addr = (server_ip[0] << 0U)  |
+                                 (server_ip[1] << 8U)  |
+                                 (server_ip[2] << 16U) |
+                                 (server_ip[3] << 24U);
+    http_client.port = port;
+    http_client.path = path;
+    http_client.dst_mem_addr = (u8_t *)dst_addr;
+    http_client.dst_size = dst_size;
+    bar_cnt = 0;
+
+    LWIP_DEBUGF(HTTP_CLIENT_DEBUG | LWIP_DBG_STATE,
+                ("%s GET http://%s:%u%s\n", prefix_str, ipaddr_ntoa(&http_client.server_ip), port, path));
+
+    start_time_ms = tegrabl_get_timestamp_ms();
+    for (attempt = 0; attempt < HTTP_MAX_ATTEMPTS; attempt++) {
+        if (attempt != 0U) {
+            LWIP_DEBUGF(HTTP_CLIENT_DEBUG | LWIP_DBG_STATE,
+                        ("%s Resuming at byte %u (err: %d)\n", prefix_str, http_client.rcvd_bytes, ret));
+        }
+
+        ret = start_request();
+        if (ret == ERR_OK) {
+            ret = wait_for_completion();
+        }
+
+        /* Bad responses and oversize files do not get better by retrying */
+        if ((ret == ERR_OK) || (ret == ERR_VAL) || (ret == ERR_MEM) || (ret == ERR_ARG)) {
+            break;
+        }
+    }
+    if (bar_cnt != 0U) {
+        tegrabl_printf("\n");
+    }
+
+    if (ret != ERR_OK) {
+        goto done;
+    }
+
+    elapsed_ms = tegrabl_get_timestamp_ms() - start_time_ms;
+    LWIP_DEBUGF(HTTP_CLIENT_DEBUG | LWIP_DBG_STATE,
+                ("%s Received %u bytes in %u ms\n", prefix_str, http_client.rcvd_bytes, (u32_t)elapsed_ms));
+
+    if (file_size != NULL) {
+        *file_size = http_client.rcvd_bytes;
+    }
+
+done:
+    lwip_core_unlock();
+    return ret;
+}
+
+#endif /* LWIP_TCP */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2019, NVIDIA Corporation.  All rights reserved.
+ * Copyright (c) 2018-2021, NVIDIA Corporation.  All rights reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property
  * and proprietary rights in and to this software, related documentation
@@ -11,6 +11,7 @@
 #include "lwip/apps/tftp_client.h"
 #include "lwip/ip_addr.h"
 #include <string.h>
+#include <kernel/thread.h>
 
 #if LWIP_UDP
 
@@ -22,6 +23,7 @@
 #define TFTP_CLIENT_PORT               50033U
 #define TFTP_ACK_RESEND_TIMEOUT        5000U
 #define TFTP_MAX_ACK_RETRIES           5U
+#define TFTP_POLL_INTERVAL_MS          1U
 
 #define TFTP_READ                      1U
 #define TFTP_WRITE                     2U
@@ -226,6 +228,7 @@ recv(void *a, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t
     }
 
 fail:
+    pbuf_free(p);
     return;
 }
 
@@ -234,6 +237,8 @@ tftp_client_init(const u8_t * const tftp_server_ip)
 {
     err_t ret = ERR_OK;
 
+    lwip_core_lock();
+
     if (tftp_server_ip == NULL) {
         ret = ERR_ARG;
         LWIP_DEBUGF(TFTP_DEBUG | LWIP_DBG_STATE, ("%s Invalid TFTP server IP addr passed\n", prefix_str));
@@ -277,6 +282,7 @@ cleanup:
     }
 
 done:
+    lwip_core_unlock();
     return ret;
 }
 
@@ -297,6 +303,9 @@ tftp_client_recv(char * const filename,
     time_t curr_time_ms;
     err_t ret = ERR_OK;
 
+    /* Held throughout, except while waiting so that the RX worker gets in */
+    lwip_core_lock();
+
     if ((filename == NULL) || (filetype == NULL) || (dst_addr == NULL)) {
         ret = ERR_ARG;
         LWIP_DEBUGF(TFTP_DEBUG | LWIP_DBG_STATE, ("%s Invalid args\n", prefix_str));
@@ -405,7 +414,10 @@ tftp_client_recv(char * const filename,
             last_ack_retry_blk = tftp_client.last_rcvd_blk;
             tftp_client.exptd_blk = tftp_client.last_rcvd_blk + 1;
         }
-        tegrabl_udelay(100);
+        /* Blocks arrive on the RX worker, sleep so that it can run */
+        lwip_core_unlock();
+        thread_sleep(TFTP_POLL_INTERVAL_MS);
+        lwip_core_lock();
     }
 
     if (ack_retries >= TFTP_MAX_ACK_RETRIES) {
@@ -424,16 +436,19 @@ fail:
     if (p != NULL) {
         pbuf_free(p);
     }
+    lwip_core_unlock();
     return ret;
 }
 
 void
 tftp_client_deinit(void)
 {
+    lwip_core_lock();
     if (tftp_client.pcb != NULL) {
         udp_remove(tftp_client.pcb);
         tftp_client.pcb = NULL;
     }
+    lwip_core_unlock();
 }
 
 #endif /* LWIP_UDP */
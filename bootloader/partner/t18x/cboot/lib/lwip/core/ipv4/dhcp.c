@@ -705,20 +705,16 @@ void dhcp_cleanup(struct netif *netif)
 }
 
 /**
- * @ingroup dhcp4
- * Start DHCP negotiation for a network interface.
- *
- * If no DHCP client instance was attached to this interface,
- * a new client is created first. If a DHCP client instance
- * was already present, it restarts negotiation.
+ * Attach (or reset) the DHCP client of a network interface and start
+ * negotiation, either from INIT (DISCOVER) or from INIT-REBOOT (REQUEST
+ * for a previously leased address) when reboot_addr is given.
  *
  * @param netif The lwIP network interface
+ * @param reboot_addr address to request, NULL to discover
  * @return lwIP error code
- * - ERR_OK - No error
- * - ERR_MEM - Out of memory
  */
-err_t
-dhcp_start(struct netif *netif)
+static err_t
+dhcp_start_common(struct netif *netif, const ip4_addr_t *reboot_addr)
 {
   struct dhcp *dhcp;
   err_t result;
@@ -779,7 +775,13 @@ dhcp_start(struct netif *netif)
 
 
   /* (re)start the DHCP negotiation */
-  result = dhcp_discover(netif);
+  if ((reboot_addr != NULL) && !ip4_addr_isany(reboot_addr)) {
+    /* dhcp_reboot() requests offered_ip_addr, NAK or timeout fall back to discover */
+    ip4_addr_copy(dhcp->offered_ip_addr, *reboot_addr);
+    result = dhcp_reboot(netif);
+  } else {
+    result = dhcp_discover(netif);
+  }
   if (result != ERR_OK) {
     /* free resources allocated above */
     dhcp_stop(netif);
@@ -788,6 +790,45 @@ dhcp_start(struct netif *netif)
   return result;
 }
 
+/**
+ * @ingroup dhcp4
+ * Start DHCP negotiation for a network interface.
+ *
+ * If no DHCP client instance was attached to this interface,
+ * a new client is created first. If a DHCP client instance
+ * was already present, it restarts negotiation.
+ *
+ * @param netif The lwIP network interface
+ * @return lwIP error code
+ * - ERR_OK - No error
+ * - ERR_MEM - Out of memory
+ */
+err_t
+dhcp_start(struct netif *netif)
+{
+  return dhcp_start_common(netif, NULL);
+}
+
+/**
+ * @ingroup dhcp4
+ * Start DHCP negotiation in the INIT-REBOOT state (RFC 2131, 3.2):
+ * a REQUEST for a previously leased address is broadcast instead of a
+ * DISCOVER. If the server NAKs or does not answer, the client falls back
+ * to regular discovery.
+ *
+ * @param netif The lwIP network interface
+ * @param addr previously leased address
+ * @return lwIP error code
+ * - ERR_OK - No error
+ * - ERR_MEM - Out of memory
+ */
+err_t
+dhcp_start_reboot(struct netif *netif, const ip4_addr_t *addr)
+{
+  LWIP_ERROR("addr != NULL", (addr != NULL), return ERR_ARG;);
+  return dhcp_start_common(netif, addr);
+}
+
 /**
  * @ingroup dhcp4
  * Inform a DHCP server of our manual configuration.
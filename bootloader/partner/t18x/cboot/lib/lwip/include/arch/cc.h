@@ -51,5 +51,14 @@ typedef int32_t s32_t;
 
 #define PACK_STRUCT_STRUCT __PACKED
 
+/*
+ * lwIP is entered both from the network RX worker and from the thread
+ * driving the boot. The RX worker holds this lock while it feeds frames,
+ * any other caller must take it around its lwIP calls. Provided by the
+ * netif glue.
+ */
+void lwip_core_lock(void);
+void lwip_core_unlock(void);
+
 #endif
 
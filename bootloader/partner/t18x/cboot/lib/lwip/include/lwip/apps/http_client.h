@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2021, NVIDIA Corporation.  All rights reserved.
+ *
+ * NVIDIA Corporation and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA Corporation is strictly prohibited.
+ */
+
+#ifndef LWIP_HDR_APPS_HTTP_CLIENT_H
+#define LWIP_HDR_APPS_HTTP_CLIENT_H
+
+#include "lwip/opt.h"
+#include "lwip/err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Enable HTTP client debug messages
+ */
+#if !defined HTTP_CLIENT_DEBUG || defined __DOXYGEN__
+#define HTTP_CLIENT_DEBUG     LWIP_DBG_ON
+#endif
+
+/**
+ * Default port of the HTTP server
+ */
+#define HTTP_CLIENT_DEFAULT_PORT    80U
+
+/**
+ * Fetch a file with HTTP/1.1 GET over TCP. The body is streamed straight
+ * into dst_addr. If the connection fails part way, the transfer is resumed
+ * with a Range request from the last byte received.
+ * @param server_ip HTTP server IP address
+ * @param port HTTP server port
+ * @param path absolute path of the file on the server, e.g. "/boot.img"
+ * @param dst_addr memory address where received file is to be copied
+ * @param dst_size size of the destination memory
+ * @param file_size size of the received file
+ * @returns error, ERR_MEM if the file does not fit in dst_size
+ */
+err_t http_client_get(const u8_t * const server_ip,
+					  u16_t port,
+					  const char * const path,
+					  void * const dst_addr,
+					  u32_t dst_size,
+					  u32_t * const file_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LWIP_HDR_APPS_HTTP_CLIENT_H */
@@ -1,6 +1,6 @@
 /*
  *
- * Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2018-2021, NVIDIA CORPORATION.  All rights reserved.
  *
  * NVIDIA CORPORATION and its licensors retain all intellectual property
  * and proprietary rights in and to this software and related documentation
@@ -69,11 +69,19 @@
 #define LWIP_DHCP                       1
 #define LWIP_ARP                        1
 #define DHCP_DOES_ARP_CHECK             0
+/* Keep siaddr (next-server) of the lease, used as TFTP server fallback */
+#define LWIP_DHCP_BOOTP_FILE            1
 #define LWIP_ICMP                       1
 
 /* ENABLE IPV4 */
 #define LWIP_IPV4                       1
 
+/* HTTP boot: full size segments and a large, scaled receive window */
+#define TCP_MSS                         1460
+#define TCP_WND                         (256 * 1024)
+#define LWIP_WND_SCALE                  1
+#define TCP_RCV_SCALE                   3
+
 /* Misc */
 #define LWIP_NETIF_STATUS_CALLBACK      1
 #define MEMP_MEM_MALLOC                 1
@@ -89,9 +97,6 @@
 #define TCP_SND_QUEUELEN                40
 #define MEMP_NUM_TCP_SEG                TCP_SND_QUEUELEN
 #define TCP_SND_BUF                     (12 * TCP_MSS)
-#define TCP_WND                         (10 * TCP_MSS)
-#define LWIP_WND_SCALE                  1
-#define TCP_RCV_SCALE                   0
 #define PBUF_POOL_SIZE                  400 /* pbuf tests need ~200KByte */
 
 /* Enable IGMP and MDNS for MDNS tests */
@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2018, NVIDIA CORPORATION.  All rights reserved.
+# Copyright (c) 2018-2021, NVIDIA CORPORATION.  All rights reserved.
 #
 # NVIDIA CORPORATION and its licensors retain all intellectual property
 # and proprietary rights in and to this software and related documentation
@@ -24,7 +24,8 @@ include $(LOCAL_DIR)/Filelists.mk
 
 MODULE_SRCS += \
 	$(LWIPNOAPPSFILES) \
-	$(TFTPCLIENTFILES)
+	$(TFTPCLIENTFILES) \
+	$(HTTPCLIENTFILES)
 
 include make/module.mk
 
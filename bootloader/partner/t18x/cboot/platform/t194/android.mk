@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2017-2019, NVIDIA CORPORATION.  All rights reserved.
+# Copyright (c) 2017-2021, NVIDIA CORPORATION.  All rights reserved.
 #
 # NVIDIA CORPORATION and its licensors retain all intellectual property
 # and proprietary rights in and to this software and related documentation
@@ -23,6 +23,10 @@ GLOBAL_DEFINES += \
 ifeq ($(PLATFORM_IS_AFTER_N),1)
 GLOBAL_DEFINES += \
        CONFIG_ENABLE_SYSTEM_AS_ROOT=1
+
+# AVB 2.0 hashes images on secondary cores while it reads them
+GLOBAL_DEFINES += \
+	CONFIG_ENABLE_WORKQUEUE_SMP=1
 endif
 
 MODULE_DEPS += \
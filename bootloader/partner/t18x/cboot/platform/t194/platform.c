@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2020, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2017-2021, NVIDIA CORPORATION.  All rights reserved.
  *
  * NVIDIA CORPORATION and its licensors retain all intellectual property
  * and proprietary rights in and to this software, related documentation
@@ -76,6 +76,9 @@
 #endif
 
 #include <tegrabl_cbo.h>
+#include <tegrabl_profiler.h>
+#include <tegrabl_workqueue.h>
+#include <tegrabl_t194_ccplex_nvg.h>
 #include <tegrabl_odmdata_soc.h>
 #include <arfuse.h>
 #include <tegrabl_drf.h>
@@ -403,6 +406,13 @@ void platform_init_mmu_mappings(void)
 					CPUBL_PARAMS_SIZE,
 					MMU_FLAG_CACHED | MMU_FLAG_READWRITE | MMU_FLAG_EXECUTE_NOT);
 
+	if (boot_params->profiling_data_address != 0ULL) {
+		arm64_mmu_map((uintptr_t)boot_params->profiling_data_address,
+					  (uintptr_t)boot_params->profiling_data_address,
+					  TEGRABL_PROFILER_PAGE_SIZE,
+					  MMU_FLAG_CACHED | MMU_FLAG_READWRITE | MMU_FLAG_EXECUTE_NOT);
+	}
+
 	arm64_mmu_map(
 			(uintptr_t)boot_params->carveout_info[CARVEOUT_MISC].base,
 			(uintptr_t)boot_params->carveout_info[CARVEOUT_MISC].base,
@@ -449,8 +459,23 @@ void platform_uninit(void)
 	tegrabl_wdt_disable(TEGRABL_WDT_LCCPLEX);
 #endif /* CONFIG_ENABLE_WDT */
 
+#if defined(CONFIG_ENABLE_DISPLAY)
+	/* Display bring-up may still be running on its own thread */
+	tegrabl_display_wait_ready();
+#endif
+
+	/* Collect BPMP requests posted without waiting, e.g. XUSB powergate */
+	if (tegrabl_ccplex_bpmp_flush() != TEGRABL_NO_ERROR) {
+		pr_error("BPMP requests posted before handoff failed\n");
+	}
+
 	platform_uninit_timer();
 
+#if defined(CONFIG_ENABLE_WORKQUEUE_SMP)
+	/* Secondary cores must be off for the kernel to bring them up */
+	tegrabl_workqueue_stop_cpus();
+#endif
+
 	arch_disable_ints();
 
 #if WITH_MMU
@@ -461,6 +486,26 @@ void platform_uninit(void)
 	arm64_disable_serror();
 }
 
+#if defined(CONFIG_ENABLE_WORKQUEUE_SMP)
+static void platform_init_workqueue(void)
+{
+	uint64_t mpidrs[TEGRABL_WORKQUEUE_MAX_CPUS];
+	uint64_t self = ARM64_READ_SYSREG(MPIDR_EL1) & 0xFFFFFFULL;
+	uint32_t num_cores = tegrabl_ccplex_nvg_num_cores();
+	uint32_t count = 0;
+	uint32_t i;
+
+	for (i = 0; (i < num_cores) && (count < TEGRABL_WORKQUEUE_MAX_CPUS); i++) {
+		mpidrs[count] = tegrabl_ccplex_nvg_logical_to_mpidr(i);
+		if (mpidrs[count] != self) {
+			count++;
+		}
+	}
+
+	(void)tegrabl_workqueue_start_cpus(mpidrs, count);
+}
+#endif
+
 static tegrabl_error_t platform_init_power(void)
 {
 	tegrabl_error_t err = TEGRABL_NO_ERROR;
@@ -570,6 +615,18 @@ void platform_init(void)
 	dev_param = &boot_params->device_config;
 	TEGRABL_UNUSED(dev_param);
 
+	err = tegrabl_profiler_init(boot_params->profiling_data_address,
+								CPUBL_PROFILER_OFFSET, CPUBL_PROFILER_SIZE);
+	if (err != TEGRABL_NO_ERROR) {
+		pr_warn("profiler init failed\n");
+		err = TEGRABL_NO_ERROR;
+	}
+	tegrabl_profiler_record("cpubl platform init", 0, MINIMAL);
+
+#if defined(CONFIG_ENABLE_WORKQUEUE_SMP)
+	platform_init_workqueue();
+#endif
+
 #if defined(CONFIG_ENABLE_DEVICE_PROD)
 	err = tegrabl_device_prod_register(
 			(uintptr_t)boot_params->controller_prod_settings,
@@ -635,7 +692,9 @@ void platform_init(void)
 	}
 
 	/* configures fixed / fused storage devices */
+	tegrabl_profiler_begin("storage-init");
 	err = config_storage(dev_param, boot_params->storage_devices);
+	tegrabl_profiler_end("storage-init");
 	if (err != TEGRABL_NO_ERROR) {
 		pr_error("Error config_storage\n");
 		hang_up = true;
@@ -650,6 +709,15 @@ void platform_init(void)
 	}
 #endif
 
+#if defined(CONFIG_ENABLE_UFS_PWR_MODE_CACHE)
+	err = tegrabl_ufs_complete_hs_mode();
+	if (err != TEGRABL_NO_ERROR) {
+		pr_error("Error switching UFS to HS mode\n");
+		hang_up = true;
+		goto fail;
+	}
+#endif
+
 #if defined(CONFIG_ENABLE_NCT)
 	err = tegrabl_nct_init();
 	if (err != TEGRABL_NO_ERROR) {
@@ -663,7 +731,9 @@ void platform_init(void)
 	}
 
 #if defined(CONFIG_ENABLE_DISPLAY)
-	err = tegrabl_display_init();
+	tegrabl_profiler_begin("display");
+	err = tegrabl_display_init_async();
+	tegrabl_profiler_end("display");
 	if (err != TEGRABL_NO_ERROR) {
 		pr_warn("display init failed\n");
 	}
@@ -77,6 +77,9 @@ MODULE_DEPS += \
 	$(LOCAL_DIR)/../../../../common/drivers/pwm \
 	$(LOCAL_DIR)/../../../../common/drivers/display \
 	$(LOCAL_DIR)/../../../../common/lib/cbo \
+	$(LOCAL_DIR)/../../../../common/lib/profiler \
+	$(LOCAL_DIR)/../../../../common/lib/workqueue \
+	$(LOCAL_DIR)/../../../../common/lib/background \
 	$(LOCAL_DIR)/../../../../$(TARGET_FAMILY)/common/lib/device_prod
 
 ifeq ($(filter t19x, $(TARGET_FAMILY)),)
@@ -112,6 +115,7 @@ GLOBAL_DEFINES += \
 	CONFIG_ENABLE_SATA=1 \
 	CONFIG_ENABLE_UFS=1 \
 	CONFIG_ENABLE_UFS_HS_MODE=1 \
+	CONFIG_ENABLE_UFS_PWR_MODE_CACHE=1 \
 	CONFIG_ENABLE_UFS_USE_CAR=1 \
 	CONFIG_ENABLE_UFS_SKIP_PMC_IMPL=1 \
 	CONFIG_ENABLE_NVBLOB=1 \
@@ -133,6 +137,11 @@ GLOBAL_DEFINES += \
 	CONFIG_ENABLE_STAGED_SCRUBBING=1 \
 	CONFIG_ENABLE_WAR_CBOOT_STAGED_SCRUBBING=1 \
 	CONFIG_SKIP_GPCDMA_RESET=1 \
+	CONFIG_ENABLE_DMA_COPY=1 \
+	CONFIG_ENABLE_BACKGROUND_TASKS=1 \
+	CONFIG_ENABLE_DISPLAY_THREAD=1 \
+	CONFIG_ENABLE_STORAGE_PROBE_THREADS=1 \
+	CONFIG_BOOT_PROFILER=1 \
 	CONFIG_DEBUG_LOGLEVEL=TEGRABL_LOG_INFO
 
 ALLMODULE_OBJS += $(LOCAL_DIR)/../../../../t19x/common/drivers/se/prebuilt/se.mod.o
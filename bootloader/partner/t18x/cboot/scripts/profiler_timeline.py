@@ -0,0 +1,115 @@
+#!/usr/bin/env python
+
+##########################################################################
+# Usage : profiler_timeline.py [--page <offset>] <input> [output]
+#
+# input  : either the /chosen/cboot-profiler DT node directory (for example
+#          /proc/device-tree/chosen/cboot-profiler), or a raw dump of the
+#          64KB profiler page (bl_prof_dataptr) with --page giving the offset
+#          of the records to decode (default: CPUBL profiler offset).
+# output : Chrome trace-event JSON, viewable as a flame chart in
+#          chrome://tracing or ui.perfetto.dev. Defaults to stdout.
+#
+# Records starting with '>' open a span and records starting with '<' close
+# the innermost open span with the same name; anything else is an instant
+# event. A per-span summary (count/total/self time) is printed to stderr.
+##########################################################################
+
+import sys, os, struct, json
+
+# Must match tegrabl_profiler.h
+MAX_PROFILE_STRLEN = 55
+RECORD_FMT = '<%dsQ' % (MAX_PROFILE_STRLEN + 1)
+RECORD_SIZE = struct.calcsize(RECORD_FMT)
+CPUBL_PROFILER_OFFSET = (8 + 4 + 4 + 4) * 1024
+CPUBL_PROFILER_SIZE = 4 * 1024
+SPAN_BEGIN = '>'
+SPAN_END = '<'
+
+def read_dt_node(path):
+    with open(os.path.join(path, 'timestamps-us'), 'rb') as f:
+        raw = f.read()
+    stamps = struct.unpack('>%dQ' % (len(raw) // 8), raw)
+    with open(os.path.join(path, 'events'), 'rb') as f:
+        names = f.read().decode('ascii', 'replace').split('\0')
+    return list(zip(stamps, names))
+
+def read_page(path, offset, size):
+    records = []
+    with open(path, 'rb') as f:
+        f.seek(offset)
+        raw = f.read(size)
+    for pos in range(0, len(raw) - RECORD_SIZE + 1, RECORD_SIZE):
+        name, stamp = struct.unpack_from(RECORD_FMT, raw, pos)
+        if stamp == 0:
+            continue
+        name = name.split(b'\0', 1)[0].decode('ascii', 'replace')
+        records.append((stamp, name))
+    return records
+
+def build_trace(records):
+    events = []
+    stack = []
+    summary = {}
+
+    for stamp, name in sorted(records, key=lambda r: r[0]):
+        if name.startswith(SPAN_BEGIN):
+            stack.append([name[1:], stamp, 0])
+            events.append({'name': name[1:], 'ph': 'B', 'ts': stamp,
+                           'pid': 0, 'tid': 0})
+        elif name.startswith(SPAN_END):
+            tag = name[1:]
+            # Tolerate unbalanced spans by closing everything above the match
+            while stack:
+                span, start, child = stack.pop()
+                dur = stamp - start
+                entry = summary.setdefault(span, [0, 0, 0])
+                entry[0] += 1
+                entry[1] += dur
+                entry[2] += dur - child
+                events.append({'name': span, 'ph': 'E', 'ts': stamp,
+                               'pid': 0, 'tid': 0})
+                if stack:
+                    stack[-1][2] += dur
+                if span == tag:
+                    break
+        else:
+            events.append({'name': name, 'ph': 'i', 's': 'g', 'ts': stamp,
+                           'pid': 0, 'tid': 0})
+
+    for span, start, child in stack:
+        sys.stderr.write('warning: span %s opened at %d us never closed\n' %
+                         (span, start))
+
+    return events, summary
+
+if __name__ == "__main__":
+    args = sys.argv[1:]
+    offset = CPUBL_PROFILER_OFFSET
+    if len(args) >= 2 and args[0] == '--page':
+        offset = int(args[1], 0)
+        args = args[2:]
+
+    if len(args) < 1:
+        sys.stdout.write('Usage: %s [--page <offset>] <input> [output]\n' %
+                                                                sys.argv[0])
+        sys.exit(1)
+
+    if os.path.isdir(args[0]):
+        records = read_dt_node(args[0])
+    else:
+        records = read_page(args[0], offset, CPUBL_PROFILER_SIZE)
+
+    events, summary = build_trace(records)
+
+    out = open(args[1], 'w') if len(args) > 1 else sys.stdout
+    json.dump({'traceEvents': events, 'displayTimeUnit': 'ms'}, out, indent=1)
+    if out is not sys.stdout:
+        out.close()
+
+    sys.stderr.write('%-24s %6s %12s %12s\n' % ('span', 'count', 'total(us)',
+                                                'self(us)'))
+    for span in sorted(summary, key=lambda s: -summary[s][1]):
+        count, total, self_time = summary[span]
+        sys.stderr.write('%-24s %6d %12d %12d\n' % (span, count, total,
+                                                    self_time))
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020, NVIDIA CORPORATION.  All Rights Reserved.
+ * Copyright (c) 2020-2021, NVIDIA CORPORATION.  All Rights Reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property and
  * proprietary rights in and to this software and related documentation.  Any
@@ -19,8 +19,14 @@ tegrabl_error_t tegrabl_pcie_soc_preinit(uint8_t ctrl_num)
 	return TEGRABL_ERR_NOT_SUPPORTED'
 }
 
-tegrabl_error_t tegrabl_pcie_soc_init(uint8_t ctrl_num, uint8_t link_speed)
+tegrabl_error_t tegrabl_pcie_soc_start(uint8_t ctrl_num, uint8_t link_speed)
 {
 	pr_error("%s: is not supported for T18x\n", __func__);
 	return TEGRABL_ERR_NOT_SUPPORTED'
 }
+
+tegrabl_error_t tegrabl_pcie_soc_poll(uint8_t ctrl_num)
+{
+	pr_error("%s: is not supported for T18x\n", __func__);
+	return TEGRABL_ERR_NOT_SUPPORTED;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2020, NVIDIA Corporation.  All Rights Reserved.
+ * Copyright (c) 2015-2021, NVIDIA Corporation.  All Rights Reserved.
  *
  * NVIDIA Corporation and its licensors retain all intellectual property and
  * proprietary rights in and to this software and related documentation.  Any
@@ -27,6 +27,7 @@
 #include <tegrabl_bootimg.h>
 #include <tegrabl_linuxboot_helper.h>
 #include <tegrabl_exit.h>
+#include <tegrabl_background.h>
 
 #ifdef CONFIG_ENABLE_A_B_SLOT
 #include <tegrabl_a_b_boot_control.h>
@@ -493,6 +494,143 @@ done:
 	return err;
 }
 
+#define AUX_INFO_ASYNC_NOT_SUPPORTED		104
+#define AUX_INFO_ASYNC_NOT_STARTED			105
+#define AUX_INFO_ASYNC_INVALID				106
+
+/* Time given to each xfer_wait round of an async load, background tasks run in between */
+#define BINARY_ASYNC_WAIT_TIMEOUT_US		1000U
+
+static bool tegrabl_bdev_is_ufs_lun(tegrabl_bdev_t *bdev)
+{
+	uint16_t storage_type = tegrabl_blockdev_get_storage_type(bdev);
+
+	return (storage_type == TEGRABL_STORAGE_UFS) || (storage_type == TEGRABL_STORAGE_UFS_USER);
+}
+
+static tegrabl_error_t tegrabl_open_binary_partition(tegrabl_binary_type_t bin_type,
+		struct tegrabl_binary_info *binary, struct tegrabl_partition *partition)
+{
+	tegrabl_error_t err;
+	tegrabl_binary_copy_t bin_copy = TEGRABL_BINARY_COPY_PRIMARY;
+
+#if defined(CONFIG_ENABLE_A_B_SLOT)
+	err = a_b_get_bin_copy(bin_type, &bin_copy);
+	if (err != TEGRABL_NO_ERROR) {
+		goto done;
+	}
+#endif
+
+	err = tegrabl_get_binary_info(bin_type, binary, bin_copy);
+	if (err != TEGRABL_NO_ERROR) {
+		goto done;
+	}
+
+	err = tegrabl_partition_open(binary->partition_name, partition);
+
+done:
+	return err;
+}
+
+tegrabl_error_t tegrabl_load_binary_async(tegrabl_binary_type_t bin_type,
+	tegrabl_binary_type_t overlap_type, struct tegrabl_binary_async_load *load)
+{
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+	struct tegrabl_partition overlap_partition;
+	struct tegrabl_binary_info binary = {0};
+	char partition_name[TEGRABL_GPT_MAX_PARTITION_NAME + 1];
+	uint64_t num_sectors;
+
+	if ((load == NULL) || (bin_type >= TEGRABL_BINARY_MAX) || (overlap_type >= TEGRABL_BINARY_MAX)) {
+		err = TEGRABL_ERROR(TEGRABL_ERR_INVALID, AUX_INFO_ASYNC_INVALID);
+		goto done;
+	}
+
+	load->xfer = NULL;
+
+	binary.partition_name = partition_name;
+	err = tegrabl_open_binary_partition(overlap_type, &binary, &overlap_partition);
+	if (err != TEGRABL_NO_ERROR) {
+		goto done;
+	}
+
+	err = tegrabl_open_binary_partition(bin_type, &binary, &load->partition);
+	if (err != TEGRABL_NO_ERROR) {
+		goto done;
+	}
+
+	/* Only UFS keeps a transfer queue per LUN, other devices serialise */
+	if (!tegrabl_bdev_is_ufs_lun(load->partition.block_device) ||
+		!tegrabl_bdev_is_ufs_lun(overlap_partition.block_device) ||
+		(load->partition.block_device == overlap_partition.block_device)) {
+		err = TEGRABL_ERROR(TEGRABL_ERR_NOT_SUPPORTED, AUX_INFO_ASYNC_NOT_SUPPORTED);
+		goto done;
+	}
+
+	load->load_address = binary.load_address;
+	load->size = tegrabl_partition_size(&load->partition);
+	num_sectors = load->size >> load->partition.block_device->block_size_log2;
+	if (num_sectors == 0ULL) {
+		err = TEGRABL_ERROR(TEGRABL_ERR_INVALID, AUX_INFO_INVALID_PARTITION_SIZE);
+		goto done;
+	}
+
+	pr_info("Loading partition %s at %p from device(0x%x) in background\n", binary.partition_name,
+			binary.load_address, tegrabl_blockdev_get_storage_type(load->partition.block_device));
+
+	err = tegrabl_partition_async_read(&load->partition, binary.load_address, 0, num_sectors,
+									   &load->xfer);
+	if ((err != TEGRABL_NO_ERROR) && (load->xfer != NULL)) {
+		tegrabl_free(load->xfer);
+		load->xfer = NULL;
+	}
+
+done:
+	if (err != TEGRABL_NO_ERROR) {
+		TEGRABL_SET_HIGHEST_MODULE(err);
+	}
+	return err;
+}
+
+tegrabl_error_t tegrabl_load_binary_async_wait(struct tegrabl_binary_async_load *load,
+	void **load_address, uint32_t *binary_length)
+{
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+	uint8_t status = TEGRABL_BLOCKDEV_XFER_IN_PROGRESS;
+
+	if ((load == NULL) || (load->xfer == NULL)) {
+		err = TEGRABL_ERROR(TEGRABL_ERR_NOT_STARTED, AUX_INFO_ASYNC_NOT_STARTED);
+		goto done;
+	}
+
+	do {
+		err = tegrabl_blockdev_xfer_wait(load->xfer, BINARY_ASYNC_WAIT_TIMEOUT_US, &status);
+		if ((err == TEGRABL_NO_ERROR) && (status != TEGRABL_BLOCKDEV_XFER_COMPLETE)) {
+			tegrabl_background_yield();
+		}
+	} while ((err == TEGRABL_NO_ERROR) && (status != TEGRABL_BLOCKDEV_XFER_COMPLETE));
+
+	tegrabl_free(load->xfer);
+	load->xfer = NULL;
+
+	if (err != TEGRABL_NO_ERROR) {
+		pr_error("Error reading partition %s\n", load->partition.partition_info->name);
+		TEGRABL_SET_HIGHEST_MODULE(err);
+		goto done;
+	}
+
+	if (load_address != NULL) {
+		*load_address = load->load_address;
+	}
+
+	if (binary_length != NULL) {
+		*binary_length = (uint32_t)load->size;
+	}
+
+done:
+	return err;
+}
+
 tegrabl_error_t tegrabl_load_binary(
 		tegrabl_binary_type_t bin_type, void **load_address,
 		uint32_t *binary_length)
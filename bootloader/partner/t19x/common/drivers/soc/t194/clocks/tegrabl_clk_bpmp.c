@@ -17,6 +17,7 @@
 #include <tegrabl_qspi.h>
 #include <tegrabl_soc_misc.h>
 #include <tegrabl_soc_clock.h>
+#include <string.h>
 
 #include <bpmp_abi.h>
 #include <clk-t194.h>
@@ -1607,6 +1608,37 @@ void tegrabl_usbf_program_tracking_clock(bool is_enable)
 	return;
 }
 
+/*
+ * Set the PG state of all XUSB partitions. BPMP serves one request per
+ * channel at a time, so the partitions are done one after the other.
+ */
+static tegrabl_error_t tegrabl_xusb_set_pg_state(uint32_t state)
+{
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+
+	struct mrq_pg_request xusb_pg_request = {
+		.cmd = CMD_PG_SET_STATE,
+		.id = TEGRA194_POWER_DOMAIN_XUSBA,
+		.set_state = {
+			.state = state,
+		}
+	};
+
+	while (xusb_pg_request.id <= TEGRA194_POWER_DOMAIN_XUSBC) {
+		err = tegrabl_ccplex_bpmp_xfer(&xusb_pg_request, NULL, sizeof(xusb_pg_request), 0, MRQ_PG);
+		if (err != TEGRABL_NO_ERROR) {
+			pr_error("PG_STATE %u for %d failed. Skipping others.\n", state, xusb_pg_request.id);
+			TEGRABL_SET_HIGHEST_MODULE(err);
+			return err;
+		} else {
+			pr_trace("PG_STATE %u set for %d\n", state, xusb_pg_request.id);
+		}
+		++(xusb_pg_request.id);
+	}
+
+	return TEGRABL_NO_ERROR;
+}
+
 tegrabl_error_t tegrabl_usbf_clock_init(void)
 {
 	uint32_t dummy;
@@ -1625,14 +1657,6 @@ tegrabl_error_t tegrabl_usbf_clock_init(void)
 	const uint8_t src_id = 1;
 	const uint8_t rate = 2;
 
-	struct mrq_pg_request xusb_pg_request = {
-		.cmd = CMD_PG_SET_STATE,
-		.id = TEGRA194_POWER_DOMAIN_XUSBA,
-		.set_state = {
-			.state = PG_STATE_ON,
-		}
-	};
-
 	pr_trace("Programming XUSB clks\n");
 	for (index = 0UL; index < 3UL; index++) {
 		err = internal_tegrabl_car_set_clk_src(usbf_clk[index][clk_id], usbf_clk[index][src_id]);
@@ -1646,50 +1670,66 @@ tegrabl_error_t tegrabl_usbf_clock_init(void)
 	}
 
 	/* unPowerGate XUSB */
-	while (xusb_pg_request.id <= TEGRA194_POWER_DOMAIN_XUSBC) {
-		err = tegrabl_ccplex_bpmp_xfer(&xusb_pg_request, NULL, sizeof(xusb_pg_request), 0, MRQ_PG);
-		if (err != TEGRABL_NO_ERROR) {
-			pr_error("PG_STATE_ON for %d failed. Skipping others.\n", xusb_pg_request.id);
-			TEGRABL_SET_HIGHEST_MODULE(err);
-			goto fail;
-		} else {
-			pr_trace("un-Powergated %d\n", xusb_pg_request.id);
-		}
-		++(xusb_pg_request.id);
-	}
-	err = TEGRABL_NO_ERROR;
+	err = tegrabl_xusb_set_pg_state(PG_STATE_ON);
 
 fail:
 	return err;
 }
 
+#define NUM_XUSB_PG_DOMAINS \
+	(TEGRA194_POWER_DOMAIN_XUSBC - TEGRA194_POWER_DOMAIN_XUSBA + 1)
+
+/* Powergate requests posted at handoff, live until BPMP acks them */
+static struct mrq_pg_request xusb_pg_off_request[NUM_XUSB_PG_DOMAINS];
+static struct tegrabl_bpmp_mrq xusb_pg_off_mrq[NUM_XUSB_PG_DOMAINS];
+
+static void tegrabl_xusb_pg_off_done(struct tegrabl_bpmp_mrq *req)
+{
+	struct mrq_pg_request *pg_request = req->req;
+
+	if (req->status != TEGRABL_NO_ERROR) {
+		pr_error("PG_STATE %u for %d failed\n", PG_STATE_OFF, pg_request->id);
+	} else {
+		pr_trace("PG_STATE %u set for %d\n", PG_STATE_OFF, pg_request->id);
+	}
+}
+
 tegrabl_error_t tegrabl_usb_powergate(void)
 {
 	tegrabl_error_t err = TEGRABL_NO_ERROR;
-
-	struct mrq_pg_request xusb_pg_request = {
-		.cmd = CMD_PG_SET_STATE,
-		.id = TEGRA194_POWER_DOMAIN_XUSBA,
-		.set_state = {
-			.state = PG_STATE_OFF,
+	uint32_t i;
+
+	/*
+	 * PowerGate XUSBA..XUSBC partitions. Nothing depends on these before
+	 * the kernel handoff, so post them and let the loader carry on while
+	 * BPMP works through them; they are collected by
+	 * tegrabl_ccplex_bpmp_flush().
+	 */
+	for (i = 0; i < NUM_XUSB_PG_DOMAINS; i++) {
+		if (!xusb_pg_off_mrq[i].done && (xusb_pg_off_mrq[i].req != NULL)) {
+			/* Still queued from an earlier call */
+			continue;
 		}
-	};
 
-	/* PowerGate XUSBA and XUSBC partitions */
-	while (xusb_pg_request.id <= TEGRA194_POWER_DOMAIN_XUSBC) {
-		err = tegrabl_ccplex_bpmp_xfer(&xusb_pg_request, NULL, sizeof(xusb_pg_request), 0, MRQ_PG);
+		memset(&xusb_pg_off_mrq[i], 0, sizeof(xusb_pg_off_mrq[i]));
+		xusb_pg_off_request[i].cmd = CMD_PG_SET_STATE;
+		xusb_pg_off_request[i].id = TEGRA194_POWER_DOMAIN_XUSBA + i;
+		xusb_pg_off_request[i].set_state.state = PG_STATE_OFF;
+
+		xusb_pg_off_mrq[i].mrq = MRQ_PG;
+		xusb_pg_off_mrq[i].req = &xusb_pg_off_request[i];
+		xusb_pg_off_mrq[i].req_size = sizeof(xusb_pg_off_request[i]);
+		xusb_pg_off_mrq[i].cb = tegrabl_xusb_pg_off_done;
+
+		err = tegrabl_ccplex_bpmp_post(&xusb_pg_off_mrq[i]);
 		if (err != TEGRABL_NO_ERROR) {
-			pr_error("PG_STATE_OFF for %d failed. Skipping others.\n", xusb_pg_request.id);
+			pr_error("Failed to post PG_STATE %u for %d\n", PG_STATE_OFF,
+					 xusb_pg_off_request[i].id);
 			TEGRABL_SET_HIGHEST_MODULE(err);
-			goto fail;
-		} else {
-			pr_trace("Powergated %d\n", xusb_pg_request.id);
+			break;
 		}
-		++(xusb_pg_request.id);
 	}
-	err = TEGRABL_NO_ERROR;
 
-fail:
 	return err;
 }
 
@@ -597,7 +597,20 @@ fail:
 	return error;
 }
 
-tegrabl_error_t tegrabl_pcie_soc_init(uint8_t ctrl_num, uint8_t link_speed)
+/** Link training steps of a controller started by tegrabl_pcie_soc_start() */
+#define PCIE_TRAIN_IDLE		0U
+#define PCIE_TRAIN_PERST	1U
+#define PCIE_TRAIN_LTSSM	2U
+
+/** Time PEX_RST is held low before the LTSSM is started */
+#define PCIE_PERST_DELAY_US		100000U
+/** Time allowed for the link to come up once the LTSSM is started */
+#define PCIE_LINK_UP_TIMEOUT_US	1000000U
+
+static uint8_t pcie_train_step[MAX_CTRL_SUPPORTED];
+static time_t pcie_train_start[MAX_CTRL_SUPPORTED];
+
+tegrabl_error_t tegrabl_pcie_soc_start(uint8_t ctrl_num, uint8_t link_speed)
 {
 	tegrabl_error_t error;
 	uint32_t val;
@@ -660,39 +673,72 @@ tegrabl_error_t tegrabl_pcie_soc_init(uint8_t ctrl_num, uint8_t link_speed)
 	val |= 1 << LINK_CAPABLE_SHIFT;
 	pcie_dbi_write32(ctrl_num, PORT_LOGIC_PORT_LINK_CTRL_OFF, val);
 
-	/** Deassert PEX_RST signal to endpoint */
+	/** Deassert PEX_RST signal to endpoint, tegrabl_pcie_soc_poll() releases it */
 	val = pcie_appl_read32(ctrl_num, APPL_PINMUX);
 	val &= ~APPL_PINMUX_PEX_RST;	/* APPL_PINMUX_PEX_RST to 0 */
 	pcie_appl_write32(ctrl_num, APPL_PINMUX, val);
 
-	tegrabl_udelay(100000U);
+	pcie_train_step[ctrl_num] = PCIE_TRAIN_PERST;
+	pcie_train_start[ctrl_num] = tegrabl_get_timestamp_us();
 
-	/** Assert PEX_RST signal to endpoint */
-	val = pcie_appl_read32(ctrl_num, APPL_PINMUX);
-	val |= APPL_PINMUX_PEX_RST;	/* APPL_PINMUX_PEX_RST to 1 */
-	pcie_appl_write32(ctrl_num, APPL_PINMUX, val);
+fail:
+	if (error != TEGRABL_NO_ERROR) {
+		tegrabl_pcie_reset_state(ctrl_num);
+	}
+	return error;
+}
 
-	tegrabl_udelay(1U);
+tegrabl_error_t tegrabl_pcie_soc_poll(uint8_t ctrl_num)
+{
+	tegrabl_error_t error = TEGRABL_ERR_BUSY;
+	time_t elapsed;
+	uint32_t val;
 
-	/** Start LTSSM from RP side */
-	val = pcie_appl_read32(ctrl_num, APPL_CTRL);
-	val |= APPL_CTRL_LTSSM_EN;
-	pcie_appl_write32(ctrl_num, APPL_CTRL, val);
+	elapsed = tegrabl_get_timestamp_us() - pcie_train_start[ctrl_num];
 
-	/** Poll for PCIe link up */
-	error = tegra_reg_poll_mask(appl_reg_offset[ctrl_num] + APPL_LINK_STATUS, RDLH_LINK_UP_MASK,
-								RDLH_LINK_UP, 1000000);
-	if (error != TEGRABL_NO_ERROR) {
-		pr_critical("Failed to link up controller-%d\n", ctrl_num);
-		error = TEGRABL_ERR_INIT_FAILED;
-		goto fail;
-	}
-	pr_info("PCIe controller-%d link is up\n", ctrl_num);
+	switch (pcie_train_step[ctrl_num]) {
+	case PCIE_TRAIN_PERST:
+		if (elapsed < PCIE_PERST_DELAY_US) {
+			break;
+		}
 
-fail:
-	if (error != TEGRABL_NO_ERROR) {
-		tegrabl_pcie_reset_state(ctrl_num);
+		/** Assert PEX_RST signal to endpoint */
+		val = pcie_appl_read32(ctrl_num, APPL_PINMUX);
+		val |= APPL_PINMUX_PEX_RST;	/* APPL_PINMUX_PEX_RST to 1 */
+		pcie_appl_write32(ctrl_num, APPL_PINMUX, val);
+
+		tegrabl_udelay(1U);
+
+		/** Start LTSSM from RP side */
+		val = pcie_appl_read32(ctrl_num, APPL_CTRL);
+		val |= APPL_CTRL_LTSSM_EN;
+		pcie_appl_write32(ctrl_num, APPL_CTRL, val);
+
+		pcie_train_step[ctrl_num] = PCIE_TRAIN_LTSSM;
+		pcie_train_start[ctrl_num] = tegrabl_get_timestamp_us();
+		break;
+
+	case PCIE_TRAIN_LTSSM:
+		/** Check for PCIe link up */
+		if ((NV_READ32(appl_reg_offset[ctrl_num] + APPL_LINK_STATUS) & RDLH_LINK_UP_MASK) == RDLH_LINK_UP) {
+			pr_info("PCIe controller-%d link is up\n", ctrl_num);
+			pcie_train_step[ctrl_num] = PCIE_TRAIN_IDLE;
+			error = TEGRABL_NO_ERROR;
+			break;
+		}
+		if (elapsed >= PCIE_LINK_UP_TIMEOUT_US) {
+			pr_critical("Failed to link up controller-%d\n", ctrl_num);
+			pcie_train_step[ctrl_num] = PCIE_TRAIN_IDLE;
+			tegrabl_pcie_reset_state(ctrl_num);
+			error = TEGRABL_ERR_INIT_FAILED;
+		}
+		break;
+
+	default:
+		error = TEGRABL_ERR_NOT_INITIALIZED;
+		break;
 	}
+
 	return error;
 }
 
@@ -14,6 +14,7 @@
 #include <tegrabl_error.h>
 #include <tegrabl_binary_types.h>
 #include <tegrabl_blockdev.h>
+#include <tegrabl_partition_manager.h>
 /**
  *@brief Binary information table
  */
@@ -80,6 +81,46 @@ tegrabl_error_t tegrabl_load_binary(tegrabl_binary_type_t bin_type,
  */
 tegrabl_error_t tegrabl_load_binary_bdev(tegrabl_binary_type_t bin_type, void **load_address,
 										 uint32_t *binary_length,  tegrabl_bdev_t *bdev);
+/**
+ * @brief Read of a binary started by tegrabl_load_binary_async()
+ */
+struct tegrabl_binary_async_load {
+	struct tegrabl_partition partition;
+	struct tegrabl_blockdev_xfer_info *xfer;
+	void *load_address;
+	uint64_t size;
+};
+
+/**
+ * @brief Starts reading a binary to its predefined load address without
+ * waiting for it. The read is only started when the binary and overlap_type
+ * are on different UFS LUNs, which have their own transfer queues, so that
+ * the caller can load overlap_type meanwhile.
+ *
+ * @param bin_type Type of binary to be loaded
+ * @param overlap_type Type of binary the caller loads while this one is read
+ * @param load Handle of the read, to be passed to tegrabl_load_binary_async_wait()
+ *
+ * @return TEGRABL_NO_ERROR if the read was started, TEGRABL_ERR_NOT_SUPPORTED
+ *		   if the binaries cannot be read together, otherwise an appropriate
+ *		   error value.
+ */
+tegrabl_error_t tegrabl_load_binary_async(tegrabl_binary_type_t bin_type,
+	tegrabl_binary_type_t overlap_type, struct tegrabl_binary_async_load *load);
+
+/**
+ * @brief Waits for a read started by tegrabl_load_binary_async()
+ *
+ * @param load Handle of the read
+ * @param load_address Gets updated with memory address where binary is loaded.
+ * @param binary_length length of the binary which is read.
+ *
+ * @return TEGRABL_NO_ERROR if loading was successful, otherwise an appropriate
+ *		   error value.
+ */
+tegrabl_error_t tegrabl_load_binary_async_wait(struct tegrabl_binary_async_load *load,
+	void **load_address, uint32_t *binary_length);
+
 /**
  * @brief Updates the location of recovery image blob downloaded
  * in recovery for flashing or rcm boot.
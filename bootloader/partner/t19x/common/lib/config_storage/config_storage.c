@@ -44,6 +44,12 @@
 #endif
 #include <tegrabl_board_info.h>
 #include <tegrabl_malloc.h>
+#if defined(CONFIG_ENABLE_STORAGE_PROBE_THREADS)
+#if !defined(CONFIG_ENABLE_BACKGROUND_TASKS)
+#error "CONFIG_ENABLE_STORAGE_PROBE_THREADS needs CONFIG_ENABLE_BACKGROUND_TASKS"
+#endif
+#include <tegrabl_background.h>
+#endif
 #include <stdlib.h>
 #include <string.h>
 
@@ -395,6 +401,188 @@ fail:
 	return err;
 }
 
+#if defined(CONFIG_ENABLE_STORAGE_PROBE_THREADS)
+/*
+ * Devices after the boot device are brought up as background tasks. They
+ * only switch at tegrabl_background_yield() in their card, link and PHY
+ * polling loops, so the waits of different controllers overlap.
+ */
+struct storage_probe {
+	struct tegrabl_background_task task;
+	struct tegrabl_device_config_params *device_config;
+	tegrabl_storage_type_t device_type;
+	uint8_t instance;
+	tegrabl_error_t err;
+	bool used;
+};
+
+static struct storage_probe storage_probes[TEGRABL_MAX_STORAGE_DEVICES];
+
+/* Storage types which are brought up by the same driver context */
+static tegrabl_storage_type_t storage_probe_family(tegrabl_storage_type_t device_type)
+{
+	switch (device_type) {
+	case TEGRABL_STORAGE_SDMMC_BOOT:
+	case TEGRABL_STORAGE_SDMMC_USER:
+	case TEGRABL_STORAGE_SDMMC_RPMB:
+		return TEGRABL_STORAGE_SDMMC_USER;
+	case TEGRABL_STORAGE_UFS:
+	case TEGRABL_STORAGE_UFS_USER:
+	case TEGRABL_STORAGE_UFS_RPMB:
+		return TEGRABL_STORAGE_UFS;
+	default:
+		return device_type;
+	}
+}
+
+/*
+ * SD card, UFS and USB pick their controller or LUNs at runtime, so any
+ * instance of them is treated as the same device
+ */
+static bool storage_probe_matches(struct storage_probe *probe, tegrabl_storage_type_t device_type,
+								  uint8_t instance)
+{
+	tegrabl_storage_type_t family = storage_probe_family(device_type);
+
+	if (storage_probe_family(probe->device_type) != family) {
+		return false;
+	}
+
+	switch (family) {
+	case TEGRABL_STORAGE_SDCARD:
+	case TEGRABL_STORAGE_UFS:
+	case TEGRABL_STORAGE_USB_MS:
+		return true;
+	default:
+		return probe->instance == instance;
+	}
+}
+
+static tegrabl_error_t storage_probe_run(void *arg)
+{
+	struct storage_probe *probe = (struct storage_probe *)arg;
+
+	return init_storage_device(probe->device_config, probe->device_type, probe->instance);
+}
+
+static tegrabl_error_t storage_probe_collect(struct storage_probe *probe)
+{
+	if (tegrabl_background_pending(&probe->task)) {
+		probe->err = tegrabl_background_wait(&probe->task);
+	}
+
+	return probe->err;
+}
+
+static tegrabl_error_t storage_probe_start(uint32_t idx,
+										   struct tegrabl_device_config_params *device_config,
+										   tegrabl_storage_type_t device_type, uint8_t instance)
+{
+	struct storage_probe *probe = &storage_probes[idx];
+	uint32_t i;
+
+	/* A driver context is never brought up twice at once */
+	for (i = 0; i < idx; i++) {
+		if (storage_probes[i].used && storage_probe_matches(&storage_probes[i], device_type, instance)) {
+			(void)storage_probe_collect(&storage_probes[i]);
+		}
+	}
+
+	probe->device_config = device_config;
+	probe->device_type = device_type;
+	probe->instance = instance;
+	probe->err = TEGRABL_NO_ERROR;
+	probe->used = true;
+
+	return tegrabl_background_start(&probe->task, "storage-probe", storage_probe_run, probe);
+}
+
+/* Keep the block devices in list order, whichever probe registered first */
+static void storage_probe_sort_bdevs(void)
+{
+	tegrabl_bdev_t *bdev;
+	tegrabl_bdev_t *next;
+	tegrabl_storage_type_t type;
+	uint8_t instance;
+	uint32_t count = 0;
+	uint32_t i;
+	uint32_t j;
+	uint32_t k;
+
+	for (bdev = tegrabl_blockdev_next_device(NULL); bdev != NULL; bdev = tegrabl_blockdev_next_device(bdev)) {
+		count++;
+	}
+
+	for (i = 0; i < TEGRABL_MAX_STORAGE_DEVICES; i++) {
+		if (!storage_probes[i].used) {
+			continue;
+		}
+
+		/* Moved devices go behind the ones still to be visited */
+		bdev = tegrabl_blockdev_next_device(NULL);
+		for (k = 0; (k < count) && (bdev != NULL); k++) {
+			next = tegrabl_blockdev_next_device(bdev);
+			type = (tegrabl_storage_type_t)tegrabl_blockdev_get_storage_type(bdev);
+			instance = (uint8_t)tegrabl_blockdev_get_instance(bdev);
+			if (storage_probe_matches(&storage_probes[i], type, instance)) {
+				/* Already placed by an earlier probe of the same device */
+				for (j = 0; j < i; j++) {
+					if (storage_probes[j].used && storage_probe_matches(&storage_probes[j], type, instance)) {
+						break;
+					}
+				}
+				if (j == i) {
+					(void)tegrabl_blockdev_move_to_tail(bdev);
+				}
+			}
+			bdev = next;
+		}
+	}
+}
+
+/* Returns the first failure in list order once every probe is collected */
+static tegrabl_error_t storage_probe_finish(void)
+{
+	tegrabl_error_t err = TEGRABL_NO_ERROR;
+	tegrabl_error_t probe_err;
+	bool busy;
+	uint32_t i;
+
+	/* Each yield lends the CPU to every task once, so the probes take turns */
+	do {
+		busy = false;
+		for (i = 0; i < TEGRABL_MAX_STORAGE_DEVICES; i++) {
+			if (tegrabl_background_pending(&storage_probes[i].task) && !storage_probes[i].task.done) {
+				busy = true;
+			}
+		}
+		if (busy) {
+			tegrabl_background_yield();
+		}
+	} while (busy);
+
+	for (i = 0; i < TEGRABL_MAX_STORAGE_DEVICES; i++) {
+		if (!storage_probes[i].used) {
+			continue;
+		}
+		probe_err = storage_probe_collect(&storage_probes[i]);
+		if ((probe_err != TEGRABL_NO_ERROR) && (err == TEGRABL_NO_ERROR)) {
+			pr_error("Failed to initialize device %d-%d\n", storage_probes[i].device_type,
+					 storage_probes[i].instance);
+			err = probe_err;
+		}
+	}
+
+	storage_probe_sort_bdevs();
+
+	for (i = 0; i < TEGRABL_MAX_STORAGE_DEVICES; i++) {
+		storage_probes[i].used = false;
+	}
+
+	return err;
+}
+#endif
+
 /**
 * @brief Placeholder for storing active boot device information
 */
@@ -424,6 +612,9 @@ tegrabl_error_t config_storage(struct tegrabl_device_config_params *device_confi
 		[TEGRABL_BOOT_DEV_SDCARD] = TEGRABL_STORAGE_SDCARD,
 	};
 	uint8_t instance = 0;
+#if defined(CONFIG_ENABLE_STORAGE_PROBE_THREADS)
+	tegrabl_error_t probe_err;
+#endif
 #if defined(CONFIG_OS_IS_L4T)
 	bool is_storage_list = false;
 	static uint8_t storage_to_boot_dev_type[TEGRABL_STORAGE_MAX] = {
@@ -502,13 +693,29 @@ tegrabl_error_t config_storage(struct tegrabl_device_config_params *device_confi
 		}
 #endif
 
+#if defined(CONFIG_ENABLE_STORAGE_PROBE_THREADS)
+		err = storage_probe_start(i, device_config, device, instance);
+		if (err != TEGRABL_NO_ERROR) {
+			pr_error("Failed to start device %d-%d\n", device, instance);
+			break;
+		}
+#else
 		err = init_storage_device(device_config, device, instance);
 		if (err != TEGRABL_NO_ERROR) {
 			pr_error("Failed to initialize device %d-%d\n", device, instance);
 			goto fail;
 		}
+#endif
 	}
 
+#if defined(CONFIG_ENABLE_STORAGE_PROBE_THREADS)
+	/* Started probes are collected even if a later one could not start */
+	probe_err = storage_probe_finish();
+	if (err == TEGRABL_NO_ERROR) {
+		err = probe_err;
+	}
+#endif
+
 fail:
 	return err;
 }
@@ -352,7 +352,7 @@ static int add_profiler_carveout(char *cmdline, int len,
 	int ret = 0;
 	TEGRABL_UNUSED(priv);
 
-#if !defined(CONFIG_BOOT_PROFILER)
+#if !defined(CONFIG_BOOT_PROFILER_CARVEOUT)
 	TEGRABL_UNUSED(cmdline);
 	TEGRABL_UNUSED(len);
 	TEGRABL_UNUSED(param);